@@ -3,6 +3,13 @@ import { useNavigate } from 'react-router-dom';
 import { connectMQTT, publishMessage, disconnectMQTT, subscribeToTopic } from '../services/mqttService';
 import '../styles/App.css';
 
+// Comando em lote do ESP32 de nuvem: {"on": [..], "off": [..]}, aplicado de uma vez
+const BULK_COMMAND_TOPIC = 'esp32_02/gpio/bulk/set';
+const BULK_STATE_TOPIC = 'esp32_02/gpio/bulk/state';
+
+// GPIO 32 e 33 passam de 32 bits: sem operadores bit a bit, que truncam a máscara
+const gpioBit = (mask, pin) => Math.floor(mask / 2 ** Number(pin)) % 2 === 1;
+
 export default function App() {
   const navigate = useNavigate();
   const [connectionStatus, setConnectionStatus] = useState('Conectando ao Broker MQTT...');
@@ -129,7 +136,14 @@ export default function App() {
           }, (topic, message) => {
             if (!isMounted) return;
             if (topic === 'sistema/regras/lista') {
-              setRules(JSON.parse(message));
+              const update = JSON.parse(message);
+              if (Array.isArray(update)) {
+                setRules(update);
+              } else if (update.op === 'add') {
+                setRules(prev => [...prev.filter(rule => rule.id !== update.rule.id), update.rule]);
+              } else if (update.op === 'delete') {
+                setRules(prev => prev.filter(rule => rule.id !== update.rule_id));
+              }
             } else if (topic === 'sistema/dashboard/status') {
               const newStatus = JSON.parse(message);
               setStatus({
@@ -143,6 +157,13 @@ export default function App() {
                 ldr_raw: newStatus.ldr_raw !== undefined ? newStatus.ldr_raw : '-',
                 last_update: newStatus.last_update ? new Date(newStatus.last_update).toLocaleTimeString() : '-'
               });
+            } else if (topic === BULK_STATE_TOPIC) {
+              // Aviso (não retido) de um comando em lote: {"mask": M, "value": V}, bit n = GPIO n.
+              // O estado retido de cada pino também chega pelo tópico do pino.
+              const { mask, value } = JSON.parse(message);
+              setControlledGpios(prev => prev.map(gpio => (
+                gpioBit(mask, gpio.pin) ? { ...gpio, state: gpioBit(value, gpio.pin) ? 'ON' : 'OFF' } : gpio
+              )));
             } else {
               setControlledGpios(prev => {
                 const gpioStatus = prev.map(gpio => {
@@ -161,6 +182,7 @@ export default function App() {
         if (isMounted) {
           subscribeToTopic('sistema/regras/lista');
           subscribeToTopic('sistema/dashboard/status');
+          subscribeToTopic(BULK_STATE_TOPIC);
           await publishMessage('sistema/regras/gerenciar', JSON.stringify({ command: "get_list" }));
         }
       } catch (err) {
@@ -205,6 +227,20 @@ export default function App() {
       });
   };
 
+  // Cena: todos os GPIOs controlados mudam com uma única mensagem ao ESP32
+  const handleBulkControl = (scene) => {
+    const pins = controlledGpios.map(gpio => Number(gpio.pin));
+    const command = scene === 'invert'
+      ? { on: controlledGpios.filter(gpio => gpio.state !== 'ON').map(gpio => Number(gpio.pin)),
+          off: controlledGpios.filter(gpio => gpio.state === 'ON').map(gpio => Number(gpio.pin)) }
+      : { [scene]: pins };
+    publishMessage(BULK_COMMAND_TOPIC, JSON.stringify(command))
+      .catch(err => {
+        console.error('Erro ao publicar comando em lote:', err);
+        alert('Erro ao enviar comando. Verifique a conexão MQTT.');
+      });
+  };
+
   const handleAddRule = (e) => {
     e.preventDefault();
     const rule = {
@@ -328,6 +364,18 @@ export default function App() {
       <div className="mb-8">
         <h2 className="text-2xl font-semibold mb-4 text-white">Controle Manual</h2>
         <div className="space-y-4">
+          {controlledGpios.length > 1 && (
+            <div className="bg-gray-800 rounded-lg p-6 shadow-lg">
+              <div className="flex flex-col sm:flex-row justify-between items-center">
+                <h3 className="text-xl font-bold mb-4 sm:mb-0">Todos os GPIOs</h3>
+                <div className="grid grid-cols-3 gap-2">
+                  <button onClick={() => handleBulkControl('on')} className="btn btn-green">ON</button>
+                  <button onClick={() => handleBulkControl('off')} className="btn btn-red">OFF</button>
+                  <button onClick={() => handleBulkControl('invert')} className="btn btn-blue">Inverter</button>
+                </div>
+              </div>
+            </div>
+          )}
           {controlledGpios.length === 0 ? (
             <p className="text-gray-400">Nenhum GPIO configurado. Adicione um acima.</p>
           ) : (
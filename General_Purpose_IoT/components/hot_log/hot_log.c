@@ -0,0 +1,112 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+
+#include "hot_log.h"
+
+static int64_t (*hot_log_clock_ms)(void);
+
+void hot_log_init(int64_t (*clock_ms)(void)) {
+    hot_log_clock_ms = clock_ms;
+}
+
+// --- Erros Repetidos ---
+
+bool hot_log_limit_allow(hot_log_limit_t *limit, uint32_t *suppressed) {
+    *suppressed = 0;
+    if (!hot_log_clock_ms) return true;
+    int64_t now_ms = hot_log_clock_ms();
+    if (now_ms < limit->next_ms) {
+        limit->suppressed++;
+        return false;
+    }
+    *suppressed = limit->suppressed;
+    limit->suppressed = 0;
+    limit->next_ms = now_ms + HOT_LOG_ERROR_INTERVAL_MS;
+    return true;
+}
+
+// --- Anel em RAM ---
+// Bytes em sequência circular; a linha é formatada fora do lock e só a cópia
+// fica na seção crítica. A leitura descarta o pedaço da linha mais antiga que
+// foi parcialmente sobrescrito.
+
+#if HOT_LOG_RING_ENABLED
+static char ring[HOT_LOG_RING_SIZE];
+static size_t ring_head;    // Próximo byte a escrever
+static size_t ring_used;    // Bytes válidos, até HOT_LOG_RING_SIZE
+static uint32_t ring_lines;
+static portMUX_TYPE ring_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+void hot_log_ring_write(char level, const char *tag, const char *format, ...) {
+#if HOT_LOG_RING_ENABLED
+    char line[HOT_LOG_LINE_SIZE];
+    unsigned long now_ms = hot_log_clock_ms ? (unsigned long)hot_log_clock_ms() : 0;
+    int len = snprintf(line, sizeof(line), "%lu %c %s: ", now_ms, level, tag);
+    if (len < 0) return;
+    if (len < (int)sizeof(line) - 1) {
+        va_list args;
+        va_start(args, format);
+        int body = vsnprintf(line + len, sizeof(line) - len, format, args);
+        va_end(args);
+        if (body > 0) len += body;
+    }
+    if (len > (int)sizeof(line) - 2) len = (int)sizeof(line) - 2;   // Cortada: ainda termina em '\n'
+    line[len++] = '\n';
+
+    portENTER_CRITICAL(&ring_lock);
+    size_t first = HOT_LOG_RING_SIZE - ring_head;
+    if (first > (size_t)len) first = (size_t)len;
+    memcpy(&ring[ring_head], line, first);
+    memcpy(ring, line + first, (size_t)len - first);
+    ring_head = (ring_head + (size_t)len) % HOT_LOG_RING_SIZE;
+    ring_used = ring_used + (size_t)len > HOT_LOG_RING_SIZE ? HOT_LOG_RING_SIZE : ring_used + (size_t)len;
+    ring_lines++;
+    portEXIT_CRITICAL(&ring_lock);
+#else
+    (void)level;
+    (void)tag;
+    (void)format;
+#endif
+}
+
+size_t hot_log_ring_read(char *out, size_t size) {
+#if HOT_LOG_RING_ENABLED
+    if (size == 0) return 0;
+    portENTER_CRITICAL(&ring_lock);
+    size_t count = ring_used < size ? ring_used : size;
+    size_t start = (ring_head + HOT_LOG_RING_SIZE - count) % HOT_LOG_RING_SIZE;
+    // O primeiro byte copiado só começa uma linha se vier logo depois de um '\n';
+    // com o anel cheio copiado inteiro, o byte anterior é o fim da linha mais nova
+    bool partial = count == HOT_LOG_RING_SIZE || (count < ring_used && ring[(start + HOT_LOG_RING_SIZE - 1) % HOT_LOG_RING_SIZE] != '\n');
+    size_t first = HOT_LOG_RING_SIZE - start;
+    if (first > count) first = count;
+    memcpy(out, &ring[start], first);
+    memcpy(out + first, ring, count - first);
+    portEXIT_CRITICAL(&ring_lock);
+
+    // Pula o resto da linha cortada pelo tamanho de out ou sobrescrita no anel
+    if (partial) {
+        char *newline = memchr(out, '\n', count);
+        if (!newline) return 0;
+        size_t skip = (size_t)(newline - out) + 1;
+        memmove(out, out + skip, count - skip);
+        count -= skip;
+    }
+    return count;
+#else
+    (void)out;
+    (void)size;
+    return 0;
+#endif
+}
+
+uint32_t hot_log_ring_lines(void) {
+#if HOT_LOG_RING_ENABLED
+    return ring_lines;
+#else
+    return 0;
+#endif
+}
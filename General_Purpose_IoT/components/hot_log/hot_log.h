@@ -0,0 +1,106 @@
+#ifndef HOT_LOG_H
+#define HOT_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_log.h"
+
+// ======================================================
+// --- LOGS DO CAMINHO QUENTE ---
+// ======================================================
+// Componente compartilhado pelos dois firmwares (EXTRA_COMPONENT_DIRS). Uma
+// linha de log na UART a 115200 baud custa ~87 µs por caractere e o ESP_LOGx
+// espera a FIFO esvaziar: as linhas por leitura e por comando ocupavam
+// milissegundos de cada ciclo. Os logs desses caminhos usam HOT_LOGI, cujo
+// destino é escolhido na compilação por HOT_LOG_MODE:
+//
+//   HOT_LOG_OFF  - removidos (padrão; o formato continua verificado pelo compilador)
+//   HOT_LOG_RING - linha curta no anel em RAM
+//   HOT_LOG_UART - ESP_LOGI, como antes (depuração)
+//
+// Erros que se repetem a cada leitura ou comando usam HOT_LOGE_LIMITED/
+// HOT_LOGW_LIMITED: na UART, no máximo uma linha por HOT_LOG_ERROR_INTERVAL_MS
+// para cada hot_log_limit_t, com a contagem das omitidas. Com
+// HOT_LOG_RING_ENABLED, todas as ocorrências vão também para o anel, que os
+// firmwares publicam em DEVICE_ID/system/logs quando recebem um pedido.
+//
+// As opções precisam ser as mesmas em todos os componentes; para mudá-las, use
+// idf_build_set_property(COMPILE_DEFINITIONS ...) no CMakeLists.txt do projeto.
+
+#define HOT_LOG_OFF  0
+#define HOT_LOG_RING 1
+#define HOT_LOG_UART 2
+
+#ifndef HOT_LOG_MODE
+#define HOT_LOG_MODE HOT_LOG_OFF
+#endif
+#ifndef HOT_LOG_RING_ENABLED
+#define HOT_LOG_RING_ENABLED 1
+#endif
+#if HOT_LOG_MODE == HOT_LOG_RING && !HOT_LOG_RING_ENABLED
+#error "HOT_LOG_MODE HOT_LOG_RING precisa de HOT_LOG_RING_ENABLED"
+#endif
+#ifndef HOT_LOG_RING_SIZE
+#define HOT_LOG_RING_SIZE 1024           // Cabe numa mensagem da outbox do firmware da nuvem
+#endif
+#ifndef HOT_LOG_LINE_SIZE
+#define HOT_LOG_LINE_SIZE 96             // Linhas maiores são cortadas no anel
+#endif
+#ifndef HOT_LOG_ERROR_INTERVAL_MS
+#define HOT_LOG_ERROR_INTERVAL_MS 10000
+#endif
+
+// Relógio das linhas do anel e dos limites de erro; sem ele todo erro é registrado
+void hot_log_init(int64_t (*clock_ms)(void));
+
+// --- Anel em RAM ---
+// Sem HOT_LOG_RING_ENABLED as funções existem, mas não guardam nada.
+
+// Acrescenta "<ms> <nível> <tag>: <mensagem>\n"; sobrescreve as linhas mais antigas
+void hot_log_ring_write(char level, const char *tag, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// Copia as linhas inteiras mais recentes, da mais antiga para a mais nova, sem
+// terminador. Retorna os bytes copiados (0 com o anel vazio).
+size_t hot_log_ring_read(char *out, size_t size);
+
+// Linhas escritas desde o boot (inclusive as já sobrescritas)
+uint32_t hot_log_ring_lines(void);
+
+#if HOT_LOG_MODE == HOT_LOG_UART
+#define HOT_LOGI(tag, format, ...) ESP_LOGI(tag, format, ##__VA_ARGS__)
+#elif HOT_LOG_MODE == HOT_LOG_RING
+#define HOT_LOGI(tag, format, ...) hot_log_ring_write('I', tag, format, ##__VA_ARGS__)
+#else
+#define HOT_LOGI(tag, format, ...) \
+    do { if (0) hot_log_ring_write('I', tag, format, ##__VA_ARGS__); } while (0)
+#endif
+
+// --- Erros Repetidos ---
+
+typedef struct {
+    int64_t next_ms;        // Antes disso, a mensagem só é contada
+    uint32_t suppressed;    // Omitidas desde a última linha na UART
+} hot_log_limit_t;
+
+#define HOT_LOG_LIMIT_INIT { 0, 0 }
+
+// true se a mensagem deve ir para a UART agora; *suppressed recebe quantas
+// foram omitidas desde a anterior. Chamadas concorrentes no mesmo limite podem
+// deixar passar uma linha a mais ou errar a contagem por uma, nunca travar.
+bool hot_log_limit_allow(hot_log_limit_t *limit, uint32_t *suppressed);
+
+#define HOT_LOG_LIMITED(esp_log, level, limit, tag, format, ...) do { \
+        uint32_t hot_log_suppressed_; \
+        if (HOT_LOG_RING_ENABLED) hot_log_ring_write(level, tag, format, ##__VA_ARGS__); \
+        if (hot_log_limit_allow(limit, &hot_log_suppressed_)) { \
+            if (hot_log_suppressed_ > 0) esp_log(tag, format " (+%lu omitidas)", ##__VA_ARGS__, (unsigned long)hot_log_suppressed_); \
+            else esp_log(tag, format, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define HOT_LOGE_LIMITED(limit, tag, format, ...) HOT_LOG_LIMITED(ESP_LOGE, 'E', limit, tag, format, ##__VA_ARGS__)
+#define HOT_LOGW_LIMITED(limit, tag, format, ...) HOT_LOG_LIMITED(ESP_LOGW, 'W', limit, tag, format, ##__VA_ARGS__)
+
+#endif // HOT_LOG_H
@@ -0,0 +1,53 @@
+#include "radio_burst.h"
+
+void radio_burst_init(radio_burst_t *rb, uint32_t period_ms, uint32_t phase_ms, uint32_t linger_ms, int64_t now_ms) {
+    rb->period_ms = period_ms > 0 ? period_ms : 1;
+    rb->linger_ms = linger_ms;
+    rb->next_burst_ms = now_ms + phase_ms;
+    rb->sleep_at_ms = INT64_MAX;
+    rb->awake_since_ms = now_ms;
+    rb->window_start_ms = now_ms;
+    rb->window_awake_ms = 0;
+    rb->window_bursts = 0;
+}
+
+bool radio_burst_start(radio_burst_t *rb, int64_t now_ms) {
+    if (now_ms < rb->next_burst_ms) return false;
+    int64_t missed = (now_ms - rb->next_burst_ms) / rb->period_ms;
+    rb->next_burst_ms += (missed + 1) * rb->period_ms;
+    if (rb->sleep_at_ms == INT64_MAX) rb->awake_since_ms = now_ms;   // Já acordado: a janela só se estende
+    rb->sleep_at_ms = now_ms + rb->linger_ms;
+    rb->window_bursts++;
+    return true;
+}
+
+bool radio_burst_poll_sleep(radio_burst_t *rb, int64_t now_ms) {
+    if (now_ms < rb->sleep_at_ms) return false;
+    if (rb->sleep_at_ms > rb->awake_since_ms) rb->window_awake_ms += (uint64_t)(rb->sleep_at_ms - rb->awake_since_ms);
+    rb->sleep_at_ms = INT64_MAX;
+    return true;
+}
+
+int64_t radio_burst_deadline(const radio_burst_t *rb) {
+    return rb->sleep_at_ms < rb->next_burst_ms ? rb->sleep_at_ms : rb->next_burst_ms;
+}
+
+uint16_t radio_burst_snapshot(radio_burst_t *rb, int64_t now_ms, uint32_t *bursts) {
+    uint64_t awake_ms = rb->window_awake_ms;
+    if (rb->sleep_at_ms != INT64_MAX) {
+        // Acordado agora: conta até now_ms (ou o fim da janela acordada) e o
+        // resto fica para a próxima
+        int64_t until_ms = now_ms < rb->sleep_at_ms ? now_ms : rb->sleep_at_ms;
+        if (until_ms > rb->awake_since_ms) {
+            awake_ms += (uint64_t)(until_ms - rb->awake_since_ms);
+            rb->awake_since_ms = until_ms;
+        }
+    }
+    uint64_t window_ms = now_ms > rb->window_start_ms ? (uint64_t)(now_ms - rb->window_start_ms) : 0;
+    uint64_t permille = window_ms ? awake_ms * 1000 / window_ms : 0;
+    *bursts = rb->window_bursts;
+    rb->window_start_ms = now_ms;
+    rb->window_awake_ms = 0;
+    rb->window_bursts = 0;
+    return permille > 1000 ? 1000 : (uint16_t)permille;
+}
@@ -0,0 +1,64 @@
+#ifndef RADIO_BURST_H
+#define RADIO_BURST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// ======================================================
+// --- RAJADAS DO RÁDIO (MODO DE BAIXO CONSUMO) ---
+// ======================================================
+// Componente compartilhado pelos dois firmwares (EXTRA_COMPONENT_DIRS). No modo
+// de baixo consumo o Wi-Fi fica em modem sleep e só é mantido acordado numa
+// rajada por período: as publicações do período saem juntas num instante da
+// grade phase + k * period e o rádio continua acordado por linger_ms (ACKs do
+// TCP e respostas do broker) antes de voltar ao modo econômico.
+//
+// Este arquivo só decide quando: o relógio é passado pelo chamador, então a
+// política roda no host com relógio simulado. Quem liga e desliga o modem
+// sleep é radio_burst_power.c (só ESP-IDF).
+//
+// O tempo acordado contado é o das janelas em que o firmware força o rádio
+// ligado (rajada + linger); os despertares do modem sleep a cada
+// listen_interval beacons para ouvir o AP ficam de fora.
+
+typedef struct {
+    uint32_t period_ms;
+    uint32_t linger_ms;
+    int64_t next_burst_ms;       // Próximo instante da grade
+    int64_t sleep_at_ms;         // Fim da janela acordada (INT64_MAX dormindo)
+    int64_t awake_since_ms;      // Início da parte da janela ainda não contada
+    int64_t window_start_ms;     // Início da janela de medição
+    uint64_t window_awake_ms;
+    uint32_t window_bursts;
+} radio_burst_t;
+
+// A primeira rajada ocorre em now_ms + phase_ms
+void radio_burst_init(radio_burst_t *rb, uint32_t period_ms, uint32_t phase_ms, uint32_t linger_ms, int64_t now_ms);
+
+// true se now_ms alcançou a rajada: o rádio passa a contar como acordado até
+// now_ms + linger_ms e a próxima rajada é o primeiro instante da grade depois
+// de now_ms (rajadas perdidas, ex.: sem conexão, não se acumulam).
+bool radio_burst_start(radio_burst_t *rb, int64_t now_ms);
+
+// true uma vez, quando a janela acordada termina: o chamador volta ao modem sleep
+bool radio_burst_poll_sleep(radio_burst_t *rb, int64_t now_ms);
+
+// Próximo instante em que start ou poll_sleep têm algo a fazer
+int64_t radio_burst_deadline(const radio_burst_t *rb);
+
+// Parcela (‰) do tempo com o rádio forçado acordado desde o snapshot anterior
+// (ou desde init); *bursts recebe as rajadas da janela. Começa outra janela.
+uint16_t radio_burst_snapshot(radio_burst_t *rb, int64_t now_ms, uint32_t *bursts);
+
+// --- Só ESP-IDF (radio_burst_power.c) ---
+
+// Modem sleep (WIFI_PS_MAX_MODEM) e, com CONFIG_PM_ENABLE e
+// CONFIG_FREERTOS_USE_TICKLESS_IDLE, light sleep automático entre as rajadas.
+// Chamar depois de esp_wifi_start(); o listen_interval vai no wifi_config_t.
+esp_err_t radio_burst_power_init(void);
+
+// false durante a rajada (WIFI_PS_NONE), true para voltar ao modem sleep
+void radio_burst_power_save(bool enabled);
+
+#endif // RADIO_BURST_H
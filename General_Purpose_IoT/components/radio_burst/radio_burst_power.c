@@ -0,0 +1,25 @@
+#include "sdkconfig.h"
+#include "esp_pm.h"
+#include "esp_wifi.h"
+
+#include "radio_burst.h"
+
+esp_err_t radio_burst_power_init(void) {
+#if CONFIG_PM_ENABLE
+    // Frequência mínima no cristal; o light sleep automático exige tickless idle
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = CONFIG_XTAL_FREQ,
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        .light_sleep_enable = true,
+#endif
+    };
+    esp_err_t err = esp_pm_configure(&pm_config);
+    if (err != ESP_OK) return err;
+#endif
+    return esp_wifi_set_ps(WIFI_PS_MAX_MODEM);
+}
+
+void radio_burst_power_save(bool enabled) {
+    esp_wifi_set_ps(enabled ? WIFI_PS_MAX_MODEM : WIFI_PS_NONE);
+}
@@ -0,0 +1,102 @@
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "runtime_metrics.h"
+
+static const uint32_t bucket_bounds_us[RUNTIME_METRICS_BUCKETS - 1] = RUNTIME_METRICS_BUCKET_BOUNDS_US;
+static const char *const metric_names[RUNTIME_METRIC_KINDS] = { "sensor_read", "publish", "nvs_commit", "gpio_command" };
+
+typedef struct {
+    atomic_uint_least32_t count;
+    atomic_uint_least32_t failures;
+    atomic_uint_least32_t sum_us;
+    atomic_uint_least32_t max_us;
+    atomic_uint_least32_t buckets[RUNTIME_METRICS_BUCKETS];
+} metric_counters_t;
+
+static metric_counters_t counters[RUNTIME_METRIC_KINDS];
+
+void runtime_metrics_record(runtime_metric_t metric, int64_t start_us, int64_t end_us, bool ok) {
+    if ((unsigned)metric >= RUNTIME_METRIC_KINDS) return;
+    int64_t elapsed_us = end_us - start_us;
+    uint32_t us = elapsed_us < 0 ? 0 : elapsed_us > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed_us;
+    size_t bucket = 0;
+    while (bucket < RUNTIME_METRICS_BUCKETS - 1 && us > bucket_bounds_us[bucket]) bucket++;
+
+    metric_counters_t *c = &counters[metric];
+    atomic_fetch_add_explicit(&c->count, 1, memory_order_relaxed);
+    if (!ok) atomic_fetch_add_explicit(&c->failures, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->sum_us, us, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->buckets[bucket], 1, memory_order_relaxed);
+    uint_least32_t max_us = atomic_load_explicit(&c->max_us, memory_order_relaxed);
+    while (us > max_us && !atomic_compare_exchange_weak_explicit(&c->max_us, &max_us, us,
+                                                                 memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+void runtime_metrics_snapshot(runtime_metric_window_t *out) {
+    for (int m = 0; m < RUNTIME_METRIC_KINDS; m++) {
+        metric_counters_t *c = &counters[m];
+        out[m].count = atomic_exchange_explicit(&c->count, 0, memory_order_relaxed);
+        out[m].failures = atomic_exchange_explicit(&c->failures, 0, memory_order_relaxed);
+        out[m].sum_us = atomic_exchange_explicit(&c->sum_us, 0, memory_order_relaxed);
+        out[m].max_us = atomic_exchange_explicit(&c->max_us, 0, memory_order_relaxed);
+        for (int b = 0; b < RUNTIME_METRICS_BUCKETS; b++) {
+            out[m].buckets[b] = atomic_exchange_explicit(&c->buckets[b], 0, memory_order_relaxed);
+        }
+    }
+}
+
+// Acrescenta ao buffer como snprintf; written < 0 propaga o erro
+static void append(char *buffer, size_t size, int *written, const char *format, ...) {
+    if (*written < 0) return;
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer + *written, size > (size_t)*written ? size - *written : 0, format, args);
+    va_end(args);
+    *written = n < 0 ? n : *written + n;
+}
+
+int runtime_metrics_format_json(const runtime_metric_window_t *ops, const runtime_system_stats_t *sys,
+                                char *buffer, size_t size) {
+    int written = 0;
+    append(buffer, size, &written, "{");
+    if (sys) {
+        append(buffer, size, &written, "\"up\":%lu,\"heap\":[%lu,%lu],", (unsigned long)sys->uptime_s,
+               (unsigned long)sys->heap_free, (unsigned long)sys->heap_min);
+    }
+    append(buffer, size, &written, "\"bounds_us\":[");
+    for (int b = 0; b < RUNTIME_METRICS_BUCKETS - 1; b++) {
+        append(buffer, size, &written, "%s%lu", b ? "," : "", (unsigned long)bucket_bounds_us[b]);
+    }
+    append(buffer, size, &written, "],\"ops\":{");
+    bool first = true;
+    for (int m = 0; m < RUNTIME_METRIC_KINDS; m++) {
+        const runtime_metric_window_t *op = &ops[m];
+        if (op->count == 0) continue;
+        append(buffer, size, &written, "%s\"%s\":[%lu,%lu,%lu,%lu,[", first ? "" : ",", metric_names[m],
+               (unsigned long)op->count, (unsigned long)op->failures,
+               (unsigned long)((op->sum_us + op->count / 2) / op->count), (unsigned long)op->max_us);
+        for (int b = 0; b < RUNTIME_METRICS_BUCKETS; b++) {
+            append(buffer, size, &written, "%s%lu", b ? "," : "", (unsigned long)op->buckets[b]);
+        }
+        append(buffer, size, &written, "]]");
+        first = false;
+    }
+    append(buffer, size, &written, "}");
+    if (sys && sys->task_count > 0) {
+        append(buffer, size, &written, ",\"tasks\":{");
+        for (size_t i = 0; i < sys->task_count; i++) {
+            append(buffer, size, &written, "%s\"%s\":[%u,%lu]", i ? "," : "", sys->tasks[i].name,
+                   (unsigned)sys->tasks[i].cpu_permille, (unsigned long)sys->tasks[i].stack_free);
+        }
+        append(buffer, size, &written, "}");
+    }
+    if (sys && sys->radio_reported) {
+        append(buffer, size, &written, ",\"radio\":[%u,%lu]", (unsigned)sys->radio_awake_permille,
+               (unsigned long)sys->radio_bursts);
+    }
+    append(buffer, size, &written, "}");
+    return written;
+}
@@ -0,0 +1,81 @@
+#ifndef RUNTIME_METRICS_H
+#define RUNTIME_METRICS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ======================================================
+// --- MÉTRICAS DE EXECUÇÃO ---
+// ======================================================
+// Componente compartilhado pelos dois firmwares (EXTRA_COMPONENT_DIRS). Cada
+// operação medida tem contadores e um histograma de latência com faixas fixas,
+// todos atômicos de 32 bits: registrar não usa trava e pode ser feito de
+// qualquer tarefa. O snapshot lê e zera a janela campo a campo (não é um
+// retrato atômico do conjunto, o que basta para telemetria periódica).
+
+#define RUNTIME_METRICS_BUCKETS 8
+// Limite superior (inclusivo) de cada faixa, em µs; a última faixa não tem limite
+#define RUNTIME_METRICS_BUCKET_BOUNDS_US { 50, 200, 1000, 5000, 20000, 100000, 500000 }
+
+#ifndef RUNTIME_METRICS_MAX_TASKS
+#define RUNTIME_METRICS_MAX_TASKS 24     // Precisa cobrir todas as tarefas do sistema (uxTaskGetSystemState)
+#endif
+#define RUNTIME_METRICS_TASK_NAME_SIZE 16
+#define RUNTIME_METRICS_JSON_SIZE 1024   // Snapshot com ~15 tarefas e as operações de um firmware
+
+typedef enum {
+    RUNTIME_METRIC_SENSOR_READ,   // read() de um driver de sensor
+    RUNTIME_METRIC_PUBLISH,       // Publicação MQTT (falha: msg_id negativo ou fila cheia)
+    RUNTIME_METRIC_NVS_COMMIT,    // Gravação do estado no NVS
+    RUNTIME_METRIC_GPIO_COMMAND,  // Chegada do comando -> estado publicado
+    RUNTIME_METRIC_KINDS,
+} runtime_metric_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t failures;
+    uint32_t sum_us;
+    uint32_t max_us;
+    uint32_t buckets[RUNTIME_METRICS_BUCKETS];
+} runtime_metric_window_t;
+
+typedef struct {
+    char name[RUNTIME_METRICS_TASK_NAME_SIZE];
+    uint16_t cpu_permille;   // Parcela da CPU de todos os núcleos na janela
+    uint32_t stack_free;     // Menor folga da pilha desde a criação da tarefa, em bytes
+} runtime_task_stats_t;
+
+typedef struct {
+    uint32_t uptime_s;
+    uint32_t heap_free;
+    uint32_t heap_min;       // Menor heap livre desde o boot
+    size_t task_count;
+    runtime_task_stats_t tasks[RUNTIME_METRICS_MAX_TASKS];
+    // Modo de baixo consumo (radio_burst.h); preenchido pelo firmware depois da coleta
+    bool radio_reported;
+    uint16_t radio_awake_permille;
+    uint32_t radio_bursts;
+} runtime_system_stats_t;
+
+// Registra uma operação entre start_us e end_us (esp_timer_get_time)
+void runtime_metrics_record(runtime_metric_t metric, int64_t start_us, int64_t end_us, bool ok);
+
+// Copia a janela de cada operação para out[RUNTIME_METRIC_KINDS] e começa outra
+void runtime_metrics_snapshot(runtime_metric_window_t *out);
+
+// Uptime, heap e tarefas. Só no ESP-IDF: a lista de tarefas exige
+// CONFIG_FREERTOS_USE_TRACE_FACILITY e a CPU por tarefa,
+// CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS (sem elas, cpu_permille fica 0).
+// Chamar sempre da mesma tarefa: a CPU é a diferença para a chamada anterior.
+void runtime_metrics_collect_system(runtime_system_stats_t *out);
+
+// {"up":s,"heap":[livre,mínimo],"bounds_us":[..],
+//  "ops":{"publish":[n,falhas,média_us,máx_us,[faixas]],...},"tasks":{"nome":[cpu‰,pilha],...},
+//  "radio":[acordado‰,rajadas]}
+// Operações sem registros na janela ficam de fora; sys pode ser NULL.
+// Retorna o tamanho escrito, como snprintf.
+int runtime_metrics_format_json(const runtime_metric_window_t *ops, const runtime_system_stats_t *sys,
+                                char *buffer, size_t size);
+
+#endif // RUNTIME_METRICS_H
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <string.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+
+#include "runtime_metrics.h"
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+// Estado da chamada anterior, para a CPU na janela; só a tarefa que publica acessa
+static TaskStatus_t task_status[RUNTIME_METRICS_MAX_TASKS];
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+static struct {
+    UBaseType_t number;
+    uint32_t run_time;
+} previous[RUNTIME_METRICS_MAX_TASKS];
+static size_t previous_count;
+static uint32_t previous_total;
+
+static uint32_t previous_run_time(UBaseType_t number) {
+    for (size_t i = 0; i < previous_count; i++) {
+        if (previous[i].number == number) return previous[i].run_time;
+    }
+    return 0;   // Tarefa nova: conta desde a criação
+}
+#endif
+#endif
+
+void runtime_metrics_collect_system(runtime_system_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
+    out->heap_free = esp_get_free_heap_size();
+    out->heap_min = esp_get_minimum_free_heap_size();
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    // Retorna 0 se houver mais tarefas que RUNTIME_METRICS_MAX_TASKS
+    UBaseType_t count = uxTaskGetSystemState(task_status, RUNTIME_METRICS_MAX_TASKS, &total);
+    for (UBaseType_t i = 0; i < count; i++) {
+        runtime_task_stats_t *task = &out->tasks[i];
+        snprintf(task->name, sizeof(task->name), "%s", task_status[i].pcTaskName);
+        task->stack_free = task_status[i].usStackHighWaterMark;   // StackType_t tem 1 byte no ESP-IDF
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+        // Contadores de 32 bits: a diferença vale enquanto a janela for menor que ~71 min
+        uint32_t window = (uint32_t)total - previous_total;
+        uint32_t busy = (uint32_t)task_status[i].ulRunTimeCounter - previous_run_time(task_status[i].xTaskNumber);
+        uint64_t permille = window ? (uint64_t)busy * 1000 / ((uint64_t)window * portNUM_PROCESSORS) : 0;
+        task->cpu_permille = permille > 1000 ? 1000 : (uint16_t)permille;
+#endif
+    }
+    out->task_count = count;
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    for (UBaseType_t i = 0; i < count; i++) {
+        previous[i].number = task_status[i].xTaskNumber;
+        previous[i].run_time = (uint32_t)task_status[i].ulRunTimeCounter;
+    }
+    previous_count = count;
+    previous_total = (uint32_t)total;
+#endif
+#endif
+}
@@ -0,0 +1,358 @@
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "hot_log.h"
+#include "nvs.h"
+#include "driver/gpio.h"
+#include "hal/gpio_ll.h"
+#include "soc/gpio_struct.h"
+
+#include "gpio_control.h"
+#include "mqtt_outbox.h"
+
+static const char *TAG = "GPIO_CONTROL";
+// Publicação do estado falha a cada comando enquanto a fila estiver cheia
+static hot_log_limit_t publish_error_limit = HOT_LOG_LIMIT_INIT;
+
+static const char *nvs_namespace = "storage";
+static const char *state_topic_format = "gpio/%d/state";
+static const char *bulk_state_topic = "gpio/bulk/state";
+
+void gpio_control_init(const char *ns, const char *topic_format, const char *bulk_topic) {
+    nvs_namespace = ns;
+    state_topic_format = topic_format;
+    bulk_state_topic = bulk_topic;
+}
+
+// --- Interpretação dos Comandos ---
+
+bool gpio_command_parse_topic(const char *topic, int topic_len, const char *prefix, const char *suffix, int *pin) {
+    int prefix_len = strlen(prefix);
+    int suffix_len = strlen(suffix);
+    int digits_len = topic_len - prefix_len - suffix_len;
+    if (digits_len < 1 || digits_len > 2) return false;   // GPIOs do ESP32 vão de 0 a 39
+    if (memcmp(topic, prefix, prefix_len) != 0 || memcmp(topic + topic_len - suffix_len, suffix, suffix_len) != 0) return false;
+    int value = 0;
+    for (const char *c = topic + prefix_len; c < topic + prefix_len + digits_len; c++) {
+        if (*c < '0' || *c > '9') return false;
+        value = value * 10 + (*c - '0');
+    }
+    *pin = value;
+    return true;
+}
+
+static bool payload_equals(const char *data, int data_len, const char *literal) {
+    return data_len == (int)strlen(literal) && memcmp(data, literal, data_len) == 0;
+}
+
+gpio_action_t gpio_command_parse_action(const char *data, int data_len) {
+    if (payload_equals(data, data_len, "ON")) return GPIO_ACTION_ON;
+    if (payload_equals(data, data_len, "OFF")) return GPIO_ACTION_OFF;
+    if (payload_equals(data, data_len, "TOGGLE")) return GPIO_ACTION_TOGGLE;
+    return GPIO_ACTION_INVALID;
+}
+
+uint8_t gpio_action_apply(gpio_action_t action, uint8_t current_state) {
+    switch (action) {
+        case GPIO_ACTION_ON: return 1;
+        case GPIO_ACTION_OFF: return 0;
+        case GPIO_ACTION_TOGGLE: return !current_state;
+        default: return current_state;
+    }
+}
+
+// --- Comando em Lote ---
+
+static const char *skip_spaces(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+    return p;
+}
+
+static const char *parse_number(const char *p, const char *end, uint64_t *out) {
+    if (p >= end || *p < '0' || *p > '9') return NULL;
+    uint64_t value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        if (value > (UINT64_MAX - 9) / 10) return NULL;
+        value = value * 10 + (uint64_t)(*p - '0');
+    }
+    *out = value;
+    return p;
+}
+
+// [n, n, ...] com pinos de 0 a 63, acumulados em bits
+static const char *parse_pin_list(const char *p, const char *end, uint64_t *bits) {
+    p = skip_spaces(p + 1, end);   // Depois do '['
+    if (p < end && *p == ']') return p + 1;
+    while (p < end) {
+        uint64_t pin;
+        p = parse_number(p, end, &pin);
+        if (p == NULL || pin > 63) return NULL;
+        *bits |= (uint64_t)1 << pin;
+        p = skip_spaces(p, end);
+        if (p < end && *p == ']') return p + 1;
+        if (p >= end || *p != ',') return NULL;
+        p = skip_spaces(p + 1, end);
+    }
+    return NULL;
+}
+
+bool gpio_bulk_parse(const char *data, int data_len, uint64_t *mask, uint64_t *value) {
+    const char *p = data, *end = data + data_len;
+    uint64_t mask_bits = 0, value_bits = 0, on_bits = 0, off_bits = 0;
+    p = skip_spaces(p, end);
+    if (p >= end || *p != '{') return false;
+    p = skip_spaces(p + 1, end);
+    if (p < end && *p == '}') return false;
+    while (p < end) {
+        if (*p != '"') return false;
+        const char *key = ++p;
+        while (p < end && *p != '"') p++;
+        if (p >= end) return false;
+        int key_len = (int)(p - key);
+        p = skip_spaces(p + 1, end);
+        if (p >= end || *p != ':') return false;
+        p = skip_spaces(p + 1, end);
+
+        if (payload_equals(key, key_len, "mask")) p = parse_number(p, end, &mask_bits);
+        else if (payload_equals(key, key_len, "value")) p = parse_number(p, end, &value_bits);
+        else if (payload_equals(key, key_len, "on") && p < end && *p == '[') p = parse_pin_list(p, end, &on_bits);
+        else if (payload_equals(key, key_len, "off") && p < end && *p == '[') p = parse_pin_list(p, end, &off_bits);
+        else return false;
+        if (p == NULL) return false;
+
+        p = skip_spaces(p, end);
+        if (p < end && *p == '}') {
+            if (skip_spaces(p + 1, end) != end) return false;
+            if (on_bits & off_bits) return false;
+            *mask = mask_bits | on_bits | off_bits;
+            *value = ((value_bits & mask_bits) & ~(on_bits | off_bits)) | on_bits;
+            return *mask != 0;
+        }
+        if (p >= end || *p != ',') return false;
+        p = skip_spaces(p + 1, end);
+    }
+    return false;
+}
+
+// --- Estado dos Pinos (RAM + NVS) ---
+// levels é alterado pela tarefa do MQTT e lido pelo timer de gravação; o lock
+// protege o bitmask de 64 bits e os instantes. O acesso ao NVS fica fora dele.
+
+static portMUX_TYPE state_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint64_t levels;           // Estado atual, bit n = GPIO n
+static uint64_t saved_levels;     // Último bitmask gravado no NVS
+static int64_t pending_since_ms;  // Primeira mudança ainda não gravada
+static int64_t last_change_ms;
+
+static inline uint64_t pin_bit(int gpio_num) {
+    return gpio_num >= 0 && gpio_num < 64 ? (uint64_t)1 << gpio_num : 0;
+}
+
+void gpio_state_load_all(const int *pins, size_t count) {
+    nvs_handle_t nvs_handle;
+    uint64_t loaded = 0;
+    esp_err_t err = nvs_open(nvs_namespace, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Erro ao abrir o NVS para leitura (%s)", esp_err_to_name(err));
+        return;
+    }
+    size_t length = sizeof(loaded);
+    err = nvs_get_blob(nvs_handle, GPIO_CONTROL_STATE_BLOB_KEY, &loaded, &length);
+    if (err == ESP_OK && length != sizeof(loaded)) {
+        ESP_LOGE(TAG, "Blob de estado com tamanho inesperado (%u bytes), usando padrão (OFF)", (unsigned)length);
+        loaded = 0;
+    } else if (err == ESP_ERR_NVS_NOT_FOUND) {
+        // Firmware anterior: uma chave u8 por pino
+        int migrated = 0;
+        for (size_t i = 0; i < count; i++) {
+            char key[20];
+            uint8_t state;
+            snprintf(key, sizeof(key), GPIO_CONTROL_STATE_KEY_FORMAT, pins[i]);
+            if (nvs_get_u8(nvs_handle, key, &state) != ESP_OK) continue;
+            if (state) loaded |= pin_bit(pins[i]);
+            nvs_erase_key(nvs_handle, key);
+            migrated++;
+        }
+        if (migrated > 0) {
+            err = nvs_set_blob(nvs_handle, GPIO_CONTROL_STATE_BLOB_KEY, &loaded, sizeof(loaded));
+            if (err == ESP_OK) err = nvs_commit(nvs_handle);
+            ESP_LOGI(TAG, "Estado de %d pinos migrado para o blob '%s' (%s)", migrated, GPIO_CONTROL_STATE_BLOB_KEY, esp_err_to_name(err));
+        } else {
+            ESP_LOGI(TAG, "Estado não encontrado no NVS, usando padrão (OFF)");
+        }
+    } else if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Erro ao ler o estado dos pinos do NVS (%s)", esp_err_to_name(err));
+        loaded = 0;
+    }
+    nvs_close(nvs_handle);
+
+    portENTER_CRITICAL(&state_lock);
+    levels = saved_levels = loaded;
+    portEXIT_CRITICAL(&state_lock);
+}
+
+uint8_t gpio_state_get(int gpio_num) {
+    portENTER_CRITICAL(&state_lock);
+    uint8_t state = (levels & pin_bit(gpio_num)) != 0;
+    portEXIT_CRITICAL(&state_lock);
+    return state;
+}
+
+void gpio_state_set(int gpio_num, uint8_t state, int64_t now_ms) {
+    portENTER_CRITICAL(&state_lock);
+    if (levels == saved_levels) pending_since_ms = now_ms;
+    levels = state ? levels | pin_bit(gpio_num) : levels & ~pin_bit(gpio_num);
+    last_change_ms = now_ms;
+    portEXIT_CRITICAL(&state_lock);
+}
+
+void gpio_state_set_mask(uint64_t mask, uint64_t value, int64_t now_ms) {
+    portENTER_CRITICAL(&state_lock);
+    if (levels == saved_levels) pending_since_ms = now_ms;
+    levels = (levels & ~mask) | (value & mask);
+    last_change_ms = now_ms;
+    portEXIT_CRITICAL(&state_lock);
+}
+
+int64_t gpio_state_flush_delay_ms(int64_t now_ms) {
+    portENTER_CRITICAL(&state_lock);
+    bool dirty = levels != saved_levels;
+    int64_t due_ms = last_change_ms + GPIO_CONTROL_FLUSH_QUIET_MS;
+    if (due_ms > pending_since_ms + GPIO_CONTROL_FLUSH_MAX_DELAY_MS) due_ms = pending_since_ms + GPIO_CONTROL_FLUSH_MAX_DELAY_MS;
+    portEXIT_CRITICAL(&state_lock);
+    if (!dirty) return -1;
+    return due_ms > now_ms ? due_ms - now_ms : 0;
+}
+
+esp_err_t gpio_state_flush(void) {
+    portENTER_CRITICAL(&state_lock);
+    uint64_t snapshot = levels;
+    bool dirty = snapshot != saved_levels;
+    portEXIT_CRITICAL(&state_lock);
+    if (!dirty) return ESP_OK;
+
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(nvs_namespace, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Erro ao abrir o NVS para escrita (%s)", esp_err_to_name(err));
+        return err;
+    }
+    err = nvs_set_blob(nvs_handle, GPIO_CONTROL_STATE_BLOB_KEY, &snapshot, sizeof(snapshot));
+    if (err == ESP_OK) err = nvs_commit(nvs_handle);
+    nvs_close(nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Erro ao salvar o estado dos pinos no NVS (%s)", esp_err_to_name(err));
+        return err;
+    }
+
+    portENTER_CRITICAL(&state_lock);
+    saved_levels = snapshot;
+    pending_since_ms = last_change_ms;   // Mudança durante a gravação: conta a partir dela
+    portEXIT_CRITICAL(&state_lock);
+    ESP_LOGI(TAG, "Estado dos pinos salvo no NVS (0x%010llx)", (unsigned long long)snapshot);
+    return ESP_OK;
+}
+
+// --- Tabela de Pinos e Caminho Rápido ---
+// Cada pino é configurado como saída uma única vez; depois disso um comando só
+// escreve no registrador W1TS/W1TC, sem gpio_reset_pin (que solta o pino e gera
+// um pulso na saída) nem gpio_set_direction.
+
+static uint64_t configured_pins;   // bit n = GPIO n já configurado como saída
+
+static void configure_pin(int gpio_num) {
+    gpio_reset_pin(gpio_num);
+    gpio_set_direction(gpio_num, GPIO_MODE_OUTPUT);
+    gpio_set_level(gpio_num, gpio_state_get(gpio_num));
+    configured_pins |= pin_bit(gpio_num);
+}
+
+void gpio_control_configure_pins(const int *pins, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        int pin = pins[i];
+        if (!GPIO_IS_VALID_OUTPUT_GPIO(pin)) {
+            ESP_LOGE(TAG, "GPIO %d não é um pino de saída válido.", pin);
+            continue;
+        }
+        configure_pin(pin);
+        ESP_LOGI(TAG, "Estado inicial do GPIO %d definido para %s a partir do NVS.", pin, gpio_state_get(pin) ? "ON" : "OFF");
+    }
+}
+
+bool gpio_control_set(int gpio_num, uint8_t new_state, int64_t now_ms) {
+    if (!GPIO_IS_VALID_OUTPUT_GPIO(gpio_num)) {
+        ESP_LOGE(TAG, "GPIO %d não é um pino de saída válido.", gpio_num);
+        return false;
+    }
+    if (!(configured_pins & pin_bit(gpio_num))) {
+        ESP_LOGW(TAG, "GPIO %d fora da tabela de pinos, configurando como saída.", gpio_num);
+        configure_pin(gpio_num);
+    }
+    gpio_ll_set_level(&GPIO, gpio_num, new_state);
+    gpio_state_set(gpio_num, new_state, now_ms);
+    return true;
+}
+
+bool gpio_control_set_mask(uint64_t mask, uint64_t value, int64_t now_ms) {
+    for (uint64_t rest = mask; rest != 0; rest &= rest - 1) {
+        int pin = __builtin_ctzll(rest);
+        if (!GPIO_IS_VALID_OUTPUT_GPIO(pin)) {
+            ESP_LOGE(TAG, "GPIO %d não é um pino de saída válido.", pin);
+            return false;
+        }
+    }
+    for (uint64_t rest = mask & ~configured_pins; rest != 0; rest &= rest - 1) {
+        int pin = __builtin_ctzll(rest);
+        ESP_LOGW(TAG, "GPIO %d fora da tabela de pinos, configurando como saída.", pin);
+        configure_pin(pin);
+    }
+    uint64_t set = mask & value;
+    uint64_t clear = mask & ~value;
+    if ((uint32_t)set) GPIO.out_w1ts = (uint32_t)set;
+    if ((uint32_t)clear) GPIO.out_w1tc = (uint32_t)clear;
+    if (set >> 32) GPIO.out1_w1ts.val = (uint32_t)(set >> 32);
+    if (clear >> 32) GPIO.out1_w1tc.val = (uint32_t)(clear >> 32);
+    gpio_state_set_mask(mask, value, now_ms);
+    return true;
+}
+
+// --- Publicação do Estado ---
+
+bool gpio_control_publish_state(int gpio_num, uint8_t state) {
+    char state_topic[64];
+    snprintf(state_topic, sizeof(state_topic), state_topic_format, gpio_num);
+    const char* state_str = (state == 1) ? "ON" : "OFF";
+
+    // Um estado ainda não enviado para o mesmo pino é substituído na fila
+    if (mqtt_outbox_publish(state_topic, state_str, 0, 1, 1)) {
+        HOT_LOGI(TAG, "Estado '%s' do GPIO %d na fila de '%s'", state_str, gpio_num, state_topic);
+        return true;
+    }
+    HOT_LOGE_LIMITED(&publish_error_limit, TAG, "FALHA ao publicar estado do GPIO %d: fila de saída cheia.", gpio_num);
+    return false;
+}
+
+bool gpio_control_publish_bulk_state(uint64_t mask, uint64_t value) {
+    // Sem isso o tópico retido dos pinos ficaria com o estado anterior ao lote
+    bool queued = true;
+    for (uint64_t rest = mask; rest != 0; rest &= rest - 1) {
+        int pin = __builtin_ctzll(rest);
+        queued &= gpio_control_publish_state(pin, (uint8_t)((value >> pin) & 1));
+    }
+    char payload[64];
+    int len = snprintf(payload, sizeof(payload), "{\"mask\":%llu,\"value\":%llu}",
+                       (unsigned long long)mask, (unsigned long long)(value & mask));
+    HOT_LOGI(TAG, "Publicando estado em lote %s em '%s'", payload, bulk_state_topic);
+    if (!mqtt_outbox_publish(bulk_state_topic, payload, len, 1, 0)) {
+        HOT_LOGE_LIMITED(&publish_error_limit, TAG, "FALHA ao publicar estado em lote: fila de saída cheia.");
+        return false;
+    }
+    return queued;
+}
+
+void gpio_control_set_and_publish(int gpio_num, uint8_t new_state, int64_t now_ms) {
+    if (!gpio_control_set(gpio_num, new_state, now_ms)) return;
+    HOT_LOGI(TAG, "GPIO %d set to %s", gpio_num, new_state ? "ON" : "OFF");
+    gpio_control_publish_state(gpio_num, new_state);
+}
@@ -0,0 +1,112 @@
+#ifndef GPIO_CONTROL_H
+#define GPIO_CONTROL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// ======================================================
+// --- CONTROLE DOS PINOS POR COMANDOS MQTT ---
+// ======================================================
+// Interpretação dos comandos "<DEVICE_ID>/gpio/<pino>/set", estado dos pinos
+// com persistência no NVS e publicação do estado retido. Separado do app_main
+// para poder ser compilado no host com a HAL simulada.
+//
+// O estado de todos os pinos fica em RAM, num bitmask indexado pelo número do
+// GPIO, e vai para o NVS como um único blob. Os comandos só alteram a RAM; a
+// gravação é adiada até os comandos pararem por GPIO_CONTROL_FLUSH_QUIET_MS
+// (limitada a GPIO_CONTROL_FLUSH_MAX_DELAY_MS depois da primeira mudança), então
+// uma rajada de TOGGLE vira um commit, e nenhum se o estado final for o gravado.
+
+#ifndef GPIO_CONTROL_STATE_BLOB_KEY
+#define GPIO_CONTROL_STATE_BLOB_KEY "gpio_levels"       // Chave NVS do bitmask (uint64_t)
+#endif
+#ifndef GPIO_CONTROL_STATE_KEY_FORMAT
+#define GPIO_CONTROL_STATE_KEY_FORMAT "gpio_state_%d"   // Chave antiga (um u8 por pino), só para migração
+#endif
+#ifndef GPIO_CONTROL_FLUSH_QUIET_MS
+#define GPIO_CONTROL_FLUSH_QUIET_MS 2000
+#endif
+#ifndef GPIO_CONTROL_FLUSH_MAX_DELAY_MS
+#define GPIO_CONTROL_FLUSH_MAX_DELAY_MS 10000
+#endif
+
+typedef enum {
+    GPIO_ACTION_INVALID = 0,
+    GPIO_ACTION_ON,
+    GPIO_ACTION_OFF,
+    GPIO_ACTION_TOGGLE,
+} gpio_action_t;
+
+// Namespace NVS, formato do tópico de estado de um pino (ex.: DEVICE_ID
+// "/gpio/%d/state") e tópico do estado agregado dos comandos em lote
+void gpio_control_init(const char *nvs_namespace, const char *state_topic_format, const char *bulk_state_topic);
+
+// Extrai o pino de "<prefix><pino><suffix>". topic não precisa terminar em '\0'
+// (event->topic do esp_mqtt_client não termina).
+bool gpio_command_parse_topic(const char *topic, int topic_len, const char *prefix, const char *suffix, int *pin);
+
+// "ON", "OFF" ou "TOGGLE" (comparação exata); GPIO_ACTION_INVALID caso contrário
+gpio_action_t gpio_command_parse_action(const char *data, int data_len);
+
+uint8_t gpio_action_apply(gpio_action_t action, uint8_t current_state);
+
+// Comando em lote (bit n = GPIO n), sem alocação: {"mask":M,"value":V} e/ou
+// {"on":[2,4],"off":[5]}, com números decimais. Pinos de on/off entram na
+// máscara; bits de value fora da máscara são ignorados. Retorna false para
+// JSON inválido, chave desconhecida, pino em on e off ou máscara vazia.
+bool gpio_bulk_parse(const char *data, int data_len, uint64_t *mask, uint64_t *value);
+
+// Lê o blob do NVS uma vez no boot (um nvs_open). Sem blob, migra as chaves
+// antigas dos pinos informados para o blob e as apaga.
+void gpio_state_load_all(const int *pins, size_t count);
+
+// Estado em RAM (0 para pinos nunca definidos)
+uint8_t gpio_state_get(int gpio_num);
+
+// Altera o estado em RAM; a gravação no NVS fica pendente
+void gpio_state_set(int gpio_num, uint8_t state, int64_t now_ms);
+
+// Altera de uma vez os pinos de mask para os níveis de value
+void gpio_state_set_mask(uint64_t mask, uint64_t value, int64_t now_ms);
+
+// Tempo até a gravação pendente vencer (0 se já venceu), ou -1 se a RAM já
+// coincide com o NVS. O firmware rearma um timer com esse valor a cada comando.
+int64_t gpio_state_flush_delay_ms(int64_t now_ms);
+
+// Grava o bitmask no NVS se diferir do último gravado (um set_blob e um commit).
+// Chamado pelo timer e antes de reiniciar. Seguro contra gpio_state_set
+// concorrente: uma mudança durante a gravação continua pendente.
+esp_err_t gpio_state_flush(void);
+
+// Configura os pinos como saída uma única vez, com o nível do estado em RAM
+// (chame depois de gpio_state_load_all). Pinos inválidos são ignorados.
+void gpio_control_configure_pins(const int *pins, size_t count);
+
+// Caminho rápido do comando: escreve o nível direto no registrador do GPIO e
+// atualiza o estado em RAM. Um pino fora da tabela é configurado na primeira
+// vez. Retorna false se o pino não for uma saída válida.
+bool gpio_control_set(int gpio_num, uint8_t new_state, int64_t now_ms);
+
+// Caminho rápido do comando em lote: todos os pinos que ligam mudam numa escrita
+// em W1TS e os que desligam numa escrita em W1TC (por banco de 32 GPIOs). Retorna
+// false, sem alterar nada, se algum pino da máscara não for uma saída válida.
+bool gpio_control_set_mask(uint64_t mask, uint64_t value, int64_t now_ms);
+
+// Publica o estado (QoS 1, retido) pela fila de saída (mqtt_outbox), para os
+// dois brokers. Não bloqueia: um broker desconectado recebe o último estado ao
+// reconectar. Retorna false se a fila de saída descartou a mensagem. O tópico
+// retido de cada pino é o estado autoritativo, também após comandos em lote.
+bool gpio_control_publish_state(int gpio_num, uint8_t state);
+
+// Estado de um comando em lote: o estado retido de cada pino da máscara (pela
+// fila de saída, que substitui o pendente do mesmo pino) e um aviso não retido
+// {"mask":M,"value":V} no tópico do lote, para quem atualiza tudo de uma vez.
+// Retorna false se a fila de saída descartou alguma das mensagens.
+bool gpio_control_publish_bulk_state(uint64_t mask, uint64_t value);
+
+// gpio_control_set seguido de gpio_control_publish_state
+void gpio_control_set_and_publish(int gpio_num, uint8_t new_state, int64_t now_ms);
+
+#endif // GPIO_CONTROL_H
@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+
+#include "gpio_latency.h"
+
+// Gravado pela tarefa do MQTT, lido pela tarefa que publica o diagnóstico
+static portMUX_TYPE latency_lock = portMUX_INITIALIZER_UNLOCKED;
+static gpio_latency_t latency;
+
+static void stage_add(gpio_latency_stage_t *stage, int64_t elapsed_us) {
+    uint32_t us = elapsed_us < 0 ? 0 : elapsed_us > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed_us;
+    stage->last_us = us;
+    if (us > stage->max_us) stage->max_us = us;
+    stage->sum_us += us;
+}
+
+void gpio_latency_record(int64_t received_us, int64_t edge_us, int64_t published_us) {
+    portENTER_CRITICAL(&latency_lock);
+    latency.commands++;
+    latency.window++;
+    stage_add(&latency.edge, edge_us - received_us);
+    stage_add(&latency.publish, published_us - received_us);
+    portEXIT_CRITICAL(&latency_lock);
+}
+
+void gpio_latency_snapshot(gpio_latency_t *out, bool reset_window) {
+    portENTER_CRITICAL(&latency_lock);
+    *out = latency;
+    if (reset_window) {
+        latency.window = 0;
+        latency.edge.max_us = latency.edge.sum_us = 0;
+        latency.publish.max_us = latency.publish.sum_us = 0;
+    }
+    portEXIT_CRITICAL(&latency_lock);
+}
+
+static uint32_t stage_mean(const gpio_latency_stage_t *stage, uint32_t count) {
+    return count ? (uint32_t)((stage->sum_us + count / 2) / count) : 0;
+}
+
+int gpio_latency_format_json(const gpio_latency_t *stats, char *buffer, size_t size) {
+    return snprintf(buffer, size,
+                    "{\"commands\":%lu,\"window\":%lu,"
+                    "\"edge_us\":{\"last\":%lu,\"mean\":%lu,\"max\":%lu},"
+                    "\"publish_us\":{\"last\":%lu,\"mean\":%lu,\"max\":%lu}}",
+                    (unsigned long)stats->commands, (unsigned long)stats->window,
+                    (unsigned long)stats->edge.last_us, (unsigned long)stage_mean(&stats->edge, stats->window),
+                    (unsigned long)stats->edge.max_us,
+                    (unsigned long)stats->publish.last_us, (unsigned long)stage_mean(&stats->publish, stats->window),
+                    (unsigned long)stats->publish.max_us);
+}
@@ -0,0 +1,38 @@
+#ifndef GPIO_LATENCY_H
+#define GPIO_LATENCY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ======================================================
+// --- LATÊNCIA DOS COMANDOS DE GPIO ---
+// ======================================================
+// Três instantes por comando (esp_timer_get_time, em µs): chegada do evento
+// MQTT_EVENT_DATA, escrita no registrador do GPIO (borda na saída) e retorno
+// das publicações do estado. Acumula a janela desde o último relatório; o
+// firmware publica o relatório no tópico de diagnóstico.
+
+typedef struct {
+    uint32_t last_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+} gpio_latency_stage_t;
+
+typedef struct {
+    uint32_t commands;        // Total desde o boot
+    uint32_t window;          // Comandos na janela atual
+    gpio_latency_stage_t edge;      // Chegada -> borda
+    gpio_latency_stage_t publish;   // Chegada -> estado publicado
+} gpio_latency_t;
+
+void gpio_latency_record(int64_t received_us, int64_t edge_us, int64_t published_us);
+
+// Cópia das estatísticas; com reset_window, a próxima janela começa vazia
+void gpio_latency_snapshot(gpio_latency_t *out, bool reset_window);
+
+// {"commands":N,"window":n,"edge_us":{"last":..,"mean":..,"max":..},"publish_us":{...}}
+// Retorna o tamanho escrito, como snprintf.
+int gpio_latency_format_json(const gpio_latency_t *stats, char *buffer, size_t size);
+
+#endif // GPIO_LATENCY_H
@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "hot_log.h"
+
+#include "mqtt_outbox.h"
+
+static const char *TAG = "MQTT_OUTBOX";
+// Com um broker fora do ar, cada publicação repetiria o mesmo aviso
+static hot_log_limit_t drop_log_limit = HOT_LOG_LIMIT_INIT;
+static hot_log_limit_t enqueue_log_limit = HOT_LOG_LIMIT_INIT;
+
+typedef struct {
+    char topic[MQTT_OUTBOX_TOPIC_SIZE];
+    char payload[MQTT_OUTBOX_PAYLOAD_SIZE];
+    int len;
+    uint8_t qos;
+    uint8_t retain;
+    uint8_t pending;      // bit b = falta enviar ao broker b; 0 = vaga livre
+    uint8_t sending;      // bit b = um drain() do broker b está enviando esta vaga
+    uint32_t order;       // Ordem de chegada da última mensagem (envio do mais antigo primeiro)
+    uint32_t generation;  // Muda a cada substituição: detecta troca durante o envio
+} outbox_slot_t;
+
+typedef struct {
+    esp_mqtt_client_handle_t client;
+    volatile bool connected;
+    uint32_t enqueued;
+    uint32_t coalesced;
+    uint32_t dropped;
+    uint32_t failed;
+} outbox_broker_t;
+
+// Tarefas dos dois clientes MQTT e a do heartbeat usam a fila; o lock protege
+// vagas e contadores, nunca é mantido durante chamadas ao cliente MQTT
+static portMUX_TYPE outbox_lock = portMUX_INITIALIZER_UNLOCKED;
+static outbox_slot_t slots[MQTT_OUTBOX_SLOTS];
+static outbox_broker_t brokers[MQTT_OUTBOX_BROKERS];
+static uint32_t next_order;
+
+static const char *const broker_names[MQTT_OUTBOX_BROKERS] = { "cloud", "local" };
+
+// O esp-mqtt guarda o PUBLISH inteiro na outbox: cabeçalho fixo (até 3 bytes com
+// o tamanho), tamanho do tópico (2), id da mensagem (2), tópico e payload
+static bool fits_outbox(esp_mqtt_client_handle_t client, const char *topic, int len) {
+    return esp_mqtt_client_get_outbox_size(client) + 7 + (int)strlen(topic) + len <= MQTT_OUTBOX_MAX_BYTES;
+}
+
+void mqtt_outbox_init(void) {
+    portENTER_CRITICAL(&outbox_lock);
+    memset(slots, 0, sizeof(slots));
+    memset(brokers, 0, sizeof(brokers));
+    next_order = 0;
+    portEXIT_CRITICAL(&outbox_lock);
+}
+
+void mqtt_outbox_attach(mqtt_outbox_broker_t broker, esp_mqtt_client_handle_t client) {
+    portENTER_CRITICAL(&outbox_lock);
+    brokers[broker].client = client;
+    brokers[broker].connected = false;
+    portEXIT_CRITICAL(&outbox_lock);
+}
+
+void mqtt_outbox_set_connected(mqtt_outbox_broker_t broker, bool connected) {
+    brokers[broker].connected = connected;
+    if (connected) mqtt_outbox_drain(broker);
+}
+
+bool mqtt_outbox_publish(const char *topic, const char *payload, int len, int qos, int retain) {
+    if (len <= 0) len = (int)strlen(payload);
+    uint8_t targets = 0;
+    bool fits = strlen(topic) < MQTT_OUTBOX_TOPIC_SIZE && len <= MQTT_OUTBOX_PAYLOAD_SIZE;
+    outbox_slot_t *slot = NULL;
+
+    portENTER_CRITICAL(&outbox_lock);
+    for (int b = 0; b < MQTT_OUTBOX_BROKERS; b++) {
+        if (brokers[b].client) targets |= 1u << b;
+    }
+    if (fits) {
+        outbox_slot_t *free_slot = NULL;
+        for (int i = 0; i < MQTT_OUTBOX_SLOTS; i++) {
+            if (!slots[i].pending) {
+                if (!free_slot) free_slot = &slots[i];
+            } else if (strcmp(slots[i].topic, topic) == 0) {
+                slot = &slots[i];
+                break;
+            }
+        }
+        if (slot) {
+            for (int b = 0; b < MQTT_OUTBOX_BROKERS; b++) {
+                if (slot->pending & (1u << b)) brokers[b].coalesced++;
+            }
+        } else if (free_slot) {
+            slot = free_slot;
+            strcpy(slot->topic, topic);
+        }
+    }
+    if (slot && targets) {
+        memcpy(slot->payload, payload, len);
+        slot->len = len;
+        slot->qos = (uint8_t)qos;
+        slot->retain = (uint8_t)retain;
+        slot->pending |= targets;
+        slot->order = next_order++;
+        slot->generation++;
+    } else if (!slot) {
+        for (int b = 0; b < MQTT_OUTBOX_BROKERS; b++) {
+            if (targets & (1u << b)) brokers[b].dropped++;
+        }
+    }
+    portEXIT_CRITICAL(&outbox_lock);
+
+    if (!slot) {
+        HOT_LOGW_LIMITED(&drop_log_limit, TAG, "Mensagem para '%s' descartada (%s)", topic, fits ? "fila cheia" : "grande demais");
+        return false;
+    }
+    for (int b = 0; b < MQTT_OUTBOX_BROKERS; b++) {
+        if (targets & (1u << b)) mqtt_outbox_drain((mqtt_outbox_broker_t)b);
+    }
+    return true;
+}
+
+void mqtt_outbox_drain(mqtt_outbox_broker_t broker) {
+    outbox_broker_t *state = &brokers[broker];
+    esp_mqtt_client_handle_t client = state->client;
+    const uint8_t bit = 1u << broker;
+    char topic[MQTT_OUTBOX_TOPIC_SIZE];
+    char payload[MQTT_OUTBOX_PAYLOAD_SIZE];
+
+    while (client && state->connected) {
+        // Reserva a vaga pendente mais antiga e envia a cópia fora do lock. Outro
+        // drain() do mesmo broker (publish() de outra tarefa, MQTT_EVENT_PUBLISHED)
+        // pula a vaga reservada em vez de enviá-la de novo.
+        portENTER_CRITICAL(&outbox_lock);
+        outbox_slot_t *oldest = NULL;
+        for (int i = 0; i < MQTT_OUTBOX_SLOTS; i++) {
+            if ((slots[i].pending & bit) && !(slots[i].sending & bit) &&
+                (!oldest || (int32_t)(slots[i].order - oldest->order) < 0)) oldest = &slots[i];
+        }
+        if (!oldest) {
+            portEXIT_CRITICAL(&outbox_lock);
+            break;
+        }
+        oldest->sending |= bit;
+        strcpy(topic, oldest->topic);
+        memcpy(payload, oldest->payload, oldest->len);
+        int len = oldest->len, qos = oldest->qos, retain = oldest->retain;
+        uint32_t generation = oldest->generation;
+        portEXIT_CRITICAL(&outbox_lock);
+
+        bool fits = fits_outbox(client, topic, len);
+        int msg_id = fits ? esp_mqtt_client_enqueue(client, topic, payload, len, qos, retain, true) : -1;
+
+        // Sem espaço na outbox do cliente a vaga continua pendente até um ack liberar espaço
+        portENTER_CRITICAL(&outbox_lock);
+        oldest->sending &= ~bit;
+        if (fits && msg_id < 0) {
+            state->failed++;
+        } else if (fits) {
+            state->enqueued++;
+            // Substituída durante o envio: a versão nova continua pendente
+            if (oldest->generation == generation) oldest->pending &= ~bit;
+        }
+        portEXIT_CRITICAL(&outbox_lock);
+        if (!fits) break;
+        if (msg_id < 0) {
+            HOT_LOGE_LIMITED(&enqueue_log_limit, TAG, "FALHA ao enfileirar '%s' para o broker %s", topic, broker_names[broker]);
+            break;
+        }
+    }
+}
+
+static bool send_to(mqtt_outbox_broker_t broker, esp_mqtt_client_handle_t client, const char *topic, const char *payload,
+                    int len, int qos, int retain) {
+    outbox_broker_t *state = &brokers[broker];
+    bool fits = fits_outbox(client, topic, len);
+    int msg_id = fits ? esp_mqtt_client_enqueue(client, topic, payload, len, qos, retain, true) : -1;
+    portENTER_CRITICAL(&outbox_lock);
+    if (!fits) state->dropped++;
+    else if (msg_id < 0) state->failed++;
+    else state->enqueued++;
+    portEXIT_CRITICAL(&outbox_lock);
+    if (msg_id < 0) {
+        HOT_LOGW_LIMITED(&enqueue_log_limit, TAG, "'%s' não enviado para o broker %s (%s)", topic, broker_names[broker], fits ? "erro" : "outbox cheia");
+    }
+    return msg_id >= 0;
+}
+
+int mqtt_outbox_send_now(const char *topic, const char *payload, int len, int qos, int retain) {
+    if (len == 0) len = (int)strlen(payload);
+    int sent = 0;
+    for (int b = 0; b < MQTT_OUTBOX_BROKERS; b++) {
+        esp_mqtt_client_handle_t client = brokers[b].client;
+        if (!client || !brokers[b].connected) continue;
+        sent += send_to((mqtt_outbox_broker_t)b, client, topic, payload, len, qos, retain);
+    }
+    return sent;
+}
+
+bool mqtt_outbox_send_now_to(mqtt_outbox_broker_t broker, const char *topic, const char *payload, int len, int qos, int retain) {
+    if (len == 0) len = (int)strlen(payload);
+    esp_mqtt_client_handle_t client = brokers[broker].client;
+    return client && send_to(broker, client, topic, payload, len, qos, retain);
+}
+
+void mqtt_outbox_get_stats(mqtt_outbox_broker_t broker, mqtt_outbox_stats_t *out) {
+    const outbox_broker_t *state = &brokers[broker];
+    uint32_t pending = 0;
+    portENTER_CRITICAL(&outbox_lock);
+    for (int i = 0; i < MQTT_OUTBOX_SLOTS; i++) {
+        if (slots[i].pending & (1u << broker)) pending++;
+    }
+    out->connected = state->connected;
+    out->pending = pending;
+    out->enqueued = state->enqueued;
+    out->coalesced = state->coalesced;
+    out->dropped = state->dropped;
+    out->failed = state->failed;
+    esp_mqtt_client_handle_t client = state->client;
+    portEXIT_CRITICAL(&outbox_lock);
+    out->outbox_bytes = client ? esp_mqtt_client_get_outbox_size(client) : 0;
+}
+
+int mqtt_outbox_format_json(char *buffer, size_t size) {
+    int written = 0;
+    for (int b = 0; b < MQTT_OUTBOX_BROKERS; b++) {
+        mqtt_outbox_stats_t stats;
+        mqtt_outbox_get_stats((mqtt_outbox_broker_t)b, &stats);
+        int n = snprintf(buffer + written, size > (size_t)written ? size - written : 0,
+                         "%s\"%s\":{\"up\":%d,\"pending\":%lu,\"bytes\":%d,\"sent\":%lu,\"coalesced\":%lu,\"dropped\":%lu,\"failed\":%lu}",
+                         b == 0 ? "{" : ",", broker_names[b], stats.connected, (unsigned long)stats.pending,
+                         stats.outbox_bytes, (unsigned long)stats.enqueued, (unsigned long)stats.coalesced,
+                         (unsigned long)stats.dropped, (unsigned long)stats.failed);
+        if (n < 0) return n;
+        written += n;
+    }
+    int n = snprintf(buffer + written, size > (size_t)written ? size - written : 0, "}");
+    return n < 0 ? n : written + n;
+}
@@ -0,0 +1,88 @@
+#ifndef MQTT_OUTBOX_H
+#define MQTT_OUTBOX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "mqtt_client.h"
+
+// ======================================================
+// --- FILA DE SAÍDA PARA OS DOIS BROKERS ---
+// ======================================================
+// Toda publicação do firmware da nuvem passa por aqui. Cada tópico ocupa no
+// máximo uma vaga: uma mensagem nova para um tópico ainda pendente substitui a
+// anterior (o estado retido de um pino só importa pelo último valor). Cada vaga
+// marca os brokers para os quais ainda falta enviar.
+//
+// O envio usa esp_mqtt_client_enqueue (não bloqueia: a tarefa do próprio
+// cliente transmite) e só acontece com o broker conectado e com a outbox do
+// cliente abaixo de MQTT_OUTBOX_MAX_BYTES. Um broker lento ou fora do ar só
+// acumula vagas pendentes, que continuam sendo substituídas, e não atrasa o
+// outro; drain() no MQTT_EVENT_PUBLISHED dele retoma o envio.
+
+#ifndef MQTT_OUTBOX_SLOTS
+#define MQTT_OUTBOX_SLOTS 24            // Tópicos distintos pendentes ao mesmo tempo
+#endif
+#ifndef MQTT_OUTBOX_TOPIC_SIZE
+#define MQTT_OUTBOX_TOPIC_SIZE 48
+#endif
+#ifndef MQTT_OUTBOX_PAYLOAD_SIZE
+#define MQTT_OUTBOX_PAYLOAD_SIZE 224
+#endif
+#ifndef MQTT_OUTBOX_MAX_BYTES
+#define MQTT_OUTBOX_MAX_BYTES 2048      // Limite da outbox de cada cliente (esp_mqtt_client_get_outbox_size)
+#endif
+
+typedef enum {
+    MQTT_OUTBOX_CLOUD,
+    MQTT_OUTBOX_LOCAL,
+    MQTT_OUTBOX_BROKERS,
+} mqtt_outbox_broker_t;
+
+typedef struct {
+    bool connected;
+    uint32_t pending;      // Tópicos aguardando envio para este broker
+    int outbox_bytes;      // Ocupação da outbox do cliente
+    uint32_t enqueued;     // Mensagens entregues ao esp_mqtt_client_enqueue
+    uint32_t coalesced;    // Mensagens substituídas antes do envio
+    uint32_t dropped;      // Descartadas: sem vaga livre, maiores que a vaga ou sem espaço no send_now
+    uint32_t failed;       // esp_mqtt_client_enqueue retornou erro
+} mqtt_outbox_stats_t;
+
+// Esvazia a fila, zera os contadores e desassocia os clientes
+void mqtt_outbox_init(void);
+
+// Associa o cliente ao broker (NULL desassocia). Começa desconectado.
+void mqtt_outbox_attach(mqtt_outbox_broker_t broker, esp_mqtt_client_handle_t client);
+
+// Chamado nos eventos CONNECTED/DISCONNECTED; ao conectar, envia o pendente
+void mqtt_outbox_set_connected(mqtt_outbox_broker_t broker, bool connected);
+
+// Coloca a mensagem na fila de todos os brokers associados e tenta enviar.
+// Retorna false se foi descartada.
+bool mqtt_outbox_publish(const char *topic, const char *payload, int len, int qos, int retain);
+
+// Envio imediato para os brokers conectados, sem ocupar vaga (mensagens maiores
+// que MQTT_OUTBOX_PAYLOAD_SIZE, como o snapshot de métricas). Um broker com a
+// outbox do cliente sem espaço para a mensagem não a recebe (conta em dropped);
+// serve para dados periódicos, em que a próxima mensagem substitui a perdida.
+// Retorna para quantos brokers a mensagem saiu.
+int mqtt_outbox_send_now(const char *topic, const char *payload, int len, int qos, int retain);
+
+// send_now para um só broker, sem exigir set_connected: serve para a mensagem do
+// MQTT_EVENT_CONNECTED que precisa sair antes do pendente (o "online" retido).
+// Retorna false se a mensagem não saiu.
+bool mqtt_outbox_send_now_to(mqtt_outbox_broker_t broker, const char *topic, const char *payload, int len, int qos, int retain);
+
+// Envia o pendente do broker até a outbox do cliente encher. Chamado no
+// MQTT_EVENT_PUBLISHED do próprio broker e periodicamente. Chamadas simultâneas
+// (de tarefas diferentes) não enviam a mesma vaga duas vezes: cada uma reserva a
+// vaga que está enviando.
+void mqtt_outbox_drain(mqtt_outbox_broker_t broker);
+
+void mqtt_outbox_get_stats(mqtt_outbox_broker_t broker, mqtt_outbox_stats_t *out);
+
+// {"cloud":{"up":1,"pending":0,"bytes":0,"sent":N,"coalesced":N,"dropped":N,"failed":N},"local":{...}}
+int mqtt_outbox_format_json(char *buffer, size_t size);
+
+#endif // MQTT_OUTBOX_H
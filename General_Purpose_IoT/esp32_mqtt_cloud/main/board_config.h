@@ -7,11 +7,33 @@
 #define MQTT_GPIO_COMMAND_TOPIC_PREFIX   DEVICE_ID "/gpio/"
 #define MQTT_GPIO_COMMAND_TOPIC_SUFFIX   "/set"
 #define MQTT_GPIO_STATE_TOPIC_FORMAT     DEVICE_ID "/gpio/%d/state"
+#define MQTT_GPIO_BULK_COMMAND_TOPIC     DEVICE_ID "/gpio/bulk/set"     // {"mask":M,"value":V} ou {"on":[..],"off":[..]}
+#define MQTT_GPIO_BULK_STATE_TOPIC       DEVICE_ID "/gpio/bulk/state"
 #define MQTT_SYSTEM_STATUS_TOPIC         DEVICE_ID "/system/status"
+#define MQTT_SYSTEM_DIAGNOSTICS_TOPIC    DEVICE_ID "/system/diagnostics"
+#define MQTT_SYSTEM_OUTBOX_TOPIC         DEVICE_ID "/system/outbox"
+#define MQTT_SYSTEM_METRICS_TOPIC        DEVICE_ID "/system/metrics"    // Métricas de execução (ver runtime_metrics.h)
+#define MQTT_SYSTEM_LOGS_REQUEST_TOPIC   DEVICE_ID "/system/logs/get"   // Qualquer mensagem pede o anel de logs (ver hot_log.h)
+#define MQTT_SYSTEM_LOGS_TOPIC           DEVICE_ID "/system/logs"       // Resposta: linhas do anel, da mais antiga para a mais nova
 
 // --- Outras Configurações ---
 #define HEARTBEAT_INTERVAL_MS 5000
+#define HEARTBEAT_TASK_STACK_SIZE 3072
+#define HEARTBEAT_TASK_PRIORITY 5
+#define DIAGNOSTICS_INTERVAL_MS 30000   // Latência dos comandos de GPIO (JSON em MQTT_SYSTEM_DIAGNOSTICS_TOPIC) e fila de saída (MQTT_SYSTEM_OUTBOX_TOPIC)
+#define METRICS_INTERVAL_MS 60000       // Janela das métricas de execução em MQTT_SYSTEM_METRICS_TOPIC
 #define NVS_NAMESPACE "storage"
-#define NVS_STATE_KEY_FORMAT "gpio_state_%d" 
+
+// Modo de baixo consumo: heartbeat, diagnóstico e métricas saem juntos numa
+// rajada por LOW_POWER_BURST_PERIOD_MS e, entre elas, o Wi-Fi fica em modem
+// sleep (light sleep com CONFIG_PM_ENABLE e tickless idle). Os comandos de GPIO
+// continuam sendo atendidos na hora, mas chegam com até LOW_POWER_LISTEN_INTERVAL
+// beacons de atraso. Ver radio_burst.h no componente compartilhado.
+#define LOW_POWER_MODE_ENABLED 0
+#define LOW_POWER_BURST_PERIOD_MS 30000   // Substitui HEARTBEAT_INTERVAL_MS
+#define LOW_POWER_HEARTBEAT_HOLD_MS (2 * LOW_POWER_BURST_PERIOD_MS)   // Validade do heartbeat no gateway: tolera uma rajada perdida
+#define LOW_POWER_BURST_LINGER_MS 300     // Rádio acordado após a rajada (ACKs do TCP)
+#define LOW_POWER_LISTEN_INTERVAL 3       // ~300 ms de atraso adicionado a um comando
+#define LOW_POWER_KEEPALIVE_SECONDS 300   // Padrão do esp-mqtt: 120 s
 
 #endif // BOARD_CONFIG_H
@@ -4,8 +4,9 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
 #include "nvs_flash.h"
-#include "nvs.h"
 #include "driver/gpio.h"
 #include "mqtt_client.h"
 #include "esp_wifi.h"
@@ -14,112 +15,198 @@
 
 #include "credentials.h"
 #include "board_config.h"
+#include "gpio_control.h"
+#include "gpio_latency.h"
+#include "mqtt_outbox.h"
+#include "runtime_metrics.h"
+#include "hot_log.h"
+#include "radio_burst.h"
 
 // --- Constantes e Variáveis Globais ---
 static const char *TAG = "GENERIC_MQTT_APP";
+// Comandos inválidos repetidos (cliente com defeito) saem uma vez por intervalo na UART
+static hot_log_limit_t invalid_command_limit = HOT_LOG_LIMIT_INIT;
 
 esp_mqtt_client_handle_t cloud_client = NULL;
 esp_mqtt_client_handle_t local_client = NULL;
 TaskHandle_t heartbeat_task_handle = NULL;
-static bool cloud_mqtt_connected = false;
+// Criada uma vez, com pilha estática; quedas dos brokers ficam na fila de saída
+static StaticTask_t heartbeat_task_tcb;
+static StackType_t heartbeat_task_stack[HEARTBEAT_TASK_STACK_SIZE];
+static esp_timer_handle_t gpio_flush_timer = NULL;
+#if LOW_POWER_MODE_ENABLED
+// Rajadas do rádio; só a heartbeat_task acessa
+static radio_burst_t radio_burst;
+#endif
+
+// Pinos controláveis por comando; o estado deles é restaurado do NVS no boot
+static const int gpio_pins[] = {2, 4, 5, 13, 14, 16, 17, 18, 19, 21, 22, 23, 25, 26, 27, 32, 33};
+#define GPIO_PIN_COUNT (sizeof(gpio_pins) / sizeof(gpio_pins[0]))
 
 // Referência ao certificado da nuvem
 extern const uint8_t emqxsl_ca_crt_start[] asm("_binary_emqxsl_ca_crt_start");
 extern const uint8_t emqxsl_ca_crt_end[]   asm("_binary_emqxsl_ca_crt_end");
 
-// --- Funções de Persistência (NVS) para Múltiplos Pinos ---
-
-static void save_gpio_state(int gpio_num, uint8_t state) {
-    nvs_handle_t nvs_handle;
-    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Erro ao abrir o NVS para escrita (%s)", esp_err_to_name(err));
-        return;
-    }
-    char key[20];
-    snprintf(key, sizeof(key), NVS_STATE_KEY_FORMAT, gpio_num);
-    err = nvs_set_u8(nvs_handle, key, state);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Erro ao salvar estado para GPIO %d no NVS (%s)", gpio_num, esp_err_to_name(err));
-    } else {
-        ESP_LOGI(TAG, "Estado do GPIO %d (%s) salvo no NVS.", gpio_num, state == 1 ? "ON" : "OFF");
-    }
-    nvs_commit(nvs_handle);
-    nvs_close(nvs_handle);
-}
-
-static uint8_t load_gpio_state(int gpio_num) {
-    nvs_handle_t nvs_handle;
-    uint8_t state = 0; // Estado padrão: OFF
-    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Erro ao abrir o NVS para leitura (%s)", esp_err_to_name(err));
-        return state;
-    }
-    char key[20];
-    snprintf(key, sizeof(key), NVS_STATE_KEY_FORMAT, gpio_num);
-    err = nvs_get_u8(nvs_handle, key, &state);
-    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
-        ESP_LOGE(TAG, "Erro ao ler NVS para GPIO %d (%s)", gpio_num, esp_err_to_name(err));
-    } else if (err == ESP_ERR_NVS_NOT_FOUND) {
-        ESP_LOGI(TAG, "Estado não encontrado para GPIO %d, usando padrão (%s)", gpio_num, state ? "ON" : "OFF");
-    }
-    nvs_close(nvs_handle);
-    return state;
+static int64_t uptime_ms(void) {
+    return esp_timer_get_time() / 1000;
 }
 
 // --- Funções de Controle e Publicação ---
 
-void update_and_publish_state(int gpio_num, uint8_t new_state) {
-    if (!GPIO_IS_VALID_OUTPUT_GPIO(gpio_num)) {
-        ESP_LOGE(TAG, "GPIO %d não é um pino de saída válido.", gpio_num);
-        return;
-    }
+static void rearm_gpio_flush(int64_t now_ms) {
+    // Rearma a gravação adiada: cada comando empurra o commit para depois da rajada
+    int64_t delay_ms = gpio_state_flush_delay_ms(now_ms);
+    esp_timer_stop(gpio_flush_timer);
+    if (delay_ms >= 0) esp_timer_start_once(gpio_flush_timer, (uint64_t)delay_ms * 1000);
+}
 
-    gpio_reset_pin(gpio_num);
-    gpio_set_direction(gpio_num, GPIO_MODE_OUTPUT);
-    gpio_set_level(gpio_num, new_state);
-    ESP_LOGI(TAG, "GPIO %d set to %s", gpio_num, new_state ? "ON" : "OFF");
+// received_us: instante da chegada do comando, para a medida de latência
+void update_and_publish_state(int gpio_num, uint8_t new_state, int64_t received_us) {
+    if (!gpio_control_set(gpio_num, new_state, received_us / 1000)) return;
+    int64_t edge_us = esp_timer_get_time();
+    bool published = gpio_control_publish_state(gpio_num, new_state);
+    int64_t now_us = esp_timer_get_time();
+    gpio_latency_record(received_us, edge_us, now_us);
+    runtime_metrics_record(RUNTIME_METRIC_PUBLISH, edge_us, now_us, published);
+    runtime_metrics_record(RUNTIME_METRIC_GPIO_COMMAND, received_us, now_us, true);
+    rearm_gpio_flush(now_us / 1000);
+}
 
-    save_gpio_state(gpio_num, new_state);
+// Comando em lote: uma escrita nos registradores, o estado de cada pino e o aviso
+// do lote pela fila de saída e uma gravação
+void update_and_publish_bulk_state(uint64_t mask, uint64_t value, int64_t received_us) {
+    if (!gpio_control_set_mask(mask, value, received_us / 1000)) return;
+    int64_t edge_us = esp_timer_get_time();
+    bool published = gpio_control_publish_bulk_state(mask, value);
+    int64_t now_us = esp_timer_get_time();
+    gpio_latency_record(received_us, edge_us, now_us);
+    runtime_metrics_record(RUNTIME_METRIC_PUBLISH, edge_us, now_us, published);
+    runtime_metrics_record(RUNTIME_METRIC_GPIO_COMMAND, received_us, now_us, true);
+    rearm_gpio_flush(now_us / 1000);
+}
 
-    char state_topic[64];
-    snprintf(state_topic, sizeof(state_topic), MQTT_GPIO_STATE_TOPIC_FORMAT, gpio_num);
-    const char* state_str = (new_state == 1) ? "ON" : "OFF";
-    int msg_id;
+// --- Persistência Adiada do Estado dos Pinos ---
+static void gpio_flush_timer_callback(void *arg) {
+    int64_t start_us = esp_timer_get_time();
+    if (gpio_state_flush_delay_ms(start_us / 1000) < 0) return;   // Nada pendente: não há commit para medir
+    esp_err_t err = gpio_state_flush();
+    runtime_metrics_record(RUNTIME_METRIC_NVS_COMMIT, start_us, esp_timer_get_time(), err == ESP_OK);
+}
 
-    ESP_LOGI(TAG, "Tentando publicar estado '%s' para GPIO %d em '%s'", state_str, gpio_num, state_topic);
+// Reinícios por esp_restart() (ex.: depois de uma OTA) gravam o que estiver pendente;
+// pânico, brownout e queda de energia perdem no máximo a última rajada
+static void gpio_flush_on_shutdown(void) {
+    gpio_state_flush();
+}
 
-    if (cloud_client && cloud_mqtt_connected) {
-        msg_id = esp_mqtt_client_publish(cloud_client, state_topic, state_str, 0, 1, 1);
-        if (msg_id != -1) {
-            ESP_LOGI(TAG, "Estado publicado para o broker da NUVEM, msg_id=%d", msg_id);
-        } else {
-            ESP_LOGE(TAG, "FALHA ao publicar estado para o broker da NUVEM.");
-        }
+static void gpio_persistence_init(void) {
+    const esp_timer_create_args_t timer_args = {
+        .callback = gpio_flush_timer_callback,
+        .name = "gpio_flush",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &gpio_flush_timer));
+    ESP_ERROR_CHECK(esp_register_shutdown_handler(gpio_flush_on_shutdown));
+}
+
+// --- Diagnóstico: latência dos comandos na última janela e fila de saída ---
+static void publish_diagnostics(void) {
+    gpio_latency_t stats;
+    char payload[MQTT_OUTBOX_PAYLOAD_SIZE];
+    gpio_latency_snapshot(&stats, true);
+    int len = gpio_latency_format_json(&stats, payload, sizeof(payload));
+    if (len > 0 && len < (int)sizeof(payload)) {
+        mqtt_outbox_publish(MQTT_SYSTEM_DIAGNOSTICS_TOPIC, payload, len, 0, 0);
+        ESP_LOGI(TAG, "Diagnóstico: %s", payload);
     }
-    
-    if (local_client) {
-        msg_id = esp_mqtt_client_publish(local_client, state_topic, state_str, 0, 1, 1);
-        if (msg_id != -1) {
-            ESP_LOGI(TAG, "Estado publicado para o broker LOCAL, msg_id=%d", msg_id);
-        } else {
-            ESP_LOGE(TAG, "FALHA ao publicar estado para o broker LOCAL.");
-        }
+    len = mqtt_outbox_format_json(payload, sizeof(payload));
+    if (len > 0 && len < (int)sizeof(payload)) {
+        mqtt_outbox_publish(MQTT_SYSTEM_OUTBOX_TOPIC, payload, len, 0, 0);
+        ESP_LOGI(TAG, "Fila de saída: %s", payload);
     }
 }
 
+// --- Métricas de Execução: comandos, publicações, NVS, tarefas e heap desde o snapshot anterior ---
+static void publish_metrics(void) {
+    static runtime_metric_window_t ops[RUNTIME_METRIC_KINDS];
+    static runtime_system_stats_t sys;
+    static char payload[RUNTIME_METRICS_JSON_SIZE];
+    runtime_metrics_snapshot(ops);
+    runtime_metrics_collect_system(&sys);
+#if LOW_POWER_MODE_ENABLED
+    sys.radio_reported = true;
+    sys.radio_awake_permille = radio_burst_snapshot(&radio_burst, uptime_ms(), &sys.radio_bursts);
+#endif
+    int len = runtime_metrics_format_json(ops, &sys, payload, sizeof(payload));
+    if (len <= 0 || len >= (int)sizeof(payload)) {
+        ESP_LOGE(TAG, "Snapshot de métricas maior que %d bytes", (int)sizeof(payload));
+        return;
+    }
+    // Maior que uma vaga da fila de saída: vai direto para os brokers conectados
+    mqtt_outbox_send_now(MQTT_SYSTEM_METRICS_TOPIC, payload, len, 0, 0);
+}
+
+#if HOT_LOG_RING_ENABLED
+// --- Logs sob Demanda: anel de hot_log.h em MQTT_SYSTEM_LOGS_TOPIC ---
+// O pedido pode vir de qualquer um dos brokers; a resposta vai para os dois
+static void publish_hot_logs(void) {
+    static char payload[HOT_LOG_RING_SIZE + 1];
+    size_t len = hot_log_ring_read(payload, HOT_LOG_RING_SIZE);
+    payload[len] = '\0';   // len 0 (anel vazio) faz o envio usar strlen
+    mqtt_outbox_send_now(MQTT_SYSTEM_LOGS_TOPIC, payload, (int)len, 0, 0);
+}
+
+static bool is_logs_request(esp_mqtt_event_handle_t event) {
+    return event->topic_len == (int)strlen(MQTT_SYSTEM_LOGS_REQUEST_TOPIC) &&
+           memcmp(event->topic, MQTT_SYSTEM_LOGS_REQUEST_TOPIC, event->topic_len) == 0;
+}
+#endif
+
 // --- Tarefa de Heartbeat ---
+// No modo de baixo consumo o heartbeat sai uma vez por rajada, mais espaçado que
+// o timeout de status do gateway: o payload vira {"status":"heartbeat","hold_ms":N}
+// e o gateway só marca o dispositivo offline depois de hold_ms mais o timeout
 static void heartbeat_task(void *pvParameters) {
+#if LOW_POWER_MODE_ENABLED
+    char heartbeat[48];
+    snprintf(heartbeat, sizeof(heartbeat), "{\"status\":\"heartbeat\",\"hold_ms\":%d}", LOW_POWER_HEARTBEAT_HOLD_MS);
+#else
+    const char *heartbeat = "heartbeat";
+#endif
+    int64_t last_diagnostics_ms = esp_timer_get_time() / 1000;
+    int64_t last_metrics_ms = last_diagnostics_ms;
+#if LOW_POWER_MODE_ENABLED
+    // O despertar de cada rajada varia alguns ms: com folga de meio período,
+    // diagnóstico e métricas não pulam a rajada em que vencem
+    const int64_t slack_ms = LOW_POWER_BURST_PERIOD_MS / 2;
+#else
+    const int64_t slack_ms = 0;
+#endif
     while (1) {
+#if LOW_POWER_MODE_ENABLED
+        // Dorme até o fim da janela acordada ou até a próxima rajada
+        int64_t wait_ms = radio_burst_deadline(&radio_burst) - uptime_ms();
+        TickType_t wait_ticks = wait_ms > 0 ? pdMS_TO_TICKS(wait_ms) : 0;
+        vTaskDelay(wait_ticks > 0 ? wait_ticks : 1);
+        if (radio_burst_poll_sleep(&radio_burst, uptime_ms())) radio_burst_power_save(true);
+        if (!radio_burst_start(&radio_burst, uptime_ms())) continue;
+        radio_burst_power_save(false);
+#else
         vTaskDelay(pdMS_TO_TICKS(HEARTBEAT_INTERVAL_MS));
-        if (local_client) {
-            int msg_id = esp_mqtt_client_publish(local_client, MQTT_SYSTEM_STATUS_TOPIC, "heartbeat", 0, 0, 0);
-            if (msg_id != -1) {
-                ESP_LOGI(TAG, "Heartbeat publicado para o broker LOCAL, msg_id=%d", msg_id);
-            } else {
-                ESP_LOGE(TAG, "FALHA ao publicar heartbeat para o broker LOCAL.");
-            }
+#endif
+        if (!mqtt_outbox_publish(MQTT_SYSTEM_STATUS_TOPIC, heartbeat, 0, 0, 0)) {
+            ESP_LOGE(TAG, "FALHA ao publicar heartbeat: fila de saída cheia.");
+        }
+        // Mensagens QoS 0 saem da outbox sem MQTT_EVENT_PUBLISHED: retoma daqui
+        mqtt_outbox_drain(MQTT_OUTBOX_CLOUD);
+        mqtt_outbox_drain(MQTT_OUTBOX_LOCAL);
+        int64_t now_ms = esp_timer_get_time() / 1000;
+        if (now_ms - last_diagnostics_ms >= DIAGNOSTICS_INTERVAL_MS - slack_ms) {
+            last_diagnostics_ms = now_ms;
+            publish_diagnostics();
+        }
+        if (now_ms - last_metrics_ms >= METRICS_INTERVAL_MS - slack_ms) {
+            last_metrics_ms = now_ms;
+            publish_metrics();
         }
     }
 }
@@ -129,10 +216,24 @@ static void local_mqtt_event_handler(void *handler_args, esp_event_base_t base,
     switch ((esp_mqtt_event_id_t)event_id) {
         case MQTT_EVENT_CONNECTED:
             ESP_LOGI(TAG, "Cliente LOCAL conectado.");
+#if HOT_LOG_RING_ENABLED
+            esp_mqtt_client_subscribe(local_client, MQTT_SYSTEM_LOGS_REQUEST_TOPIC, 0);
+#endif
+            mqtt_outbox_set_connected(MQTT_OUTBOX_LOCAL, true);
             break;
         case MQTT_EVENT_DISCONNECTED:
             ESP_LOGW(TAG, "Cliente LOCAL desconectado.");
+            mqtt_outbox_set_connected(MQTT_OUTBOX_LOCAL, false);
+            break;
+        case MQTT_EVENT_PUBLISHED:
+            // Ack liberou espaço na outbox deste cliente
+            mqtt_outbox_drain(MQTT_OUTBOX_LOCAL);
+            break;
+#if HOT_LOG_RING_ENABLED
+        case MQTT_EVENT_DATA:
+            if (is_logs_request(event_data)) publish_hot_logs();
             break;
+#endif
         default:
             break;
     }
@@ -144,49 +245,63 @@ static void cloud_mqtt_event_handler(void *handler_args, esp_event_base_t base,
     switch ((esp_mqtt_event_id_t)event_id) {
         case MQTT_EVENT_CONNECTED:
             ESP_LOGI(TAG, "Cliente da NUVEM conectado.");
-            cloud_mqtt_connected = true;
-            esp_mqtt_client_publish(cloud_client, MQTT_SYSTEM_STATUS_TOPIC, "online", 0, 1, 1);
+            // Par do last will: só para a nuvem e antes dos estados pendentes ocuparem a outbox
+            mqtt_outbox_send_now_to(MQTT_OUTBOX_CLOUD, MQTT_SYSTEM_STATUS_TOPIC, "online", 0, 1, 1);
             char command_topic_wildcard[64];
             snprintf(command_topic_wildcard, sizeof(command_topic_wildcard), "%s+%s", MQTT_GPIO_COMMAND_TOPIC_PREFIX, MQTT_GPIO_COMMAND_TOPIC_SUFFIX);
             esp_mqtt_client_subscribe(cloud_client, command_topic_wildcard, 1);
             ESP_LOGI(TAG, "Inscrito em: %s", command_topic_wildcard);
-            if (heartbeat_task_handle == NULL) {
-                xTaskCreate(heartbeat_task, "heartbeat_task", 3072, NULL, 5, &heartbeat_task_handle);
-            }
+#if HOT_LOG_RING_ENABLED
+            esp_mqtt_client_subscribe(cloud_client, MQTT_SYSTEM_LOGS_REQUEST_TOPIC, 0);
+#endif
+            // Estados que mudaram com a nuvem fora do ar (só o último de cada pino)
+            mqtt_outbox_set_connected(MQTT_OUTBOX_CLOUD, true);
             break;
 
         case MQTT_EVENT_DISCONNECTED:
             ESP_LOGW(TAG, "Cliente da NUVEM desconectado.");
-            cloud_mqtt_connected = false;
-            if (heartbeat_task_handle != NULL) {
-                vTaskDelete(heartbeat_task_handle);
-                heartbeat_task_handle = NULL;
-            }
+            mqtt_outbox_set_connected(MQTT_OUTBOX_CLOUD, false);
+            break;
+
+        case MQTT_EVENT_PUBLISHED:
+            mqtt_outbox_drain(MQTT_OUTBOX_CLOUD);
             break;
 
         case MQTT_EVENT_DATA:
-            if (strncmp(event->topic, MQTT_GPIO_COMMAND_TOPIC_PREFIX, strlen(MQTT_GPIO_COMMAND_TOPIC_PREFIX)) == 0) {
+            {
+                int64_t received_us = esp_timer_get_time();
+#if HOT_LOG_RING_ENABLED
+                if (is_logs_request(event)) {
+                    publish_hot_logs();
+                    return;
+                }
+#endif
                 int pin_number;
-                int items = sscanf(event->topic, MQTT_GPIO_COMMAND_TOPIC_PREFIX "%d" MQTT_GPIO_COMMAND_TOPIC_SUFFIX, &pin_number);
-                if (items == 1) {
-                    ESP_LOGI(TAG, "Comando recebido para o pino: %d", pin_number);
+                uint64_t mask, value;
+                if (event->topic_len == (int)strlen(MQTT_GPIO_BULK_COMMAND_TOPIC) &&
+                    memcmp(event->topic, MQTT_GPIO_BULK_COMMAND_TOPIC, event->topic_len) == 0) {
+                    if (!gpio_bulk_parse(event->data, event->data_len, &mask, &value)) {
+                        HOT_LOGW_LIMITED(&invalid_command_limit, TAG, "Comando em lote inválido: %.*s", event->data_len, event->data);
+                        runtime_metrics_record(RUNTIME_METRIC_GPIO_COMMAND, received_us, esp_timer_get_time(), false);
+                        return;
+                    }
+                    update_and_publish_bulk_state(mask, value, received_us);
+                } else if (gpio_command_parse_topic(event->topic, event->topic_len, MQTT_GPIO_COMMAND_TOPIC_PREFIX,
+                                                    MQTT_GPIO_COMMAND_TOPIC_SUFFIX, &pin_number)) {
+                    HOT_LOGI(TAG, "Comando recebido para o pino: %d", pin_number);
                     if (!GPIO_IS_VALID_OUTPUT_GPIO(pin_number)) {
-                        ESP_LOGE(TAG, "GPIO %d não é um pino de saída válido.", pin_number);
+                        HOT_LOGE_LIMITED(&invalid_command_limit, TAG, "GPIO %d não é um pino de saída válido.", pin_number);
+                        runtime_metrics_record(RUNTIME_METRIC_GPIO_COMMAND, received_us, esp_timer_get_time(), false);
                         return;
                     }
-                    uint8_t current_state = gpio_get_level(pin_number);
-                    uint8_t new_state = current_state;
-                    if (strncmp(event->data, "ON", event->data_len) == 0) {
-                        new_state = 1;
-                    } else if (strncmp(event->data, "OFF", event->data_len) == 0) {
-                        new_state = 0;
-                    } else if (strncmp(event->data, "TOGGLE", event->data_len) == 0) {
-                        new_state = !current_state;
-                    } else {
-                        ESP_LOGW(TAG, "Comando desconhecido: %.*s", event->data_len, event->data);
+                    gpio_action_t action = gpio_command_parse_action(event->data, event->data_len);
+                    if (action == GPIO_ACTION_INVALID) {
+                        HOT_LOGW_LIMITED(&invalid_command_limit, TAG, "Comando desconhecido: %.*s", event->data_len, event->data);
+                        runtime_metrics_record(RUNTIME_METRIC_GPIO_COMMAND, received_us, esp_timer_get_time(), false);
                         return;
                     }
-                    update_and_publish_state(pin_number, new_state);
+                    // TOGGLE parte do estado em RAM, sem ler o pino
+                    update_and_publish_state(pin_number, gpio_action_apply(action, gpio_state_get(pin_number)), received_us);
                 }
             }
             break;
@@ -220,9 +335,13 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t e
                     .qos = 1,
                     .retain = 1
                 },
+#if LOW_POWER_MODE_ENABLED
+                .session.keepalive = LOW_POWER_KEEPALIVE_SECONDS,
+#endif
             };
             cloud_client = esp_mqtt_client_init(&cloud_mqtt_cfg);
             esp_mqtt_client_register_event(cloud_client, ESP_EVENT_ANY_ID, cloud_mqtt_event_handler, NULL);
+            mqtt_outbox_attach(MQTT_OUTBOX_CLOUD, cloud_client);
         }
         esp_mqtt_client_start(cloud_client);
 
@@ -233,9 +352,13 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t e
                     .username = MQTT_USER,
                     .authentication.password = MQTT_PASS,
                 },
+#if LOW_POWER_MODE_ENABLED
+                .session.keepalive = LOW_POWER_KEEPALIVE_SECONDS,
+#endif
             };
             local_client = esp_mqtt_client_init(&local_mqtt_cfg);
             esp_mqtt_client_register_event(local_client, ESP_EVENT_ANY_ID, local_mqtt_event_handler, NULL);
+            mqtt_outbox_attach(MQTT_OUTBOX_LOCAL, local_client);
         }
         esp_mqtt_client_start(local_client);
     }
@@ -257,11 +380,18 @@ void wifi_init_sta(void) {
         .sta = {
             .ssid = WIFI_SSID,
             .password = WIFI_PASS,
+#if LOW_POWER_MODE_ENABLED
+            .listen_interval = LOW_POWER_LISTEN_INTERVAL,
+#endif
         }
     };
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
     ESP_ERROR_CHECK(esp_wifi_start());
+#if LOW_POWER_MODE_ENABLED
+    esp_err_t err = radio_burst_power_init();
+    if (err != ESP_OK) ESP_LOGE(TAG, "Falha ao configurar o modo de baixo consumo: %s", esp_err_to_name(err));
+#endif
 }
 
 // --- Função Principal ---
@@ -272,24 +402,23 @@ void app_main(void) {
         ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK(ret);
+    hot_log_init(uptime_ms);
+    gpio_control_init(NVS_NAMESPACE, MQTT_GPIO_STATE_TOPIC_FORMAT, MQTT_GPIO_BULK_STATE_TOPIC);
 
-    // Lista de pinos para inicializar
-    int pins[] = {2, 4, 5, 13, 14, 16, 17, 18, 19, 21, 22, 23, 25, 26, 27, 32, 33}; // GPIOs
-    int num_pins = sizeof(pins) / sizeof(pins[0]);
+    gpio_persistence_init();
 
-    // Inicializa cada pino
-    for (int i = 0; i < num_pins; i++) {
-        int pin = pins[i];
-        if (!GPIO_IS_VALID_OUTPUT_GPIO(pin)) {
-            ESP_LOGE(TAG, "GPIO %d não é um pino de saída válido.", pin);
-            continue;
-        }
-        uint8_t initial_state = load_gpio_state(pin);
-        gpio_reset_pin(pin);
-        gpio_set_direction(pin, GPIO_MODE_OUTPUT);
-        gpio_set_level(pin, initial_state);
-        ESP_LOGI(TAG, "Estado inicial do GPIO %d definido para %s a partir do NVS.", pin, initial_state ? "ON" : "OFF");
-    }
+    // Uma leitura do NVS e uma configuração por pino, só no boot
+    gpio_state_load_all(gpio_pins, GPIO_PIN_COUNT);
+    gpio_control_configure_pins(gpio_pins, GPIO_PIN_COUNT);
+
+    // Heartbeat e diagnóstico para os dois brokers; a fila de saída segura o
+    // que não puder sair enquanto um deles estiver desconectado
+    mqtt_outbox_init();
+#if LOW_POWER_MODE_ENABLED
+    radio_burst_init(&radio_burst, LOW_POWER_BURST_PERIOD_MS, LOW_POWER_BURST_PERIOD_MS, LOW_POWER_BURST_LINGER_MS, uptime_ms());
+#endif
+    heartbeat_task_handle = xTaskCreateStatic(heartbeat_task, "heartbeat_task", HEARTBEAT_TASK_STACK_SIZE, NULL,
+                                              HEARTBEAT_TASK_PRIORITY, heartbeat_task_stack, &heartbeat_task_tcb);
 
     wifi_init_sta();
 }
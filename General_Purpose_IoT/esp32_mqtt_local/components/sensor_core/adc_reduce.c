@@ -0,0 +1,71 @@
+#include <string.h>
+#include "adc_reduce.h"
+
+void adc_reduce_init(adc_reduce_t *reduce, const uint8_t *channels, size_t count) {
+    memset(reduce, 0, sizeof(*reduce));
+    memset(reduce->slot_of, -1, sizeof(reduce->slot_of));
+    for (size_t i = 0; i < count && reduce->channel_count < ADC_REDUCE_MAX_CHANNELS; i++) {
+        if (channels[i] >= sizeof(reduce->slot_of) || reduce->slot_of[channels[i]] >= 0) continue;
+        reduce->slot_of[channels[i]] = (int8_t)reduce->channel_count;
+        reduce->channels[reduce->channel_count++].channel = channels[i];
+    }
+}
+
+void adc_reduce_reset(adc_reduce_t *reduce) {
+    for (size_t i = 0; i < reduce->channel_count; i++) {
+        adc_reduce_channel_t *ch = &reduce->channels[i];
+        ch->primed = 0;
+        ch->sum = 0;
+        ch->count = 0;
+    }
+    reduce->discarded = 0;
+}
+
+static inline uint16_t median3(uint16_t a, uint16_t b, uint16_t c) {
+    uint16_t lo = a < b ? a : b;
+    uint16_t hi = a < b ? b : a;
+    uint16_t mid = hi < c ? hi : c;
+    return lo > mid ? lo : mid;
+}
+
+void adc_reduce_feed(adc_reduce_t *reduce, const uint8_t *frames, size_t len) {
+    for (size_t i = 0; i + ADC_REDUCE_RESULT_BYTES <= len; i += ADC_REDUCE_RESULT_BYTES) {
+        uint16_t word = (uint16_t)(frames[i] | (frames[i + 1] << 8));
+        int8_t slot = reduce->slot_of[word >> 12];
+        if (slot < 0) {
+            reduce->discarded++;
+            continue;
+        }
+        adc_reduce_channel_t *ch = &reduce->channels[slot];
+        uint16_t sample = word & 0x0FFF;
+        // As duas primeiras amostras da janela entram sem filtro
+        uint16_t filtered = ch->primed < 2 ? sample : median3(ch->history[0], ch->history[1], sample);
+        if (ch->primed < 2) ch->primed++;
+        ch->history[0] = ch->history[1];
+        ch->history[1] = sample;
+        ch->sum += filtered;
+        ch->count++;
+    }
+}
+
+static const adc_reduce_channel_t *find_channel(const adc_reduce_t *reduce, uint8_t channel) {
+    if (channel >= sizeof(reduce->slot_of) || reduce->slot_of[channel] < 0) return NULL;
+    return &reduce->channels[reduce->slot_of[channel]];
+}
+
+bool adc_reduce_mean_q4(const adc_reduce_t *reduce, uint8_t channel, uint16_t *mean_q4) {
+    const adc_reduce_channel_t *ch = find_channel(reduce, channel);
+    if (ch == NULL || ch->count == 0) return false;
+    // Divisão em 64 bits: só uma vez por janela, sem limite de amostras
+    *mean_q4 = (uint16_t)((((uint64_t)ch->sum << ADC_REDUCE_FRAC_BITS) + ch->count / 2) / ch->count);
+    return true;
+}
+
+uint32_t adc_reduce_count(const adc_reduce_t *reduce, uint8_t channel) {
+    const adc_reduce_channel_t *ch = find_channel(reduce, channel);
+    return ch ? ch->count : 0;
+}
+
+uint16_t adc_reduce_q4_to_raw(uint16_t mean_q4) {
+    return (uint16_t)((mean_q4 + (1u << (ADC_REDUCE_FRAC_BITS - 1))) >> ADC_REDUCE_FRAC_BITS);
+}
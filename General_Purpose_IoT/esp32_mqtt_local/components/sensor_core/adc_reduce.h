@@ -0,0 +1,56 @@
+#ifndef ADC_REDUCE_H
+#define ADC_REDUCE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ======================================================
+// --- REDUÇÃO DAS AMOSTRAS DO ADC CONTÍNUO (DMA) ---
+// ======================================================
+// Reduz um quadro do ADC contínuo a um valor por canal em uma única
+// passada e só com inteiros: cada amostra passa por uma mediana de 3
+// (remove picos isolados) e entra na soma da janela; o resultado é a média
+// em ponto fixo Q12.4 (16x a resolução do ADC de 12 bits).
+//
+// O quadro está no formato TYPE1 do ESP32: palavras de 16 bits
+// little-endian com o dado nos 12 bits baixos e o canal nos 4 altos.
+
+#define ADC_REDUCE_MAX_CHANNELS 4
+#define ADC_REDUCE_FRAC_BITS 4
+#define ADC_REDUCE_RESULT_BYTES 2
+
+typedef struct {
+    uint8_t channel;
+    uint8_t primed;         // Amostras no histórico da mediana (0 a 2)
+    uint16_t history[2];    // Duas amostras anteriores do canal
+    uint32_t sum;
+    uint32_t count;
+} adc_reduce_channel_t;
+
+typedef struct {
+    adc_reduce_channel_t channels[ADC_REDUCE_MAX_CHANNELS];
+    size_t channel_count;
+    int8_t slot_of[16];     // Canal do ADC -> índice em channels[] (-1 se ignorado)
+    uint32_t discarded;     // Amostras de canais não configurados
+} adc_reduce_t;
+
+// Configura os canais a reduzir (no máximo ADC_REDUCE_MAX_CHANNELS, canais 0 a 15).
+void adc_reduce_init(adc_reduce_t *reduce, const uint8_t *channels, size_t count);
+
+// Começa uma nova janela (zera somas e históricos).
+void adc_reduce_reset(adc_reduce_t *reduce);
+
+// Acumula len bytes de amostras TYPE1; um byte final ímpar é ignorado.
+void adc_reduce_feed(adc_reduce_t *reduce, const uint8_t *frames, size_t len);
+
+// Média do canal na janela, em Q12.4. Retorna false se o canal não teve amostras.
+bool adc_reduce_mean_q4(const adc_reduce_t *reduce, uint8_t channel, uint16_t *mean_q4);
+
+// Número de amostras do canal na janela.
+uint32_t adc_reduce_count(const adc_reduce_t *reduce, uint8_t channel);
+
+// Converte Q12.4 para a leitura bruta de 12 bits, com arredondamento.
+uint16_t adc_reduce_q4_to_raw(uint16_t mean_q4);
+
+#endif // ADC_REDUCE_H
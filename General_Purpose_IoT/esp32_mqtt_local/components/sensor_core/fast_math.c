@@ -0,0 +1,79 @@
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "fast_math.h"
+
+#define LOG2_10 3.32192809488736f
+
+static inline uint32_t float_bits(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+static inline float bits_float(uint32_t bits) {
+    float x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+float fast_log2f(float x) {
+    // x = m * 2^e com m em [sqrt(0.5), sqrt(2)): log2(x) = e + log2(m)
+    uint32_t bits = float_bits(x);
+    int e = (int)((bits >> 23) & 0xFF) - 127;
+    float m = bits_float((bits & 0x007FFFFFu) | 0x3F800000u);   // [1, 2)
+    if (m > 1.41421356f) {
+        m *= 0.5f;
+        e++;
+    }
+    // log(m) = 2 * atanh(t), t = (m - 1) / (m + 1), |t| < 0.172
+    float t = (m - 1.0f) / (m + 1.0f);
+    float t2 = t * t;
+    float series = t * (2.0f + t2 * (2.0f / 3.0f + t2 * (2.0f / 5.0f + t2 * (2.0f / 7.0f))));
+    return (float)e + series * 1.44269504f;   // 1 / ln(2)
+}
+
+float fast_exp2f(float x) {
+    if (x < -126.0f) x = -126.0f;
+    if (x > 127.0f) x = 127.0f;
+    // x = i + f com f em [-0.5, 0.5]: 2^x = 2^i * e^(f * ln 2)
+    float rounded = x < 0 ? x - 0.5f : x + 0.5f;
+    int i = (int)rounded;
+    float y = (x - (float)i) * 0.69314718f;
+    float p = 1.0f + y * (1.0f + y * (1.0f / 2 + y * (1.0f / 6 + y * (1.0f / 24 + y * (1.0f / 120 + y * (1.0f / 720))))));
+    return p * bits_float((uint32_t)(i + 127) << 23);
+}
+
+void mq135_curve_init(mq135_curve_t *curve, const mq135_calibration_t *cal) {
+    curve->slope = cal->slope;
+    curve->y_intercept = cal->y_intercept;
+    curve->exponent = 1.0f / cal->slope;
+    curve->offset = -cal->y_intercept * LOG2_10 / cal->slope;
+}
+
+float mq135_curve_ppm(const mq135_curve_t *curve, float ratio) {
+    return fast_exp2f(fast_log2f(ratio) * curve->exponent + curve->offset);
+}
+
+void sea_level_table_init(sea_level_table_t *table, float altitude_m) {
+    for (int i = 0; i < SEA_LEVEL_TABLE_SIZE; i++) {
+        double temperature_c = SEA_LEVEL_TABLE_MIN_C + i;
+        double base = 1.0 - (STANDARD_LAPSE_RATE * altitude_m) / (temperature_c + STANDARD_LAPSE_RATE * altitude_m + SEA_LEVEL_TEMP_K);
+        table->factor[i] = (float)(1.0 / pow(base, EXPONENT));
+    }
+    table->altitude_m = altitude_m;
+    table->ready = true;
+}
+
+bool sea_level_table_factor(const sea_level_table_t *table, float temperature_c, float *factor) {
+    if (!(temperature_c >= SEA_LEVEL_TABLE_MIN_C && temperature_c <= SEA_LEVEL_TABLE_MAX_C)) return false;
+    float x = temperature_c - SEA_LEVEL_TABLE_MIN_C;
+    int i = (int)x;
+    if (i >= SEA_LEVEL_TABLE_SIZE - 1) {
+        *factor = table->factor[SEA_LEVEL_TABLE_SIZE - 1];
+        return true;
+    }
+    float frac = x - (float)i;
+    *factor = table->factor[i] + frac * (table->factor[i + 1] - table->factor[i]);
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <stdbool.h>
+#include "sensor_math.h"
+
+// ======================================================
+// --- MATEMÁTICA RÁPIDA PARA AS CONVERSÕES ---
+// ======================================================
+// Alternativas em float às chamadas de log10/pow em double da libm, que no
+// ESP32 (FPU só de precisão simples) são emuladas em software:
+// - log2/exp2 por polinômio, para a curva do MQ-135;
+// - tabela do fator da fórmula barométrica por temperatura, para uma
+//   altitude fixa, com interpolação linear.
+// O erro fica na ordem do arredondamento de float (~2e-6 relativo no ppm,
+// como log10f/powf); ver o relatório de precisão do firmware_bench.
+
+// log2(x) para x > 0 normal; erro do polinômio < 1e-7 (mais o arredondamento da soma do expoente)
+float fast_log2f(float x);
+
+// 2^x, com x limitado a [-126, 127]; erro relativo < 3e-7
+float fast_exp2f(float x);
+
+// --- MQ-135 ---
+// ppm = 10^((log10(Rs/R0) - b) / m) = 2^(log2(Rs/R0) / m - b * log2(10) / m)
+typedef struct {
+    float slope;        // Parâmetros da calibração de origem (para detectar mudança)
+    float y_intercept;
+    float exponent;     // 1 / m
+    float offset;       // -b * log2(10) / m
+} mq135_curve_t;
+
+void mq135_curve_init(mq135_curve_t *curve, const mq135_calibration_t *cal);
+
+// ppm para uma razão Rs/R0 > 0
+float mq135_curve_ppm(const mq135_curve_t *curve, float ratio);
+
+// --- Pressão ao nível do mar ---
+// Fator P0/P da fórmula barométrica, de grau em grau, na faixa de operação do BMP280.
+#define SEA_LEVEL_TABLE_MIN_C (-40)
+#define SEA_LEVEL_TABLE_MAX_C 85
+#define SEA_LEVEL_TABLE_SIZE (SEA_LEVEL_TABLE_MAX_C - SEA_LEVEL_TABLE_MIN_C + 1)
+
+typedef struct {
+    bool ready;
+    float altitude_m;
+    float factor[SEA_LEVEL_TABLE_SIZE];
+} sea_level_table_t;
+
+// Calcula a tabela para a altitude (pow em double, uma vez)
+void sea_level_table_init(sea_level_table_t *table, float altitude_m);
+
+// Fator interpolado; false fora da faixa da tabela (ou temperatura NaN)
+bool sea_level_table_factor(const sea_level_table_t *table, float temperature_c, float *factor);
+
+#endif // FAST_MATH_H
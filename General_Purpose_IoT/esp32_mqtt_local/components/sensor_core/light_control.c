@@ -0,0 +1,59 @@
+#include "light_control.h"
+
+void light_control_init(light_control_t *ctl, uint16_t threshold_low, uint16_t threshold_high, uint16_t hysteresis) {
+    ctl->threshold_low = threshold_low;
+    ctl->threshold_high = threshold_high;
+    ctl->hysteresis = hysteresis;
+    ctl->level = LIGHT_LEVEL_UNKNOWN;
+    ctl->faults = 0;
+    ctl->transitions = 0;
+}
+
+// Nível sem histerese (mesma regra dos limiares originais: "<=" fica no nível de baixo)
+static light_level_t classify(const light_control_t *ctl, int raw) {
+    if (raw <= ctl->threshold_low) return LIGHT_LEVEL_DARK;
+    if (raw <= ctl->threshold_high) return LIGHT_LEVEL_DIM;
+    return LIGHT_LEVEL_BRIGHT;
+}
+
+bool light_control_update(light_control_t *ctl, uint16_t raw) {
+    light_level_t level = ctl->level;
+    ctl->faults = 0;
+    if (level == LIGHT_LEVEL_UNKNOWN) {
+        level = classify(ctl, raw);
+    } else {
+        // Sobe só se a leitura menos a histerese já estiver acima do limiar; desce só se
+        // a leitura mais a histerese ainda estiver abaixo
+        light_level_t up = classify(ctl, (int)raw - ctl->hysteresis);
+        light_level_t down = classify(ctl, (int)raw + ctl->hysteresis);
+        if (up > level) level = up;
+        else if (down < level) level = down;
+    }
+    if (level == ctl->level) return false;
+    ctl->level = level;
+    ctl->transitions++;
+    return true;
+}
+
+bool light_control_fault(light_control_t *ctl) {
+    if (ctl->faults < LIGHT_CONTROL_MAX_FAULTS) ctl->faults++;
+    if (ctl->faults < LIGHT_CONTROL_MAX_FAULTS || ctl->level == LIGHT_LEVEL_UNKNOWN) return false;
+    ctl->level = LIGHT_LEVEL_UNKNOWN;
+    ctl->transitions++;
+    return true;
+}
+
+void light_control_duty(light_level_t level, uint32_t duty_max, uint32_t duty[LIGHT_COLORS]) {
+    duty[LIGHT_RED] = level == LIGHT_LEVEL_DARK ? duty_max : 0;
+    duty[LIGHT_GREEN] = level == LIGHT_LEVEL_DIM ? duty_max : 0;
+    duty[LIGHT_BLUE] = level == LIGHT_LEVEL_BRIGHT ? duty_max : 0;
+}
+
+const char *light_level_name(light_level_t level) {
+    switch (level) {
+        case LIGHT_LEVEL_DARK: return "escuro";
+        case LIGHT_LEVEL_DIM: return "médio";
+        case LIGHT_LEVEL_BRIGHT: return "claro";
+        default: return "desconhecido";
+    }
+}
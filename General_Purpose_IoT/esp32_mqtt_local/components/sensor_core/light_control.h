@@ -0,0 +1,52 @@
+#ifndef LIGHT_CONTROL_H
+#define LIGHT_CONTROL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ======================================================
+// --- CONTROLE AUTOMÁTICO DO LED RGB PELO LDR ---
+// ======================================================
+// Máquina de estados da cor do LED a partir da leitura do LDR (0 a 4095):
+// escuro (vermelho) até threshold_low, médio (verde) até threshold_high e
+// claro (azul) acima. Para trocar de nível a leitura precisa ultrapassar o
+// limiar por mais que hysteresis, então o ruído do ADC perto de um limiar
+// não faz o LED piscar. update() informa se o nível mudou, para que o
+// chamador só mexa no hardware quando necessário. Uma leitura que falha
+// mantém o nível; só LIGHT_CONTROL_MAX_FAULTS falhas seguidas apagam o LED.
+
+#define LIGHT_CONTROL_MAX_FAULTS 3
+
+typedef enum {
+    LIGHT_LEVEL_UNKNOWN,   // Sem leitura válida: LED apagado
+    LIGHT_LEVEL_DARK,
+    LIGHT_LEVEL_DIM,
+    LIGHT_LEVEL_BRIGHT,
+} light_level_t;
+
+typedef enum { LIGHT_RED, LIGHT_GREEN, LIGHT_BLUE, LIGHT_COLORS } light_color_t;
+
+typedef struct {
+    uint16_t threshold_low;
+    uint16_t threshold_high;
+    uint16_t hysteresis;
+    light_level_t level;
+    uint16_t faults;        // Leituras seguidas com falha
+    uint32_t transitions;   // Trocas de nível desde init
+} light_control_t;
+
+void light_control_init(light_control_t *ctl, uint16_t threshold_low, uint16_t threshold_high, uint16_t hysteresis);
+
+// Nova leitura do LDR. Retorna true se o nível mudou.
+bool light_control_update(light_control_t *ctl, uint16_t raw);
+
+// Leitura falhou: mantém o nível até LIGHT_CONTROL_MAX_FAULTS falhas seguidas e
+// então volta para LIGHT_LEVEL_UNKNOWN. Retorna true se o nível mudou.
+bool light_control_fault(light_control_t *ctl);
+
+// Duty de cada cor (índice light_color_t) para o nível, com duty_max na cor ativa
+void light_control_duty(light_level_t level, uint32_t duty_max, uint32_t duty[LIGHT_COLORS]);
+
+const char *light_level_name(light_level_t level);
+
+#endif // LIGHT_CONTROL_H
@@ -0,0 +1,42 @@
+#include <math.h>
+#include "publish_policy.h"
+
+void publish_policy_reset(publish_policy_t *policy) {
+    policy->has_last = false;
+    policy->last_sent_ms = 0;
+    policy->sent = 0;
+    policy->suppressed = 0;
+}
+
+static bool field_due(const publish_field_policy_t *field, float last, float value, int64_t silence_ms) {
+    if (field->max_silence_ms > 0 && silence_ms >= field->max_silence_ms) return true;
+    // A comparação negada também envia quando o valor vira NaN
+    return !(fabsf(value - last) <= field->deadband);
+}
+
+bool publish_policy_should_publish(publish_policy_t *policy, const telemetry_reading_t *reading, int64_t now_ms) {
+    if (reading->sensor != policy->sensor) return true;
+    size_t count = telemetry_field_count(reading->sensor);
+    bool due = !policy->has_last;
+    for (size_t i = 0; i < count && !due; i++) {
+        due = field_due(&policy->fields[i], policy->last[i], telemetry_field_value(reading, i), now_ms - policy->last_sent_ms);
+    }
+    if (!due) {
+        policy->suppressed++;
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) policy->last[i] = telemetry_field_value(reading, i);
+    policy->has_last = true;
+    policy->last_sent_ms = now_ms;
+    policy->sent++;
+    return true;
+}
+
+uint32_t publish_policy_hold_ms(const publish_policy_t *policy) {
+    uint32_t hold = 0;
+    for (size_t i = 0; i < telemetry_field_count(policy->sensor); i++) {
+        uint32_t silence = policy->fields[i].max_silence_ms;
+        if (silence > 0 && (hold == 0 || silence < hold)) hold = silence;
+    }
+    return hold;
+}
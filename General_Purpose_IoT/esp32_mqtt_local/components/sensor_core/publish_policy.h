@@ -0,0 +1,45 @@
+#ifndef PUBLISH_POLICY_H
+#define PUBLISH_POLICY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "telemetry_codec.h"
+
+// ======================================================
+// --- PUBLICAÇÃO POR MUDANÇA (BANDA MORTA) ---
+// ======================================================
+// Decide se uma leitura de sensor lento precisa ser enviada: sim quando algum
+// campo se afastou do último valor enviado mais que a banda do campo, ou
+// quando o silêncio máximo de algum campo expirou desde o último envio. A
+// leitura vai inteira (todos os campos), então o erro de quem reconstrói a
+// série repetindo o último valor fica limitado à banda de cada campo.
+//
+// O receptor sabe por quanto tempo o valor vale pelo metadado hold_ms
+// (publish_policy_hold_ms), para não tratar o silêncio como falha.
+
+typedef struct {
+    float deadband;            // Variação mínima (em módulo, estritamente maior) para enviar; 0 envia toda mudança
+    uint32_t max_silence_ms;   // Envia mesmo sem mudança após esse intervalo; 0 desliga
+} publish_field_policy_t;
+
+typedef struct {
+    telemetry_sensor_t sensor;
+    publish_field_policy_t fields[TELEMETRY_MAX_FIELDS];   // Na ordem de telemetry_field_value
+    bool has_last;
+    float last[TELEMETRY_MAX_FIELDS];   // Valores do último envio
+    int64_t last_sent_ms;
+    uint32_t sent;
+    uint32_t suppressed;
+} publish_policy_t;
+
+// Zera o estado (a próxima leitura sempre é enviada); mantém sensor e fields.
+void publish_policy_reset(publish_policy_t *policy);
+
+// Retorna true se a leitura deve ser enviada e, nesse caso, a registra como
+// último envio. Leituras de outro sensor sempre retornam true.
+bool publish_policy_should_publish(publish_policy_t *policy, const telemetry_reading_t *reading, int64_t now_ms);
+
+// Menor silêncio máximo entre os campos (0 se nenhum tiver limite)
+uint32_t publish_policy_hold_ms(const publish_policy_t *policy);
+
+#endif // PUBLISH_POLICY_H
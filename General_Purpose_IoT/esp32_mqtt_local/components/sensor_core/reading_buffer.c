@@ -0,0 +1,43 @@
+#include <string.h>
+#include "reading_buffer.h"
+
+void reading_buffer_init(reading_buffer_t *buf, reading_buffer_entry_t *storage, size_t capacity) {
+    memset(buf, 0, sizeof(*buf));
+    buf->entries = storage;
+    buf->capacity = capacity;
+}
+
+bool reading_buffer_push(reading_buffer_t *buf, const telemetry_reading_t *reading, uint32_t seq, uint32_t sampled_at_ms) {
+    if (buf->capacity == 0) {
+        buf->dropped++;
+        return false;
+    }
+    bool kept_all = true;
+    if (buf->count == buf->capacity) {
+        buf->head = (buf->head + 1) % buf->capacity;
+        buf->count--;
+        buf->dropped++;
+        kept_all = false;
+    }
+    reading_buffer_entry_t *entry = &buf->entries[(buf->head + buf->count) % buf->capacity];
+    entry->reading = *reading;
+    entry->seq = seq;
+    entry->sampled_at_ms = sampled_at_ms;
+    buf->count++;
+    if (buf->count > buf->high_water) buf->high_water = buf->count;
+    return kept_all;
+}
+
+const reading_buffer_entry_t *reading_buffer_peek(const reading_buffer_t *buf) {
+    return buf->count ? &buf->entries[buf->head] : NULL;
+}
+
+void reading_buffer_pop(reading_buffer_t *buf) {
+    if (buf->count == 0) return;
+    buf->head = (buf->head + 1) % buf->capacity;
+    buf->count--;
+}
+
+size_t reading_buffer_count(const reading_buffer_t *buf) {
+    return buf->count;
+}
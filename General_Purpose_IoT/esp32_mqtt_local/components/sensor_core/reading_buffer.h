@@ -0,0 +1,45 @@
+#ifndef READING_BUFFER_H
+#define READING_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "telemetry_codec.h"
+
+// ======================================================
+// --- FILA DE LEITURAS FEITAS SEM CONEXÃO ---
+// ======================================================
+// Buffer circular de tamanho fixo (o armazenamento é fornecido pelo
+// chamador) que guarda as leituras com o instante da amostra enquanto o
+// broker está inacessível. Quando cheio, a leitura mais antiga é
+// sobrescrita e contada em dropped. Um único produtor/consumidor: o
+// chamador é responsável pela exclusão mútua, se houver mais de uma tarefa.
+
+typedef struct {
+    telemetry_reading_t reading;
+    uint32_t seq;             // Número da leitura (telemetry_meta_t.seq)
+    uint32_t sampled_at_ms;   // Relógio do chamador (ms); diferenças em aritmética módulo 2^32
+} reading_buffer_entry_t;
+
+typedef struct {
+    reading_buffer_entry_t *entries;
+    size_t capacity;
+    size_t head;        // Próxima leitura a sair
+    size_t count;
+    uint32_t dropped;   // Leituras sobrescritas por falta de espaço
+    size_t high_water;  // Maior ocupação desde a inicialização
+} reading_buffer_t;
+
+void reading_buffer_init(reading_buffer_t *buf, reading_buffer_entry_t *storage, size_t capacity);
+
+// Enfileira a leitura. Retorna false se precisou descartar a mais antiga.
+bool reading_buffer_push(reading_buffer_t *buf, const telemetry_reading_t *reading, uint32_t seq, uint32_t sampled_at_ms);
+
+// Leitura mais antiga sem removê-la (NULL se vazia).
+const reading_buffer_entry_t *reading_buffer_peek(const reading_buffer_t *buf);
+
+void reading_buffer_pop(reading_buffer_t *buf);
+
+size_t reading_buffer_count(const reading_buffer_t *buf);
+
+#endif // READING_BUFFER_H
@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <string.h>
+#include "sensor_batch.h"
+
+typedef struct {
+    const char *sensor;
+    const char *json_object;
+    const uint8_t *record;
+    size_t record_len;
+} batch_item_t;
+
+void sensor_batch_init(sensor_batch_t *batch, uint32_t max_age_ms, size_t max_readings, bool binary,
+                       sensor_batch_flush_fn_t flush, void *flush_ctx) {
+    memset(batch, 0, sizeof(*batch));
+    batch->max_age_ms = max_age_ms;
+    batch->max_readings = max_readings;
+    batch->binary = binary;
+    batch->flush = flush;
+    batch->flush_ctx = flush_ctx;
+}
+
+void sensor_batch_flush(sensor_batch_t *batch) {
+    if (batch->readings == 0) return;
+    if (!batch->binary) {
+        batch->buffer[batch->len++] = ']';
+        batch->buffer[batch->len] = '\0';
+    }
+    if (batch->flush) {
+        batch->flush(batch->buffer, batch->len, batch->readings, batch->flush_ctx);
+    }
+    batch->len = 0;
+    batch->readings = 0;
+}
+
+// Escreve ",{"sensor":"<nome>",<campos>}" (ou "[" no início) a partir de buffer[len]
+static bool append_json(sensor_batch_t *batch, const batch_item_t *item) {
+    // Reserva 2 bytes para o ']' final e o terminador
+    size_t room = sizeof(batch->buffer) - batch->len - 2;
+    const char *fields = item->json_object + 1;   // Pula o '{' do objeto original
+    bool has_fields = fields[0] != '}';
+    int written = snprintf(batch->buffer + batch->len, room + 1, "%c{\"sensor\":\"%s\"%s%s",
+                           batch->readings == 0 ? '[' : ',', item->sensor, has_fields ? "," : "", has_fields ? fields : "}");
+    if (written < 0 || (size_t)written > room) {
+        batch->buffer[batch->len] = '\0';
+        return false;
+    }
+    batch->len += (size_t)written;
+    return true;
+}
+
+static bool append_record(sensor_batch_t *batch, const batch_item_t *item) {
+    if (item->record_len > sizeof(batch->buffer) - batch->len) return false;
+    memcpy(batch->buffer + batch->len, item->record, item->record_len);
+    batch->len += item->record_len;
+    return true;
+}
+
+static bool append_item(sensor_batch_t *batch, const batch_item_t *item) {
+    return batch->binary ? append_record(batch, item) : append_json(batch, item);
+}
+
+static bool batch_add(sensor_batch_t *batch, const batch_item_t *item, int64_t now_ms) {
+    sensor_batch_poll(batch, now_ms);
+    if (!append_item(batch, item)) {
+        // Não coube: envia o quadro atual e tenta de novo em um quadro vazio
+        if (batch->readings == 0) {
+            batch->dropped++;
+            return false;
+        }
+        sensor_batch_flush(batch);
+        if (!append_item(batch, item)) {
+            batch->dropped++;
+            return false;
+        }
+    }
+    if (batch->readings == 0) {
+        batch->first_reading_ms = now_ms;
+    }
+    batch->readings++;
+    if (batch->max_readings > 0 && batch->readings >= batch->max_readings) {
+        sensor_batch_flush(batch);
+    }
+    return true;
+}
+
+bool sensor_batch_add(sensor_batch_t *batch, const char *sensor, const char *json_object, int64_t now_ms) {
+    if (batch->binary || json_object[0] != '{') return false;
+    batch_item_t item = { .sensor = sensor, .json_object = json_object };
+    return batch_add(batch, &item, now_ms);
+}
+
+bool sensor_batch_add_record(sensor_batch_t *batch, const uint8_t *record, size_t len, int64_t now_ms) {
+    if (!batch->binary || len == 0) return false;
+    batch_item_t item = { .record = record, .record_len = len };
+    return batch_add(batch, &item, now_ms);
+}
+
+int64_t sensor_batch_deadline(const sensor_batch_t *batch) {
+    if (batch->readings == 0) return INT64_MAX;
+    return batch->first_reading_ms + batch->max_age_ms;
+}
+
+void sensor_batch_poll(sensor_batch_t *batch, int64_t now_ms) {
+    if (batch->readings > 0 && now_ms >= sensor_batch_deadline(batch)) {
+        sensor_batch_flush(batch);
+    }
+}
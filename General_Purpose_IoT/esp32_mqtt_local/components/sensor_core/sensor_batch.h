@@ -0,0 +1,55 @@
+#ifndef SENSOR_BATCH_H
+#define SENSOR_BATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ======================================================
+// --- AGRUPAMENTO DE LEITURAS EM UM ÚNICO PAYLOAD ---
+// ======================================================
+// Acumula as leituras de vários sensores em um array JSON
+// ([{"sensor":"bmp280",...},{"sensor":"dht11",...}]) e entrega o quadro
+// ao callback de envio quando atinge o número máximo de leituras, quando
+// a próxima leitura não cabe no buffer ou quando a leitura mais antiga
+// ultrapassa a janela configurada. No modo binário o quadro é apenas a
+// concatenação dos registros de telemetry_codec.h.
+
+#ifndef SENSOR_BATCH_BUFFER_SIZE
+#define SENSOR_BATCH_BUFFER_SIZE 704   // 4 leituras JSON com seq, ts e hold_ms
+#endif
+
+typedef void (*sensor_batch_flush_fn_t)(const char *payload, size_t len, size_t readings, void *ctx);
+
+typedef struct {
+    char buffer[SENSOR_BATCH_BUFFER_SIZE];
+    size_t len;
+    size_t readings;
+    int64_t first_reading_ms;
+    uint32_t max_age_ms;
+    size_t max_readings;
+    bool binary;
+    sensor_batch_flush_fn_t flush;
+    void *flush_ctx;
+    uint32_t dropped;   // Leituras que não cabem nem em um quadro vazio
+} sensor_batch_t;
+
+void sensor_batch_init(sensor_batch_t *batch, uint32_t max_age_ms, size_t max_readings, bool binary,
+                       sensor_batch_flush_fn_t flush, void *flush_ctx);
+
+// Adiciona uma leitura. json_object deve ser um objeto JSON ("{...}");
+// o campo "sensor" é inserido no início. Pode disparar o envio do quadro.
+bool sensor_batch_add(sensor_batch_t *batch, const char *sensor, const char *json_object, int64_t now_ms);
+
+// Equivalente a sensor_batch_add para lotes binários.
+bool sensor_batch_add_record(sensor_batch_t *batch, const uint8_t *record, size_t len, int64_t now_ms);
+
+// Envia o quadro se a leitura mais antiga já expirou a janela.
+void sensor_batch_poll(sensor_batch_t *batch, int64_t now_ms);
+
+// Instante em que o quadro atual expira (INT64_MAX se estiver vazio).
+int64_t sensor_batch_deadline(const sensor_batch_t *batch);
+
+void sensor_batch_flush(sensor_batch_t *batch);
+
+#endif // SENSOR_BATCH_H
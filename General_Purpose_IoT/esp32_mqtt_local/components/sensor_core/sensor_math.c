@@ -0,0 +1,77 @@
+#include <math.h>
+#include "sensor_math.h"
+#include "fast_math.h"
+
+float mq135_resistance(int adc_reading, const mq135_calibration_t *cal) {
+    if (adc_reading <= 0) return 0;
+    return (cal->ref_voltage * cal->adc_full_scale / adc_reading) - cal->ref_voltage;
+}
+
+#if SENSOR_MATH_IMPL == SENSOR_MATH_IMPL_DOUBLE
+
+float sensor_sea_level_pressure(float pressure_pa, float temperature_c, float altitude_m) {
+    // Pressão em hPa (pressure vem em Pa, dividir por 100)
+    float P = pressure_pa * PA_TO_HPA;
+    // Fórmula barométrica para pressão ao nível do mar
+    return P / pow(1.0 - (STANDARD_LAPSE_RATE * altitude_m) / (temperature_c + STANDARD_LAPSE_RATE * altitude_m + SEA_LEVEL_TEMP_K), EXPONENT);
+}
+
+float mq135_ppm(int adc_reading, const mq135_calibration_t *cal) {
+    float razao = mq135_resistance(adc_reading, cal) / cal->r0;   // Razão entre Rs e R0
+    float ppm_log = (log10(razao) - cal->y_intercept) / cal->slope;
+    return pow(10, ppm_log);
+}
+
+#else
+
+// Mesmas fórmulas em precisão simples; em FAST, só para entradas fora da tabela/curva
+static float sea_level_pressure_float(float pressure_pa, float temperature_c, float altitude_m) {
+    float P = pressure_pa * PA_TO_HPA;
+    float lapse = (float)STANDARD_LAPSE_RATE * altitude_m;
+    return P / powf(1.0f - lapse / (temperature_c + lapse + (float)SEA_LEVEL_TEMP_K), (float)EXPONENT);
+}
+
+static float mq135_ppm_float(float razao, const mq135_calibration_t *cal) {
+    return powf(10.0f, (log10f(razao) - cal->y_intercept) / cal->slope);
+}
+
+#if SENSOR_MATH_IMPL == SENSOR_MATH_IMPL_FLOAT
+
+float sensor_sea_level_pressure(float pressure_pa, float temperature_c, float altitude_m) {
+    return sea_level_pressure_float(pressure_pa, temperature_c, altitude_m);
+}
+
+float mq135_ppm(int adc_reading, const mq135_calibration_t *cal) {
+    return mq135_ppm_float(mq135_resistance(adc_reading, cal) / cal->r0, cal);
+}
+
+#else
+
+static sea_level_table_t sea_level_table;
+static mq135_curve_t mq135_curve;
+static bool mq135_curve_ready;
+
+float sensor_sea_level_pressure(float pressure_pa, float temperature_c, float altitude_m) {
+    if (!sea_level_table.ready || sea_level_table.altitude_m != altitude_m) {
+        sea_level_table_init(&sea_level_table, altitude_m);
+    }
+    float factor;
+    if (!sea_level_table_factor(&sea_level_table, temperature_c, &factor)) {
+        return sea_level_pressure_float(pressure_pa, temperature_c, altitude_m);
+    }
+    return pressure_pa * PA_TO_HPA * factor;
+}
+
+float mq135_ppm(int adc_reading, const mq135_calibration_t *cal) {
+    float razao = mq135_resistance(adc_reading, cal) / cal->r0;   // Razão entre Rs e R0
+    // Rs = 0 (ADC em 0 ou no fundo de escala) ou r0 inválido: mesmo resultado da libm
+    if (!(razao > 0.0f) || isinf(razao)) return mq135_ppm_float(razao, cal);
+    if (!mq135_curve_ready || mq135_curve.slope != cal->slope || mq135_curve.y_intercept != cal->y_intercept) {
+        mq135_curve_init(&mq135_curve, cal);
+        mq135_curve_ready = true;
+    }
+    return mq135_curve_ppm(&mq135_curve, razao);
+}
+
+#endif
+#endif
@@ -0,0 +1,46 @@
+#ifndef SENSOR_MATH_H
+#define SENSOR_MATH_H
+
+// ======================================================
+// --- CONVERSÕES DAS LEITURAS DOS SENSORES ---
+// ======================================================
+// Funções puras (sem HAL): podem ser compiladas e medidas no host.
+
+// Implementação das conversões, escolhida na compilação:
+// - DOUBLE: log10/pow em double da libm (referência; emulado em software no ESP32)
+// - FLOAT: log10f/powf da libm em precisão simples
+// - FAST: tabela da fórmula barométrica e log2/exp2 por polinômio (ver fast_math.h)
+#define SENSOR_MATH_IMPL_DOUBLE 0
+#define SENSOR_MATH_IMPL_FLOAT 1
+#define SENSOR_MATH_IMPL_FAST 2
+#ifndef SENSOR_MATH_IMPL
+#define SENSOR_MATH_IMPL SENSOR_MATH_IMPL_FAST
+#endif
+
+// --- Constantes físicas da fórmula barométrica ---
+#define PA_TO_HPA 0.01f  // Conversão de Pascal para hPa
+#define STANDARD_LAPSE_RATE 0.0065 // K/m
+#define SEA_LEVEL_TEMP_K 273.15 // K
+#define EXPONENT 5.257  // Exponente para cálculo da pressão
+
+// Curva de calibração do MQ-135: log10(Rs/R0) = slope * log10(ppm) + y_intercept
+typedef struct {
+    float r0;               // Resistência do sensor em ar limpo
+    float slope;            // Parâmetro m da curva
+    float y_intercept;      // Parâmetro b da curva
+    float ref_voltage;      // Tensão de referência do divisor
+    float adc_full_scale;   // Leitura máxima do ADC (4095 em 12 bits)
+} mq135_calibration_t;
+
+// Pressão ao nível do mar em hPa (pressure_pa em Pa, temperature_c em °C).
+// Em FAST a tabela é refeita quando altitude_m muda; não chamar de mais de uma tarefa.
+float sensor_sea_level_pressure(float pressure_pa, float temperature_c, float altitude_m);
+
+// Resistência do sensor (Rs) a partir da leitura do ADC; 0 se a leitura for inválida
+float mq135_resistance(int adc_reading, const mq135_calibration_t *cal);
+
+// Concentração estimada em ppm a partir da leitura do ADC.
+// Em FAST a curva é recalculada quando slope ou y_intercept mudam (r0 pode mudar livremente).
+float mq135_ppm(int adc_reading, const mq135_calibration_t *cal);
+
+#endif // SENSOR_MATH_H
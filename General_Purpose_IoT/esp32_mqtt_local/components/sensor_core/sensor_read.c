@@ -0,0 +1,83 @@
+#include "sensor_read.h"
+
+esp_err_t sensor_read_bmp280(bmp280_t *dev, float altitude_m, telemetry_reading_t *reading) {
+    float temperature, pressure;
+    esp_err_t err = bmp280_read_float(dev, &temperature, &pressure, NULL);
+    if (err != ESP_OK) return err;
+    reading->sensor = TELEMETRY_SENSOR_BMP280;
+    reading->bmp280.temperature = temperature;
+    reading->bmp280.pressure_hpa = pressure * PA_TO_HPA;
+    reading->bmp280.pressure_sea_level = sensor_sea_level_pressure(pressure, temperature, altitude_m);
+    return ESP_OK;
+}
+
+esp_err_t sensor_read_dht(dht_sensor_type_t type, gpio_num_t pin, telemetry_reading_t *reading) {
+    float temperature, humidity;
+    esp_err_t err = dht_read_float_data(type, pin, &humidity, &temperature);
+    if (err != ESP_OK) return err;
+    reading->sensor = TELEMETRY_SENSOR_DHT11;
+    reading->dht11.temperature = temperature;
+    reading->dht11.humidity = humidity;
+    return ESP_OK;
+}
+
+esp_err_t sensor_read_mq135(adc_oneshot_unit_handle_t adc, adc_channel_t channel,
+                            const mq135_calibration_t *cal, telemetry_reading_t *reading) {
+    int adc_reading;
+    esp_err_t err = adc_oneshot_read(adc, channel, &adc_reading);
+    if (err != ESP_OK) return err;
+    reading->sensor = TELEMETRY_SENSOR_MQ135;
+    reading->mq135.adc_raw = (uint16_t)adc_reading;
+    reading->mq135.ppm = mq135_ppm(adc_reading, cal);
+    return ESP_OK;
+}
+
+esp_err_t sensor_read_ldr(adc_oneshot_unit_handle_t adc, adc_channel_t channel, telemetry_reading_t *reading) {
+    int adc_reading;
+    esp_err_t err = adc_oneshot_read(adc, channel, &adc_reading);
+    if (err != ESP_OK) return err;
+    reading->sensor = TELEMETRY_SENSOR_LDR;
+    reading->ldr.ldr_raw = (uint16_t)adc_reading;
+    return ESP_OK;
+}
+
+#define ADC_BURST_CHUNK_BYTES 256
+
+esp_err_t sensor_read_adc_burst(adc_continuous_handle_t adc, adc_reduce_t *reduce, size_t frame_bytes, uint32_t timeout_ms) {
+    uint8_t chunk[ADC_BURST_CHUNK_BYTES];
+    size_t total = 0;
+    adc_reduce_reset(reduce);
+    esp_err_t err = adc_continuous_start(adc);
+    if (err != ESP_OK) return err;
+    while (total < frame_bytes) {
+        uint32_t got = 0;
+        size_t want = frame_bytes - total < sizeof(chunk) ? frame_bytes - total : sizeof(chunk);
+        err = adc_continuous_read(adc, chunk, (uint32_t)want, &got, timeout_ms);
+        if (err != ESP_OK) break;
+        adc_reduce_feed(reduce, chunk, got);
+        total += got;
+    }
+    adc_continuous_stop(adc);
+    // Descarta o que o DMA converteu entre a última leitura e a parada
+    adc_continuous_flush_pool(adc);
+    return err;
+}
+
+esp_err_t sensor_read_mq135_reduced(const adc_reduce_t *reduce, adc_channel_t channel,
+                                    const mq135_calibration_t *cal, telemetry_reading_t *reading) {
+    uint16_t mean_q4;
+    if (!adc_reduce_mean_q4(reduce, (uint8_t)channel, &mean_q4)) return ESP_ERR_NOT_FOUND;
+    uint16_t raw = adc_reduce_q4_to_raw(mean_q4);
+    reading->sensor = TELEMETRY_SENSOR_MQ135;
+    reading->mq135.adc_raw = raw;
+    reading->mq135.ppm = mq135_ppm(raw, cal);
+    return ESP_OK;
+}
+
+esp_err_t sensor_read_ldr_reduced(const adc_reduce_t *reduce, adc_channel_t channel, telemetry_reading_t *reading) {
+    uint16_t mean_q4;
+    if (!adc_reduce_mean_q4(reduce, (uint8_t)channel, &mean_q4)) return ESP_ERR_NOT_FOUND;
+    reading->sensor = TELEMETRY_SENSOR_LDR;
+    reading->ldr.ldr_raw = adc_reduce_q4_to_raw(mean_q4);
+    return ESP_OK;
+}
@@ -0,0 +1,39 @@
+#ifndef SENSOR_READ_H
+#define SENSOR_READ_H
+
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_continuous.h"
+#include "bmp280.h"
+#include "dht.h"
+
+#include "sensor_math.h"
+#include "telemetry_codec.h"
+#include "adc_reduce.h"
+
+// ======================================================
+// --- LEITURA DOS SENSORES ---
+// ======================================================
+// Lê o sensor pelo driver e preenche um telemetry_reading_t pronto para
+// telemetry_format_json/telemetry_encode_binary. Não publica nem registra
+// logs: o chamador decide o que fazer em caso de erro.
+
+esp_err_t sensor_read_bmp280(bmp280_t *dev, float altitude_m, telemetry_reading_t *reading);
+esp_err_t sensor_read_dht(dht_sensor_type_t type, gpio_num_t pin, telemetry_reading_t *reading);
+esp_err_t sensor_read_mq135(adc_oneshot_unit_handle_t adc, adc_channel_t channel,
+                            const mq135_calibration_t *cal, telemetry_reading_t *reading);
+esp_err_t sensor_read_ldr(adc_oneshot_unit_handle_t adc, adc_channel_t channel, telemetry_reading_t *reading);
+
+// --- ADC contínuo (DMA) ---
+// Rajada: inicia a conversão contínua já configurada, reduz frame_bytes de
+// amostras com adc_reduce (janela nova) e para o ADC. Uma única ativação do
+// ADC1 atende todos os canais do padrão configurado.
+esp_err_t sensor_read_adc_burst(adc_continuous_handle_t adc, adc_reduce_t *reduce, size_t frame_bytes, uint32_t timeout_ms);
+
+// Leituras a partir das médias da rajada (sem nova conversão)
+esp_err_t sensor_read_mq135_reduced(const adc_reduce_t *reduce, adc_channel_t channel,
+                                    const mq135_calibration_t *cal, telemetry_reading_t *reading);
+esp_err_t sensor_read_ldr_reduced(const adc_reduce_t *reduce, adc_channel_t channel, telemetry_reading_t *reading);
+
+#endif // SENSOR_READ_H
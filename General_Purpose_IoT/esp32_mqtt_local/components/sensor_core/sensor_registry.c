@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <string.h>
+#include "sensor_registry.h"
+
+static void registry_sample(void *ctx) {
+    sensor_registry_slot_t *slot = ctx;
+    sensor_registry_t *reg = slot->registry;
+    sensor_health_t *health = &slot->health;
+    telemetry_reading_t reading = { .sensor = slot->driver->sensor };
+    bool timed = reg->sink.clock_us && reg->sink.read_timed;
+    int64_t start_us = timed ? reg->sink.clock_us() : 0;
+    esp_err_t err = slot->driver->read(&reading);
+    if (timed) reg->sink.read_timed(slot->driver, err, start_us, reg->sink.clock_us(), reg->sink.ctx);
+    health->reads++;
+    if (err == ESP_OK) {
+        health->consecutive_failures = 0;
+        health->last_ok_ms = reg->clock_ms();
+        if (reg->sink.reading) reg->sink.reading(slot->driver, &reading, reg->sink.ctx);
+    } else {
+        health->failures++;
+        health->consecutive_failures++;
+        health->last_error = err;
+        if (reg->sink.failure) reg->sink.failure(slot->driver, err, health, reg->sink.ctx);
+    }
+}
+
+size_t sensor_registry_init(sensor_registry_t *reg, const sensor_driver_t *const *drivers, size_t count,
+                            sensor_scheduler_t *sched, const sensor_registry_sink_t *sink,
+                            int64_t (*clock_ms)(void)) {
+    memset(reg, 0, sizeof(*reg));
+    reg->sink = *sink;
+    reg->clock_ms = clock_ms;
+    for (size_t i = 0; i < count && reg->count < SENSOR_REGISTRY_MAX_DRIVERS; i++) {
+        const sensor_driver_t *driver = drivers[i];
+        if (driver->read == NULL) continue;
+        sensor_registry_slot_t *slot = &reg->slots[reg->count];
+        slot->registry = reg;
+        slot->driver = driver;
+        slot->health.last_ok_ms = -1;
+        slot->health.init_error = driver->init ? driver->init() : ESP_OK;
+        if (sensor_scheduler_register(sched, driver->name, driver->period_ms, driver->phase_ms,
+                                      registry_sample, slot, clock_ms()) < 0) {
+            continue;
+        }
+        reg->count++;
+    }
+    return reg->count;
+}
+
+const sensor_driver_t *sensor_registry_find(const sensor_registry_t *reg, telemetry_sensor_t sensor) {
+    for (size_t i = 0; i < reg->count; i++) {
+        if (reg->slots[i].driver->sensor == sensor) return reg->slots[i].driver;
+    }
+    return NULL;
+}
+
+size_t sensor_registry_encode(const sensor_driver_t *driver, const telemetry_reading_t *reading,
+                              const telemetry_meta_t *meta, bool binary, uint8_t *buf, size_t cap) {
+    if (driver->encode) return driver->encode(reading, meta, binary, buf, cap);
+    if (binary) return telemetry_encode_binary(reading, meta, buf, cap);
+    return telemetry_format_json(reading, meta, (char *)buf, cap);
+}
+
+int sensor_registry_format_health(const sensor_registry_t *reg, int64_t now_ms, char *buffer, size_t size) {
+    int written = snprintf(buffer, size, "{");
+    for (size_t i = 0; i < reg->count && written >= 0; i++) {
+        const sensor_health_t *health = &reg->slots[i].health;
+        int n = snprintf(buffer + written, size > (size_t)written ? size - written : 0,
+                         "%s\"%s\":{\"reads\":%lu,\"failures\":%lu,\"streak\":%lu,\"age_ms\":%lld}",
+                         i == 0 ? "" : ",", reg->slots[i].driver->name, (unsigned long)health->reads,
+                         (unsigned long)health->failures, (unsigned long)health->consecutive_failures,
+                         health->last_ok_ms < 0 ? -1LL : (long long)(now_ms - health->last_ok_ms));
+        written = n < 0 ? n : written + n;
+    }
+    if (written < 0) return written;
+    int n = snprintf(buffer + written, size > (size_t)written ? size - written : 0, "}");
+    return n < 0 ? n : written + n;
+}
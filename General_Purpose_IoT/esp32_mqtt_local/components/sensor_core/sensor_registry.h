@@ -0,0 +1,96 @@
+#ifndef SENSOR_REGISTRY_H
+#define SENSOR_REGISTRY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#include "sensor_scheduler.h"
+#include "telemetry_codec.h"
+
+// ======================================================
+// --- DRIVERS DE SENSOR E REGISTRO ---
+// ======================================================
+// Cada sensor é um sensor_driver_t constante (um arquivo por driver) com
+// init/read/encode, período, defasagem e tópico. O firmware monta uma tabela
+// estática de ponteiros para os drivers; o registro inicializa cada um, cadastra
+// no agendador e, a cada execução, chama read() e entrega a leitura ao
+// callback de publicação. Saúde (leituras, falhas, falhas seguidas) fica no
+// próprio registro, sem heap nem pilha por sensor: adicionar um sensor é
+// escrever o driver e acrescentá-lo à tabela.
+
+#ifndef SENSOR_REGISTRY_MAX_DRIVERS
+#define SENSOR_REGISTRY_MAX_DRIVERS 8
+#endif
+
+typedef struct sensor_driver sensor_driver_t;
+
+struct sensor_driver {
+    const char *name;              // Nome no agendador, nos logs e no lote
+    telemetry_sensor_t sensor;     // Id das leituras (telemetry_reading_t.sensor)
+    const char *topic;             // Tópico de publicação (sem o sufixo binário)
+    uint32_t period_ms;
+    uint32_t phase_ms;             // Defasagem da primeira leitura
+    esp_err_t (*init)(void);       // Opcional: configura o hardware no boot
+    esp_err_t (*read)(telemetry_reading_t *reading);
+    // Opcional: codificação própria (sensores fora de telemetry_codec, ids a
+    // partir de TELEMETRY_SENSOR_EXTERNAL). Retorna os bytes escritos ou 0.
+    size_t (*encode)(const telemetry_reading_t *reading, const telemetry_meta_t *meta,
+                     bool binary, uint8_t *buf, size_t cap);
+};
+
+typedef struct {
+    esp_err_t init_error;
+    esp_err_t last_error;
+    uint32_t reads;
+    uint32_t failures;
+    uint32_t consecutive_failures;
+    int64_t last_ok_ms;            // -1 até a primeira leitura válida
+} sensor_health_t;
+
+// Callbacks do firmware; ctx é o mesmo de sensor_registry_init
+typedef struct {
+    void (*reading)(const sensor_driver_t *driver, const telemetry_reading_t *reading, void *ctx);
+    void (*failure)(const sensor_driver_t *driver, esp_err_t err, const sensor_health_t *health, void *ctx);
+    // Opcionais: com os dois, cada read() é cronometrado por clock_us (µs) e
+    // read_timed recebe o intervalo antes de reading/failure
+    int64_t (*clock_us)(void);
+    void (*read_timed)(const sensor_driver_t *driver, esp_err_t err, int64_t start_us, int64_t end_us, void *ctx);
+    void *ctx;
+} sensor_registry_sink_t;
+
+typedef struct sensor_registry sensor_registry_t;
+
+typedef struct {
+    sensor_registry_t *registry;
+    const sensor_driver_t *driver;
+    sensor_health_t health;
+} sensor_registry_slot_t;
+
+struct sensor_registry {
+    sensor_registry_slot_t slots[SENSOR_REGISTRY_MAX_DRIVERS];
+    size_t count;
+    sensor_registry_sink_t sink;
+    int64_t (*clock_ms)(void);
+};
+
+// Inicializa os drivers e os cadastra em sched. Um driver cujo init falhou
+// continua agendado (o erro aparece na saúde e nas falhas de leitura). Retorna
+// quantos drivers foram cadastrados.
+size_t sensor_registry_init(sensor_registry_t *reg, const sensor_driver_t *const *drivers, size_t count,
+                            sensor_scheduler_t *sched, const sensor_registry_sink_t *sink,
+                            int64_t (*clock_ms)(void));
+
+// Driver das leituras com esse id (NULL se nenhum)
+const sensor_driver_t *sensor_registry_find(const sensor_registry_t *reg, telemetry_sensor_t sensor);
+
+// encode() do driver ou, sem ele, telemetry_encode_binary/telemetry_format_json
+size_t sensor_registry_encode(const sensor_driver_t *driver, const telemetry_reading_t *reading,
+                              const telemetry_meta_t *meta, bool binary, uint8_t *buf, size_t cap);
+
+// {"bmp280":{"reads":N,"failures":N,"streak":N,"age_ms":N},...}; age_ms é o
+// tempo desde a última leitura válida (-1 se nunca houve)
+int sensor_registry_format_health(const sensor_registry_t *reg, int64_t now_ms, char *buffer, size_t size);
+
+#endif // SENSOR_REGISTRY_H
@@ -0,0 +1,94 @@
+#include <string.h>
+#include "sensor_scheduler.h"
+
+// Ordem do heap: prazo mais próximo primeiro; empate resolvido pela ordem de registro
+static int entry_before(const sensor_scheduler_t *sched, uint8_t a, uint8_t b) {
+    int64_t due_a = sched->entries[a].next_due_ms;
+    int64_t due_b = sched->entries[b].next_due_ms;
+    if (due_a != due_b) return due_a < due_b;
+    return a < b;
+}
+
+static void heap_swap(sensor_scheduler_t *sched, size_t i, size_t j) {
+    uint8_t tmp = sched->heap[i];
+    sched->heap[i] = sched->heap[j];
+    sched->heap[j] = tmp;
+}
+
+static void heap_sift_up(sensor_scheduler_t *sched, size_t i) {
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!entry_before(sched, sched->heap[i], sched->heap[parent])) break;
+        heap_swap(sched, i, parent);
+        i = parent;
+    }
+}
+
+static void heap_sift_down(sensor_scheduler_t *sched, size_t i) {
+    while (1) {
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        size_t smallest = i;
+        if (left < sched->count && entry_before(sched, sched->heap[left], sched->heap[smallest])) smallest = left;
+        if (right < sched->count && entry_before(sched, sched->heap[right], sched->heap[smallest])) smallest = right;
+        if (smallest == i) break;
+        heap_swap(sched, i, smallest);
+        i = smallest;
+    }
+}
+
+void sensor_scheduler_init(sensor_scheduler_t *sched) {
+    memset(sched, 0, sizeof(*sched));
+}
+
+int sensor_scheduler_register(sensor_scheduler_t *sched, const char *name,
+                              uint32_t period_ms, uint32_t phase_ms,
+                              sensor_sample_fn_t sample, void *ctx, int64_t now_ms) {
+    if (sched->count >= SENSOR_SCHEDULER_MAX_ENTRIES || period_ms == 0 || sample == NULL) {
+        return -1;
+    }
+    uint8_t id = (uint8_t)sched->count;
+    sensor_schedule_entry_t *entry = &sched->entries[id];
+    entry->name = name;
+    entry->sample = sample;
+    entry->ctx = ctx;
+    entry->period_ms = period_ms;
+    entry->next_due_ms = now_ms + phase_ms;
+    entry->last_run_ms = 0;
+    entry->run_count = 0;
+    entry->skipped_periods = 0;
+
+    sched->heap[sched->count] = id;
+    sched->count++;
+    heap_sift_up(sched, sched->count - 1);
+    return id;
+}
+
+int64_t sensor_scheduler_next_deadline(const sensor_scheduler_t *sched) {
+    if (sched->count == 0) return INT64_MAX;
+    return sched->entries[sched->heap[0]].next_due_ms;
+}
+
+size_t sensor_scheduler_run_due(sensor_scheduler_t *sched, int64_t now_ms) {
+    size_t executed = 0;
+    while (sched->count > 0) {
+        sensor_schedule_entry_t *entry = &sched->entries[sched->heap[0]];
+        if (entry->next_due_ms > now_ms) break;
+
+        entry->sample(entry->ctx);
+        entry->last_run_ms = now_ms;
+        entry->run_count++;
+        executed++;
+
+        // Mantém a grade de tempo original (sem deriva). Se o laço atrasou mais
+        // de um período, os prazos perdidos são descartados em vez de disparados em rajada.
+        entry->next_due_ms += entry->period_ms;
+        if (entry->next_due_ms <= now_ms) {
+            int64_t missed = (now_ms - entry->next_due_ms) / entry->period_ms + 1;
+            entry->next_due_ms += missed * entry->period_ms;
+            entry->skipped_periods += (uint32_t)missed;
+        }
+        heap_sift_down(sched, 0);
+    }
+    return executed;
+}
@@ -0,0 +1,53 @@
+#ifndef SENSOR_SCHEDULER_H
+#define SENSOR_SCHEDULER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ======================================================
+// --- AGENDADOR DE AMOSTRAGEM DOS SENSORES ---
+// ======================================================
+// Uma única tarefa percorre um min-heap ordenado pelo próximo prazo
+// (next_due_ms) de cada sensor registrado. Cada sensor tem período e
+// defasagem próprios. O módulo não depende do FreeRTOS: o relógio é
+// passado pelo chamador, o que permite executá-lo no host.
+
+#ifndef SENSOR_SCHEDULER_MAX_ENTRIES
+#define SENSOR_SCHEDULER_MAX_ENTRIES 8
+#endif
+
+typedef void (*sensor_sample_fn_t)(void *ctx);
+
+typedef struct {
+    const char *name;
+    sensor_sample_fn_t sample;
+    void *ctx;
+    uint32_t period_ms;
+    int64_t next_due_ms;
+    int64_t last_run_ms;
+    uint32_t run_count;
+    uint32_t skipped_periods;   // Períodos perdidos por atraso do laço
+} sensor_schedule_entry_t;
+
+typedef struct {
+    sensor_schedule_entry_t entries[SENSOR_SCHEDULER_MAX_ENTRIES];
+    uint8_t heap[SENSOR_SCHEDULER_MAX_ENTRIES];   // Índices em entries[], ordenados por prazo
+    size_t count;
+} sensor_scheduler_t;
+
+void sensor_scheduler_init(sensor_scheduler_t *sched);
+
+// Registra um sensor. A primeira execução ocorre em now_ms + phase_ms.
+// Retorna o id da entrada ou -1 se a tabela estiver cheia ou o período for zero.
+int sensor_scheduler_register(sensor_scheduler_t *sched, const char *name,
+                              uint32_t period_ms, uint32_t phase_ms,
+                              sensor_sample_fn_t sample, void *ctx, int64_t now_ms);
+
+// Prazo absoluto da próxima amostragem (INT64_MAX se não houver sensores).
+int64_t sensor_scheduler_next_deadline(const sensor_scheduler_t *sched);
+
+// Executa, em ordem de prazo, todas as entradas vencidas até now_ms.
+// Retorna o número de callbacks executados.
+size_t sensor_scheduler_run_due(sensor_scheduler_t *sched, int64_t now_ms);
+
+#endif // SENSOR_SCHEDULER_H
@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <string.h>
+#include "telemetry_codec.h"
+
+const char *telemetry_sensor_name(telemetry_sensor_t sensor) {
+    switch (sensor) {
+        case TELEMETRY_SENSOR_BMP280: return "bmp280";
+        case TELEMETRY_SENSOR_DHT11: return "dht11";
+        case TELEMETRY_SENSOR_MQ135: return "mq135";
+        case TELEMETRY_SENSOR_LDR: return "ldr";
+        default: return "unknown";
+    }
+}
+
+static const char *const bmp280_fields[] = { "temperature", "pressure", "pressure_sea_level" };
+static const char *const dht11_fields[] = { "temperature", "humidity" };
+static const char *const mq135_fields[] = { "adc_raw", "ppm" };
+static const char *const ldr_fields[] = { "ldr_raw" };
+
+size_t telemetry_field_count(telemetry_sensor_t sensor) {
+    switch (sensor) {
+        case TELEMETRY_SENSOR_BMP280: return 3;
+        case TELEMETRY_SENSOR_DHT11: return 2;
+        case TELEMETRY_SENSOR_MQ135: return 2;
+        case TELEMETRY_SENSOR_LDR: return 1;
+        default: return 0;
+    }
+}
+
+const char *telemetry_field_name(telemetry_sensor_t sensor, size_t index) {
+    if (index >= telemetry_field_count(sensor)) return NULL;
+    switch (sensor) {
+        case TELEMETRY_SENSOR_BMP280: return bmp280_fields[index];
+        case TELEMETRY_SENSOR_DHT11: return dht11_fields[index];
+        case TELEMETRY_SENSOR_MQ135: return mq135_fields[index];
+        default: return ldr_fields[index];
+    }
+}
+
+float telemetry_field_value(const telemetry_reading_t *reading, size_t index) {
+    switch (reading->sensor) {
+        case TELEMETRY_SENSOR_BMP280:
+            return index == 0 ? reading->bmp280.temperature : index == 1 ? reading->bmp280.pressure_hpa : reading->bmp280.pressure_sea_level;
+        case TELEMETRY_SENSOR_DHT11:
+            return index == 0 ? reading->dht11.temperature : reading->dht11.humidity;
+        case TELEMETRY_SENSOR_MQ135:
+            return index == 0 ? (float)reading->mq135.adc_raw : reading->mq135.ppm;
+        case TELEMETRY_SENSOR_LDR:
+            return (float)reading->ldr.ldr_raw;
+        default:
+            return 0;
+    }
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t value) {
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)(value >> 8);
+    return p + 2;
+}
+
+static uint8_t *put_f32(uint8_t *p, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    p[0] = (uint8_t)(bits & 0xFF);
+    p[1] = (uint8_t)((bits >> 8) & 0xFF);
+    p[2] = (uint8_t)((bits >> 16) & 0xFF);
+    p[3] = (uint8_t)(bits >> 24);
+    return p + 4;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)((value >> 8) & 0xFF);
+    p[2] = (uint8_t)((value >> 16) & 0xFF);
+    p[3] = (uint8_t)(value >> 24);
+    return p + 4;
+}
+
+static uint8_t *put_u64(uint8_t *p, uint64_t value) {
+    p = put_u32(p, (uint32_t)(value & 0xFFFFFFFFu));
+    return put_u32(p, (uint32_t)(value >> 32));
+}
+
+static size_t meta_size(const telemetry_meta_t *meta) {
+    if (meta == NULL || meta->flags == 0) return 0;
+    size_t size = 1;
+    if (meta->flags & TELEMETRY_META_AGE) size += 4;
+    if (meta->flags & TELEMETRY_META_SEQ) size += 4;
+    if (meta->flags & TELEMETRY_META_TS) size += 8;
+    if (meta->flags & TELEMETRY_META_HOLD) size += 4;
+    return size;
+}
+
+static size_t payload_size(telemetry_sensor_t sensor) {
+    switch (sensor) {
+        case TELEMETRY_SENSOR_BMP280: return 12;
+        case TELEMETRY_SENSOR_DHT11: return 8;
+        case TELEMETRY_SENSOR_MQ135: return 6;
+        case TELEMETRY_SENSOR_LDR: return 2;
+        default: return 0;
+    }
+}
+
+size_t telemetry_encode_binary(const telemetry_reading_t *reading, const telemetry_meta_t *meta,
+                               uint8_t *buf, size_t cap) {
+    size_t size = payload_size(reading->sensor);
+    size_t extra = meta_size(meta);
+    if (size == 0 || cap < TELEMETRY_HEADER_SIZE + extra + size) return 0;
+
+    uint8_t *p = buf;
+    *p++ = extra ? TELEMETRY_CODEC_VERSION_META : TELEMETRY_CODEC_VERSION;
+    *p++ = (uint8_t)reading->sensor;
+    if (extra) {
+        *p++ = meta->flags;
+        if (meta->flags & TELEMETRY_META_AGE) p = put_u32(p, meta->age_ms);
+        if (meta->flags & TELEMETRY_META_SEQ) p = put_u32(p, meta->seq);
+        if (meta->flags & TELEMETRY_META_TS) p = put_u64(p, (uint64_t)meta->ts_ms);
+        if (meta->flags & TELEMETRY_META_HOLD) p = put_u32(p, meta->hold_ms);
+    }
+    switch (reading->sensor) {
+        case TELEMETRY_SENSOR_BMP280:
+            p = put_f32(p, reading->bmp280.temperature);
+            p = put_f32(p, reading->bmp280.pressure_hpa);
+            p = put_f32(p, reading->bmp280.pressure_sea_level);
+            break;
+        case TELEMETRY_SENSOR_DHT11:
+            p = put_f32(p, reading->dht11.temperature);
+            p = put_f32(p, reading->dht11.humidity);
+            break;
+        case TELEMETRY_SENSOR_MQ135:
+            p = put_u16(p, reading->mq135.adc_raw);
+            p = put_f32(p, reading->mq135.ppm);
+            break;
+        case TELEMETRY_SENSOR_LDR:
+            p = put_u16(p, reading->ldr.ldr_raw);
+            break;
+        default:
+            return 0;   // Sensor externo: o driver codifica
+    }
+    return (size_t)(p - buf);
+}
+
+size_t telemetry_format_json(const telemetry_reading_t *reading, const telemetry_meta_t *meta,
+                             char *buf, size_t cap) {
+    int written = -1;
+    switch (reading->sensor) {
+        case TELEMETRY_SENSOR_BMP280:
+            written = snprintf(buf, cap, "{\"temperature\":%.2f,\"pressure\":%.2f,\"pressure_sea_level\":%.2f}",
+                               reading->bmp280.temperature, reading->bmp280.pressure_hpa, reading->bmp280.pressure_sea_level);
+            break;
+        case TELEMETRY_SENSOR_DHT11:
+            written = snprintf(buf, cap, "{\"temperature\":%.1f,\"humidity\":%.1f}",
+                               reading->dht11.temperature, reading->dht11.humidity);
+            break;
+        case TELEMETRY_SENSOR_MQ135:
+            written = snprintf(buf, cap, "{\"adc_raw\":%d,\"ppm\":%.2f}", reading->mq135.adc_raw, reading->mq135.ppm);
+            break;
+        case TELEMETRY_SENSOR_LDR:
+            written = snprintf(buf, cap, "{\"ldr_raw\":%d}", reading->ldr.ldr_raw);
+            break;
+        default:
+            break;
+    }
+    if (written < 0 || (size_t)written >= cap) return 0;
+    return telemetry_json_append_meta(buf, (size_t)written, cap, meta);
+}
+
+size_t telemetry_json_append_meta(char *buf, size_t len, size_t cap, const telemetry_meta_t *meta) {
+    int written;
+    if (meta == NULL || meta->flags == 0) return len;
+    if (len < 2 || buf[len - 1] != '}') return 0;
+
+    // Reabre o objeto: troca o '}' final pelos metadados
+    len--;
+    if (meta->flags & TELEMETRY_META_AGE) {
+        written = snprintf(buf + len, cap - len, ",\"age_ms\":%lu", (unsigned long)meta->age_ms);
+        if (written < 0 || (size_t)written >= cap - len) return 0;
+        len += (size_t)written;
+    }
+    if (meta->flags & TELEMETRY_META_SEQ) {
+        written = snprintf(buf + len, cap - len, ",\"seq\":%lu", (unsigned long)meta->seq);
+        if (written < 0 || (size_t)written >= cap - len) return 0;
+        len += (size_t)written;
+    }
+    if (meta->flags & TELEMETRY_META_TS) {
+        written = snprintf(buf + len, cap - len, ",\"ts\":%lld", (long long)meta->ts_ms);
+        if (written < 0 || (size_t)written >= cap - len) return 0;
+        len += (size_t)written;
+    }
+    if (meta->flags & TELEMETRY_META_HOLD) {
+        written = snprintf(buf + len, cap - len, ",\"hold_ms\":%lu", (unsigned long)meta->hold_ms);
+        if (written < 0 || (size_t)written >= cap - len) return 0;
+        len += (size_t)written;
+    }
+    if (len + 2 > cap) return 0;
+    buf[len++] = '}';
+    buf[len] = '\0';
+    return len;
+}
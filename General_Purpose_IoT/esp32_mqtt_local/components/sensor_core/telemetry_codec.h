@@ -0,0 +1,94 @@
+#ifndef TELEMETRY_CODEC_H
+#define TELEMETRY_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ======================================================
+// --- CODIFICAÇÃO DAS LEITURAS (JSON OU BINÁRIO) ---
+// ======================================================
+// Formato binário (little-endian, sem alocação):
+//   v1: [versão u8 = 1][sensor u8][campos do sensor]
+//   v2: [versão u8 = 2][sensor u8][flags u8][metadados][campos do sensor]
+//   bmp280: temperature f32, pressure (hPa) f32, pressure_sea_level f32
+//   dht11:  temperature f32, humidity f32
+//   mq135:  adc_raw u16, ppm f32
+//   ldr:    ldr_raw u16
+// Metadados v2, na ordem dos bits de flags presentes:
+//   TELEMETRY_META_AGE: age_ms u32 (atraso entre a amostra e o envio)
+//   TELEMETRY_META_SEQ: seq u32 (número da leitura no dispositivo)
+//   TELEMETRY_META_TS:  ts u64 (instante da amostra, epoch em ms)
+//   TELEMETRY_META_HOLD: hold_ms u32 (validade do valor: publicação por
+//                        banda morta, ver publish_policy.h)
+// Leituras sem metadados continuam em v1. Registros são autodelimitados
+// pelo id do sensor e pelas flags, então um lote binário é apenas a
+// concatenação de registros. No JSON, os metadados viram campos extras
+// do objeto ("age_ms", "seq", "ts", "hold_ms").
+
+#define TELEMETRY_CODEC_VERSION 1
+#define TELEMETRY_CODEC_VERSION_META 2
+#define TELEMETRY_HEADER_SIZE 2
+#define TELEMETRY_META_MAX_SIZE 21     // flags u8 + age_ms u32 + seq u32 + ts u64 + hold_ms u32
+#define TELEMETRY_MAX_RECORD_SIZE (TELEMETRY_HEADER_SIZE + TELEMETRY_META_MAX_SIZE + 12)
+
+#define TELEMETRY_META_AGE 0x01
+#define TELEMETRY_META_SEQ 0x02
+#define TELEMETRY_META_TS 0x04
+#define TELEMETRY_META_HOLD 0x08
+
+#define TELEMETRY_MAX_FIELDS 3   // Campos do maior sensor (bmp280)
+
+typedef enum {
+    TELEMETRY_SENSOR_BMP280 = 1,
+    TELEMETRY_SENSOR_DHT11 = 2,
+    TELEMETRY_SENSOR_MQ135 = 3,
+    TELEMETRY_SENSOR_LDR = 4,
+    // A partir daqui: sensores fora deste codec, com encode() próprio no driver
+    // (ver sensor_registry.h) e campos em telemetry_reading_t.external
+    TELEMETRY_SENSOR_EXTERNAL = 0x80,
+} telemetry_sensor_t;
+
+typedef struct {
+    telemetry_sensor_t sensor;
+    union {
+        struct { float temperature, pressure_hpa, pressure_sea_level; } bmp280;
+        struct { float temperature, humidity; } dht11;
+        struct { uint16_t adc_raw; float ppm; } mq135;
+        struct { uint16_t ldr_raw; } ldr;
+        struct { float values[TELEMETRY_MAX_FIELDS]; } external;
+    };
+} telemetry_reading_t;
+
+// Metadados opcionais de uma leitura; só os campos com o bit em flags são enviados
+typedef struct {
+    uint8_t flags;
+    uint32_t age_ms;
+    uint32_t seq;
+    int64_t ts_ms;
+    uint32_t hold_ms;
+} telemetry_meta_t;
+
+// Nome usado nos tópicos e no campo "sensor" dos lotes
+const char *telemetry_sensor_name(telemetry_sensor_t sensor);
+
+// Acesso genérico aos campos numéricos, na ordem do registro binário
+// (ex.: bmp280 -> temperature, pressure, pressure_sea_level).
+size_t telemetry_field_count(telemetry_sensor_t sensor);
+const char *telemetry_field_name(telemetry_sensor_t sensor, size_t index);
+float telemetry_field_value(const telemetry_reading_t *reading, size_t index);
+
+// Retorna o número de bytes escritos ou 0 se o buffer for pequeno demais.
+// meta pode ser NULL (registro v1).
+size_t telemetry_encode_binary(const telemetry_reading_t *reading, const telemetry_meta_t *meta,
+                               uint8_t *buf, size_t cap);
+
+// Gera o objeto JSON histórico do sensor, mais os metadados presentes em meta
+// (que pode ser NULL). Retorna o tamanho ou 0 se não couber.
+size_t telemetry_format_json(const telemetry_reading_t *reading, const telemetry_meta_t *meta,
+                             char *buf, size_t cap);
+
+// Acrescenta os metadados ao objeto JSON de len bytes em buf (para encode()
+// de drivers externos). Retorna o novo tamanho ou 0 se não couber.
+size_t telemetry_json_append_meta(char *buf, size_t len, size_t cap, const telemetry_meta_t *meta);
+
+#endif // TELEMETRY_CODEC_H
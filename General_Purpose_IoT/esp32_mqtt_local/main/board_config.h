@@ -18,6 +18,54 @@
 #define MQTT_SENSOR_DHT11_TOPIC   DEVICE_ID "/sensor/dht11"
 #define MQTT_SENSOR_MQ135_TOPIC   DEVICE_ID "/sensor/mq135"
 #define MQTT_SENSOR_LDR_TOPIC     DEVICE_ID "/sensor/ldr"
+#define MQTT_SENSOR_BATCH_TOPIC   DEVICE_ID "/sensor/batch"
+#define MQTT_SENSOR_HEALTH_TOPIC  DEVICE_ID "/status/sensors"   // Saúde dos drivers, junto com o heartbeat
+#define MQTT_SYSTEM_METRICS_TOPIC DEVICE_ID "/system/metrics"   // Métricas de execução (ver runtime_metrics.h)
+#define MQTT_SYSTEM_LOGS_REQUEST_TOPIC DEVICE_ID "/system/logs/get"   // Qualquer mensagem pede o anel de logs (ver hot_log.h)
+#define MQTT_SYSTEM_LOGS_TOPIC    DEVICE_ID "/system/logs"      // Resposta: linhas do anel, da mais antiga para a mais nova
+
+// Modo lote: agrupa as leituras feitas dentro da janela em um único PUBLISH
+// no tópico MQTT_SENSOR_BATCH_TOPIC em vez de um PUBLISH por sensor
+#define MQTT_BATCH_MODE_ENABLED 0
+#define SENSOR_BATCH_WINDOW_MS 2000      // Idade máxima da leitura mais antiga do lote
+#define SENSOR_BATCH_MAX_READINGS 4      // Envia assim que o lote atingir esse número de leituras
+
+// Publicação por mudança dos sensores lentos (BMP280 e DHT11): a leitura só é
+// enviada quando algum campo varia mais que a banda morta desde o último envio
+// ou após SENSOR_MAX_SILENCE_MS sem envio (ver publish_policy.h). 0 publica tudo.
+#define PUBLISH_POLICY_ENABLED 1
+#define SENSOR_MAX_SILENCE_MS 60000
+#define BMP280_TEMPERATURE_DEADBAND 0.2f   // °C
+#define BMP280_PRESSURE_DEADBAND 0.5f      // hPa (pressão medida e ao nível do mar)
+#define DHT11_TEMPERATURE_DEADBAND 0.5f    // °C (resolução do DHT11: 1 °C)
+#define DHT11_HUMIDITY_DEADBAND 1.5f       // % (resolução do DHT11: 1 %)
+
+// Modo de baixo consumo (baterias): as leituras esperam na fila offline (com
+// age_ms) e saem, com o heartbeat e as métricas vencidos, numa única rajada por
+// LOW_POWER_BURST_PERIOD_MS. Entre as rajadas o Wi-Fi fica em modem sleep
+// (light sleep com CONFIG_PM_ENABLE e tickless idle) e o keepalive é esticado
+// para o PINGREQ não acordar o rádio. O modo lote deixa de ser usado. Neste
+// firmware o PWM do LED (LEDC) e o controle de luz a cada
+// LIGHT_CONTROL_PERIOD_MS limitam o light sleep. Ver radio_burst.h no
+// componente compartilhado.
+#define LOW_POWER_MODE_ENABLED 0
+#define LOW_POWER_BURST_PERIOD_MS 30000   // Maior atraso adicionado a uma leitura
+#define LOW_POWER_BURST_PHASE_MS 1900     // Logo depois da última leitura do período de 2 s (LIGHT_SENSOR_READ_PHASE_MS)
+#define LOW_POWER_BURST_LINGER_MS 300     // Rádio acordado após a rajada (ACKs do TCP)
+#define LOW_POWER_LISTEN_INTERVAL 10      // Beacons entre despertares do modem sleep (~1 s)
+#define LOW_POWER_KEEPALIVE_SECONDS 120   // 12x o padrão: bem menos PINGREQ acordando o rádio
+
+// Relógio: SNTP para o instante de cada leitura ("ts"). Defina SNTP_FALLBACK_SERVER
+// em credentials.h (ex.: o IP do Raspberry Pi) para um servidor local de reserva.
+#define SNTP_SERVER "pool.ntp.org"
+#define SNTP_FALLBACK_TIMEOUT_MS 30000   // Sem sincronizar nesse prazo, usa SNTP_FALLBACK_SERVER
+
+// Codificação das leituras: JSON (padrão) ou registro binário de tamanho fixo
+// (ver telemetry_codec.h). Em modo binário o tópico recebe o sufixo "/bin".
+#define TELEMETRY_ENCODING_JSON 0
+#define TELEMETRY_ENCODING_BINARY 1
+#define TELEMETRY_ENCODING TELEMETRY_ENCODING_JSON
+#define MQTT_BINARY_TOPIC_SUFFIX "/bin"
 
 // ======================================================
 // --- CONFIGURAÇÕES DE PINOS (GPIO) E SENSORES ---
@@ -31,6 +79,7 @@
 #define LIGHT_SENSOR_ADC_CHANNEL ADC_CHANNEL_5
 #define LIGHT_SENSOR_THRESHOLD_RED 1365
 #define LIGHT_SENSOR_THRESHOLD_GREEN 2730
+#define LIGHT_SENSOR_HYSTERESIS 100    // Contagens do ADC além do limiar para trocar de cor
 #define ADC_RESOLUTION_12_BITS 4095.0  // Resolução ADC (12 bits)
 #define I2C_MASTER_SCL_IO GPIO_NUM_22
 #define I2C_MASTER_SDA_IO GPIO_NUM_21
@@ -42,6 +91,29 @@
 #define ADC_BITWIDTH ADC_BITWIDTH_12
 #define ALTITUDE 27.0f  // Altitude do local em metros
 
+// Aquisição do MQ-135 e do LDR: uma conversão one-shot por leitura (padrão) ou
+// rajada do ADC contínuo (DMA) nos dois canais, reduzida por mediana de 3 e média
+// (ver adc_reduce.h). No modo contínuo os dois sensores são lidos juntos no
+// período e na fase do MQ-135.
+#define ADC_ACQUISITION_ONESHOT 0
+#define ADC_ACQUISITION_CONTINUOUS 1
+#define ADC_ACQUISITION_MODE ADC_ACQUISITION_ONESHOT
+#define ADC_CONTINUOUS_SAMPLE_FREQ_HZ 20000  // Mínimo do ADC contínuo no ESP32
+#define ADC_BURST_BYTES 256                  // 128 conversões (64 por canal), ~6,4 ms a 20 kHz
+#define ADC_BURST_TIMEOUT_MS 50
+#define ADC_BURST_REUSE_MS 100               // MQ-135 e LDR leem a mesma rajada dentro desse intervalo
+
+// LED RGB controlado pelo LDR: PWM do LEDC com transição suave entre as cores
+#define LIGHT_LEDC_MODE LEDC_LOW_SPEED_MODE
+#define LIGHT_LEDC_TIMER LEDC_TIMER_0
+#define LIGHT_LEDC_FREQ_HZ 5000
+#define LIGHT_LEDC_RESOLUTION LEDC_TIMER_10_BIT
+#define LIGHT_LEDC_DUTY_MAX 1023
+#define LIGHT_LEDC_RED_CHANNEL LEDC_CHANNEL_0
+#define LIGHT_LEDC_GREEN_CHANNEL LEDC_CHANNEL_1
+#define LIGHT_LEDC_BLUE_CHANNEL LEDC_CHANNEL_2
+#define LIGHT_FADE_MS 150              // Duração da transição entre cores
+
 // ======================================================
 // --- CONFIGURAÇÕES DO SENSOR MQ-135 ---
 // ======================================================
@@ -59,29 +131,43 @@
 #define BMP280_FILTER BMP280_FILTER_16
 #define BMP280_OVERSAMPLING BMP280_ULTRA_HIGH_RES
 #define BMP280_STANDBY BMP280_STANDBY_250
-#define PA_TO_HPA 0.01f  // Conversão de Pascal para hPa
-#define STANDARD_LAPSE_RATE 0.0065 // K/m
-#define SEA_LEVEL_TEMP_K 273.15 // K
-#define EXPONENT 5.257  // Exponente para cálculo da pressão
+// Constantes da fórmula barométrica: ver sensor_math.h (componente sensor_core)
 
 // ======================================================
 // --- CONFIGURAÇÕES DE BUFFER ---
 // ======================================================
-#define BMP280_BUFFER_SIZE 256
-#define DHT11_BUFFER_SIZE 128
-#define MQ135_BUFFER_SIZE 128
-#define LDR_BUFFER_SIZE 64
+#define SENSOR_PAYLOAD_BUFFER_SIZE 160  // Maior payload JSON de um sensor (BMP280, ~70 bytes, +75 com age_ms, seq, ts e hold_ms)
+#define SENSOR_HEALTH_BUFFER_SIZE 384   // JSON de saúde dos drivers (~75 bytes por sensor)
+
+// Fila offline: leituras feitas sem conexão com o broker (24 bytes cada).
+// 1024 leituras cobrem ~8 min com os períodos atuais (2 leituras/s).
+#define OFFLINE_BUFFER_CAPACITY 1024
+#define OFFLINE_DRAIN_BURST 8            // Leituras enviadas por rodada após reconectar
+#define OFFLINE_DRAIN_INTERVAL_MS 100    // Intervalo entre rodadas (~80 leituras/s)
 
 // ======================================================
 // --- CONFIGURAÇÕES DE TAREFAS ---
 // ======================================================
-#define HEARTBEAT_TASK_STACK_SIZE 3072
-#define SENSOR_TASK_STACK_SIZE 4096
+#define SAMPLING_TASK_STACK_SIZE 4096  // Tarefa única que executa todos os sensores
 #define TASK_PRIORITY 5
+// Laço de controle do LED pelo LDR, independente da publicação e do MQTT (modo
+// one-shot; no modo contínuo o LED acompanha as rajadas do ADC)
+#define LIGHT_CONTROL_TASK_STACK_SIZE 2048
+#define LIGHT_CONTROL_TASK_PRIORITY (TASK_PRIORITY + 1)
+#define LIGHT_CONTROL_PERIOD_MS 20
 #define HEARTBEAT_INTERVAL 20000
+#define METRICS_INTERVAL_MS 60000      // Janela das métricas de execução em MQTT_SYSTEM_METRICS_TOPIC
 #define BMP280_READ_INTERVAL 2000
 #define DHT11_READ_INTERVAL 2000
 #define MQ135_READ_INTERVAL 2000
 #define LIGHT_SENSOR_READ_INTERVAL 2000
 
+// Defasagem da primeira leitura de cada sensor (espalha as leituras dentro do período)
+#define HEARTBEAT_PHASE_MS 0
+#define METRICS_PHASE_MS 250
+#define BMP280_READ_PHASE_MS 0
+#define DHT11_READ_PHASE_MS 500
+#define MQ135_READ_PHASE_MS 1000
+#define LIGHT_SENSOR_READ_PHASE_MS 1500
+
 #endif // BOARD_CONFIG_H
@@ -0,0 +1,101 @@
+#include <stdbool.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_continuous.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "sensor_drivers.h"
+#include "sensor_read.h"
+
+static const char *TAG = "SENSOR_ADC";
+
+static bool adc_ready = false;
+
+#if ADC_ACQUISITION_MODE == ADC_ACQUISITION_CONTINUOUS
+#if SOC_ADC_DIGI_RESULT_BYTES != ADC_REDUCE_RESULT_BYTES
+#error "adc_reduce espera amostras TYPE1 de 2 bytes (ESP32)"
+#endif
+static adc_continuous_handle_t adc_continuous_handle;
+static adc_reduce_t adc_reduce;
+static int64_t last_burst_us = INT64_MIN / 2;
+static esp_err_t last_burst_err = ESP_FAIL;
+
+esp_err_t sensor_adc_init(void) {
+    static const uint8_t channels[] = { MQ135_ADC_CHANNEL, LIGHT_SENSOR_ADC_CHANNEL };
+    if (adc_ready) return ESP_OK;
+    adc_continuous_handle_cfg_t handle_config = {
+        .max_store_buf_size = ADC_BURST_BYTES * 2,
+        .conv_frame_size = ADC_BURST_BYTES,
+    };
+    esp_err_t err = adc_continuous_new_handle(&handle_config, &adc_continuous_handle);
+    if (err != ESP_OK) return err;
+    adc_digi_pattern_config_t pattern[2];
+    for (size_t i = 0; i < 2; i++) {
+        pattern[i] = (adc_digi_pattern_config_t){
+            .atten = ADC_ATTEN_DB_12, .channel = channels[i], .unit = ADC_UNIT_1, .bit_width = ADC_BITWIDTH_12,
+        };
+    }
+    adc_continuous_config_t config = {
+        .pattern_num = 2,
+        .adc_pattern = pattern,
+        .sample_freq_hz = ADC_CONTINUOUS_SAMPLE_FREQ_HZ,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+    };
+    err = adc_continuous_config(adc_continuous_handle, &config);
+    if (err != ESP_OK) return err;
+    adc_reduce_init(&adc_reduce, channels, 2);
+    adc_ready = true;
+    ESP_LOGI(TAG, "[%s] ADC1 contínuo: CH%d (MQ135) e CH%d (Light Sensor), rajadas de %d bytes a %d Hz.",
+             DEVICE_ID, MQ135_ADC_CHANNEL, LIGHT_SENSOR_ADC_CHANNEL, ADC_BURST_BYTES, ADC_CONTINUOUS_SAMPLE_FREQ_HZ);
+    return ESP_OK;
+}
+
+esp_err_t sensor_adc_burst(const adc_reduce_t **reduce) {
+    int64_t now_us = esp_timer_get_time();
+    *reduce = &adc_reduce;
+    if (now_us - last_burst_us < (int64_t)ADC_BURST_REUSE_MS * 1000) return last_burst_err;
+    last_burst_us = now_us;
+    last_burst_err = adc_ready ? sensor_read_adc_burst(adc_continuous_handle, &adc_reduce, ADC_BURST_BYTES, ADC_BURST_TIMEOUT_MS)
+                               : ESP_ERR_INVALID_STATE;
+    if (last_burst_err == ESP_OK && adc_reduce.discarded > 0) {
+        ESP_LOGW(TAG, "[%s] %lu amostras de canais inesperados descartadas", DEVICE_ID, (unsigned long)adc_reduce.discarded);
+    }
+    return last_burst_err;
+}
+#else
+static adc_oneshot_unit_handle_t adc1_handle;
+// adc_oneshot_read não é thread-safe para a mesma unidade: a sampling_task (MQ-135
+// e LDR) e a light_control_task se revezam no ADC1 por este mutex
+static StaticSemaphore_t adc_lock_storage;
+static SemaphoreHandle_t adc_lock;
+
+esp_err_t sensor_adc_init(void) {
+    if (adc_lock == NULL) adc_lock = xSemaphoreCreateMutexStatic(&adc_lock_storage);
+    if (adc_ready) return ESP_OK;
+    adc_oneshot_unit_init_cfg_t init_config = { .unit_id = ADC_UNIT_1 };
+    esp_err_t err = adc_oneshot_new_unit(&init_config, &adc1_handle);
+    if (err != ESP_OK) return err;
+    adc_oneshot_chan_cfg_t chan_config = { .atten = ADC_ATTEN_DB_12, .bitwidth = ADC_BITWIDTH_12 };
+    if ((err = adc_oneshot_config_channel(adc1_handle, MQ135_ADC_CHANNEL, &chan_config)) != ESP_OK) return err;
+    ESP_LOGI(TAG, "[%s] ADC1 CH%d (MQ135) configurado.", DEVICE_ID, MQ135_ADC_CHANNEL);
+    if ((err = adc_oneshot_config_channel(adc1_handle, LIGHT_SENSOR_ADC_CHANNEL, &chan_config)) != ESP_OK) return err;
+    ESP_LOGI(TAG, "[%s] ADC1 CH%d (Light Sensor) configurado.", DEVICE_ID, LIGHT_SENSOR_ADC_CHANNEL);
+    adc_ready = true;
+    return ESP_OK;
+}
+
+adc_oneshot_unit_handle_t sensor_adc_oneshot(void) {
+    return adc1_handle;
+}
+
+void sensor_adc_lock(void) {
+    if (adc_lock) xSemaphoreTake(adc_lock, portMAX_DELAY);
+}
+
+void sensor_adc_unlock(void) {
+    if (adc_lock) xSemaphoreGive(adc_lock);
+}
+#endif
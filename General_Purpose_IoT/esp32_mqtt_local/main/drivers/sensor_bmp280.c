@@ -0,0 +1,57 @@
+#include <string.h>
+#include "esp_log.h"
+#include "hot_log.h"
+#include "bmp280.h"
+#include "i2cdev.h"
+
+#include "sensor_drivers.h"
+#include "sensor_read.h"
+
+static const char *TAG = "BMP280";
+
+static bmp280_t bmp280_dev;
+
+static esp_err_t bmp280_driver_init(void) {
+    ESP_LOGI(TAG, "[%s] Iniciando init_bmp280()...", DEVICE_ID);
+    esp_err_t err = i2cdev_init();
+    if (err != ESP_OK) return err;
+    memset(&bmp280_dev, 0, sizeof(bmp280_t));
+    err = bmp280_init_desc(&bmp280_dev, BMP280_I2C_ADDR, I2C_NUM_0, I2C_MASTER_SDA_IO, I2C_MASTER_SCL_IO);
+    if (err != ESP_OK) return err;
+    bmp280_params_t params;
+    bmp280_init_default_params(&params);
+    params.mode = BMP280_MODE_NORMAL;
+    params.filter = BMP280_FILTER_16;
+    params.oversampling_pressure = BMP280_ULTRA_HIGH_RES;
+    params.oversampling_temperature = BMP280_ULTRA_HIGH_RES;
+    params.standby = BMP280_STANDBY_250;
+    err = bmp280_init(&bmp280_dev, &params);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "[%s] Falha ao inicializar BMP280: %s", DEVICE_ID, esp_err_to_name(err));
+        return err;
+    }
+    ESP_LOGI(TAG, "[%s] BMP280 inicializado com sucesso, Chip ID: 0x%x", DEVICE_ID, bmp280_dev.id);
+    if (bmp280_dev.id != BMP280_CHIP_ID && bmp280_dev.id != BME280_CHIP_ID) {
+        ESP_LOGE(TAG, "[%s] ID do chip BMP280 inválido: 0x%x", DEVICE_ID, bmp280_dev.id);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t bmp280_driver_read(telemetry_reading_t *reading) {
+    esp_err_t err = sensor_read_bmp280(&bmp280_dev, ALTITUDE, reading);
+    if (err == ESP_OK) {
+        HOT_LOGI(TAG, "[%s] Raw temperature: %.2f C, Raw pressure: %.2f hPa, Sea-level pressure: %.2f hPa",
+                 DEVICE_ID, reading->bmp280.temperature, reading->bmp280.pressure_hpa, reading->bmp280.pressure_sea_level);
+    }
+    return err;
+}
+
+const sensor_driver_t bmp280_driver = {
+    .name = "bmp280",
+    .sensor = TELEMETRY_SENSOR_BMP280,
+    .topic = MQTT_SENSOR_BMP280_TOPIC,
+    .period_ms = BMP280_READ_INTERVAL,
+    .phase_ms = BMP280_READ_PHASE_MS,
+    .init = bmp280_driver_init,
+    .read = bmp280_driver_read,
+};
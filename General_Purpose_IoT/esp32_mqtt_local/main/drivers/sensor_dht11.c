@@ -0,0 +1,26 @@
+#include "esp_log.h"
+#include "dht.h"
+
+#include "sensor_drivers.h"
+#include "sensor_read.h"
+
+static const char *TAG = "DHT11";
+
+static esp_err_t dht11_driver_init(void) {
+    ESP_LOGI(TAG, "[%s] DHT11 no GPIO %d pronto para leitura.", DEVICE_ID, DHT11_GPIO);
+    return ESP_OK;
+}
+
+static esp_err_t dht11_driver_read(telemetry_reading_t *reading) {
+    return sensor_read_dht(DHT11_SENSOR_TYPE, DHT11_GPIO, reading);
+}
+
+const sensor_driver_t dht11_driver = {
+    .name = "dht11",
+    .sensor = TELEMETRY_SENSOR_DHT11,
+    .topic = MQTT_SENSOR_DHT11_TOPIC,
+    .period_ms = DHT11_READ_INTERVAL,
+    .phase_ms = DHT11_READ_PHASE_MS,
+    .init = dht11_driver_init,
+    .read = dht11_driver_read,
+};
@@ -0,0 +1,43 @@
+#ifndef SENSOR_DRIVERS_H
+#define SENSOR_DRIVERS_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_adc/adc_oneshot.h"
+
+#include "board_config.h"
+#include "sensor_registry.h"
+#include "adc_reduce.h"
+
+// ======================================================
+// --- DRIVERS DOS SENSORES DO FIRMWARE LOCAL ---
+// ======================================================
+// Um arquivo por driver (ver sensor_registry.h). A tabela com a ordem de
+// registro fica em esp32_mqtt_local.c; pinos, tópicos, períodos e fases vêm
+// do board_config.h.
+
+extern const sensor_driver_t bmp280_driver;
+extern const sensor_driver_t dht11_driver;
+extern const sensor_driver_t mq135_driver;
+extern const sensor_driver_t ldr_driver;
+
+// --- ADC1 compartilhado pelo MQ-135 e pelo LDR ---
+// Idempotente: o init de cada driver de ADC chama.
+esp_err_t sensor_adc_init(void);
+
+#if ADC_ACQUISITION_MODE == ADC_ACQUISITION_CONTINUOUS
+// Médias da rajada do ADC contínuo. Uma rajada feita há menos de
+// ADC_BURST_REUSE_MS é reaproveitada (com o mesmo resultado), então drivers
+// agendados no mesmo instante leem a mesma rajada.
+esp_err_t sensor_adc_burst(const adc_reduce_t **reduce);
+#else
+adc_oneshot_unit_handle_t sensor_adc_oneshot(void);
+// Toda leitura do handle acima fica entre lock e unlock (o ADC1 é lido por duas tarefas)
+void sensor_adc_lock(void);
+void sensor_adc_unlock(void);
+#endif
+
+// Em esp32_mqtt_local.c: leitura do LDR para a cor do LED (err != ESP_OK apaga)
+void light_leds_feed(esp_err_t err, uint16_t raw);
+
+#endif // SENSOR_DRIVERS_H
@@ -0,0 +1,40 @@
+#include "esp_log.h"
+#include "hot_log.h"
+
+#include "sensor_drivers.h"
+#include "sensor_read.h"
+
+static const char *TAG = "LDR_SENSOR";
+
+static esp_err_t ldr_driver_read(telemetry_reading_t *reading) {
+#if ADC_ACQUISITION_MODE == ADC_ACQUISITION_CONTINUOUS
+    const adc_reduce_t *reduce;
+    esp_err_t err = sensor_adc_burst(&reduce);
+    if (err == ESP_OK) err = sensor_read_ldr_reduced(reduce, LIGHT_SENSOR_ADC_CHANNEL, reading);
+    // Sem light_control_task no modo contínuo: o LED acompanha as rajadas
+    light_leds_feed(err, err == ESP_OK ? reading->ldr.ldr_raw : 0);
+#else
+    sensor_adc_lock();
+    esp_err_t err = sensor_read_ldr(sensor_adc_oneshot(), LIGHT_SENSOR_ADC_CHANNEL, reading);
+    sensor_adc_unlock();
+#endif
+    if (err == ESP_OK) HOT_LOGI(TAG, "[%s] LDR ADC reading: %d", DEVICE_ID, reading->ldr.ldr_raw);
+    return err;
+}
+
+// No modo contínuo o LDR sai da mesma rajada do MQ-135 (mesmo período e fase;
+// registrado depois dele, reaproveita a rajada)
+const sensor_driver_t ldr_driver = {
+    .name = "ldr",
+    .sensor = TELEMETRY_SENSOR_LDR,
+    .topic = MQTT_SENSOR_LDR_TOPIC,
+#if ADC_ACQUISITION_MODE == ADC_ACQUISITION_CONTINUOUS
+    .period_ms = MQ135_READ_INTERVAL,
+    .phase_ms = MQ135_READ_PHASE_MS,
+#else
+    .period_ms = LIGHT_SENSOR_READ_INTERVAL,
+    .phase_ms = LIGHT_SENSOR_READ_PHASE_MS,
+#endif
+    .init = sensor_adc_init,
+    .read = ldr_driver_read,
+};
@@ -0,0 +1,88 @@
+#include "esp_log.h"
+#include "hot_log.h"
+
+#include "sensor_drivers.h"
+#include "sensor_read.h"
+#include "sensor_math.h"
+
+static const char *TAG = "MQ135";
+
+// Curva de calibração do sensor MQ-135 (r0 é a resistência em ar limpo, calculada)
+static mq135_calibration_t mq135_calibration = {
+    .r0 = 10.55,
+    .slope = MQ135_SLOPE,
+    .y_intercept = MQ135_Y_INTERCEPT,
+    .ref_voltage = MQ135_REF_VOLTAGE,
+    .adc_full_scale = ADC_RESOLUTION_12_BITS,
+};
+
+/*
+// Função para calibrar o sensor MQ-135 e calcular R0 (modo one-shot)
+static void calibrate_mq135() {
+    ESP_LOGI(TAG, "[%s] Calibrando sensor MQ-135 para obter R0...", DEVICE_ID);
+    float sensor_valor = 0.0;
+    float RS_air;
+    int adc_reading;
+
+    // Loop para tirar média das leituras do sensor
+    for (int x = 0; x < MQ135_CALIBRATION_SAMPLES; x++) {
+        sensor_adc_lock();
+        esp_err_t err = adc_oneshot_read(sensor_adc_oneshot(), MQ135_ADC_CHANNEL, &adc_reading);
+        sensor_adc_unlock();
+        if (err == ESP_OK) {
+            sensor_valor += adc_reading; // Acumula as leituras do ADC
+        } else {
+            ESP_LOGE(TAG, "[%s] Falha ao ler ADC durante calibração", DEVICE_ID);
+        }
+        vTaskDelay(pdMS_TO_TICKS(MQ135_CALIBRATION_DELAY_MS)); // Pequeno delay para evitar sobrecarga
+    }
+    sensor_valor = sensor_valor / MQ135_CALIBRATION_SAMPLES; // Calcula a média das leituras
+
+    ESP_LOGI(TAG, "[%s] Média das leituras = %.2f", DEVICE_ID, sensor_valor);
+
+    // Calcula RS em ar limpo
+    RS_air = mq135_resistance((int)sensor_valor, &mq135_calibration);
+    if (RS_air == 0) {
+        ESP_LOGE(TAG, "[%s] Erro: Leitura do sensor inválida na calibração!", DEVICE_ID);
+    }
+
+    // Calcula R0 com base na razão típica do sensor MQ-135 (3.7 para CO2 em ar limpo)
+    mq135_calibration.r0 = RS_air / MQ135_RS_R0_RATIO;
+
+    ESP_LOGI(TAG, "[%s] Valor de RS = %.2f", DEVICE_ID, RS_air);
+    ESP_LOGI(TAG, "[%s] Valor de R0 = %.2f", DEVICE_ID, mq135_calibration.r0);
+}
+*/
+
+static esp_err_t mq135_driver_init(void) {
+    esp_err_t err = sensor_adc_init();
+    //if (err == ESP_OK) calibrate_mq135(); // Calibra o sensor MQ-135 ao iniciar
+    return err;
+}
+
+static esp_err_t mq135_driver_read(telemetry_reading_t *reading) {
+#if ADC_ACQUISITION_MODE == ADC_ACQUISITION_CONTINUOUS
+    const adc_reduce_t *reduce;
+    esp_err_t err = sensor_adc_burst(&reduce);
+    if (err == ESP_OK) err = sensor_read_mq135_reduced(reduce, MQ135_ADC_CHANNEL, &mq135_calibration, reading);
+#else
+    sensor_adc_lock();
+    esp_err_t err = sensor_read_mq135(sensor_adc_oneshot(), MQ135_ADC_CHANNEL, &mq135_calibration, reading);
+    sensor_adc_unlock();
+#endif
+    if (err == ESP_OK && reading->mq135.adc_raw == 0) {
+        static hot_log_limit_t invalid_limit = HOT_LOG_LIMIT_INIT;
+        HOT_LOGE_LIMITED(&invalid_limit, TAG, "[%s] Erro: Leitura do sensor inválida!", DEVICE_ID);
+    }
+    return err;
+}
+
+const sensor_driver_t mq135_driver = {
+    .name = "mq135",
+    .sensor = TELEMETRY_SENSOR_MQ135,
+    .topic = MQTT_SENSOR_MQ135_TOPIC,
+    .period_ms = MQ135_READ_INTERVAL,
+    .phase_ms = MQ135_READ_PHASE_MS,
+    .init = mq135_driver_init,
+    .read = mq135_driver_read,
+};
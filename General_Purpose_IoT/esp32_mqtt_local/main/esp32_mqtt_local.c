@@ -1,217 +1,449 @@
 #include <stdio.h>
 #include <string.h>
-#include <math.h>
+#include <sys/time.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/event_groups.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "nvs_flash.h"
 #include "driver/gpio.h"
+#include "driver/ledc.h"
 #include "mqtt_client.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_netif.h"
-#include "bmp280.h"
-#include "i2cdev.h"
+#include "esp_netif_sntp.h"
+#include "esp_random.h"
 #include "esp_adc/adc_oneshot.h"
-#include "dht.h"
 
 #include "board_config.h"
 #include "credentials.h"
+#include "sensor_scheduler.h"
+#include "sensor_batch.h"
+#include "telemetry_codec.h"
+#include "reading_buffer.h"
+#include "publish_policy.h"
+#include "light_control.h"
+#include "sensor_registry.h"
+#include "runtime_metrics.h"
+#include "hot_log.h"
+#include "radio_burst.h"
+#include "drivers/sensor_drivers.h"
 
 // Variáveis globais
 static const char *TAG = "MQTT_APP";
-static const char *TAG_BMP280 = "BMP280";
-static const char *TAG_DHT11 = "DHT11";
-static const char *TAG_MQ135 = "MQ135";
 static const char *TAG_LIGHT_SENSOR = "LDR_SENSOR";
 
-// Variável global para o sensor MQ-135
-float R0 = 10.55;   // Resistência do sensor em ar limpo (calculada)
+// Sensores do dispositivo, na ordem de registro (um driver por arquivo em
+// drivers/). Adicionar um sensor é acrescentar o driver aqui.
+static const sensor_driver_t *const sensor_drivers[] = {
+    &bmp280_driver,
+    &dht11_driver,
+    &mq135_driver,
+    &ldr_driver,
+};
 
 // Handles globais
 esp_mqtt_client_handle_t client;
-TaskHandle_t heartbeat_task_handle, bmp280_task_handle, dht11_task_handle, mq135_task_handle, light_sensor_task_handle;
-static bool mqtt_connected = false;
-bmp280_t bmp280_dev;
-adc_oneshot_unit_handle_t adc1_handle;
-
-// Função para calcular pressão ao nível do mar
-static float calculate_sea_level_pressure(float pressure, float temperature, float altitude) {
-    // Pressão em hPa (pressure vem em Pa, dividir por 100)
-    float P = pressure * PA_TO_HPA; // Conversão de Pascal para hPa
-    // Fórmula barométrica para pressão ao nível do mar
-    float sea_level_pressure = P / pow(1.0 - (STANDARD_LAPSE_RATE * altitude) / (temperature + STANDARD_LAPSE_RATE * altitude + SEA_LEVEL_TEMP_K), EXPONENT);
-    return sea_level_pressure;
-}
-
-/*
-// Função para calibrar o sensor MQ-135 e calcular R0
-static void calibrate_mq135() {
-    ESP_LOGI(TAG_MQ135, "[%s] Calibrando sensor MQ-135 para obter R0...", DEVICE_ID);
-    float sensor_valor = 0.0;
-    float RS_air;
-    int adc_reading;
-
-    // Loop para tirar média das leituras do sensor
-    for (int x = 0; x < MQ135_CALIBRATION_SAMPLES; x++) {
-        if (adc_oneshot_read(adc1_handle, MQ135_ADC_CHANNEL, &adc_reading) == ESP_OK) {
-            sensor_valor += adc_reading; // Acumula as leituras do ADC
-        } else {
-            ESP_LOGE(TAG_MQ135, "[%s] Falha ao ler ADC durante calibração", DEVICE_ID);
-        }
-        vTaskDelay(pdMS_TO_TICKS(MQ135_CALIBRATION_DELAY_MS)); // Pequeno delay para evitar sobrecarga
-    }
-    sensor_valor = sensor_valor / MQ135_CALIBRATION_SAMPLES; // Calcula a média das leituras
+TaskHandle_t sampling_task_handle;
+TaskHandle_t light_control_task_handle;
+// As tarefas são criadas uma vez no app_main, com pilha estática, e nunca são
+// apagadas: uma queda do Wi-Fi ou do broker só muda os bits de conexão e a
+// sampling_task passa a guardar as leituras na fila offline.
+static StaticTask_t sampling_task_tcb;
+static StackType_t sampling_task_stack[SAMPLING_TASK_STACK_SIZE];
+#if ADC_ACQUISITION_MODE == ADC_ACQUISITION_ONESHOT
+static StaticTask_t light_control_task_tcb;
+static StackType_t light_control_task_stack[LIGHT_CONTROL_TASK_STACK_SIZE];
+#endif
+// Estado da conexão, escrito pelos handlers de eventos e lido pela sampling_task.
+// O bit do Wi-Fi cai na hora em que a estação desassocia, antes de o cliente MQTT
+// perceber a queda pelo keepalive, e as leituras já vão para a fila offline.
+#define WIFI_CONNECTED_BIT BIT0
+#define MQTT_CONNECTED_BIT BIT1
+#define LINK_UP_BITS (WIFI_CONNECTED_BIT | MQTT_CONNECTED_BIT)
+static StaticEventGroup_t connection_events_storage;
+static EventGroupHandle_t connection_events;
+// Estado da cor do LED; só quem alimenta o controle (light_control_task ou, no modo contínuo, a sampling_task) acessa
+static light_control_t light_control;
+static sensor_scheduler_t sensor_scheduler;
+static sensor_registry_t sensor_registry;
+#if MQTT_BATCH_MODE_ENABLED
+static sensor_batch_t sensor_batch;
+#endif
+// Leituras feitas sem conexão; só a sampling_task a acessa
+static reading_buffer_entry_t offline_storage[OFFLINE_BUFFER_CAPACITY];
+static reading_buffer_t offline_buffer;
+static int64_t next_drain_ms = 0;
+#if LOW_POWER_MODE_ENABLED
+// Rajadas do rádio; heartbeat e métricas vencidos esperam a próxima. Só a sampling_task acessa.
+static radio_burst_t radio_burst;
+static bool heartbeat_pending, metrics_pending;
+#endif
+// Número da próxima leitura; começa em valor aleatório para o gateway distinguir um reboot de uma lacuna
+static uint32_t next_seq;
+static volatile bool clock_synced = false;
+
+static int64_t uptime_ms(void) {
+    return esp_timer_get_time() / 1000;
+}
+
+static bool mqtt_connected(void) {
+    return (xEventGroupGetBits(connection_events) & LINK_UP_BITS) == LINK_UP_BITS;
+}
 
-    ESP_LOGI(TAG_MQ135, "[%s] Média das leituras = %.2f", DEVICE_ID, sensor_valor);
+// Toda publicação passa por aqui: duração e falhas (msg_id negativo) vão para runtime_metrics
+static int mqtt_publish(const char *topic, const char *data, int len, int qos, int retain) {
+    int64_t start_us = esp_timer_get_time();
+    int msg_id = esp_mqtt_client_publish(client, topic, data, len, qos, retain);
+    runtime_metrics_record(RUNTIME_METRIC_PUBLISH, start_us, esp_timer_get_time(), msg_id >= 0);
+    return msg_id;
+}
 
-    // Calcula RS em ar limpo
-    if (sensor_valor > 0) {
-        RS_air = (MQ135_REF_VOLTAGE * ADC_RESOLUTION_12_BITS / sensor_valor) - MQ135_REF_VOLTAGE;
-    } else {
-        ESP_LOGE(TAG_MQ135, "[%s] Erro: Leitura do sensor inválida na calibração!", DEVICE_ID);
-        RS_air = 0;
+#if PUBLISH_POLICY_ENABLED
+// Sensores lentos: só publicam quando mudam (ver publish_policy.h); só a sampling_task acessa
+static publish_policy_t publish_policies[] = {
+    { .sensor = TELEMETRY_SENSOR_BMP280, .fields = {
+        { BMP280_TEMPERATURE_DEADBAND, SENSOR_MAX_SILENCE_MS },
+        { BMP280_PRESSURE_DEADBAND, SENSOR_MAX_SILENCE_MS },
+        { BMP280_PRESSURE_DEADBAND, SENSOR_MAX_SILENCE_MS },
+    } },
+    { .sensor = TELEMETRY_SENSOR_DHT11, .fields = {
+        { DHT11_TEMPERATURE_DEADBAND, SENSOR_MAX_SILENCE_MS },
+        { DHT11_HUMIDITY_DEADBAND, SENSOR_MAX_SILENCE_MS },
+    } },
+};
+
+static publish_policy_t *publish_policy_for(telemetry_sensor_t sensor) {
+    for (size_t i = 0; i < sizeof(publish_policies) / sizeof(publish_policies[0]); i++) {
+        if (publish_policies[i].sensor == sensor) return &publish_policies[i];
+    }
+    return NULL;
+}
+#endif
+
+// Metadados enviados com cada leitura: seq sempre; ts (epoch em ms da amostra) com o
+// relógio sincronizado; age_ms só nas leituras que passaram pela fila offline; hold_ms
+// nos sensores com banda morta
+static telemetry_meta_t reading_meta(telemetry_sensor_t sensor, uint32_t seq, uint32_t sampled_at_ms, bool delayed) {
+    telemetry_meta_t meta = { .flags = TELEMETRY_META_SEQ, .seq = seq };
+    uint32_t age_ms = (uint32_t)uptime_ms() - sampled_at_ms;
+    if (delayed) {
+        meta.flags |= TELEMETRY_META_AGE;
+        meta.age_ms = age_ms;
     }
+    if (clock_synced) {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        meta.flags |= TELEMETRY_META_TS;
+        meta.ts_ms = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000 - age_ms;
+    }
+#if PUBLISH_POLICY_ENABLED
+    // Avisa o gateway por quanto tempo o valor vale sem novas publicações
+    publish_policy_t *policy = publish_policy_for(sensor);
+    if (policy && (meta.hold_ms = publish_policy_hold_ms(policy)) > 0) meta.flags |= TELEMETRY_META_HOLD;
+#endif
+    return meta;
+}
 
-    // Calcula R0 com base na razão típica do sensor MQ-135 (3.7 para CO2 em ar limpo)
-    R0 = RS_air / MQ135_RS_R0_RATIO;
+#if MQTT_BATCH_MODE_ENABLED
+static void publish_batch(const char *payload, size_t len, size_t readings, void *ctx) {
+    if (!mqtt_connected()) {
+        ESP_LOGW(TAG, "[%s] Lote com %d leituras descartado: MQTT desconectado", DEVICE_ID, (int)readings);
+        return;
+    }
+#if TELEMETRY_ENCODING == TELEMETRY_ENCODING_BINARY
+    mqtt_publish(MQTT_SENSOR_BATCH_TOPIC MQTT_BINARY_TOPIC_SUFFIX, payload, (int)len, 0, 0);
+#else
+    mqtt_publish(MQTT_SENSOR_BATCH_TOPIC, payload, (int)len, 0, 0);
+#endif
+    HOT_LOGI(TAG, "[%s] Lote com %d leituras publicado (%d bytes)", DEVICE_ID, (int)readings, (int)len);
+}
 
-    ESP_LOGI(TAG_MQ135, "[%s] Valor de RS = %.2f", DEVICE_ID, RS_air);
-    ESP_LOGI(TAG_MQ135, "[%s] Valor de R0 = %.2f", DEVICE_ID, R0);
+// Codifica a leitura (JSON ou binário, conforme TELEMETRY_ENCODING) e a acumula no lote
+static void batch_reading(const sensor_driver_t *driver, const telemetry_reading_t *reading, const telemetry_meta_t *meta) {
+    const char *sensor = driver->name;
+#if TELEMETRY_ENCODING == TELEMETRY_ENCODING_BINARY
+    uint8_t record[TELEMETRY_MAX_RECORD_SIZE];
+    size_t len = sensor_registry_encode(driver, reading, meta, true, record, sizeof(record));
+    if (len == 0) {
+        ESP_LOGE(TAG, "[%s] Falha ao codificar leitura do %s", DEVICE_ID, sensor);
+        return;
+    }
+    sensor_batch_add_record(&sensor_batch, record, len, uptime_ms());
+    HOT_LOGI(TAG, "[%s] Dados %s adicionados ao lote (%d bytes, binário)", DEVICE_ID, sensor, (int)len);
+#else
+    char sensor_data[SENSOR_PAYLOAD_BUFFER_SIZE];
+    if (sensor_registry_encode(driver, reading, meta, false, (uint8_t *)sensor_data, sizeof(sensor_data)) == 0) {
+        ESP_LOGE(TAG, "[%s] Falha ao codificar leitura do %s", DEVICE_ID, sensor);
+        return;
+    }
+    sensor_batch_add(&sensor_batch, sensor, sensor_data, uptime_ms());
+    HOT_LOGI(TAG, "[%s] Dados %s adicionados ao lote: %s", DEVICE_ID, sensor, sensor_data);
+#endif
+}
+#endif
+
+// Codifica a leitura (JSON ou binário, conforme TELEMETRY_ENCODING) e a publica no
+// tópico do driver. Retorna false se o cliente MQTT não aceitou a mensagem.
+static bool send_reading(const sensor_driver_t *driver, const telemetry_reading_t *reading, const telemetry_meta_t *meta) {
+    const char *sensor = driver->name;
+    int msg_id;
+#if TELEMETRY_ENCODING == TELEMETRY_ENCODING_BINARY
+    uint8_t record[TELEMETRY_MAX_RECORD_SIZE];
+    size_t len = sensor_registry_encode(driver, reading, meta, true, record, sizeof(record));
+    if (len == 0) {
+        ESP_LOGE(TAG, "[%s] Falha ao codificar leitura do %s", DEVICE_ID, sensor);
+        return true;   // Leitura inválida: não adianta tentar de novo
+    }
+    char binary_topic[64];
+    snprintf(binary_topic, sizeof(binary_topic), "%s%s", driver->topic, MQTT_BINARY_TOPIC_SUFFIX);
+    msg_id = mqtt_publish(binary_topic, (const char *)record, (int)len, 0, 0);
+    if (msg_id >= 0) HOT_LOGI(TAG, "[%s] Dados %s publicados (%d bytes, binário)", DEVICE_ID, sensor, (int)len);
+#else
+    char sensor_data[SENSOR_PAYLOAD_BUFFER_SIZE];
+    if (sensor_registry_encode(driver, reading, meta, false, (uint8_t *)sensor_data, sizeof(sensor_data)) == 0) {
+        ESP_LOGE(TAG, "[%s] Falha ao codificar leitura do %s", DEVICE_ID, sensor);
+        return true;
+    }
+    msg_id = mqtt_publish(driver->topic, sensor_data, 0, 0, 0);
+    if (msg_id >= 0) HOT_LOGI(TAG, "[%s] Dados %s publicados: %s", DEVICE_ID, sensor, sensor_data);
+#endif
+    return msg_id >= 0;
 }
-*/
 
-static void heartbeat_task(void *pvParameters) {
-    while (1) {
-        if (mqtt_connected) {
-            esp_mqtt_client_publish(client, MQTT_STATUS_TOPIC, "heartbeat", 0, 0, 0);
-            ESP_LOGI(TAG, "[%s] Heartbeat enviado para %s", DEVICE_ID, MQTT_BROKER);
-        }
-        vTaskDelay(pdMS_TO_TICKS(HEARTBEAT_INTERVAL));
+// Publica a leitura (ou a acumula no lote, conforme MQTT_BATCH_MODE_ENABLED). Sem
+// conexão, ou enquanto ainda houver leituras antigas na fila, a leitura entra na
+// fila offline para manter a ordem; o envio da fila é feito por drain_offline_buffer.
+// No modo de baixo consumo toda leitura passa pela fila e sai na próxima rajada.
+// Leituras dentro da banda morta não são publicadas nem consomem número de sequência.
+// Callback do sensor_registry para toda leitura válida de qualquer driver.
+static void publish_reading(const sensor_driver_t *driver, const telemetry_reading_t *reading, void *ctx) {
+#if PUBLISH_POLICY_ENABLED
+    publish_policy_t *policy = publish_policy_for(reading->sensor);
+    if (policy && !publish_policy_should_publish(policy, reading, uptime_ms())) {
+        ESP_LOGD(TAG, "[%s] Leitura do %s dentro da banda morta (%lu suprimidas)",
+                 DEVICE_ID, driver->name, (unsigned long)policy->suppressed);
+        return;
+    }
+#endif
+    uint32_t seq = next_seq++;
+    uint32_t sampled_at_ms = (uint32_t)uptime_ms();
+    if (!LOW_POWER_MODE_ENABLED && mqtt_connected() && reading_buffer_count(&offline_buffer) == 0) {
+        telemetry_meta_t meta = reading_meta(reading->sensor, seq, sampled_at_ms, false);
+#if MQTT_BATCH_MODE_ENABLED
+        batch_reading(driver, reading, &meta);
+        return;
+#else
+        if (send_reading(driver, reading, &meta)) return;
+#endif
+    }
+    if (!reading_buffer_push(&offline_buffer, reading, seq, sampled_at_ms)) {
+        static hot_log_limit_t buffer_full_limit = HOT_LOG_LIMIT_INIT;
+        HOT_LOGW_LIMITED(&buffer_full_limit, TAG, "[%s] Fila offline cheia: leitura mais antiga descartada (%lu no total)",
+                         DEVICE_ID, (unsigned long)offline_buffer.dropped);
     }
 }
 
-static void bmp280_read_task(void *pvParameters) {
-    float temperature, pressure, pressure_sea_level;
-    char sensor_data[BMP280_BUFFER_SIZE];
-    ESP_LOGI(TAG_BMP280, "[%s] Tarefa bmp280_read_task iniciada.", DEVICE_ID);
-    while (1) {
-        if (mqtt_connected) {
-            if (bmp280_read_float(&bmp280_dev, &temperature, &pressure, NULL) == ESP_OK) {
-                // Calcular pressão ao nível do mar
-                pressure_sea_level = calculate_sea_level_pressure(pressure, temperature, ALTITUDE);
-                ESP_LOGI(TAG_BMP280, "[%s] Raw temperature: %.2f C, Raw pressure: %.2f Pa, Sea-level pressure: %.2f hPa", 
-                         DEVICE_ID, temperature, pressure, pressure_sea_level);
-                snprintf(sensor_data, sizeof(sensor_data),
-                         "{\"temperature\":%.2f,\"pressure\":%.2f,\"pressure_sea_level\":%.2f}",
-                         temperature, pressure * PA_TO_HPA, pressure_sea_level);
-                esp_mqtt_client_publish(client, MQTT_SENSOR_BMP280_TOPIC, sensor_data, 0, 0, 0);
-                ESP_LOGI(TAG_BMP280, "[%s] Dados BMP280 publicados: %s", DEVICE_ID, sensor_data);
-            } else {
-                ESP_LOGE(TAG_BMP280, "[%s] Falha ao ler dados do sensor BMP280", DEVICE_ID);
-            }
-        }
-        vTaskDelay(pdMS_TO_TICKS(BMP280_READ_INTERVAL));
+// Envia até max leituras da fila, com o atraso de cada uma (age_ms)
+static void drain_offline_buffer(int max) {
+    const reading_buffer_entry_t *entry;
+    int sent = 0;
+    while (sent < max && (entry = reading_buffer_peek(&offline_buffer)) != NULL) {
+        const sensor_driver_t *driver = sensor_registry_find(&sensor_registry, entry->reading.sensor);
+        telemetry_meta_t meta = reading_meta(entry->reading.sensor, entry->seq, entry->sampled_at_ms, true);
+        if (driver && !send_reading(driver, &entry->reading, &meta)) break;
+        reading_buffer_pop(&offline_buffer);
+        sent++;
+    }
+    if (!LOW_POWER_MODE_ENABLED && sent > 0 && reading_buffer_count(&offline_buffer) == 0) {
+        ESP_LOGI(TAG, "[%s] Fila offline enviada (ocupação máxima: %d, descartadas: %lu)",
+                 DEVICE_ID, (int)offline_buffer.high_water, (unsigned long)offline_buffer.dropped);
     }
 }
 
-static void dht11_read_task(void *pvParameters) {
-    float temperature, humidity;
-    char sensor_data[DHT11_BUFFER_SIZE];
-    ESP_LOGI(TAG_DHT11, "[%s] Tarefa dht11_read_task iniciada.", DEVICE_ID);
-    while (1) {
-        if (mqtt_connected) {
-            if (dht_read_float_data(DHT11_SENSOR_TYPE, DHT11_GPIO, &humidity, &temperature) == ESP_OK) {
-                snprintf(sensor_data, sizeof(sensor_data),
-                         "{\"temperature\":%.1f,\"humidity\":%.1f}",
-                         temperature, humidity);
-                esp_mqtt_client_publish(client, MQTT_SENSOR_DHT11_TOPIC, sensor_data, 0, 0, 0);
-                ESP_LOGI(TAG_DHT11, "[%s] Dados DHT11 publicados: %s", DEVICE_ID, sensor_data);
-            } else {
-                ESP_LOGE(TAG_DHT11, "[%s] Falha ao ler dados do sensor DHT11 no GPIO %d", DEVICE_ID, DHT11_GPIO);
-            }
-        }
-        vTaskDelay(pdMS_TO_TICKS(DHT11_READ_INTERVAL));
+static void publish_heartbeat(void) {
+    if (mqtt_connected()) {
+        char health[SENSOR_HEALTH_BUFFER_SIZE];
+        mqtt_publish(MQTT_STATUS_TOPIC, "heartbeat", 0, 0, 0);
+        int len = sensor_registry_format_health(&sensor_registry, uptime_ms(), health, sizeof(health));
+        if (len > 0 && len < (int)sizeof(health)) mqtt_publish(MQTT_SENSOR_HEALTH_TOPIC, health, len, 0, 0);
+        HOT_LOGI(TAG, "[%s] Heartbeat enviado para %s", DEVICE_ID, MQTT_BROKER);
     }
 }
 
-static void mq135_read_task(void *pvParameters) {
-    char sensor_data[MQ135_BUFFER_SIZE];
-    int adc_reading;
-    float m = MQ135_SLOPE;            // Parâmetro Slope da curva de calibração
-    float b = MQ135_Y_INTERCEPT;      // Parâmetro Y-Intercept da curva de calibração
-    float Rs;                         // Resistência do sensor
-    float razao;                      // Razão entre Rs e R0
-    float ppm_log;                    // Valor de ppm em escala linear
-    float ppm;                        // Valor de ppm em escala logarítmica
-    ESP_LOGI(TAG_MQ135, "[%s] Tarefa mq135_read_task iniciada.", DEVICE_ID);
-    while (1) {
-        if (mqtt_connected) {
-            if (adc_oneshot_read(adc1_handle, MQ135_ADC_CHANNEL, &adc_reading) == ESP_OK) {
-                // Cálculo da resistência do sensor (Rs)
-                if (adc_reading > 0) {
-                    Rs = (MQ135_REF_VOLTAGE * ADC_RESOLUTION_12_BITS / adc_reading) - MQ135_REF_VOLTAGE;
-                } else {
-                    ESP_LOGE(TAG_MQ135, "[%s] Erro: Leitura do sensor inválida!", DEVICE_ID);
-                    Rs = 0;
-                }
+// Snapshot das métricas de execução (publicações, leituras, tarefas, heap e, no
+// modo de baixo consumo, a parcela do tempo com o rádio acordado) desde o anterior
+static void publish_metrics(void) {
+    static runtime_metric_window_t ops[RUNTIME_METRIC_KINDS];
+    static runtime_system_stats_t sys;
+    static char payload[RUNTIME_METRICS_JSON_SIZE];
+    runtime_metrics_snapshot(ops);
+    runtime_metrics_collect_system(&sys);
+#if LOW_POWER_MODE_ENABLED
+    sys.radio_reported = true;
+    sys.radio_awake_permille = radio_burst_snapshot(&radio_burst, uptime_ms(), &sys.radio_bursts);
+#endif
+    int len = runtime_metrics_format_json(ops, &sys, payload, sizeof(payload));
+    if (len <= 0 || len >= (int)sizeof(payload)) {
+        ESP_LOGE(TAG, "[%s] Snapshot de métricas maior que %d bytes", DEVICE_ID, (int)sizeof(payload));
+    } else if (mqtt_connected()) {
+        mqtt_publish(MQTT_SYSTEM_METRICS_TOPIC, payload, len, 0, 0);
+    }
+}
 
-                // Cálculo da razão Rs/R0
-                razao = Rs / R0;
+static void heartbeat_sample(void *ctx) {
+#if LOW_POWER_MODE_ENABLED
+    heartbeat_pending = true;
+#else
+    publish_heartbeat();
+#endif
+}
 
-                // Cálculo do valor de ppm em escala linear
-                ppm_log = (log10(razao) - b) / m;
+static void metrics_sample(void *ctx) {
+#if LOW_POWER_MODE_ENABLED
+    metrics_pending = true;
+#else
+    publish_metrics();
+#endif
+}
 
-                // Conversão para escala logarítmica
-                ppm = pow(10, ppm_log);
+#if LOW_POWER_MODE_ENABLED
+// Rajada: tira o rádio do modem sleep e envia de uma vez as leituras do período
+// e o heartbeat e as métricas vencidos
+static void publish_burst(void) {
+    radio_burst_power_save(false);
+    drain_offline_buffer(OFFLINE_BUFFER_CAPACITY);
+    if (heartbeat_pending) publish_heartbeat();
+    if (metrics_pending) publish_metrics();
+    heartbeat_pending = metrics_pending = false;
+}
+#endif
+
+#if HOT_LOG_RING_ENABLED
+// Pedido em MQTT_SYSTEM_LOGS_REQUEST_TOPIC: publica o anel de logs (linhas
+// curtas do caminho quente e todos os erros repetidos) em MQTT_SYSTEM_LOGS_TOPIC
+static void publish_hot_logs(void) {
+    static char payload[HOT_LOG_RING_SIZE + 1];
+    size_t len = hot_log_ring_read(payload, HOT_LOG_RING_SIZE);
+    payload[len] = '\0';   // len 0 (anel vazio) faz o cliente usar strlen
+    mqtt_publish(MQTT_SYSTEM_LOGS_TOPIC, payload, (int)len, 0, 0);
+}
+#endif
 
-                // Publicação dos dados
-                snprintf(sensor_data, sizeof(sensor_data), "{\"adc_raw\":%d,\"ppm\":%.2f}", adc_reading, ppm);
-                esp_mqtt_client_publish(client, MQTT_SENSOR_MQ135_TOPIC, sensor_data, 0, 0, 0);
-                ESP_LOGI(TAG_MQ135, "[%s] Dados MQ-135 publicados: %s", DEVICE_ID, sensor_data);
-            } else {
-                ESP_LOGE(TAG_MQ135, "[%s] Falha ao ler dados do sensor MQ-135 (ADC1 CH%d)", DEVICE_ID, MQ135_ADC_CHANNEL);
-            }
-        }
-        vTaskDelay(pdMS_TO_TICKS(MQ135_READ_INTERVAL));
+// Duração de cada read() dos drivers, com falha quando o driver retorna erro
+static void sensor_read_timed(const sensor_driver_t *driver, esp_err_t err, int64_t start_us, int64_t end_us, void *ctx) {
+    runtime_metrics_record(RUNTIME_METRIC_SENSOR_READ, start_us, end_us, err == ESP_OK);
+}
+
+// Callback do sensor_registry para leituras que falharam. Um sensor desconectado
+// falha a cada período: na UART sai uma linha por HOT_LOG_ERROR_INTERVAL_MS por sensor.
+static void sensor_failed(const sensor_driver_t *driver, esp_err_t err, const sensor_health_t *health, void *ctx) {
+    static hot_log_limit_t limits[SENSOR_REGISTRY_MAX_DRIVERS];
+    size_t slot = 0;
+    while (slot + 1 < sensor_registry.count && sensor_registry.slots[slot].driver != driver) slot++;
+    HOT_LOGE_LIMITED(&limits[slot], TAG, "[%s] Falha ao ler o sensor %s: %s (%lu seguidas)",
+                     DEVICE_ID, driver->name, esp_err_to_name(err), (unsigned long)health->consecutive_failures);
+}
+
+// Aplica a cor do nível atual no LED com fade do LEDC; chamada só quando o nível muda
+static void light_leds_apply(void) {
+    static const ledc_channel_t channels[LIGHT_COLORS] = { LIGHT_LEDC_RED_CHANNEL, LIGHT_LEDC_GREEN_CHANNEL, LIGHT_LEDC_BLUE_CHANNEL };
+    uint32_t duty[LIGHT_COLORS];
+    light_control_duty(light_control.level, LIGHT_LEDC_DUTY_MAX, duty);
+    for (int i = 0; i < LIGHT_COLORS; i++) {
+        ledc_set_fade_with_time(LIGHT_LEDC_MODE, channels[i], duty[i], LIGHT_FADE_MS);
+        ledc_fade_start(LIGHT_LEDC_MODE, channels[i], LEDC_FADE_NO_WAIT);
     }
+    ESP_LOGI(TAG_LIGHT_SENSOR, "[%s] Luminosidade: %s (%lu trocas)", DEVICE_ID,
+             light_level_name(light_control.level), (unsigned long)light_control.transitions);
+}
+
+void light_leds_feed(esp_err_t err, uint16_t raw) {
+    bool changed = err == ESP_OK ? light_control_update(&light_control, raw) : light_control_fault(&light_control);
+    if (changed) light_leds_apply();
 }
 
-static void light_sensor_read_task(void *pvParameters) {
-    int adc_reading;
-    char sensor_data[LDR_BUFFER_SIZE];
-    ESP_LOGI(TAG_LIGHT_SENSOR, "[%s] Tarefa light_sensor_read_task (com controle de LED) iniciada.", DEVICE_ID);
+#if ADC_ACQUISITION_MODE == ADC_ACQUISITION_ONESHOT
+// Laço de controle do LED: lê o LDR a cada LIGHT_CONTROL_PERIOD_MS e só mexe no
+// LEDC quando o nível muda. Não depende do MQTT nem do período de publicação.
+static void light_control_task(void *pvParameters) {
+    TickType_t last_wake = xTaskGetTickCount();
     while (1) {
-        if (adc_oneshot_read(adc1_handle, LIGHT_SENSOR_ADC_CHANNEL, &adc_reading) == ESP_OK) {
-            ESP_LOGI(TAG_LIGHT_SENSOR, "[%s] LDR ADC reading: %d", DEVICE_ID, adc_reading);
-            if (mqtt_connected) {
-                snprintf(sensor_data, sizeof(sensor_data), "{\"ldr_raw\":%d}", adc_reading);
-                esp_mqtt_client_publish(client, MQTT_SENSOR_LDR_TOPIC, sensor_data, 0, 0, 0);
-                ESP_LOGI(TAG_LIGHT_SENSOR, "[%s] Dados do LDR publicados: %s", DEVICE_ID, sensor_data);
-            }
+        int raw = 0;   // Não é escrito quando a leitura falha
+        sensor_adc_lock();   // A sampling_task lê o MQ-135 e o LDR no mesmo ADC1
+        esp_err_t err = adc_oneshot_read(sensor_adc_oneshot(), LIGHT_SENSOR_ADC_CHANNEL, &raw);
+        sensor_adc_unlock();
+        light_leds_feed(err, (uint16_t)raw);
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(LIGHT_CONTROL_PERIOD_MS));
+    }
+}
+#endif
 
-            // Customizar cores com base no nível de iluminação (0 a 4095)
-            if (adc_reading <= LIGHT_SENSOR_THRESHOLD_RED) { // Baixa luminosidade: vermelho dominante
-                gpio_set_level(RED_LED_GPIO, 1);   // Vermelho ligado
-                gpio_set_level(GREEN_LED_GPIO, 0); // Verde apagado
-                gpio_set_level(BLUE_LED_GPIO, 0);  // Azul apagado
-            } else if (adc_reading <= LIGHT_SENSOR_THRESHOLD_GREEN) { // Média luminosidade: verde dominante
-                gpio_set_level(RED_LED_GPIO, 0);   // Vermelho apagado
-                gpio_set_level(GREEN_LED_GPIO, 1); // Verde ligado
-                gpio_set_level(BLUE_LED_GPIO, 0);  // Azul apagado
-            } else { // Alta luminosidade: azul dominante
-                gpio_set_level(RED_LED_GPIO, 0);   // Vermelho apagado
-                gpio_set_level(GREEN_LED_GPIO, 0); // Verde apagado
-                gpio_set_level(BLUE_LED_GPIO, 1);  // Azul ligado
+// Tarefa única de amostragem: dorme até o prazo mais próximo do agendador.
+// Continua amostrando sem conexão (as leituras vão para a fila offline) e é
+// acordada por notificação quando o MQTT conecta, para começar a enviar a fila.
+static void sampling_task(void *pvParameters) {
+    ESP_LOGI(TAG, "[%s] Tarefa sampling_task iniciada com %d sensores agendados.", DEVICE_ID, (int)sensor_scheduler.count);
+    while (1) {
+        sensor_scheduler_run_due(&sensor_scheduler, uptime_ms());
+        int64_t deadline = sensor_scheduler_next_deadline(&sensor_scheduler);
+#if LOW_POWER_MODE_ENABLED
+        // Rajada perdida sem conexão sai assim que o MQTT voltar
+        if (mqtt_connected() && radio_burst_start(&radio_burst, uptime_ms())) publish_burst();
+        if (radio_burst_poll_sleep(&radio_burst, uptime_ms())) radio_burst_power_save(true);
+        int64_t burst_deadline = radio_burst_deadline(&radio_burst);
+        if (burst_deadline < deadline) deadline = burst_deadline;
+#else
+        if (mqtt_connected()) {
+#if MQTT_BATCH_MODE_ENABLED
+            // Sem conexão o lote fica retido e é enviado na reconexão, antes da fila
+            sensor_batch_poll(&sensor_batch, uptime_ms());
+            int64_t batch_deadline = sensor_batch_deadline(&sensor_batch);
+            if (batch_deadline < deadline) deadline = batch_deadline;
+#endif
+            if (reading_buffer_count(&offline_buffer) > 0) {
+                if (uptime_ms() >= next_drain_ms) {
+                    drain_offline_buffer(OFFLINE_DRAIN_BURST);
+                    next_drain_ms = uptime_ms() + OFFLINE_DRAIN_INTERVAL_MS;
+                }
+                if (reading_buffer_count(&offline_buffer) > 0 && next_drain_ms < deadline) deadline = next_drain_ms;
             }
-        } else {
-            ESP_LOGE(TAG_LIGHT_SENSOR, "[%s] Falha ao ler sensor de luminosidade (ADC1 CH%d)", DEVICE_ID, LIGHT_SENSOR_ADC_CHANNEL);
-            // Apagar LEDs em caso de erro
-            gpio_set_level(RED_LED_GPIO, 0);
-            gpio_set_level(GREEN_LED_GPIO, 0);
-            gpio_set_level(BLUE_LED_GPIO, 0);
         }
-        vTaskDelay(pdMS_TO_TICKS(LIGHT_SENSOR_READ_INTERVAL));
+#endif
+        int64_t wait_ms = deadline - uptime_ms();
+        TickType_t wait_ticks = wait_ms > 0 ? pdMS_TO_TICKS(wait_ms) : 0;
+        ulTaskNotifyTake(pdTRUE, wait_ticks > 0 ? wait_ticks : 1);
+    }
+}
+
+static void register_sensors(void) {
+    static const sensor_registry_sink_t sink = {
+        .reading = publish_reading,
+        .failure = sensor_failed,
+        .clock_us = esp_timer_get_time,
+        .read_timed = sensor_read_timed,
+    };
+    sensor_scheduler_init(&sensor_scheduler);
+    reading_buffer_init(&offline_buffer, offline_storage, OFFLINE_BUFFER_CAPACITY);
+#if MQTT_BATCH_MODE_ENABLED
+    sensor_batch_init(&sensor_batch, SENSOR_BATCH_WINDOW_MS, SENSOR_BATCH_MAX_READINGS,
+                      TELEMETRY_ENCODING == TELEMETRY_ENCODING_BINARY, publish_batch, NULL);
+#endif
+    sensor_scheduler_register(&sensor_scheduler, "heartbeat", HEARTBEAT_INTERVAL, HEARTBEAT_PHASE_MS, heartbeat_sample, NULL, uptime_ms());
+#if LOW_POWER_MODE_ENABLED
+    radio_burst_init(&radio_burst, LOW_POWER_BURST_PERIOD_MS, LOW_POWER_BURST_PHASE_MS, LOW_POWER_BURST_LINGER_MS, uptime_ms());
+#endif
+    sensor_scheduler_register(&sensor_scheduler, "metrics", METRICS_INTERVAL_MS, METRICS_PHASE_MS, metrics_sample, NULL, uptime_ms());
+    // Inicializa o hardware de cada driver e agenda as leituras
+    size_t registered = sensor_registry_init(&sensor_registry, sensor_drivers, sizeof(sensor_drivers) / sizeof(sensor_drivers[0]),
+                                             &sensor_scheduler, &sink, uptime_ms);
+    for (size_t i = 0; i < registered; i++) {
+        const sensor_registry_slot_t *slot = &sensor_registry.slots[i];
+        if (slot->health.init_error != ESP_OK) {
+            ESP_LOGE(TAG, "[%s] Falha ao inicializar o sensor %s: %s", DEVICE_ID, slot->driver->name, esp_err_to_name(slot->health.init_error));
+        }
     }
 }
 
@@ -219,39 +451,85 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
     switch ((esp_mqtt_event_id_t)event_id) {
         case MQTT_EVENT_CONNECTED:
             ESP_LOGI(TAG, "[%s] Conectado ao broker MQTT: %s", DEVICE_ID, MQTT_BROKER);
-            mqtt_connected = true;
-            esp_mqtt_client_publish(client, MQTT_STATUS_TOPIC, "online", 0, 1, 0);
-            if (heartbeat_task_handle == NULL) xTaskCreate(heartbeat_task, "heartbeat_task", HEARTBEAT_TASK_STACK_SIZE, NULL, TASK_PRIORITY, &heartbeat_task_handle);
-            if (bmp280_task_handle == NULL) xTaskCreate(bmp280_read_task, "bmp280_read_task", SENSOR_TASK_STACK_SIZE, NULL, TASK_PRIORITY, &bmp280_task_handle);
-            if (dht11_task_handle == NULL) xTaskCreate(dht11_read_task, "dht11_read_task", SENSOR_TASK_STACK_SIZE, NULL, TASK_PRIORITY, &dht11_task_handle);
-            if (mq135_task_handle == NULL) xTaskCreate(mq135_read_task, "mq135_read_task", SENSOR_TASK_STACK_SIZE, NULL, TASK_PRIORITY, &mq135_task_handle);
-            if (light_sensor_task_handle == NULL) xTaskCreate(light_sensor_read_task, "light_sensor_read_task", SENSOR_TASK_STACK_SIZE, NULL, TASK_PRIORITY, &light_sensor_task_handle);
+            xEventGroupSetBits(connection_events, MQTT_CONNECTED_BIT);
+            mqtt_publish(MQTT_STATUS_TOPIC, "online", 0, 1, 0);
+#if HOT_LOG_RING_ENABLED
+            esp_mqtt_client_subscribe(client, MQTT_SYSTEM_LOGS_REQUEST_TOPIC, 0);
+#endif
+            if (reading_buffer_count(&offline_buffer) > 0) {
+                ESP_LOGI(TAG, "[%s] Enviando %d leituras da fila offline", DEVICE_ID, (int)reading_buffer_count(&offline_buffer));
+            }
+            xTaskNotifyGive(sampling_task_handle);
             break;
         case MQTT_EVENT_DISCONNECTED:
             ESP_LOGW(TAG, "[%s] Desconectado do broker MQTT", DEVICE_ID);
-            mqtt_connected = false;
-            if (heartbeat_task_handle != NULL) { vTaskDelete(heartbeat_task_handle); heartbeat_task_handle = NULL; }
-            if (bmp280_task_handle != NULL) { vTaskDelete(bmp280_task_handle); bmp280_task_handle = NULL; }
-            if (dht11_task_handle != NULL) { vTaskDelete(dht11_task_handle); dht11_task_handle = NULL; }
-            if (mq135_task_handle != NULL) { vTaskDelete(mq135_task_handle); mq135_task_handle = NULL; }
-            if (light_sensor_task_handle != NULL) { vTaskDelete(light_sensor_task_handle); light_sensor_task_handle = NULL; }
+            xEventGroupClearBits(connection_events, MQTT_CONNECTED_BIT);
+            break;
+#if HOT_LOG_RING_ENABLED
+        case MQTT_EVENT_DATA: {
+            esp_mqtt_event_handle_t event = event_data;
+            if (event->topic_len == (int)strlen(MQTT_SYSTEM_LOGS_REQUEST_TOPIC) &&
+                memcmp(event->topic, MQTT_SYSTEM_LOGS_REQUEST_TOPIC, event->topic_len) == 0) {
+                publish_hot_logs();
+            }
             break;
+        }
+#endif
         default: break;
     }
 }
 
 static void wifi_event_handler_sta(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data) {
     if (event_id == WIFI_EVENT_STA_START) { esp_wifi_connect(); }
-    else if (event_id == WIFI_EVENT_STA_DISCONNECTED) { ESP_LOGI(TAG, "[%s] Wi-Fi desconectado. Tentando reconectar...", DEVICE_ID); esp_wifi_connect(); }
+    else if (event_id == WIFI_EVENT_STA_DISCONNECTED) { xEventGroupClearBits(connection_events, WIFI_CONNECTED_BIT); ESP_LOGI(TAG, "[%s] Wi-Fi desconectado. Tentando reconectar...", DEVICE_ID); esp_wifi_connect(); }
 }
 
 static void ip_event_handler_sta(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data) {
     if (event_id == IP_EVENT_STA_GOT_IP) { 
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
+        xEventGroupSetBits(connection_events, WIFI_CONNECTED_BIT);
         ESP_LOGI(TAG, "[%s] Conectado ao Wi-Fi! IP: " IPSTR, DEVICE_ID, IP2STR(&event->ip_info.ip));
     }
 }
 
+static void time_sync_notification_cb(struct timeval *tv) {
+    if (!clock_synced) ESP_LOGI(TAG, "[%s] Relógio sincronizado por SNTP", DEVICE_ID);
+    clock_synced = true;
+}
+
+static void sntp_start(const char *server) {
+    esp_sntp_config_t config = ESP_NETIF_SNTP_DEFAULT_CONFIG(server);
+    config.sync_cb = time_sync_notification_cb;
+    esp_err_t err = esp_netif_sntp_init(&config);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "[%s] Falha ao iniciar SNTP (%s): %s", DEVICE_ID, server, esp_err_to_name(err));
+    }
+}
+
+#ifdef SNTP_FALLBACK_SERVER
+static void sntp_fallback_cb(void *arg) {
+    if (clock_synced) return;
+    ESP_LOGW(TAG, "[%s] SNTP sem resposta de %s; usando %s", DEVICE_ID, SNTP_SERVER, SNTP_FALLBACK_SERVER);
+    esp_netif_sntp_deinit();
+    sntp_start(SNTP_FALLBACK_SERVER);
+}
+#endif
+
+// SNTP em segundo plano. Se SNTP_FALLBACK_SERVER estiver definido e o servidor
+// principal não sincronizar em SNTP_FALLBACK_TIMEOUT_MS, passa para o servidor
+// local (redes sem internet). Até a primeira sincronização as leituras saem sem
+// "ts" (só seq e age_ms).
+static void sntp_init_clock(void) {
+    sntp_start(SNTP_SERVER);
+#ifdef SNTP_FALLBACK_SERVER
+    const esp_timer_create_args_t fallback_args = { .callback = sntp_fallback_cb, .name = "sntp_fallback" };
+    esp_timer_handle_t fallback_timer;
+    if (esp_timer_create(&fallback_args, &fallback_timer) == ESP_OK) {
+        esp_timer_start_once(fallback_timer, (uint64_t)SNTP_FALLBACK_TIMEOUT_MS * 1000);
+    }
+#endif
+}
+
 void wifi_init_sta(void) {
     ESP_LOGI(TAG, "[%s] Iniciando Wi-Fi em modo Station...", DEVICE_ID);
     ESP_ERROR_CHECK(esp_netif_init());
@@ -263,81 +541,77 @@ void wifi_init_sta(void) {
     ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &wifi_event_handler_sta, NULL, &instance_any_id));
     ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &ip_event_handler_sta, NULL, &instance_got_ip));
     wifi_config_t wifi_config = { .sta = { .ssid = WIFI_SSID, .password = WIFI_PASS, .threshold.authmode = WIFI_AUTH_WPA2_PSK, }, };
+#if LOW_POWER_MODE_ENABLED
+    wifi_config.sta.listen_interval = LOW_POWER_LISTEN_INTERVAL;
+#endif
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
     ESP_ERROR_CHECK(esp_wifi_start());
+#if LOW_POWER_MODE_ENABLED
+    esp_err_t err = radio_burst_power_init();
+    if (err != ESP_OK) ESP_LOGE(TAG, "[%s] Falha ao configurar o modo de baixo consumo: %s", DEVICE_ID, esp_err_to_name(err));
+#endif
 }
 
-void init_bmp280() {
-    ESP_LOGI(TAG_BMP280, "[%s] Iniciando init_bmp280()...", DEVICE_ID);
-    ESP_ERROR_CHECK(i2cdev_init());
-    memset(&bmp280_dev, 0, sizeof(bmp280_t));
-    ESP_ERROR_CHECK(bmp280_init_desc(&bmp280_dev, BMP280_I2C_ADDR, I2C_NUM_0, I2C_MASTER_SDA_IO, I2C_MASTER_SCL_IO));
-    bmp280_params_t params;
-    bmp280_init_default_params(&params);
-    params.mode = BMP280_MODE_NORMAL;
-    params.filter = BMP280_FILTER_16;
-    params.oversampling_pressure = BMP280_ULTRA_HIGH_RES;
-    params.oversampling_temperature = BMP280_ULTRA_HIGH_RES;
-    params.standby = BMP280_STANDBY_250;
-    esp_err_t init_err = bmp280_init(&bmp280_dev, &params);
-    if (init_err != ESP_OK) {
-        ESP_LOGE(TAG_BMP280, "[%s] Falha ao inicializar BMP280: %s", DEVICE_ID, esp_err_to_name(init_err));
-    } else {
-        ESP_LOGI(TAG_BMP280, "[%s] BMP280 inicializado com sucesso, Chip ID: 0x%x", DEVICE_ID, bmp280_dev.id);
-        if (bmp280_dev.id != BMP280_CHIP_ID && bmp280_dev.id != BME280_CHIP_ID) {
-            ESP_LOGE(TAG_BMP280, "[%s] ID do chip BMP280 inválido: 0x%x", DEVICE_ID, bmp280_dev.id);
-        }
+// LED RGB no LEDC (PWM), apagado até a primeira leitura do LDR
+void light_leds_init() {
+    static const struct { gpio_num_t gpio; ledc_channel_t channel; } leds[LIGHT_COLORS] = {
+        { RED_LED_GPIO, LIGHT_LEDC_RED_CHANNEL },
+        { GREEN_LED_GPIO, LIGHT_LEDC_GREEN_CHANNEL },
+        { BLUE_LED_GPIO, LIGHT_LEDC_BLUE_CHANNEL },
+    };
+    ledc_timer_config_t timer = {
+        .speed_mode = LIGHT_LEDC_MODE,
+        .timer_num = LIGHT_LEDC_TIMER,
+        .duty_resolution = LIGHT_LEDC_RESOLUTION,
+        .freq_hz = LIGHT_LEDC_FREQ_HZ,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    ESP_ERROR_CHECK(ledc_timer_config(&timer));
+    for (int i = 0; i < LIGHT_COLORS; i++) {
+        ledc_channel_config_t channel = {
+            .gpio_num = leds[i].gpio,
+            .speed_mode = LIGHT_LEDC_MODE,
+            .channel = leds[i].channel,
+            .timer_sel = LIGHT_LEDC_TIMER,
+            .duty = 0,
+        };
+        ESP_ERROR_CHECK(ledc_channel_config(&channel));
     }
-}
-
-void adc_init_all() {
-    adc_oneshot_unit_init_cfg_t init_config = { .unit_id = ADC_UNIT_1 };
-    ESP_ERROR_CHECK(adc_oneshot_new_unit(&init_config, &adc1_handle));
-    adc_oneshot_chan_cfg_t chan_config = { .atten = ADC_ATTEN_DB_12, .bitwidth = ADC_BITWIDTH_12 };
-    ESP_ERROR_CHECK(adc_oneshot_config_channel(adc1_handle, MQ135_ADC_CHANNEL, &chan_config));
-    ESP_LOGI(TAG_MQ135, "[%s] ADC1 CH%d (MQ135) configurado.", DEVICE_ID, MQ135_ADC_CHANNEL);
-    ESP_ERROR_CHECK(adc_oneshot_config_channel(adc1_handle, LIGHT_SENSOR_ADC_CHANNEL, &chan_config));
-    ESP_LOGI(TAG_LIGHT_SENSOR, "[%s] ADC1 CH%d (Light Sensor) configurado.", DEVICE_ID, LIGHT_SENSOR_ADC_CHANNEL);
-}
-
-void dht11_init_sensor() {
-    ESP_LOGI(TAG_DHT11, "[%s] DHT11 no GPIO %d pronto para leitura.", DEVICE_ID, DHT11_GPIO);
+    ESP_ERROR_CHECK(ledc_fade_func_install(0));
+    light_control_init(&light_control, LIGHT_SENSOR_THRESHOLD_RED, LIGHT_SENSOR_THRESHOLD_GREEN, LIGHT_SENSOR_HYSTERESIS);
+    ESP_LOGI(TAG, "[%s] LED RGB inicializado no LEDC, GPIOs R:%d G:%d B:%d", DEVICE_ID, RED_LED_GPIO, GREEN_LED_GPIO, BLUE_LED_GPIO);
 }
 
 void app_main(void) {
     ESP_LOGI(TAG, "[%s] Iniciando app_main...", DEVICE_ID);
     ESP_ERROR_CHECK(nvs_flash_init());
+    hot_log_init(uptime_ms);
     
-    // Resetando os pinos
-    gpio_reset_pin(RED_LED_GPIO);
-    gpio_reset_pin(GREEN_LED_GPIO);
-    gpio_reset_pin(BLUE_LED_GPIO);
-
-    // Configurando como saída
-    gpio_set_direction(RED_LED_GPIO, GPIO_MODE_OUTPUT);
-    gpio_set_direction(GREEN_LED_GPIO, GPIO_MODE_OUTPUT);
-    gpio_set_direction(BLUE_LED_GPIO, GPIO_MODE_OUTPUT);
-
-    // Apagando todos inicialmente
-    gpio_set_level(RED_LED_GPIO, 0);
-    gpio_set_level(GREEN_LED_GPIO, 0);
-    gpio_set_level(BLUE_LED_GPIO, 0);
-
-    ESP_LOGI(TAG, "[%s] LED RGB inicializado nos GPIOs R:%d G:%d B:%d", DEVICE_ID, RED_LED_GPIO, GREEN_LED_GPIO, BLUE_LED_GPIO);
-    
-    init_bmp280(); 
-    adc_init_all();
-    dht11_init_sensor();
-    //calibrate_mq135(); // Calibra o sensor MQ-135 ao iniciar
+    light_leds_init();
+
+    next_seq = esp_random();
+    connection_events = xEventGroupCreateStatic(&connection_events_storage);
+    register_sensors();
+    sampling_task_handle = xTaskCreateStatic(sampling_task, "sampling_task", SAMPLING_TASK_STACK_SIZE, NULL, TASK_PRIORITY,
+                                             sampling_task_stack, &sampling_task_tcb);
+#if ADC_ACQUISITION_MODE == ADC_ACQUISITION_ONESHOT
+    light_control_task_handle = xTaskCreateStatic(light_control_task, "light_control", LIGHT_CONTROL_TASK_STACK_SIZE, NULL,
+                                                  LIGHT_CONTROL_TASK_PRIORITY, light_control_task_stack, &light_control_task_tcb);
+#endif
 
     wifi_init_sta();
+    sntp_init_clock();
 
     esp_mqtt_client_config_t mqtt_cfg = {
         .broker.address.uri = MQTT_BROKER,
         .credentials.username = MQTT_USERNAME,
         .credentials.authentication.password = MQTT_PASSWORD,
+#if LOW_POWER_MODE_ENABLED
+        .session.keepalive = LOW_POWER_KEEPALIVE_SECONDS,
+#else
         .session.keepalive = MQTT_KEEPALIVE_SECONDS,
+#endif
         .session.last_will = { 
             .topic = MQTT_STATUS_TOPIC, 
             .msg = MQTT_LAST_WILL_MESSAGE, 
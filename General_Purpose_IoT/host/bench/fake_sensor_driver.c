@@ -0,0 +1,36 @@
+#include <stdio.h>
+#include "fake_sensor_driver.h"
+
+static uint32_t fake_count;
+static uint32_t fake_fail_every;
+
+void fake_sensor_reset(uint32_t fail_every) {
+    fake_count = 0;
+    fake_fail_every = fail_every;
+}
+
+static esp_err_t fake_sensor_read(telemetry_reading_t *reading) {
+    fake_count++;
+    if (fake_fail_every && fake_count % fake_fail_every == 0) return ESP_ERR_TIMEOUT;
+    reading->external.values[0] = (float)fake_count;
+    return ESP_OK;
+}
+
+// JSON {"count":N} com os metadados de sempre; sem formato binário
+static size_t fake_sensor_encode(const telemetry_reading_t *reading, const telemetry_meta_t *meta,
+                                 bool binary, uint8_t *buf, size_t cap) {
+    if (binary) return 0;
+    int written = snprintf((char *)buf, cap, "{\"count\":%lu}", (unsigned long)reading->external.values[0]);
+    if (written < 0 || (size_t)written >= cap) return 0;
+    return telemetry_json_append_meta((char *)buf, (size_t)written, cap, meta);
+}
+
+const sensor_driver_t fake_sensor_driver = {
+    .name = "fake",
+    .sensor = FAKE_SENSOR_ID,
+    .topic = "esp32_01/sensor/fake",
+    .period_ms = 500,
+    .phase_ms = 250,
+    .read = fake_sensor_read,
+    .encode = fake_sensor_encode,
+};
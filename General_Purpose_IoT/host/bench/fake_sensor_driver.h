@@ -0,0 +1,22 @@
+#ifndef FAKE_SENSOR_DRIVER_H
+#define FAKE_SENSOR_DRIVER_H
+
+#include <stdint.h>
+#include "sensor_registry.h"
+
+// ======================================================
+// --- DRIVER DE SENSOR FALSO (HOST) ---
+// ======================================================
+// Sensor fora de telemetry_codec (id TELEMETRY_SENSOR_EXTERNAL, encode
+// próprio) usado pelo benchmark para mostrar que um sensor novo é só um
+// sensor_driver_t: o registro, o agendador e a publicação não mudam.
+// Cada leitura devolve um contador crescente; uma a cada fail_every falha.
+
+#define FAKE_SENSOR_ID ((telemetry_sensor_t)(TELEMETRY_SENSOR_EXTERNAL + 0))
+
+extern const sensor_driver_t fake_sensor_driver;
+
+// Reinicia o contador e define a cada quantas leituras uma falha (0 nunca)
+void fake_sensor_reset(uint32_t fail_every);
+
+#endif // FAKE_SENSOR_DRIVER_H
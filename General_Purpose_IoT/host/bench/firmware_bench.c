@@ -0,0 +1,1478 @@
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "hal_stub.h"
+#include "sensor_scheduler.h"
+#include "sensor_batch.h"
+#include "telemetry_codec.h"
+#include "sensor_math.h"
+#include "fast_math.h"
+#include "sensor_read.h"
+#include "reading_buffer.h"
+#include "adc_reduce.h"
+#include "publish_policy.h"
+#include "light_control.h"
+#include "sensor_registry.h"
+#include "fake_sensor_driver.h"
+#include "gpio_control.h"
+#include "mqtt_outbox.h"
+#include "gpio_latency.h"
+#include "runtime_metrics.h"
+#include "hot_log.h"
+#include "radio_burst.h"
+#include "board_config.h"
+
+// ======================================================
+// --- BENCHMARK DA LÓGICA DOS FIRMWARES NO HOST ---
+// ======================================================
+// Mede o custo por operação dos caminhos executados a cada amostra (leitura,
+// conversão, codificação, lote, agendador) e a cada comando de GPIO, com a
+// HAL simulada. Uso: firmware_bench [iterações] [filtro por nome]
+
+#define DEFAULT_ITERATIONS 200000
+
+static volatile uint32_t bench_sink;   // Impede que o compilador descarte os resultados
+static uint32_t bench_failures;        // Verificações dos relatórios que falharam: código de saída
+
+// Marca de uma verificação dos relatórios; cada FALHA conta para o código de saída
+static const char *check(bool ok) {
+    if (!ok) bench_failures++;
+    return ok ? "ok" : "FALHA";
+}
+
+static const mq135_calibration_t bench_mq135 = {
+    .r0 = 10.55f, .slope = -0.3376f, .y_intercept = 0.7165f, .ref_voltage = 10.0f, .adc_full_scale = 4095.0f,
+};
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Fórmulas originais em double: referência do relatório de precisão
+static double reference_sea_level_pressure(float pressure_pa, float temperature_c, float altitude_m) {
+    return pressure_pa * 0.01 / pow(1.0 - (STANDARD_LAPSE_RATE * altitude_m) / (temperature_c + STANDARD_LAPSE_RATE * altitude_m + SEA_LEVEL_TEMP_K), EXPONENT);
+}
+
+static double reference_mq135_ppm(int adc_reading, const mq135_calibration_t *cal) {
+    double razao = mq135_resistance(adc_reading, cal) / cal->r0;
+    return pow(10, (log10(razao) - cal->y_intercept) / cal->slope);
+}
+
+// --- Casos ---
+// sensor_math/* mede a implementação escolhida em SENSOR_MATH_IMPL; reference/* e
+// fast_math/* medem as alternativas diretamente, para comparar no mesmo binário.
+
+static void bench_sea_level_pressure(uint32_t iterations) {
+    float acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        acc += sensor_sea_level_pressure(101000.0f + (i & 255), 20.0f + (i & 15), 27.0f);
+    }
+    bench_sink += (uint32_t)acc;
+}
+
+static void bench_mq135_ppm(uint32_t iterations) {
+    float acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        acc += mq135_ppm(1000 + (int)(i & 1023), &bench_mq135);
+    }
+    bench_sink += (uint32_t)acc;
+}
+
+static void bench_reference_sea_level(uint32_t iterations) {
+    double acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        acc += reference_sea_level_pressure(101000.0f + (i & 255), 20.0f + (i & 15), 27.0f);
+    }
+    bench_sink += (uint32_t)acc;
+}
+
+static void bench_reference_mq135(uint32_t iterations) {
+    double acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        acc += reference_mq135_ppm(1000 + (int)(i & 1023), &bench_mq135);
+    }
+    bench_sink += (uint32_t)acc;
+}
+
+static void bench_fast_sea_level(uint32_t iterations) {
+    static sea_level_table_t table;
+    float acc = 0;
+    sea_level_table_init(&table, 27.0f);
+    for (uint32_t i = 0; i < iterations; i++) {
+        float factor;
+        if (sea_level_table_factor(&table, 20.0f + (i & 15), &factor)) acc += (101000.0f + (i & 255)) * PA_TO_HPA * factor;
+    }
+    bench_sink += (uint32_t)acc;
+}
+
+static void bench_fast_mq135(uint32_t iterations) {
+    mq135_curve_t curve;
+    float acc = 0;
+    mq135_curve_init(&curve, &bench_mq135);
+    for (uint32_t i = 0; i < iterations; i++) {
+        acc += mq135_curve_ppm(&curve, mq135_resistance(1000 + (int)(i & 1023), &bench_mq135) / bench_mq135.r0);
+    }
+    bench_sink += (uint32_t)acc;
+}
+
+static void bench_read_bmp280(uint32_t iterations) {
+    bmp280_t dev = { 0 };
+    telemetry_reading_t reading;
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (sensor_read_bmp280(&dev, 27.0f, &reading) == ESP_OK) bench_sink += (uint32_t)reading.bmp280.pressure_sea_level;
+    }
+}
+
+static void bench_read_mq135(uint32_t iterations) {
+    telemetry_reading_t reading;
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (sensor_read_mq135(NULL, ADC_CHANNEL_6, &bench_mq135, &reading) == ESP_OK) bench_sink += (uint32_t)reading.mq135.ppm;
+    }
+}
+
+static telemetry_reading_t sample_reading(uint32_t i) {
+    static bmp280_t dev;
+    telemetry_reading_t reading;
+    switch (i & 3) {
+        case 0: sensor_read_bmp280(&dev, 27.0f, &reading); break;
+        case 1: sensor_read_dht(DHT_TYPE_DHT11, 23, &reading); break;
+        case 2: sensor_read_mq135(NULL, ADC_CHANNEL_6, &bench_mq135, &reading); break;
+        default: sensor_read_ldr(NULL, ADC_CHANNEL_5, &reading); break;
+    }
+    return reading;
+}
+
+static void bench_format_json(uint32_t iterations) {
+    telemetry_reading_t readings[4];
+    char buf[160];
+    for (uint32_t i = 0; i < 4; i++) readings[i] = sample_reading(i);
+    for (uint32_t i = 0; i < iterations; i++) {
+        bench_sink += (uint32_t)telemetry_format_json(&readings[i & 3], NULL, buf, sizeof(buf));
+    }
+}
+
+static void bench_encode_binary(uint32_t iterations) {
+    telemetry_reading_t readings[4];
+    uint8_t buf[TELEMETRY_MAX_RECORD_SIZE];
+    for (uint32_t i = 0; i < 4; i++) readings[i] = sample_reading(i);
+    for (uint32_t i = 0; i < iterations; i++) {
+        bench_sink += (uint32_t)telemetry_encode_binary(&readings[i & 3], NULL, buf, sizeof(buf));
+    }
+}
+
+// Caminho completo de uma amostra publicada individualmente em JSON (com seq e ts)
+static void bench_sample_publish_json(uint32_t iterations) {
+    esp_mqtt_client_handle_t client = hal_stub_mqtt_client();
+    char buf[160];
+    for (uint32_t i = 0; i < iterations; i++) {
+        telemetry_reading_t reading = sample_reading(i);
+        telemetry_meta_t meta = { .flags = TELEMETRY_META_SEQ | TELEMETRY_META_TS, .seq = i, .ts_ms = 1760000000000LL + i };
+        size_t len = telemetry_format_json(&reading, &meta, buf, sizeof(buf));
+        bench_sink += (uint32_t)esp_mqtt_client_publish(client, "esp32_01/sensor/x", buf, (int)len, 0, 0);
+    }
+}
+
+static void count_flush(const char *payload, size_t len, size_t readings, void *ctx) {
+    (void)payload;
+    (void)ctx;
+    bench_sink += (uint32_t)(len + readings);
+}
+
+static void bench_batch_json(uint32_t iterations) {
+    static sensor_batch_t batch;
+    char buf[160];
+    sensor_batch_init(&batch, 2000, 4, false, count_flush, NULL);
+    for (uint32_t i = 0; i < iterations; i++) {
+        telemetry_reading_t reading = sample_reading(i);
+        telemetry_format_json(&reading, NULL, buf, sizeof(buf));
+        sensor_batch_add(&batch, telemetry_sensor_name(reading.sensor), buf, i);
+    }
+    sensor_batch_flush(&batch);
+}
+
+static void bench_batch_binary(uint32_t iterations) {
+    static sensor_batch_t batch;
+    uint8_t record[TELEMETRY_MAX_RECORD_SIZE];
+    sensor_batch_init(&batch, 2000, 4, true, count_flush, NULL);
+    for (uint32_t i = 0; i < iterations; i++) {
+        telemetry_reading_t reading = sample_reading(i);
+        size_t len = telemetry_encode_binary(&reading, NULL, record, sizeof(record));
+        sensor_batch_add_record(&batch, record, len, i);
+    }
+    sensor_batch_flush(&batch);
+}
+
+// Desconexão de 64 leituras seguida do envio da fila com age_ms (custo por leitura)
+#define BENCH_OFFLINE_CAPACITY 64
+
+static void bench_offline_drain(uint32_t iterations) {
+    static reading_buffer_entry_t storage[BENCH_OFFLINE_CAPACITY];
+    static reading_buffer_t buffer;
+    esp_mqtt_client_handle_t client = hal_stub_mqtt_client();
+    char buf[160];
+    reading_buffer_init(&buffer, storage, BENCH_OFFLINE_CAPACITY);
+    for (uint32_t i = 0; i < iterations; i++) {
+        telemetry_reading_t reading = sample_reading(i);
+        reading_buffer_push(&buffer, &reading, i, i * 500u);
+        if (reading_buffer_count(&buffer) < BENCH_OFFLINE_CAPACITY && i + 1 < iterations) continue;
+        const reading_buffer_entry_t *entry;
+        while ((entry = reading_buffer_peek(&buffer)) != NULL) {
+            telemetry_meta_t meta = {
+                .flags = TELEMETRY_META_AGE | TELEMETRY_META_SEQ | TELEMETRY_META_TS,
+                .age_ms = i * 500u - entry->sampled_at_ms,
+                .seq = entry->seq,
+                .ts_ms = 1760000000000LL + entry->sampled_at_ms,
+            };
+            size_t len = telemetry_format_json(&entry->reading, &meta, buf, sizeof(buf));
+            bench_sink += (uint32_t)esp_mqtt_client_publish(client, "esp32_01/sensor/x", buf, (int)len, 0, 0);
+            reading_buffer_pop(&buffer);
+        }
+    }
+}
+
+// --- ADC: one-shot x rajada contínua (custo por par MQ-135 + LDR publicado) ---
+// O caminho one-shot faz uma conversão por sensor; a rajada faz 64 por canal
+// e reduz tudo em uma passada antes de montar as duas leituras.
+#define BENCH_ADC_BURST_BYTES 256
+
+static void bench_adc_oneshot(uint32_t iterations) {
+    telemetry_reading_t mq135, ldr;
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (sensor_read_mq135(NULL, ADC_CHANNEL_6, &bench_mq135, &mq135) == ESP_OK &&
+            sensor_read_ldr(NULL, ADC_CHANNEL_5, &ldr) == ESP_OK) {
+            bench_sink += (uint32_t)mq135.mq135.ppm + ldr.ldr.ldr_raw;
+        }
+    }
+}
+
+static adc_continuous_handle_t bench_adc_continuous(adc_reduce_t *reduce) {
+    static const uint8_t channels[] = { ADC_CHANNEL_6, ADC_CHANNEL_5 };
+    adc_digi_pattern_config_t pattern[2];
+    for (size_t i = 0; i < 2; i++) {
+        pattern[i] = (adc_digi_pattern_config_t){ .atten = ADC_ATTEN_DB_12, .channel = channels[i], .unit = ADC_UNIT_1, .bit_width = ADC_BITWIDTH_12 };
+    }
+    adc_continuous_handle_cfg_t handle_cfg = { .max_store_buf_size = 1024, .conv_frame_size = BENCH_ADC_BURST_BYTES };
+    adc_continuous_config_t config = {
+        .pattern_num = 2, .adc_pattern = pattern, .sample_freq_hz = SOC_ADC_SAMPLE_FREQ_THRES_LOW,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1, .format = ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+    };
+    adc_continuous_handle_t adc;
+    adc_continuous_new_handle(&handle_cfg, &adc);
+    adc_continuous_config(adc, &config);
+    adc_reduce_init(reduce, channels, 2);
+    return adc;
+}
+
+static void bench_adc_burst(uint32_t iterations) {
+    static adc_reduce_t reduce;
+    adc_continuous_handle_t adc = bench_adc_continuous(&reduce);
+    telemetry_reading_t mq135, ldr;
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (sensor_read_adc_burst(adc, &reduce, BENCH_ADC_BURST_BYTES, 100) == ESP_OK &&
+            sensor_read_mq135_reduced(&reduce, ADC_CHANNEL_6, &bench_mq135, &mq135) == ESP_OK &&
+            sensor_read_ldr_reduced(&reduce, ADC_CHANNEL_5, &ldr) == ESP_OK) {
+            bench_sink += (uint32_t)mq135.mq135.ppm + ldr.ldr.ldr_raw;
+        }
+    }
+}
+
+// Só o núcleo de redução, sobre um quadro já convertido
+static void bench_adc_reduce_feed(uint32_t iterations) {
+    static adc_reduce_t reduce;
+    uint8_t frame[BENCH_ADC_BURST_BYTES];
+    uint32_t got = 0;
+    adc_continuous_handle_t adc = bench_adc_continuous(&reduce);
+    adc_continuous_start(adc);
+    adc_continuous_read(adc, frame, sizeof(frame), &got, 0);
+    adc_continuous_stop(adc);
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint16_t mean_q4;
+        adc_reduce_reset(&reduce);
+        adc_reduce_feed(&reduce, frame, got);
+        if (adc_reduce_mean_q4(&reduce, ADC_CHANNEL_6, &mean_q4)) bench_sink += mean_q4;
+    }
+}
+
+// Decisão da banda morta para leituras do BMP280 (ruído da HAL simulada: ±0,5 °C, ±128 Pa)
+static void bench_publish_policy(uint32_t iterations) {
+    static bmp280_t dev;
+    publish_policy_t policy = { .sensor = TELEMETRY_SENSOR_BMP280, .fields = { { 0.2f, 60000 }, { 0.5f, 60000 }, { 0.5f, 60000 } } };
+    telemetry_reading_t readings[16];
+    for (uint32_t i = 0; i < 16; i++) sensor_read_bmp280(&dev, 27.0f, &readings[i]);
+    for (uint32_t i = 0; i < iterations; i++) {
+        bench_sink += publish_policy_should_publish(&policy, &readings[i & 15], (int64_t)i * 2000);
+    }
+}
+
+// Controle do LED pelo LDR: rampa lenta cruzando os dois limiares com ruído de ±96 contagens
+static void bench_light_control(uint32_t iterations) {
+    light_control_t ctl;
+    uint32_t duty[LIGHT_COLORS];
+    light_control_init(&ctl, 1365, 2730, 100);
+    for (uint32_t i = 0; i < iterations; i++) {
+        int value = (int)((i >> 4) % 4096) + (int)((i * 2654435761u >> 24) % 193) - 96;
+        uint16_t raw = (uint16_t)(value < 0 ? 0 : value > 4095 ? 4095 : value);
+        if (light_control_update(&ctl, raw)) {
+            light_control_duty(ctl.level, 1023, duty);
+            bench_sink += duty[LIGHT_RED];
+        }
+    }
+    bench_sink += ctl.transitions;
+}
+
+static void count_sample(void *ctx) {
+    (void)ctx;
+    bench_sink++;
+}
+
+static void bench_scheduler(uint32_t iterations) {
+    static sensor_scheduler_t sched;
+    sensor_scheduler_init(&sched);
+    sensor_scheduler_register(&sched, "heartbeat", 20000, 0, count_sample, NULL, 0);
+    sensor_scheduler_register(&sched, "bmp280", 2000, 0, count_sample, NULL, 0);
+    sensor_scheduler_register(&sched, "dht11", 2000, 500, count_sample, NULL, 0);
+    sensor_scheduler_register(&sched, "mq135", 2000, 1000, count_sample, NULL, 0);
+    sensor_scheduler_register(&sched, "ldr", 2000, 1500, count_sample, NULL, 0);
+    int64_t now = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        now = sensor_scheduler_next_deadline(&sched);
+        bench_sink += (uint32_t)sensor_scheduler_run_due(&sched, now);
+    }
+}
+
+// --- Registro de Drivers ---
+// Um driver do codec (BMP280 na HAL simulada) e o driver falso pelo mesmo
+// caminho do firmware: agendador -> sensor_registry -> encode -> publicação.
+static int64_t registry_clock;
+
+static int64_t registry_clock_ms(void) {
+    return registry_clock;
+}
+
+static esp_err_t host_bmp280_read(telemetry_reading_t *reading) {
+    static bmp280_t dev;
+    return sensor_read_bmp280(&dev, 27.0f, reading);
+}
+
+static const sensor_driver_t host_bmp280_driver = {
+    .name = "bmp280",
+    .sensor = TELEMETRY_SENSOR_BMP280,
+    .topic = "esp32_01/sensor/bmp280",
+    .period_ms = 2000,
+    .read = host_bmp280_read,
+};
+
+static const sensor_driver_t *const registry_drivers[] = { &host_bmp280_driver, &fake_sensor_driver };
+#define REGISTRY_DRIVERS (sizeof(registry_drivers) / sizeof(registry_drivers[0]))
+
+typedef struct {
+    uint32_t published[REGISTRY_DRIVERS];
+    char last[REGISTRY_DRIVERS][160];
+} registry_out_t;
+
+static void registry_publish(const sensor_driver_t *driver, const telemetry_reading_t *reading, void *ctx) {
+    registry_out_t *out = ctx;
+    size_t i = driver == &fake_sensor_driver ? 1 : 0;
+    telemetry_meta_t meta = { .flags = TELEMETRY_META_SEQ, .seq = out->published[i] };
+    if (sensor_registry_encode(driver, reading, &meta, false, (uint8_t *)out->last[i], sizeof(out->last[i])) > 0) {
+        out->published[i]++;
+    }
+}
+
+// Executa até steps prazos do agendador ou até until_ms no relógio simulado
+static void run_registry(sensor_registry_t *reg, registry_out_t *out, uint32_t steps, int64_t until_ms) {
+    static sensor_scheduler_t sched;
+    const sensor_registry_sink_t sink = { .reading = registry_publish, .ctx = out };
+    registry_clock = 0;
+    sensor_scheduler_init(&sched);
+    sensor_registry_init(reg, registry_drivers, REGISTRY_DRIVERS, &sched, &sink, registry_clock_ms);
+    for (uint32_t i = 0; i < steps && sensor_scheduler_next_deadline(&sched) <= until_ms; i++) {
+        registry_clock = sensor_scheduler_next_deadline(&sched);
+        sensor_scheduler_run_due(&sched, registry_clock);
+    }
+    if (until_ms < INT64_MAX) registry_clock = until_ms;
+}
+
+static void bench_sensor_registry(uint32_t iterations) {
+    static sensor_registry_t reg;
+    static registry_out_t out;
+    fake_sensor_reset(7);
+    run_registry(&reg, &out, iterations, INT64_MAX);
+    bench_sink += out.published[0] + out.published[1];
+}
+
+// --- Reconexões ---
+// Modelo da sampling_task do firmware local sobre os módulos reais (agendador,
+// registro de drivers, fila offline). A tarefa existe o tempo todo: a queda do
+// link só muda o destino das leituras. Sem conexão elas vão para a fila; ao
+// reconectar a tarefa é notificada e envia a fila em rodadas de
+// STORM_DRAIN_BURST a cada STORM_DRAIN_INTERVAL_MS, como drain_offline_buffer.
+#define STORM_OFFLINE_CAPACITY 256
+#define STORM_DRAIN_BURST 8
+#define STORM_DRAIN_INTERVAL_MS 100
+
+typedef struct {
+    reading_buffer_t buffer;
+    bool connected;
+    int64_t connected_at_ms;        // -1 depois da primeira publicação desta conexão
+    int64_t next_drain_ms;
+    uint32_t published;
+    uint32_t reconnects;
+    uint32_t first_publishes;       // Reconexões que publicaram antes de cair de novo
+    int64_t worst_first_publish_ms;
+    int64_t total_first_publish_ms;
+} storm_state_t;
+
+static storm_state_t storm;
+static reading_buffer_entry_t storm_storage[STORM_OFFLINE_CAPACITY];
+
+static void storm_publish(const sensor_driver_t *driver, const telemetry_reading_t *reading, const telemetry_meta_t *meta) {
+    char buf[160];
+    size_t len = sensor_registry_encode(driver, reading, meta, false, (uint8_t *)buf, sizeof(buf));
+    bench_sink += (uint32_t)esp_mqtt_client_publish(hal_stub_mqtt_client(), driver->topic, buf, (int)len, 0, 0);
+    storm.published++;
+    if (storm.connected_at_ms >= 0) {
+        int64_t latency_ms = registry_clock - storm.connected_at_ms;
+        if (latency_ms > storm.worst_first_publish_ms) storm.worst_first_publish_ms = latency_ms;
+        storm.total_first_publish_ms += latency_ms;
+        storm.first_publishes++;
+        storm.connected_at_ms = -1;
+    }
+}
+
+static void storm_reading(const sensor_driver_t *driver, const telemetry_reading_t *reading, void *ctx) {
+    (void)ctx;
+    if (storm.connected && reading_buffer_count(&storm.buffer) == 0) {
+        telemetry_meta_t meta = { .flags = TELEMETRY_META_SEQ, .seq = storm.published };
+        storm_publish(driver, reading, &meta);
+        return;
+    }
+    reading_buffer_push(&storm.buffer, reading, storm.published, (uint32_t)registry_clock);
+}
+
+static void storm_drain(const sensor_registry_t *reg) {
+    const reading_buffer_entry_t *entry;
+    for (int sent = 0; sent < STORM_DRAIN_BURST && (entry = reading_buffer_peek(&storm.buffer)) != NULL; sent++) {
+        telemetry_meta_t meta = {
+            .flags = TELEMETRY_META_SEQ | TELEMETRY_META_AGE,
+            .seq = entry->seq,
+            .age_ms = (uint32_t)registry_clock - entry->sampled_at_ms,
+        };
+        storm_publish(sensor_registry_find(reg, entry->reading.sensor), &entry->reading, &meta);
+        reading_buffer_pop(&storm.buffer);
+    }
+}
+
+static void storm_set_connected(bool connected) {
+    storm.connected = connected;
+    // Conectou: a notificação acorda a tarefa na hora. Caiu antes de publicar: não conta.
+    storm.connected_at_ms = connected ? registry_clock : -1;
+    if (connected) {
+        storm.reconnects++;
+        storm.next_drain_ms = registry_clock;
+    }
+}
+
+// cycles quedas do link com duração e intervalo pseudoaleatórios (50 ms a ~3 s)
+static void run_reconnect_storm(sensor_registry_t *reg, uint32_t cycles) {
+    static sensor_scheduler_t sched;
+    const sensor_registry_sink_t sink = { .reading = storm_reading };
+    uint32_t rng = 12345;
+    int64_t next_flip_ms = 0;
+    memset(&storm, 0, sizeof(storm));
+    reading_buffer_init(&storm.buffer, storm_storage, STORM_OFFLINE_CAPACITY);
+    storm.connected = true;
+    storm.connected_at_ms = -1;
+    registry_clock = 0;
+    sensor_scheduler_init(&sched);
+    sensor_registry_init(reg, registry_drivers, REGISTRY_DRIVERS, &sched, &sink, registry_clock_ms);
+    for (uint32_t flips = 0; flips < 2 * cycles;) {
+        bool draining = storm.connected && reading_buffer_count(&storm.buffer) > 0;
+        int64_t deadline = sensor_scheduler_next_deadline(&sched);
+        if (draining && storm.next_drain_ms < deadline) deadline = storm.next_drain_ms;
+        if (next_flip_ms <= deadline) {
+            registry_clock = next_flip_ms;
+            storm_set_connected(!storm.connected);
+            rng = rng * 1664525u + 1013904223u;
+            next_flip_ms = registry_clock + 50 + (rng >> 16) % 3000;
+            flips++;
+            continue;
+        }
+        registry_clock = deadline;
+        sensor_scheduler_run_due(&sched, registry_clock);
+        if (draining && registry_clock >= storm.next_drain_ms) {
+            storm_drain(reg);
+            storm.next_drain_ms = registry_clock + STORM_DRAIN_INTERVAL_MS;
+        }
+    }
+}
+
+static void bench_reconnect_storm(uint32_t iterations) {
+    static sensor_registry_t reg;
+    fake_sensor_reset(0);
+    run_reconnect_storm(&reg, iterations);
+    bench_sink += storm.published;
+}
+
+static void bench_gpio_command_parse(uint32_t iterations) {
+    static const char *topics[] = { "esp32_02/gpio/2/set", "esp32_02/gpio/23/set", "esp32_02/gpio/x/set", "esp32_02/status" };
+    static const char *payloads[] = { "ON", "OFF", "TOGGLE", "BLINK" };
+    for (uint32_t i = 0; i < iterations; i++) {
+        const char *topic = topics[i & 3];
+        const char *payload = payloads[(i >> 2) & 3];
+        int pin;
+        if (gpio_command_parse_topic(topic, (int)strlen(topic), "esp32_02/gpio/", "/set", &pin)) {
+            bench_sink += (uint32_t)pin + gpio_command_parse_action(payload, (int)strlen(payload));
+        }
+    }
+}
+
+// Os dois brokers conectados, cada um num cliente simulado
+static void bench_outbox_connect(void) {
+    mqtt_outbox_init();
+    for (int b = 0; b < MQTT_OUTBOX_BROKERS; b++) {
+        mqtt_outbox_attach((mqtt_outbox_broker_t)b, hal_stub_mqtt_client_at(b));
+        mqtt_outbox_set_connected((mqtt_outbox_broker_t)b, true);
+    }
+}
+
+static void bench_gpio_set_and_publish(uint32_t iterations) {
+    static const int pins[] = { 2, 4, 5, 13, 14, 16, 17, 18 };
+    bench_outbox_connect();
+    gpio_control_init("storage", "esp32_02/gpio/%d/state", "esp32_02/gpio/bulk/state");
+    for (uint32_t i = 0; i < iterations; i++) {
+        gpio_control_set_and_publish(pins[i & 7], (i >> 3) & 1, (int64_t)i);
+    }
+    bench_sink += hal_stub_counters.mqtt_publishes;
+}
+
+// Só o caminho rápido (registrador + estado em RAM), sem publicação
+static void bench_gpio_set_fast(uint32_t iterations) {
+    static const int pins[] = { 2, 4, 5, 13, 14, 16, 17, 18 };
+    gpio_control_configure_pins(pins, 8);
+    for (uint32_t i = 0; i < iterations; i++) {
+        bench_sink += gpio_control_set(pins[i & 7], (i >> 3) & 1, (int64_t)i);
+    }
+    bench_sink += hal_stub_counters.gpio_resets;
+}
+
+static void bench_gpio_bulk_parse(uint32_t iterations) {
+    static const char *payloads[] = {
+        "{\"mask\":100712500,\"value\":33554436}",
+        "{\"on\":[2,4,16,25],\"off\":[5,13,14,17,18,32]}",
+        "{\"mask\":36, \"value\":4, \"off\":[33]}",
+        "{\"on\":[2],\"off\":[2]}",
+    };
+    for (uint32_t i = 0; i < iterations; i++) {
+        const char *payload = payloads[i & 3];
+        uint64_t mask, value;
+        if (gpio_bulk_parse(payload, (int)strlen(payload), &mask, &value)) bench_sink += (uint32_t)(mask ^ value);
+    }
+}
+
+// Cena de 10 pinos: um comando em lote contra 10 comandos por pino
+static void bench_gpio_bulk_scene(uint32_t iterations) {
+    static const int pins[] = { 2, 4, 5, 13, 14, 16, 17, 18, 25, 32 };
+    uint64_t mask = 0;
+    for (int p = 0; p < 10; p++) mask |= (uint64_t)1 << pins[p];
+    bench_outbox_connect();
+    gpio_control_init("storage", "esp32_02/gpio/%d/state", "esp32_02/gpio/bulk/state");
+    gpio_control_configure_pins(pins, 10);
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint64_t value = (i & 1) ? mask : 0;
+        gpio_control_set_mask(mask, value, (int64_t)i);
+        gpio_control_publish_bulk_state(mask, value);
+    }
+    bench_sink += (uint32_t)gpio_get_level(32);
+}
+
+static void bench_gpio_scene_per_pin(uint32_t iterations) {
+    static const int pins[] = { 2, 4, 5, 13, 14, 16, 17, 18, 25, 32 };
+    bench_outbox_connect();
+    gpio_control_init("storage", "esp32_02/gpio/%d/state", "esp32_02/gpio/bulk/state");
+    gpio_control_configure_pins(pins, 10);
+    for (uint32_t i = 0; i < iterations; i++) {
+        for (int p = 0; p < 10; p++) gpio_control_set_and_publish(pins[p], i & 1, (int64_t)i);
+    }
+    bench_sink += hal_stub_counters.mqtt_publishes;
+}
+
+static void bench_gpio_latency(uint32_t iterations) {
+    char payload[192];
+    gpio_latency_t stats;
+    for (uint32_t i = 0; i < iterations; i++) {
+        int64_t received_us = (int64_t)i * 1000;
+        gpio_latency_record(received_us, received_us + 3 + (i & 7), received_us + 180 + (i & 63));
+        if ((i & 1023) == 0) {
+            gpio_latency_snapshot(&stats, true);
+            bench_sink += (uint32_t)gpio_latency_format_json(&stats, payload, sizeof(payload));
+        }
+    }
+}
+
+// Rajada de TOGGLE nos 17 pinos do firmware da nuvem, um comando a cada
+// interval_ms, com o timer de gravação simulado como no app_main: cada comando
+// rearma o timer com gpio_state_flush_delay_ms e ele grava quando vence antes
+// do próximo comando. Retorna os commits no NVS.
+static const int storm_pins[] = { 2, 4, 5, 13, 14, 16, 17, 18, 19, 21, 22, 23, 25, 26, 27, 32, 33 };
+
+static uint32_t run_toggle_storm(uint32_t commands, int64_t interval_ms) {
+    const size_t pin_count = sizeof(storm_pins) / sizeof(storm_pins[0]);
+    mqtt_outbox_init();   // Sem brokers: só o custo do NVS
+    gpio_control_init("storage", "esp32_02/gpio/%d/state", "esp32_02/gpio/bulk/state");
+    gpio_state_load_all(storm_pins, pin_count);
+    uint32_t commits_before = hal_stub_counters.nvs_commits;
+    int64_t flush_at_ms = -1;
+    for (uint32_t i = 0; i < commands; i++) {
+        int64_t now_ms = (int64_t)i * interval_ms;
+        if (flush_at_ms >= 0 && flush_at_ms <= now_ms) gpio_state_flush();
+        int pin = storm_pins[(i * 2654435761u >> 16) % pin_count];
+        gpio_control_set_and_publish(pin, gpio_action_apply(GPIO_ACTION_TOGGLE, gpio_state_get(pin)), now_ms);
+        int64_t delay_ms = gpio_state_flush_delay_ms(now_ms);
+        flush_at_ms = delay_ms >= 0 ? now_ms + delay_ms : -1;
+    }
+    gpio_state_flush();   // Timer final (ou desligamento)
+    return hal_stub_counters.nvs_commits - commits_before;
+}
+
+static void bench_gpio_toggle_storm(uint32_t iterations) {
+    bench_sink += run_toggle_storm(iterations, 20);
+}
+
+// Comandos por pino com o broker da nuvem travado (outbox cheia): o custo
+// por comando deve ficar igual ao de set_and_publish
+static void bench_gpio_publish_cloud_stalled(uint32_t iterations) {
+    bench_outbox_connect();
+    hal_stub_mqtt_set_stalled(hal_stub_mqtt_client_at(MQTT_OUTBOX_CLOUD), true);
+    gpio_control_init("storage", "esp32_02/gpio/%d/state", "esp32_02/gpio/bulk/state");
+    for (uint32_t i = 0; i < iterations; i++) {
+        int pin = storm_pins[i % (sizeof(storm_pins) / sizeof(storm_pins[0]))];
+        gpio_control_set_and_publish(pin, (i / 17) & 1, (int64_t)i);
+    }
+    bench_sink += hal_stub_counters.mqtt_publishes;
+}
+
+// --- Métricas de Execução ---
+// Custo de um registro (contadores atômicos + faixa do histograma), com
+// durações que passam por todas as faixas
+static void bench_metrics_record(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        int64_t start_us = (int64_t)i * 1000;
+        runtime_metrics_record((runtime_metric_t)(i % RUNTIME_METRIC_KINDS), start_us, start_us + (i * 2654435761u >> 12), i % 17 != 0);
+    }
+    runtime_metric_window_t ops[RUNTIME_METRIC_KINDS];
+    runtime_metrics_snapshot(ops);
+    bench_sink += ops[0].count;
+}
+
+// --- Logs do Caminho Quente ---
+// Um ciclo de amostragem do firmware local (quatro leituras, JSON e publicação)
+// com as linhas que cada leitura gerava: na UART (ESP_LOGI, como antes),
+// removidas (HOT_LOG_OFF, padrão) e no anel de hot_log (HOT_LOG_RING). A UART é simulada formatando a linha como o
+// ESP_LOGI ("I (ms) TAG: ...", sem as cores) e contando os bytes; a espera pela
+// FIFO sai da contagem no relatório.
+#define UART_BAUD 115200
+#define UART_BITS_PER_BYTE 10   // 8N1
+
+typedef void (*cycle_log_fn)(char level, const char *tag, const char *format, ...);
+
+static uint64_t uart_bytes;
+
+static void uart_log(char level, const char *tag, const char *format, ...) {
+    char line[256];
+    int len = snprintf(line, sizeof(line), "%c (%lu) %s: ", level, (unsigned long)registry_clock, tag);
+    va_list args;
+    va_start(args, format);
+    int body = vsnprintf(line + len, sizeof(line) - len, format, args);
+    va_end(args);
+    uart_bytes += (uint64_t)(len + body + 1);   // + '\n'
+    bench_sink += (uint8_t)line[len];
+}
+
+static void run_sample_cycle(uint32_t cycle, cycle_log_fn log) {
+    static const char *const names[4] = { "bmp280", "dht11", "mq135", "ldr" };
+    esp_mqtt_client_handle_t client = hal_stub_mqtt_client();
+    char json[160];
+    for (uint32_t s = 0; s < 4; s++) {
+        telemetry_reading_t reading = sample_reading(s);
+        telemetry_meta_t meta = { .flags = TELEMETRY_META_SEQ, .seq = cycle * 4 + s };
+        size_t len = telemetry_format_json(&reading, &meta, json, sizeof(json));
+        bench_sink += (uint32_t)esp_mqtt_client_publish(client, "esp32_01/sensor/x", json, (int)len, 0, 0);
+        if (!log) continue;
+        if (s == 0) {
+            log('I', "BMP280", "[%s] Raw temperature: %.2f C, Raw pressure: %.2f hPa, Sea-level pressure: %.2f hPa", "esp32_01",
+                reading.bmp280.temperature, reading.bmp280.pressure_hpa, reading.bmp280.pressure_sea_level);
+        } else if (s == 3) {
+            log('I', "LDR_SENSOR", "[%s] LDR ADC reading: %d", "esp32_01", reading.ldr.ldr_raw);
+        }
+        log('I', "MQTT_APP", "[%s] Dados %s publicados: %s", "esp32_01", names[s], json);
+    }
+}
+
+static void bench_cycle_uart_logs(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) run_sample_cycle(i, uart_log);
+}
+
+static void bench_cycle_ring_logs(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) run_sample_cycle(i, hot_log_ring_write);
+}
+
+static void bench_cycle_no_logs(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) run_sample_cycle(i, NULL);
+}
+
+// --- Rajadas do Rádio ---
+// Custo da política por passagem da sampling_task no modo de baixo consumo
+// (início de rajada, fim da janela acordada e prazo), com o relógio em passos de 100 ms
+static void bench_radio_burst(uint32_t iterations) {
+    radio_burst_t rb;
+    radio_burst_init(&rb, LOW_POWER_BURST_PERIOD_MS, LOW_POWER_BURST_PHASE_MS, LOW_POWER_BURST_LINGER_MS, 0);
+    for (uint32_t i = 0; i < iterations; i++) {
+        int64_t now_ms = (int64_t)i * 100;
+        bench_sink += radio_burst_start(&rb, now_ms);
+        bench_sink += radio_burst_poll_sleep(&rb, now_ms);
+        bench_sink += (uint32_t)radio_burst_deadline(&rb);
+    }
+}
+
+typedef struct {
+    const char *name;
+    void (*run)(uint32_t iterations);
+} bench_case_t;
+
+static const bench_case_t bench_cases[] = {
+    { "sensor_math/sea_level_pressure", bench_sea_level_pressure },
+    { "sensor_math/mq135_ppm", bench_mq135_ppm },
+    { "reference/sea_level_pressure_double", bench_reference_sea_level },
+    { "reference/mq135_ppm_double", bench_reference_mq135 },
+    { "fast_math/sea_level_table", bench_fast_sea_level },
+    { "fast_math/mq135_log2_exp2", bench_fast_mq135 },
+    { "sensor_read/bmp280", bench_read_bmp280 },
+    { "sensor_read/mq135", bench_read_mq135 },
+    { "telemetry/format_json", bench_format_json },
+    { "telemetry/encode_binary", bench_encode_binary },
+    { "sample/read_format_publish_json", bench_sample_publish_json },
+    { "sensor_batch/add_json", bench_batch_json },
+    { "sensor_batch/add_binary", bench_batch_binary },
+    { "reading_buffer/offline_drain_json", bench_offline_drain },
+    { "adc/oneshot_mq135_ldr", bench_adc_oneshot },
+    { "adc/burst_reduce_64x2", bench_adc_burst },
+    { "adc_reduce/feed_256B", bench_adc_reduce_feed },
+    { "publish_policy/should_publish", bench_publish_policy },
+    { "light_control/update_noisy_ramp", bench_light_control },
+    { "sensor_scheduler/run_due", bench_scheduler },
+    { "sensor_registry/bmp280_and_fake", bench_sensor_registry },
+    { "sampling/reconnect_storm", bench_reconnect_storm },
+    { "gpio_control/parse_command", bench_gpio_command_parse },
+    { "gpio_control/set_fast_path", bench_gpio_set_fast },
+    { "gpio_control/set_and_publish", bench_gpio_set_and_publish },
+    { "gpio_control/publish_cloud_stalled", bench_gpio_publish_cloud_stalled },
+    { "gpio_control/toggle_storm_20ms", bench_gpio_toggle_storm },
+    { "gpio_control/bulk_parse", bench_gpio_bulk_parse },
+    { "gpio_control/scene_10_pins_bulk", bench_gpio_bulk_scene },
+    { "gpio_control/scene_10_pins_per_pin", bench_gpio_scene_per_pin },
+    { "gpio_latency/record", bench_gpio_latency },
+    { "runtime_metrics/record", bench_metrics_record },
+    { "hot_log/sample_cycle_uart", bench_cycle_uart_logs },
+    { "hot_log/sample_cycle_off", bench_cycle_no_logs },
+    { "hot_log/sample_cycle_ring", bench_cycle_ring_logs },
+    { "radio_burst/start_poll_deadline", bench_radio_burst },
+};
+
+// --- Precisão ---
+// Maior erro relativo de sensor_math (SENSOR_MATH_IMPL atual) em relação às
+// fórmulas originais em double, varrendo toda a faixa de entrada dos sensores.
+// Os limites ficam bem abaixo da resolução dos sensores (BMP280: ~1e-4 da pressão).
+#define MATH_MAX_PRESSURE_ERROR 1e-5
+#define MATH_MAX_PPM_ERROR 1e-4
+#define MATH_TIMING_ITERATIONS 200000
+
+// Menor de cinco medições: o relatório roda com qualquer número de iterações
+static double time_math(void (*run)(uint32_t)) {
+    double best = 0;
+    run(MATH_TIMING_ITERATIONS / 10);
+    for (int i = 0; i < 5; i++) {
+        double start = now_ns();
+        run(MATH_TIMING_ITERATIONS);
+        double ns = (now_ns() - start) / MATH_TIMING_ITERATIONS;
+        if (i == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+static void report_math_accuracy(void) {
+    double worst_pressure = 0, worst_ppm = 0;
+    float worst_temperature = 0;
+    int worst_adc = 0;
+    for (float pressure_pa = 30000.0f; pressure_pa <= 110000.0f; pressure_pa += 5000.0f) {
+        for (int centi_c = -4000; centi_c <= 8500; centi_c += 7) {
+            float temperature_c = centi_c / 100.0f;
+            double expected = reference_sea_level_pressure(pressure_pa, temperature_c, 27.0f);
+            double error = fabs(sensor_sea_level_pressure(pressure_pa, temperature_c, 27.0f) - expected) / expected;
+            if (error > worst_pressure) {
+                worst_pressure = error;
+                worst_temperature = temperature_c;
+            }
+        }
+    }
+    for (int adc = 1; adc < 4095; adc++) {
+        double expected = reference_mq135_ppm(adc, &bench_mq135);
+        double error = fabs(mq135_ppm(adc, &bench_mq135) - expected) / expected;
+        if (error > worst_ppm) {
+            worst_ppm = error;
+            worst_adc = adc;
+        }
+    }
+    printf("\nprecisão de sensor_math (SENSOR_MATH_IMPL=%d) vs. double:\n", SENSOR_MATH_IMPL);
+    printf("  pressão ao nível do mar: erro relativo máx. %.2e (%.2f °C) %s\n", worst_pressure, worst_temperature,
+           check(worst_pressure < MATH_MAX_PRESSURE_ERROR));
+    printf("  MQ-135 ppm:              erro relativo máx. %.2e (ADC %d) %s\n", worst_ppm, worst_adc,
+           check(worst_ppm < MATH_MAX_PPM_ERROR));
+
+    // Antes (fórmulas em double) e depois, lado a lado no mesmo binário
+    const double ref_sea = time_math(bench_reference_sea_level), ref_ppm = time_math(bench_reference_mq135);
+    const double cur_sea = time_math(bench_sea_level_pressure), cur_ppm = time_math(bench_mq135_ppm);
+    const double fast_sea = time_math(bench_fast_sea_level), fast_ppm = time_math(bench_fast_mq135);
+    printf("\ncusto por conversão (ns), antes (double) e depois:\n");
+    printf("  %-24s %10s %23s %23s\n", "", "double", "sensor_math", "fast_math");
+    printf("  %-26s %10.1f %14.1f (%5.1fx) %14.1f (%5.1fx)\n", "pressão ao nível do mar",   // "ã" e "í" ocupam 2 bytes cada
+           ref_sea, cur_sea, ref_sea / cur_sea, fast_sea, ref_sea / fast_sea);
+    printf("  %-24s %10.1f %14.1f (%5.1fx) %14.1f (%5.1fx)\n", "MQ-135 ppm",
+           ref_ppm, cur_ppm, ref_ppm / cur_ppm, fast_ppm, ref_ppm / fast_ppm);
+}
+
+// --- Registro de Drivers ---
+// 60 s simulados com o BMP280 e o driver falso (uma falha a cada 7 leituras):
+// toda leitura válida chega à publicação e as falhas aparecem na saúde.
+static void report_sensor_registry(void) {
+    static sensor_registry_t reg;
+    static registry_out_t out;
+    char health[384];
+    memset(&out, 0, sizeof(out));
+    hal_stub_reset();
+    fake_sensor_reset(7);
+    run_registry(&reg, &out, UINT32_MAX, 60000);
+    printf("\nsensor_registry, 60 s simulados (driver falso falha a cada 7 leituras):\n");
+    for (size_t i = 0; i < reg.count; i++) {
+        const sensor_health_t *health = &reg.slots[i].health;
+        bool ok = out.published[i] == health->reads - health->failures && health->reads > 0;
+        printf("  %-7s %3lu leituras, %2lu falhas, %3lu publicadas %s  último: %s\n", reg.slots[i].driver->name,
+               (unsigned long)health->reads, (unsigned long)health->failures, (unsigned long)out.published[i],
+               check(ok), out.last[i]);
+    }
+    if (sensor_registry_format_health(&reg, registry_clock, health, sizeof(health)) < (int)sizeof(health)) {
+        printf("  saúde: %s\n", health);
+    }
+}
+
+// --- Reconexões ---
+// 1000 quedas do link com o modelo da sampling_task: o heap não pode crescer
+// (tarefas e filas são estáticas), toda leitura válida é publicada ou contada
+// como descartada e a primeira publicação após reconectar não passa do menor
+// período dos drivers (sai na hora quando há fila).
+static size_t heap_in_use(void) {
+#if defined(__GLIBC__)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+static void report_reconnect_storm(void) {
+    static sensor_registry_t reg;
+    int64_t min_period_ms = INT64_MAX;
+    uint32_t valid = 0;
+    hal_stub_reset();
+    fake_sensor_reset(0);
+    size_t heap_before = heap_in_use();
+    run_reconnect_storm(&reg, 1000);
+    size_t heap_after = heap_in_use();
+    // Reconecta de vez e envia o que sobrou na fila
+    if (!storm.connected) storm_set_connected(true);
+    while (reading_buffer_count(&storm.buffer) > 0) storm_drain(&reg);
+    for (size_t i = 0; i < reg.count; i++) {
+        valid += reg.slots[i].health.reads - reg.slots[i].health.failures;
+        if (reg.slots[i].driver->period_ms < min_period_ms) min_period_ms = reg.slots[i].driver->period_ms;
+    }
+    printf("\nreconexões, %lu quedas do link em %.0f s simulados (fila offline de %d):\n",
+           (unsigned long)storm.reconnects, registry_clock / 1000.0, STORM_OFFLINE_CAPACITY);
+    printf("  heap: %+ld B durante as quedas %s\n", (long)(heap_after - heap_before), check(heap_after == heap_before));
+    printf("  leituras: %lu válidas, %lu publicadas, %lu descartadas, fila máx. %u %s\n",
+           (unsigned long)valid, (unsigned long)storm.published, (unsigned long)storm.buffer.dropped,
+           (unsigned)storm.buffer.high_water, check(storm.published + storm.buffer.dropped == valid));
+    printf("  primeira publicação após reconectar: média %.1f ms, máx. %lld ms (%lu reconexões) %s\n",
+           storm.first_publishes ? (double)storm.total_first_publish_ms / storm.first_publishes : 0.0,
+           (long long)storm.worst_first_publish_ms, (unsigned long)storm.first_publishes,
+           check(storm.worst_first_publish_ms <= min_period_ms));
+}
+
+// --- Fila Offline ---
+// Queda de 3x a capacidade da fila: as leituras mais antigas são descartadas e
+// contadas, a ocupação nunca passa da capacidade e o envio após reconectar sai
+// em ordem, com seq contínuo da primeira leitura que sobrou até a última.
+static void report_offline_buffer(void) {
+    static reading_buffer_entry_t storage[BENCH_OFFLINE_CAPACITY];
+    static reading_buffer_t buffer;
+    const uint32_t total = 3 * BENCH_OFFLINE_CAPACITY + 7;
+    const uint32_t first_seq = UINT32_MAX - 10;   // seq também passa pela volta de 2^32
+    uint32_t refused = 0;
+    size_t max_count = 0;
+    reading_buffer_init(&buffer, storage, BENCH_OFFLINE_CAPACITY);
+    for (uint32_t i = 0; i < total; i++) {
+        telemetry_reading_t reading = sample_reading(i);
+        if (!reading_buffer_push(&buffer, &reading, first_seq + i, i * 500u)) refused++;
+        if (reading_buffer_count(&buffer) > max_count) max_count = reading_buffer_count(&buffer);
+    }
+    uint32_t lost = total - BENCH_OFFLINE_CAPACITY;
+    uint32_t expected_seq = first_seq + lost, drained = 0, out_of_order = 0;
+    const reading_buffer_entry_t *entry;
+    while ((entry = reading_buffer_peek(&buffer)) != NULL) {
+        if (entry->seq != expected_seq || entry->sampled_at_ms != (entry->seq - first_seq) * 500u) out_of_order++;
+        expected_seq++;
+        drained++;
+        reading_buffer_pop(&buffer);
+    }
+    printf("\nfila offline, %lu leituras sem conexão (capacidade %d):\n", (unsigned long)total, BENCH_OFFLINE_CAPACITY);
+    printf("  descartadas: %lu contadas, %lu pushes recusados (esperado %lu) %s\n",
+           (unsigned long)buffer.dropped, (unsigned long)refused, (unsigned long)lost,
+           check(buffer.dropped == lost && refused == lost));
+    printf("  ocupação máx.: %u, marca d'água %u %s\n", (unsigned)max_count, (unsigned)buffer.high_water,
+           check(max_count == BENCH_OFFLINE_CAPACITY && buffer.high_water == BENCH_OFFLINE_CAPACITY));
+    printf("  envio: %lu leituras, seq %lu..%lu, %lu fora de ordem %s\n", (unsigned long)drained,
+           (unsigned long)(first_seq + lost), (unsigned long)(expected_seq - 1), (unsigned long)out_of_order,
+           check(drained == BENCH_OFFLINE_CAPACITY && out_of_order == 0 && expected_seq == first_seq + total));
+}
+
+// --- Gravações no NVS ---
+// Commits do estado dos pinos em rajadas de 1000 TOGGLE; antes da gravação
+// adiada era um commit por comando.
+static void report_nvs_coalescing(void) {
+    static const int64_t intervals_ms[] = { 20, 500, 1500, 5000 };
+    printf("\ncommits no NVS para 1000 TOGGLE (silêncio %d ms, atraso máx. %d ms):\n",
+           GPIO_CONTROL_FLUSH_QUIET_MS, GPIO_CONTROL_FLUSH_MAX_DELAY_MS);
+    for (size_t i = 0; i < sizeof(intervals_ms) / sizeof(intervals_ms[0]); i++) {
+        hal_stub_reset();
+        uint32_t commits = run_toggle_storm(1000, intervals_ms[i]);
+        printf("  um comando a cada %5lld ms: %4lu commits\n", (long long)intervals_ms[i], (unsigned long)commits);
+    }
+}
+
+// --- Fila de Saída ---
+// Rajada de 1000 TOGGLE com o broker da nuvem travado (nada sai da outbox do
+// cliente) e o local saudável. Confere que o local recebeu o último estado de
+// cada pino, que a nuvem parou de ser chamada ao encher a outbox e que, ao
+// destravar, ela recebe só o último estado de cada pino.
+static char outbox_last[HAL_STUB_MQTT_CLIENTS][64][4];
+
+static void record_outbox_message(esp_mqtt_client_handle_t client, const char *topic, const char *data, int len) {
+    int pin;
+    if (sscanf(topic, "esp32_02/gpio/%d/state", &pin) != 1 || pin < 0 || pin >= 64 || len >= 4) return;
+    for (int c = 0; c < HAL_STUB_MQTT_CLIENTS; c++) {
+        if (hal_stub_mqtt_client_at(c) == client) {
+            memcpy(outbox_last[c][pin], data, (size_t)len);
+            outbox_last[c][pin][len] = '\0';
+        }
+    }
+}
+
+static int outbox_pins_in_sync(int client) {
+    int matches = 0;
+    for (size_t i = 0; i < sizeof(storm_pins) / sizeof(storm_pins[0]); i++) {
+        int pin = storm_pins[i];
+        matches += strcmp(outbox_last[client][pin], gpio_state_get(pin) ? "ON" : "OFF") == 0;
+    }
+    return matches;
+}
+
+// Outro drain() do mesmo broker no meio de cada envio, como a tarefa de outra
+// publicação ou o MQTT_EVENT_PUBLISHED rodando enquanto o primeiro envia
+static uint32_t reentrant_sent[64];
+static int reentrant_depth;
+
+static void reentrant_drain_sink(esp_mqtt_client_handle_t client, const char *topic, const char *data, int len) {
+    (void)client;
+    (void)data;
+    (void)len;
+    int pin;
+    if (sscanf(topic, "esp32_02/gpio/%d/state", &pin) == 1 && pin >= 0 && pin < 64) reentrant_sent[pin]++;
+    if (reentrant_depth < 4) {
+        reentrant_depth++;
+        mqtt_outbox_drain(MQTT_OUTBOX_LOCAL);
+        reentrant_depth--;
+    }
+}
+
+static void report_outbox_concurrent_drain(void) {
+    const size_t pin_count = sizeof(storm_pins) / sizeof(storm_pins[0]);
+    hal_stub_reset();
+    memset(reentrant_sent, 0, sizeof(reentrant_sent));
+    bench_outbox_connect();
+    mqtt_outbox_set_connected(MQTT_OUTBOX_LOCAL, false);
+    mqtt_outbox_attach(MQTT_OUTBOX_CLOUD, NULL);
+    gpio_control_init("storage", "esp32_02/gpio/%d/state", "esp32_02/gpio/bulk/state");
+    for (size_t i = 0; i < pin_count; i++) gpio_control_publish_state(storm_pins[i], 1);
+    hal_stub_mqtt_set_sink(reentrant_drain_sink);
+    mqtt_outbox_set_connected(MQTT_OUTBOX_LOCAL, true);
+    hal_stub_mqtt_set_sink(NULL);
+    uint32_t once = 0, total = 0;
+    for (size_t i = 0; i < pin_count; i++) {
+        once += reentrant_sent[storm_pins[i]] == 1;
+        total += reentrant_sent[storm_pins[i]];
+    }
+    mqtt_outbox_stats_t stats;
+    mqtt_outbox_get_stats(MQTT_OUTBOX_LOCAL, &stats);
+    printf("  drain concorrente: %lu envios de %u pinos, %lu enviados uma só vez, %lu pendentes %s\n",
+           (unsigned long)total, (unsigned)pin_count, (unsigned long)once, (unsigned long)stats.pending,
+           check(once == pin_count && total == pin_count && stats.pending == 0));
+}
+
+static void report_outbox_fanout(void) {
+    const size_t pin_count = sizeof(storm_pins) / sizeof(storm_pins[0]);
+    esp_mqtt_client_handle_t cloud = hal_stub_mqtt_client_at(MQTT_OUTBOX_CLOUD);
+    hal_stub_reset();
+    memset(outbox_last, 0, sizeof(outbox_last));
+    hal_stub_mqtt_set_sink(record_outbox_message);
+    bench_outbox_connect();
+    hal_stub_mqtt_set_stalled(cloud, true);
+    gpio_control_init("storage", "esp32_02/gpio/%d/state", "esp32_02/gpio/bulk/state");
+    gpio_state_load_all(storm_pins, pin_count);
+
+    uint32_t cloud_calls_at_full = 0;
+    for (uint32_t i = 0; i < 1000; i++) {
+        int pin = storm_pins[(i * 2654435761u >> 16) % pin_count];
+        gpio_control_set_and_publish(pin, gpio_action_apply(GPIO_ACTION_TOGGLE, gpio_state_get(pin)), (int64_t)i * 20);
+        mqtt_outbox_stats_t stats;
+        mqtt_outbox_get_stats(MQTT_OUTBOX_CLOUD, &stats);
+        if (!cloud_calls_at_full && stats.pending > 0) cloud_calls_at_full = hal_stub_mqtt_stats(cloud).enqueues;
+    }
+    mqtt_outbox_stats_t cloud_stats, local_stats;
+    mqtt_outbox_get_stats(MQTT_OUTBOX_CLOUD, &cloud_stats);
+    mqtt_outbox_get_stats(MQTT_OUTBOX_LOCAL, &local_stats);
+    int local_sync = outbox_pins_in_sync(MQTT_OUTBOX_LOCAL);
+    uint32_t cloud_calls = hal_stub_mqtt_stats(cloud).enqueues;
+    printf("\nfila de saída, 1000 TOGGLE em %u pinos com a nuvem travada (outbox máx. %d B):\n",
+           (unsigned)pin_count, MQTT_OUTBOX_MAX_BYTES);
+    printf("  local:  %4lu enviadas, %4lu substituídas, %2lu pendentes, último estado em %d/%u pinos %s\n",
+           (unsigned long)local_stats.enqueued, (unsigned long)local_stats.coalesced, (unsigned long)local_stats.pending,
+           local_sync, (unsigned)pin_count, check(local_sync == (int)pin_count && local_stats.pending == 0));
+    printf("  nuvem:  %4lu enviadas, %4lu substituídas, %2lu pendentes, %d B na outbox, chamadas após encher: %lu %s\n",
+           (unsigned long)cloud_stats.enqueued, (unsigned long)cloud_stats.coalesced, (unsigned long)cloud_stats.pending,
+           cloud_stats.outbox_bytes, (unsigned long)(cloud_calls - cloud_calls_at_full),
+           check(cloud_calls_at_full && cloud_calls == cloud_calls_at_full && cloud_stats.outbox_bytes <= MQTT_OUTBOX_MAX_BYTES));
+
+    // Broker volta: acks esvaziam a outbox e cada MQTT_EVENT_PUBLISHED retoma o envio
+    hal_stub_mqtt_set_stalled(cloud, false);
+    hal_stub_mqtt_deliver(cloud);
+    mqtt_outbox_drain(MQTT_OUTBOX_CLOUD);
+    int cloud_sync = outbox_pins_in_sync(MQTT_OUTBOX_CLOUD);
+    printf("  nuvem destravada: +%lu mensagens, último estado em %d/%u pinos %s\n",
+           (unsigned long)(hal_stub_mqtt_stats(cloud).enqueues - cloud_calls), cloud_sync, (unsigned)pin_count,
+           check(cloud_sync == (int)pin_count));
+
+    // Cenas em lote intercaladas com TOGGLE por pino, a nuvem travada de novo: o
+    // tópico retido de cada pino também acompanha os comandos em lote
+    hal_stub_mqtt_set_stalled(cloud, true);
+    uint32_t scenes = 0;
+    for (uint32_t i = 0; i < 400; i++) {
+        int64_t now_ms = 20000 + (int64_t)i * 20;
+        uint32_t hash = i * 2654435761u;
+        if (i % 4 == 0) {
+            uint64_t mask = 0, value = 0;
+            for (size_t p = 0; p < pin_count; p++) {
+                if ((hash >> (p % 24)) & 1) continue;
+                mask |= (uint64_t)1 << storm_pins[p];
+                value |= (uint64_t)((hash >> ((p + 7) % 32)) & 1) << storm_pins[p];
+            }
+            if (mask && gpio_control_set_mask(mask, value, now_ms)) {
+                gpio_control_publish_bulk_state(mask, value);
+                scenes++;
+            }
+        } else {
+            int pin = storm_pins[(hash >> 16) % pin_count];
+            gpio_control_set_and_publish(pin, gpio_action_apply(GPIO_ACTION_TOGGLE, gpio_state_get(pin)), now_ms);
+        }
+    }
+    local_sync = outbox_pins_in_sync(MQTT_OUTBOX_LOCAL);
+    hal_stub_mqtt_set_stalled(cloud, false);
+    hal_stub_mqtt_deliver(cloud);
+    mqtt_outbox_drain(MQTT_OUTBOX_CLOUD);
+    cloud_sync = outbox_pins_in_sync(MQTT_OUTBOX_CLOUD);
+    printf("  %lu cenas em lote entre 300 TOGGLE: estado retido em %d/%u pinos no local, %d/%u na nuvem %s\n",
+           (unsigned long)scenes, local_sync, (unsigned)pin_count, cloud_sync, (unsigned)pin_count,
+           check(scenes > 0 && local_sync == (int)pin_count && cloud_sync == (int)pin_count));
+    hal_stub_mqtt_set_sink(NULL);
+}
+
+// --- Métricas de Execução ---
+// Uma janela com durações conhecidas: cada faixa do histograma recebe as
+// operações esperadas, a média e o máximo conferem e o snapshot seguinte vem
+// vazio. Imprime o JSON publicado em DEVICE_ID/system/metrics.
+static void report_runtime_metrics(void) {
+    static const uint32_t bounds_us[RUNTIME_METRICS_BUCKETS - 1] = RUNTIME_METRICS_BUCKET_BOUNDS_US;
+    runtime_metric_window_t ops[RUNTIME_METRIC_KINDS];
+    runtime_system_stats_t sys = { .uptime_s = 3600, .heap_free = 182340, .heap_min = 171208, .task_count = 2,
+                                   .tasks = { { "sampling_task", 12, 1864 }, { "IDLE0", 480, 812 } } };
+    char json[RUNTIME_METRICS_JSON_SIZE];
+    runtime_metrics_snapshot(ops);   // Descarta o que os casos deixaram
+    // Uma leitura exatamente no limite de cada faixa e uma acima do último limite
+    uint64_t sum_us = 0;
+    for (int b = 0; b < RUNTIME_METRICS_BUCKETS; b++) {
+        uint32_t us = b < RUNTIME_METRICS_BUCKETS - 1 ? bounds_us[b] : bounds_us[b - 1] + 1;
+        runtime_metrics_record(RUNTIME_METRIC_SENSOR_READ, 1000, 1000 + us, b != 3);
+        sum_us += us;
+    }
+    runtime_metrics_snapshot(ops);
+    const runtime_metric_window_t *read = &ops[RUNTIME_METRIC_SENSOR_READ];
+    bool buckets_ok = true;
+    for (int b = 0; b < RUNTIME_METRICS_BUCKETS; b++) buckets_ok &= read->buckets[b] == 1;
+    bool totals_ok = read->count == RUNTIME_METRICS_BUCKETS && read->failures == 1 && read->sum_us == sum_us &&
+                     read->max_us == bounds_us[RUNTIME_METRICS_BUCKETS - 2] + 1;
+    int len = runtime_metrics_format_json(ops, &sys, json, sizeof(json));
+    runtime_metrics_snapshot(ops);
+    printf("\nruntime_metrics, uma leitura por faixa do histograma:\n");
+    printf("  faixas %s, contagem/falhas/soma/máximo %s, nova janela vazia %s\n", check(buckets_ok),
+           check(totals_ok), check(ops[RUNTIME_METRIC_SENSOR_READ].count == 0));
+    if (len > 0 && len < (int)sizeof(json)) printf("  %s\n", json);
+}
+
+// --- Logs do Caminho Quente ---
+// Custo por ciclo de amostragem nos três destinos, um sensor falhando a cada
+// 100 ms por 100 s (uma linha na UART a cada HOT_LOG_ERROR_INTERVAL_MS, com as
+// omitidas contadas) e a leitura do anel depois de ele dar várias voltas.
+static double cycle_ns(cycle_log_fn log, uint32_t cycles) {
+    double start = now_ns();
+    for (uint32_t i = 0; i < cycles; i++) run_sample_cycle(i, log);
+    return (now_ns() - start) / cycles;
+}
+
+static void report_hot_log(void) {
+    const uint32_t cycles = 20000;
+    hal_stub_reset();
+    hot_log_init(registry_clock_ms);
+    registry_clock = 0;
+    uart_bytes = 0;
+    double uart_ns = cycle_ns(uart_log, cycles);
+    double bytes = (double)uart_bytes / cycles;
+    double off_ns = cycle_ns(NULL, cycles);
+    double ring_ns = cycle_ns(hot_log_ring_write, cycles);
+    double uart_ms = bytes * UART_BITS_PER_BYTE * 1000.0 / UART_BAUD;
+    printf("\nhot_log, ciclo de quatro leituras publicadas do firmware local (HOT_LOG_MODE %d):\n", HOT_LOG_MODE);
+    printf("  %-14s %14s %14s %18s\n", "logs", "CPU ns/ciclo", "bytes UART", "espera UART (ms)");
+    printf("  %-14s %14.0f %14.0f %18.2f\n", "UART (antes)", uart_ns, bytes, uart_ms);
+    printf("  %-14s %14.0f %14d %18.2f\n", "removidos", off_ns, 0, 0.0);
+    printf("  %-14s %14.0f %14d %18.2f\n", "anel", ring_ns, 0, 0.0);
+
+    hot_log_limit_t limit = HOT_LOG_LIMIT_INIT;
+    uint32_t allowed = 0, reported = 0, failures = 1000;
+    for (uint32_t i = 0; i < failures; i++) {
+        uint32_t suppressed;
+        registry_clock = (int64_t)i * 100;
+        if (hot_log_limit_allow(&limit, &suppressed)) {
+            allowed++;
+            reported += suppressed;
+        }
+    }
+    uint32_t expected = (uint32_t)((failures * 100 + HOT_LOG_ERROR_INTERVAL_MS - 1) / HOT_LOG_ERROR_INTERVAL_MS);
+    printf("  erro repetido: %lu falhas, %lu linhas na UART, %lu omitidas informadas + %lu pendentes %s\n",
+           (unsigned long)failures, (unsigned long)allowed, (unsigned long)reported, (unsigned long)limit.suppressed,
+           check(allowed == expected && allowed + reported + limit.suppressed == failures));
+
+#if HOT_LOG_RING_ENABLED
+    char dump[HOT_LOG_RING_SIZE + 1];
+    const uint32_t lines = 200;
+    uint32_t first_line = lines, last_line = 0;
+    bool whole = true, consecutive = true;
+    for (uint32_t i = 0; i < lines; i++) hot_log_ring_write('E', "MQTT_APP", "Falha ao ler o sensor dht11 (linha %lu)", (unsigned long)i);
+    size_t len = hot_log_ring_read(dump, HOT_LOG_RING_SIZE);
+    dump[len] = '\0';
+    for (char *line = dump, *end; *line; line = end + 1) {
+        unsigned long n;
+        end = strchr(line, '\n');
+        if (!end || sscanf(line, "%*d E MQTT_APP: Falha ao ler o sensor dht11 (linha %lu)", &n) != 1) {
+            whole = false;
+            break;
+        }
+        if (first_line == lines) first_line = (uint32_t)n;
+        else consecutive &= n == last_line + 1;
+        last_line = (uint32_t)n;
+    }
+    printf("  anel: linhas %lu a %lu de %lu recuperadas em %zu bytes, inteiras e em ordem %s\n",
+           (unsigned long)first_line, (unsigned long)last_line, (unsigned long)lines, len,
+           check(whole && consecutive && last_line == lines - 1));
+#endif
+    hot_log_init(NULL);
+}
+
+// --- Lote vs. um Tópico por Sensor ---
+// Uma hora do firmware local (quatro leituras a cada 2 s, defasadas de 500 ms,
+// com seq e ts) nos quatro modos de envio: um PUBLISH por leitura no tópico do
+// sensor ("sensor/...") ou o lote de sensor_batch com a janela e o tamanho do
+// board_config.h ("lote/..."), em JSON e em binário.
+// Bytes no fio: quadro PUBLISH QoS 0 (cabeçalho fixo, tópico e payload) mais os
+// cabeçalhos TCP/IPv4 de um segmento por mensagem.
+#define WIRE_CYCLES 1800
+#define WIRE_CYCLE_MS 2000
+#define WIRE_TCP_IP_HEADERS 40
+
+typedef struct {
+    const char *batch_topic;
+    uint32_t publishes;
+    uint32_t readings;
+    uint64_t payload_bytes;
+    uint64_t wire_bytes;
+} wire_run_t;
+
+static size_t mqtt_publish_frame_size(size_t topic_len, size_t payload_len) {
+    size_t remaining = 2 + topic_len + payload_len;   // Comprimento do tópico u16, tópico e payload
+    size_t length_bytes = 1;
+    for (size_t r = remaining; r >= 128; r >>= 7) length_bytes++;
+    return 1 + length_bytes + remaining;
+}
+
+static void wire_count(wire_run_t *run, const char *topic, size_t len, size_t readings) {
+    run->publishes++;
+    run->readings += (uint32_t)readings;
+    run->payload_bytes += len;
+    run->wire_bytes += mqtt_publish_frame_size(strlen(topic), len) + WIRE_TCP_IP_HEADERS;
+}
+
+static void wire_batch_flush(const char *payload, size_t len, size_t readings, void *ctx) {
+    wire_run_t *run = ctx;
+    bench_sink += (uint32_t)esp_mqtt_client_publish(hal_stub_mqtt_client(), run->batch_topic, payload, (int)len, 0, 0);
+    wire_count(run, run->batch_topic, len, readings);
+}
+
+static void run_wire(wire_run_t *run, bool batched, bool binary) {
+    static sensor_batch_t batch;
+    char buf[TELEMETRY_MAX_RECORD_SIZE > 192 ? TELEMETRY_MAX_RECORD_SIZE : 192], topic[64];
+    run->batch_topic = binary ? MQTT_SENSOR_BATCH_TOPIC MQTT_BINARY_TOPIC_SUFFIX : MQTT_SENSOR_BATCH_TOPIC;
+    sensor_batch_init(&batch, SENSOR_BATCH_WINDOW_MS, SENSOR_BATCH_MAX_READINGS, binary, wire_batch_flush, run);
+    for (uint32_t cycle = 0; cycle < WIRE_CYCLES; cycle++) {
+        for (uint32_t i = 0; i < 4; i++) {
+            int64_t now_ms = (int64_t)cycle * WIRE_CYCLE_MS + i * 500;
+            telemetry_reading_t reading = sample_reading(i);
+            telemetry_meta_t meta = { .flags = TELEMETRY_META_SEQ | TELEMETRY_META_TS, .seq = cycle * 4 + i,
+                                      .ts_ms = 1760000000000LL + now_ms };
+            size_t len = binary ? telemetry_encode_binary(&reading, &meta, (uint8_t *)buf, sizeof(buf))
+                                : telemetry_format_json(&reading, &meta, buf, sizeof(buf));
+            if (batched) {
+                sensor_batch_poll(&batch, now_ms);
+                if (binary) sensor_batch_add_record(&batch, (const uint8_t *)buf, len, now_ms);
+                else sensor_batch_add(&batch, telemetry_sensor_name(reading.sensor), buf, now_ms);
+                continue;
+            }
+            snprintf(topic, sizeof(topic), DEVICE_ID "/sensor/%s%s", telemetry_sensor_name(reading.sensor),
+                     binary ? MQTT_BINARY_TOPIC_SUFFIX : "");
+            bench_sink += (uint32_t)esp_mqtt_client_publish(hal_stub_mqtt_client(), topic, buf, (int)len, 0, 0);
+            wire_count(run, topic, len, 1);
+        }
+    }
+    sensor_batch_flush(&batch);
+}
+
+static void report_batch_wire(void) {
+    static const struct { const char *name; bool batched, binary; } modes[] = {
+        { "sensor/JSON", false, false },
+        { "sensor/bin", false, true },
+        { "lote/JSON", true, false },
+        { "lote/bin", true, true },
+    };
+    const double seconds = WIRE_CYCLES * WIRE_CYCLE_MS / 1000.0;
+    const uint32_t readings = WIRE_CYCLES * 4;
+    wire_run_t runs[4];
+    hal_stub_reset();
+    printf("\nlote vs. um tópico por sensor, %.0f s simulados (%lu leituras com seq e ts, lote de até %d leituras ou %d ms):\n",
+           seconds, (unsigned long)readings, SENSOR_BATCH_MAX_READINGS, SENSOR_BATCH_WINDOW_MS);
+    printf("  %-12s %10s %16s %12s %10s %13s\n", "modo", "PUBLISH/s", "payload B/leit.", "fio B/leit.", "fio B/s",
+           "CPU ns/leit.");
+    for (size_t m = 0; m < 4; m++) {
+        memset(&runs[m], 0, sizeof(runs[m]));
+        double start = now_ns();
+        run_wire(&runs[m], modes[m].batched, modes[m].binary);
+        double cpu_ns = (now_ns() - start) / readings;
+        printf("  %-12s %10.2f %16.1f %12.1f %10.1f %13.0f %s\n", modes[m].name, runs[m].publishes / seconds,
+               (double)runs[m].payload_bytes / readings, (double)runs[m].wire_bytes / readings,
+               runs[m].wire_bytes / seconds, cpu_ns, check(runs[m].readings == readings));
+    }
+    printf("  lote: um PUBLISH por ciclo e menos bytes no fio que um tópico por sensor %s\n",
+           check(runs[2].publishes == WIRE_CYCLES && runs[3].publishes == WIRE_CYCLES &&
+                 runs[2].wire_bytes < runs[0].wire_bytes && runs[3].wire_bytes < runs[1].wire_bytes));
+}
+
+// --- Modo de Baixo Consumo ---
+// Modelo da sampling_task do firmware local com LOW_POWER_MODE_ENABLED sobre os
+// módulos reais (agendador, registro de drivers, fila offline, radio_burst) por
+// uma hora simulada (até a rajada seguinte), com cada despertar da tarefa atrasado de 0 a
+// LOW_POWER_WAKE_JITTER_MS. Toda leitura entra na fila e a fila inteira sai na
+// rajada. Confere que as publicações caem na grade (até o atraso do despertar),
+// o maior atraso adicionado a uma leitura (período + atraso do despertar), que
+// nenhuma leitura se perde e a parcela acordada informada nas métricas; compara
+// com o modo normal, em que cada leitura sai na hora e o rádio nunca dorme.
+#define LOW_POWER_SIM_MS (3600 * 1000)
+#define LOW_POWER_WAKE_JITTER_MS 10
+#define LOW_POWER_QUEUE_CAPACITY 256
+
+typedef struct {
+    reading_buffer_t buffer;
+    uint32_t readings;
+    uint32_t published;
+    uint32_t transmit_instants;     // Instantes distintos com publicação (despertares do rádio)
+    int64_t last_transmit_ms;
+    int64_t worst_delay_ms;
+    int64_t total_delay_ms;
+    int64_t worst_grid_offset_ms;   // Maior distância entre a rajada e o instante da grade
+} low_power_state_t;
+
+static low_power_state_t low_power;
+static reading_buffer_entry_t low_power_storage[LOW_POWER_QUEUE_CAPACITY];
+
+static void low_power_transmit(int64_t delay_ms) {
+    low_power.published++;
+    low_power.total_delay_ms += delay_ms;
+    if (delay_ms > low_power.worst_delay_ms) low_power.worst_delay_ms = delay_ms;
+    if (registry_clock != low_power.last_transmit_ms) {
+        low_power.transmit_instants++;
+        low_power.last_transmit_ms = registry_clock;
+    }
+}
+
+static void low_power_reading(const sensor_driver_t *driver, const telemetry_reading_t *reading, void *ctx) {
+    bool burst_mode = *(const bool *)ctx;
+    (void)driver;
+    low_power.readings++;
+    if (!burst_mode) {
+        low_power_transmit(0);
+        return;
+    }
+    reading_buffer_push(&low_power.buffer, reading, low_power.readings, (uint32_t)registry_clock);
+}
+
+// Retorna a parcela acordada (‰) do snapshot final; *bursts recebe as rajadas
+static uint16_t run_low_power(bool burst_mode, uint32_t *bursts) {
+    static sensor_scheduler_t sched;
+    static sensor_registry_t reg;
+    static radio_burst_t rb;
+    const sensor_registry_sink_t sink = { .reading = low_power_reading, .ctx = &burst_mode };
+    uint32_t rng = 2024;
+    memset(&low_power, 0, sizeof(low_power));
+    low_power.last_transmit_ms = -1;
+    reading_buffer_init(&low_power.buffer, low_power_storage, LOW_POWER_QUEUE_CAPACITY);
+    fake_sensor_reset(0);
+    registry_clock = 0;
+    sensor_scheduler_init(&sched);
+    sensor_registry_init(&reg, registry_drivers, REGISTRY_DRIVERS, &sched, &sink, registry_clock_ms);
+    radio_burst_init(&rb, LOW_POWER_BURST_PERIOD_MS, LOW_POWER_BURST_PHASE_MS, LOW_POWER_BURST_LINGER_MS, 0);
+    // Termina na rajada que envia o que restou na fila
+    while (registry_clock < LOW_POWER_SIM_MS || reading_buffer_count(&low_power.buffer) > 0) {
+        int64_t deadline = sensor_scheduler_next_deadline(&sched);
+        if (burst_mode && radio_burst_deadline(&rb) < deadline) deadline = radio_burst_deadline(&rb);
+        rng = rng * 1664525u + 1013904223u;
+        registry_clock = deadline + (rng >> 16) % (LOW_POWER_WAKE_JITTER_MS + 1);
+        sensor_scheduler_run_due(&sched, registry_clock);
+        if (!burst_mode) continue;
+        int64_t grid_ms = LOW_POWER_BURST_PHASE_MS + (registry_clock - LOW_POWER_BURST_PHASE_MS) / LOW_POWER_BURST_PERIOD_MS * LOW_POWER_BURST_PERIOD_MS;
+        if (radio_burst_start(&rb, registry_clock)) {
+            const reading_buffer_entry_t *entry;
+            if (registry_clock - grid_ms > low_power.worst_grid_offset_ms) low_power.worst_grid_offset_ms = registry_clock - grid_ms;
+            while ((entry = reading_buffer_peek(&low_power.buffer)) != NULL) {
+                low_power_transmit(registry_clock - entry->sampled_at_ms);
+                reading_buffer_pop(&low_power.buffer);
+            }
+        }
+        radio_burst_poll_sleep(&rb, registry_clock);
+    }
+    if (!burst_mode) {
+        *bursts = 0;
+        return 1000;
+    }
+    return radio_burst_snapshot(&rb, registry_clock, bursts);
+}
+
+static void report_low_power(void) {
+    uint32_t bursts, unused;
+    hal_stub_reset();
+    run_low_power(false, &unused);
+    uint32_t normal_instants = low_power.transmit_instants, normal_published = low_power.published;
+    uint16_t awake_permille = run_low_power(true, &bursts);
+    uint32_t expected_bursts = (uint32_t)((registry_clock - LOW_POWER_BURST_PHASE_MS) / LOW_POWER_BURST_PERIOD_MS + 1);
+    uint32_t expected_permille = LOW_POWER_BURST_LINGER_MS * 1000 / LOW_POWER_BURST_PERIOD_MS;
+    runtime_system_stats_t sys = { .uptime_s = LOW_POWER_SIM_MS / 1000, .radio_reported = true,
+                                   .radio_awake_permille = awake_permille, .radio_bursts = bursts };
+    runtime_metric_window_t ops[RUNTIME_METRIC_KINDS];
+    char json[RUNTIME_METRICS_JSON_SIZE], expected_json[32];
+    memset(ops, 0, sizeof(ops));
+    int len = runtime_metrics_format_json(ops, &sys, json, sizeof(json));
+    snprintf(expected_json, sizeof(expected_json), ",\"radio\":[%u,%lu]", (unsigned)awake_permille, (unsigned long)bursts);
+
+    printf("\nbaixo consumo, %.0f s simulados (rajada a cada %d ms, fase %d ms, rádio acordado %d ms, despertar atrasado até %d ms):\n",
+           registry_clock / 1000.0, LOW_POWER_BURST_PERIOD_MS, LOW_POWER_BURST_PHASE_MS, LOW_POWER_BURST_LINGER_MS,
+           LOW_POWER_WAKE_JITTER_MS);
+    printf("  %-10s %12s %20s %14s\n", "modo", "publicadas", "instantes de envio", "acordado (‰)");
+    printf("  %-10s %12lu %20lu %14d\n", "normal", (unsigned long)normal_published, (unsigned long)normal_instants, 1000);
+    printf("  %-10s %12lu %20lu %14u\n", "rajadas", (unsigned long)low_power.published,
+           (unsigned long)low_power.transmit_instants, (unsigned)awake_permille);
+    printf("  leituras: %lu, todas publicadas %s\n", (unsigned long)low_power.readings,
+           check(low_power.published == low_power.readings && low_power.buffer.dropped == 0));
+    printf("  rajadas: %lu, uma por período, até %lld ms depois da grade %s\n", (unsigned long)bursts,
+           (long long)low_power.worst_grid_offset_ms,
+           check(bursts == expected_bursts && low_power.transmit_instants == bursts &&
+                 low_power.worst_grid_offset_ms <= LOW_POWER_WAKE_JITTER_MS));
+    printf("  atraso adicionado: média %.0f ms, máx. %lld ms %s\n",
+           low_power.published ? (double)low_power.total_delay_ms / low_power.published : 0.0,
+           (long long)low_power.worst_delay_ms,
+           check(low_power.worst_delay_ms <= LOW_POWER_BURST_PERIOD_MS + LOW_POWER_WAKE_JITTER_MS));
+    // ‰ truncado e a última rajada ainda acordada no snapshot: 1‰ de tolerância
+    printf("  acordado: %u‰ medido, %lu‰ esperado; métricas com %s %s\n", (unsigned)awake_permille,
+           (unsigned long)expected_permille, expected_json + 1,
+           check((uint32_t)awake_permille + 1 >= expected_permille && awake_permille <= expected_permille + 1 &&
+                 len > 0 && len < (int)sizeof(json) && strstr(json, expected_json) != NULL));
+}
+
+// Sem filtro, ou com um filtro que contém o nome do relatório (ex.: "sensor_math"
+// ou "sensor_math/mq135_ppm"); um pedaço do nome não basta
+static bool report_selected(const char *filter, const char *name) {
+    return filter == NULL || strstr(filter, name) != NULL;
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : DEFAULT_ITERATIONS;
+    const char *filter = argc > 2 ? argv[2] : NULL;
+    if (iterations == 0) iterations = DEFAULT_ITERATIONS;
+
+    printf("%-36s %12s %12s\n", "caso", "ns/op", "ops/s");
+    for (size_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++) {
+        const bench_case_t *bench = &bench_cases[i];
+        if (filter && strstr(bench->name, filter) == NULL) continue;
+        hal_stub_reset();
+        bench->run(iterations / 10 + 1);   // Aquecimento (caches, preditor de desvios)
+        hal_stub_reset();
+        double start = now_ns();
+        bench->run(iterations);
+        double ns_per_op = (now_ns() - start) / iterations;
+        printf("%-36s %12.1f %12.0f\n", bench->name, ns_per_op, 1e9 / ns_per_op);
+    }
+    if (report_selected(filter, "sensor_math")) report_math_accuracy();
+    if (report_selected(filter, "sensor_registry")) report_sensor_registry();
+    if (report_selected(filter, "sensor_batch")) report_batch_wire();
+    if (report_selected(filter, "reading_buffer")) report_offline_buffer();
+    if (report_selected(filter, "sampling")) report_reconnect_storm();
+    if (report_selected(filter, "runtime_metrics")) report_runtime_metrics();
+    if (report_selected(filter, "hot_log")) report_hot_log();
+    if (report_selected(filter, "radio_burst")) report_low_power();
+    if (report_selected(filter, "gpio_control")) {
+        report_nvs_coalescing();
+        report_outbox_fanout();
+        report_outbox_concurrent_drain();
+    }
+    if (bench_failures > 0) printf("\n%lu verificações com FALHA\n", (unsigned long)bench_failures);
+    return bench_failures > 0 || bench_sink == 0xFFFFFFFFu ? 1 : 0;   // bench_sink: impede que o compilador o descarte
+}
@@ -0,0 +1,245 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "board_config.h"
+#include "publish_policy.h"
+
+// ======================================================
+// --- REPLAY DA PUBLICAÇÃO POR BANDA MORTA ---
+// ======================================================
+// Reaplica publish_policy sobre leituras gravadas e informa quantas mensagens
+// seriam enviadas e o maior erro de quem reconstrói a série repetindo o último
+// valor publicado (o que o gateway e o dashboard fazem).
+//
+// Entrada: CSV exportado pelo cliente do InfluxDB, por exemplo
+//   influx -database esp32_dados -format csv -precision ms -execute 'SELECT * FROM bmp280' > bmp280.csv
+// com as colunas name (measurement), time e os campos do sensor; colunas
+// desconhecidas são ignoradas. Bandas e silêncio máximo padrão vêm do
+// board_config.h do firmware local.
+//
+// Uso: publish_replay [--check redução_mín_%] arquivo.csv [silêncio_máximo_ms] [campo=banda ...]
+//
+// Com --check, cada campo marca ok/FALHA para o erro máximo dentro da banda e o
+// total para a redução mínima de mensagens; qualquer FALHA sai com código 1.
+
+#define REPLAY_MAX_COLUMNS 32
+#define REPLAY_LINE_SIZE 1024
+#define REPLAY_SENSORS 4
+// Folga do erro máximo sobre a banda: a política compara em float e o valor
+// reconstruído (pressão na casa de 1000 hPa) tem ~1e-4 de arredondamento
+#define REPLAY_ERROR_TOLERANCE 1e-3
+
+typedef struct {
+    publish_policy_t policy;
+    int column[TELEMETRY_MAX_FIELDS];   // Coluna do CSV de cada campo (-1 se ausente)
+    float held[TELEMETRY_MAX_FIELDS];   // Valor reconstruído (último publicado)
+    double max_error[TELEMETRY_MAX_FIELDS];
+    uint32_t rows;
+    int64_t last_sent_ms;
+    int64_t max_gap_ms;
+} replay_sensor_t;
+
+static replay_sensor_t sensors[REPLAY_SENSORS];
+static bool checking;           // --check: marca ok/FALHA nas linhas do relatório
+static uint32_t check_failures;
+
+static const char *check(bool ok) {
+    if (!checking) return "";
+    if (!ok) check_failures++;
+    return ok ? " ok" : " FALHA";
+}
+
+static void default_policy(publish_policy_t *policy, telemetry_sensor_t sensor, uint32_t max_silence_ms) {
+    memset(policy, 0, sizeof(*policy));
+    policy->sensor = sensor;
+    for (size_t i = 0; i < TELEMETRY_MAX_FIELDS; i++) policy->fields[i].max_silence_ms = max_silence_ms;
+    switch (sensor) {
+        case TELEMETRY_SENSOR_BMP280:
+            policy->fields[0].deadband = BMP280_TEMPERATURE_DEADBAND;
+            policy->fields[1].deadband = BMP280_PRESSURE_DEADBAND;
+            policy->fields[2].deadband = BMP280_PRESSURE_DEADBAND;
+            break;
+        case TELEMETRY_SENSOR_DHT11:
+            policy->fields[0].deadband = DHT11_TEMPERATURE_DEADBAND;
+            policy->fields[1].deadband = DHT11_HUMIDITY_DEADBAND;
+            break;
+        default:
+            break;   // MQ-135 e LDR: banda 0 (toda mudança é publicada)
+    }
+}
+
+// Converte o tempo da exportação para ms (aceita s, ms ou ns)
+static int64_t to_ms(double t) {
+    if (t > 1e17) return (int64_t)(t / 1e6);
+    if (t > 1e11) return (int64_t)t;
+    return (int64_t)(t * 1000);
+}
+
+static int split_csv(char *line, char **columns) {
+    int count = 0;
+    char *p = line;
+    line[strcspn(line, "\r\n")] = '\0';
+    while (count < REPLAY_MAX_COLUMNS) {
+        columns[count++] = p;
+        char *comma = strchr(p, ',');
+        if (comma == NULL) break;
+        *comma = '\0';
+        p = comma + 1;
+    }
+    return count;
+}
+
+static int sensor_index(const char *name) {
+    for (int i = 0; i < REPLAY_SENSORS; i++) {
+        if (strcmp(telemetry_sensor_name((telemetry_sensor_t)(i + 1)), name) == 0) return i;
+    }
+    return -1;
+}
+
+static void set_reading_field(telemetry_reading_t *reading, size_t index, float value) {
+    switch (reading->sensor) {
+        case TELEMETRY_SENSOR_BMP280:
+            if (index == 0) reading->bmp280.temperature = value;
+            else if (index == 1) reading->bmp280.pressure_hpa = value;
+            else reading->bmp280.pressure_sea_level = value;
+            break;
+        case TELEMETRY_SENSOR_DHT11:
+            if (index == 0) reading->dht11.temperature = value;
+            else reading->dht11.humidity = value;
+            break;
+        case TELEMETRY_SENSOR_MQ135:
+            if (index == 0) reading->mq135.adc_raw = (uint16_t)value;
+            else reading->mq135.ppm = value;
+            break;
+        case TELEMETRY_SENSOR_LDR:
+            reading->ldr.ldr_raw = (uint16_t)value;
+            break;
+        default:
+            break;
+    }
+}
+
+static void replay_row(replay_sensor_t *s, char **columns, int count, int64_t time_ms) {
+    telemetry_reading_t reading = { .sensor = s->policy.sensor };
+    size_t fields = telemetry_field_count(s->policy.sensor);
+    for (size_t i = 0; i < fields; i++) {
+        int column = s->column[i];
+        if (column < 0 || column >= count || columns[column][0] == '\0') return;   // Linha sem o campo
+        set_reading_field(&reading, i, strtof(columns[column], NULL));
+    }
+    s->rows++;
+    if (publish_policy_should_publish(&s->policy, &reading, time_ms)) {
+        if (s->policy.sent > 1 && time_ms - s->last_sent_ms > s->max_gap_ms) s->max_gap_ms = time_ms - s->last_sent_ms;
+        s->last_sent_ms = time_ms;
+        for (size_t i = 0; i < fields; i++) s->held[i] = telemetry_field_value(&reading, i);
+    }
+    for (size_t i = 0; i < fields; i++) {
+        double error = fabs((double)telemetry_field_value(&reading, i) - s->held[i]);
+        if (error > s->max_error[i]) s->max_error[i] = error;
+    }
+}
+
+static void report(double min_reduction_pct) {
+    uint32_t total_rows = 0, total_sent = 0;
+    printf("%-8s %-20s %8s %8s %9s %10s %10s %10s\n", "sensor", "campo", "leituras", "enviadas", "redução", "banda", "erro máx.", "lacuna (s)");
+    for (int i = 0; i < REPLAY_SENSORS; i++) {
+        replay_sensor_t *s = &sensors[i];
+        if (s->rows == 0) continue;
+        total_rows += s->rows;
+        total_sent += s->policy.sent;
+        for (size_t f = 0; f < telemetry_field_count(s->policy.sensor); f++) {
+            printf("%-8s %-20s %8lu %8lu %8.1f%% %10.3f %10.3f %10.1f%s\n",
+                   telemetry_sensor_name(s->policy.sensor), telemetry_field_name(s->policy.sensor, f),
+                   (unsigned long)s->rows, (unsigned long)s->policy.sent,
+                   100.0 * (1.0 - (double)s->policy.sent / s->rows),
+                   s->policy.fields[f].deadband, s->max_error[f], s->max_gap_ms / 1000.0,
+                   check(s->max_error[f] <= s->policy.fields[f].deadband + REPLAY_ERROR_TOLERANCE));
+        }
+    }
+    double reduction_pct = total_rows > 0 ? 100.0 * (1.0 - (double)total_sent / total_rows) : 0.0;
+    if (total_rows > 0) {
+        printf("\ntotal: %lu leituras, %lu mensagens (redução de %.1f%%)%s\n",
+               (unsigned long)total_rows, (unsigned long)total_sent, reduction_pct,
+               check(reduction_pct >= min_reduction_pct));
+    } else {
+        printf("\nnenhuma leitura reconhecida%s\n", check(false));
+    }
+    if (checking) printf("redução mínima exigida: %.1f%%\n", min_reduction_pct);
+}
+
+int main(int argc, char **argv) {
+    int arg = 1;
+    double min_reduction_pct = 0.0;
+    if (argc > 2 && strcmp(argv[1], "--check") == 0) {
+        checking = true;
+        min_reduction_pct = strtod(argv[2], NULL);
+        arg = 3;
+    }
+    if (arg >= argc) {
+        fprintf(stderr, "uso: %s [--check redução_mín_%%] arquivo.csv [silêncio_máximo_ms] [campo=banda ...]\n", argv[0]);
+        return 2;
+    }
+    const char *path = argv[arg++];
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return 1;
+    }
+    uint32_t max_silence_ms = SENSOR_MAX_SILENCE_MS;
+    if (arg < argc && strchr(argv[arg], '=') == NULL) max_silence_ms = (uint32_t)strtoul(argv[arg++], NULL, 10);
+    for (int i = 0; i < REPLAY_SENSORS; i++) default_policy(&sensors[i].policy, (telemetry_sensor_t)(i + 1), max_silence_ms);
+    // campo=banda vale para o campo com esse nome em todos os sensores
+    for (; arg < argc; arg++) {
+        char *eq = strchr(argv[arg], '=');
+        if (eq == NULL) continue;
+        *eq = '\0';
+        for (int i = 0; i < REPLAY_SENSORS; i++) {
+            for (size_t f = 0; f < telemetry_field_count(sensors[i].policy.sensor); f++) {
+                if (strcmp(telemetry_field_name(sensors[i].policy.sensor, f), argv[arg]) == 0) {
+                    sensors[i].policy.fields[f].deadband = strtof(eq + 1, NULL);
+                }
+            }
+        }
+    }
+
+    char line[REPLAY_LINE_SIZE];
+    char *columns[REPLAY_MAX_COLUMNS];
+    int name_column = -1, time_column = -1;
+    if (fgets(line, sizeof(line), file) == NULL) {
+        fprintf(stderr, "%s: arquivo vazio\n", path);
+        fclose(file);
+        return 1;
+    }
+    int header_count = split_csv(line, columns);
+    for (int i = 0; i < REPLAY_SENSORS; i++) {
+        for (size_t f = 0; f < TELEMETRY_MAX_FIELDS; f++) sensors[i].column[f] = -1;
+    }
+    for (int c = 0; c < header_count; c++) {
+        if (strcmp(columns[c], "name") == 0) name_column = c;
+        else if (strcmp(columns[c], "time") == 0) time_column = c;
+        for (int i = 0; i < REPLAY_SENSORS; i++) {
+            for (size_t f = 0; f < telemetry_field_count(sensors[i].policy.sensor); f++) {
+                if (strcmp(telemetry_field_name(sensors[i].policy.sensor, f), columns[c]) == 0) sensors[i].column[f] = c;
+            }
+        }
+    }
+    if (name_column < 0 || time_column < 0) {
+        fprintf(stderr, "%s: cabeçalho sem as colunas name e time\n", path);
+        fclose(file);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        int count = split_csv(line, columns);
+        if (count <= name_column || count <= time_column) continue;
+        int index = sensor_index(columns[name_column]);
+        if (index < 0) continue;
+        replay_row(&sensors[index], columns, count, to_ms(strtod(columns[time_column], NULL)));
+    }
+    fclose(file);
+    report(min_reduction_pct);
+    if (check_failures > 0) printf("%lu verificações com FALHA\n", (unsigned long)check_failures);
+    return check_failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,396 @@
+#include <string.h>
+
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "hal/gpio_ll.h"
+#include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_continuous.h"
+#include "bmp280.h"
+#include "dht.h"
+#include "nvs.h"
+#include "mqtt_client.h"
+#include "hal_stub.h"
+
+// ======================================================
+// --- HAL SIMULADA PARA A COMPILAÇÃO NO HOST ---
+// ======================================================
+
+#define STUB_ADC_CHANNELS 10
+#define STUB_NVS_ENTRIES 64
+#define STUB_NVS_KEY_SIZE 32
+#define STUB_NVS_VALUE_SIZE 32
+
+hal_stub_counters_t hal_stub_counters;
+
+static int adc_center[STUB_ADC_CHANNELS];
+static uint32_t read_sequence;
+static esp_err_t next_read_error;
+
+typedef struct {
+    char namespace_name[16];
+    char key[STUB_NVS_KEY_SIZE];
+    uint8_t value[STUB_NVS_VALUE_SIZE];
+    size_t length;
+    int used;
+} stub_nvs_entry_t;
+
+static stub_nvs_entry_t nvs_entries[STUB_NVS_ENTRIES];
+static const char *nvs_open_namespaces[8];
+
+// Um único handle de ADC contínuo: o ESP32 tem um só controlador DMA do ADC
+static struct adc_continuous_ctx_t {
+    uint8_t channels[SOC_ADC_PATT_LEN_MAX];
+    uint32_t pattern_num;
+    uint32_t next;          // Posição no padrão da próxima conversão
+    int configured;
+    int running;
+} stub_adc_continuous;
+
+static struct esp_mqtt_client {
+    int next_msg_id;
+    bool stalled;
+    hal_stub_mqtt_stats_t stats;
+} stub_mqtt_clients[HAL_STUB_MQTT_CLIENTS];
+
+static hal_stub_mqtt_sink_t stub_mqtt_sink;
+
+void hal_stub_reset(void) {
+    memset(&hal_stub_counters, 0, sizeof(hal_stub_counters));
+    memset(&GPIO, 0, sizeof(GPIO));
+    memset(nvs_entries, 0, sizeof(nvs_entries));
+    for (int i = 0; i < STUB_ADC_CHANNELS; i++) adc_center[i] = 2048;
+    memset(&stub_adc_continuous, 0, sizeof(stub_adc_continuous));
+    read_sequence = 0;
+    next_read_error = ESP_OK;
+    memset(stub_mqtt_clients, 0, sizeof(stub_mqtt_clients));
+    stub_mqtt_sink = NULL;
+}
+
+void hal_stub_set_adc(adc_channel_t channel, int raw) {
+    if ((int)channel >= 0 && channel < STUB_ADC_CHANNELS) adc_center[channel] = raw;
+}
+
+void hal_stub_fail_next_read(esp_err_t err) {
+    next_read_error = err;
+}
+
+esp_mqtt_client_handle_t hal_stub_mqtt_client(void) {
+    return &stub_mqtt_clients[0];
+}
+
+esp_mqtt_client_handle_t hal_stub_mqtt_client_at(int index) {
+    return index >= 0 && index < HAL_STUB_MQTT_CLIENTS ? &stub_mqtt_clients[index] : NULL;
+}
+
+void hal_stub_mqtt_set_sink(hal_stub_mqtt_sink_t sink) {
+    stub_mqtt_sink = sink;
+}
+
+void hal_stub_mqtt_set_stalled(esp_mqtt_client_handle_t client, bool stalled) {
+    client->stalled = stalled;
+}
+
+void hal_stub_mqtt_deliver(esp_mqtt_client_handle_t client) {
+    client->stats.outbox_bytes = 0;
+}
+
+hal_stub_mqtt_stats_t hal_stub_mqtt_stats(esp_mqtt_client_handle_t client) {
+    return client->stats;
+}
+
+static esp_err_t take_read_error(void) {
+    esp_err_t err = next_read_error;
+    next_read_error = ESP_OK;
+    return err;
+}
+
+// Variação determinística de -32 a +31 entre leituras consecutivas
+static int jitter(void) {
+    read_sequence = read_sequence * 1103515245u + 12345u;
+    return (int)((read_sequence >> 16) & 0x3F) - 32;
+}
+
+const char *esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_NVS_NOT_FOUND: return "ESP_ERR_NVS_NOT_FOUND";
+        case ESP_ERR_NVS_INVALID_LENGTH: return "ESP_ERR_NVS_INVALID_LENGTH";
+        default: return "UNKNOWN ERROR";
+    }
+}
+
+// --- GPIO ---
+
+// Os níveis ficam nos registradores simulados (GPIO.out e GPIO.out1); escritas
+// diretas em W1TS/W1TC, como as do comando em lote, são aplicadas aqui.
+gpio_dev_t GPIO;
+
+static void gpio_apply_w1ts_w1tc(void) {
+    GPIO.out = (GPIO.out | GPIO.out_w1ts) & ~GPIO.out_w1tc;
+    GPIO.out1.val = (GPIO.out1.val | GPIO.out1_w1ts.val) & ~GPIO.out1_w1tc.val;
+    GPIO.out_w1ts = GPIO.out_w1tc = 0;
+    GPIO.out1_w1ts.val = GPIO.out1_w1tc.val = 0;
+}
+
+static void gpio_write(uint32_t gpio_num, uint32_t level) {
+    gpio_apply_w1ts_w1tc();
+    uint32_t *reg = gpio_num < 32 ? &GPIO.out : &GPIO.out1.val;
+    uint32_t bit = 1u << (gpio_num & 31);
+    *reg = level ? *reg | bit : *reg & ~bit;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num) {
+    if (!GPIO_IS_VALID_GPIO(gpio_num)) return ESP_ERR_INVALID_ARG;
+    gpio_write((uint32_t)gpio_num, 0);
+    hal_stub_counters.gpio_resets++;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode) {
+    (void)mode;
+    return GPIO_IS_VALID_GPIO(gpio_num) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level) {
+    if (!GPIO_IS_VALID_OUTPUT_GPIO(gpio_num)) return ESP_ERR_INVALID_ARG;
+    gpio_write((uint32_t)gpio_num, level);
+    hal_stub_counters.gpio_writes++;
+    return ESP_OK;
+}
+
+void gpio_ll_set_level(gpio_dev_t *hw, uint32_t gpio_num, uint32_t level) {
+    (void)hw;
+    if (gpio_num >= GPIO_NUM_MAX) return;
+    gpio_write(gpio_num, level);
+    hal_stub_counters.gpio_writes++;
+}
+
+int gpio_get_level(gpio_num_t gpio_num) {
+    if (!GPIO_IS_VALID_GPIO(gpio_num)) return 0;
+    gpio_apply_w1ts_w1tc();
+    uint32_t reg = gpio_num < 32 ? GPIO.out : GPIO.out1.val;
+    return (int)((reg >> (gpio_num & 31)) & 1);
+}
+
+// --- Sensores ---
+
+esp_err_t adc_oneshot_read(adc_oneshot_unit_handle_t handle, adc_channel_t chan, int *out_raw) {
+    (void)handle;
+    esp_err_t err = take_read_error();
+    if (err != ESP_OK) return err;
+    if ((int)chan < 0 || chan >= STUB_ADC_CHANNELS) return ESP_ERR_INVALID_ARG;
+    int raw = adc_center[chan] + jitter();
+    *out_raw = raw < 0 ? 0 : (raw > 4095 ? 4095 : raw);
+    hal_stub_counters.adc_reads++;
+    return ESP_OK;
+}
+
+// --- ADC contínuo ---
+// As conversões percorrem o padrão configurado em ordem e saem no formato
+// TYPE1 (dado nos 12 bits baixos, canal nos 4 altos, little-endian).
+
+esp_err_t adc_continuous_new_handle(const adc_continuous_handle_cfg_t *hdl_config, adc_continuous_handle_t *ret_handle) {
+    if (hdl_config == NULL || hdl_config->conv_frame_size % SOC_ADC_DIGI_RESULT_BYTES) return ESP_ERR_INVALID_ARG;
+    *ret_handle = &stub_adc_continuous;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_config(adc_continuous_handle_t handle, const adc_continuous_config_t *config) {
+    if (handle->running) return ESP_ERR_INVALID_STATE;
+    if (config->pattern_num == 0 || config->pattern_num > SOC_ADC_PATT_LEN_MAX ||
+        config->format != ADC_DIGI_OUTPUT_FORMAT_TYPE1) return ESP_ERR_INVALID_ARG;
+    for (uint32_t i = 0; i < config->pattern_num; i++) {
+        if (config->adc_pattern[i].channel >= STUB_ADC_CHANNELS) return ESP_ERR_INVALID_ARG;
+        handle->channels[i] = config->adc_pattern[i].channel;
+    }
+    handle->pattern_num = config->pattern_num;
+    handle->configured = 1;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_start(adc_continuous_handle_t handle) {
+    if (!handle->configured || handle->running) return ESP_ERR_INVALID_STATE;
+    handle->running = 1;
+    handle->next = 0;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_read(adc_continuous_handle_t handle, uint8_t *buf, uint32_t length_max, uint32_t *out_length, uint32_t timeout_ms) {
+    (void)timeout_ms;
+    if (!handle->running) return ESP_ERR_INVALID_STATE;
+    esp_err_t err = take_read_error();
+    if (err != ESP_OK) return err;
+    uint32_t len = length_max - length_max % SOC_ADC_DIGI_RESULT_BYTES;
+    for (uint32_t i = 0; i < len; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        uint8_t channel = handle->channels[handle->next];
+        handle->next = (handle->next + 1) % handle->pattern_num;
+        int raw = adc_center[channel] + jitter();
+        raw = raw < 0 ? 0 : (raw > 4095 ? 4095 : raw);
+        uint16_t word = (uint16_t)((channel << 12) | raw);
+        buf[i] = (uint8_t)word;
+        buf[i + 1] = (uint8_t)(word >> 8);
+        hal_stub_counters.adc_reads++;
+    }
+    *out_length = len;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_stop(adc_continuous_handle_t handle) {
+    if (!handle->running) return ESP_ERR_INVALID_STATE;
+    handle->running = 0;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_flush_pool(adc_continuous_handle_t handle) {
+    (void)handle;
+    return ESP_OK;
+}
+
+esp_err_t bmp280_read_float(bmp280_t *dev, float *temperature, float *pressure, float *humidity) {
+    (void)dev;
+    esp_err_t err = take_read_error();
+    if (err != ESP_OK) return err;
+    *temperature = 25.0f + jitter() / 64.0f;
+    *pressure = 101000.0f + jitter() * 4.0f;
+    if (humidity) *humidity = 0;
+    hal_stub_counters.bmp280_reads++;
+    return ESP_OK;
+}
+
+esp_err_t dht_read_float_data(dht_sensor_type_t sensor_type, gpio_num_t pin, float *humidity, float *temperature) {
+    (void)sensor_type;
+    (void)pin;
+    esp_err_t err = take_read_error();
+    if (err != ESP_OK) return err;
+    *temperature = (float)(24 + jitter() / 32);
+    *humidity = (float)(55 + jitter() / 8);
+    hal_stub_counters.dht_reads++;
+    return ESP_OK;
+}
+
+// --- NVS (em memória) ---
+// O handle é o índice do namespace em nvs_open_namespaces, mais 1.
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle) {
+    (void)open_mode;
+    for (size_t i = 0; i < sizeof(nvs_open_namespaces) / sizeof(nvs_open_namespaces[0]); i++) {
+        if (nvs_open_namespaces[i] == NULL || strcmp(nvs_open_namespaces[i], namespace_name) == 0) {
+            nvs_open_namespaces[i] = namespace_name;
+            *out_handle = (nvs_handle_t)(i + 1);
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+static stub_nvs_entry_t *nvs_find(nvs_handle_t handle, const char *key, int create) {
+    const char *namespace_name = nvs_open_namespaces[handle - 1];
+    stub_nvs_entry_t *free_entry = NULL;
+    for (int i = 0; i < STUB_NVS_ENTRIES; i++) {
+        stub_nvs_entry_t *entry = &nvs_entries[i];
+        if (!entry->used) {
+            if (!free_entry) free_entry = entry;
+        } else if (strcmp(entry->key, key) == 0 && strcmp(entry->namespace_name, namespace_name) == 0) {
+            return entry;
+        }
+    }
+    if (!create || !free_entry) return NULL;
+    strncpy(free_entry->namespace_name, namespace_name, sizeof(free_entry->namespace_name) - 1);
+    strncpy(free_entry->key, key, sizeof(free_entry->key) - 1);
+    free_entry->used = 1;
+    return free_entry;
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *key, uint8_t value) {
+    stub_nvs_entry_t *entry = nvs_find(handle, key, 1);
+    if (!entry) return ESP_ERR_NO_MEM;
+    entry->value[0] = value;
+    entry->length = 1;
+    hal_stub_counters.nvs_writes++;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char *key, uint8_t *out_value) {
+    stub_nvs_entry_t *entry = nvs_find(handle, key, 0);
+    if (!entry) return ESP_ERR_NVS_NOT_FOUND;
+    *out_value = entry->value[0];
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length) {
+    if (length > STUB_NVS_VALUE_SIZE) return ESP_ERR_INVALID_SIZE;
+    stub_nvs_entry_t *entry = nvs_find(handle, key, 1);
+    if (!entry) return ESP_ERR_NO_MEM;
+    memcpy(entry->value, value, length);
+    entry->length = length;
+    hal_stub_counters.nvs_writes++;
+    return ESP_OK;
+}
+
+// Como no ESP-IDF: out_value NULL só consulta o tamanho; buffer menor que o blob falha
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length) {
+    stub_nvs_entry_t *entry = nvs_find(handle, key, 0);
+    if (!entry) return ESP_ERR_NVS_NOT_FOUND;
+    if (out_value != NULL) {
+        if (*length < entry->length) return ESP_ERR_NVS_INVALID_LENGTH;
+        memcpy(out_value, entry->value, entry->length);
+    }
+    *length = entry->length;
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key) {
+    stub_nvs_entry_t *entry = nvs_find(handle, key, 0);
+    if (!entry) return ESP_ERR_NVS_NOT_FOUND;
+    memset(entry, 0, sizeof(*entry));
+    hal_stub_counters.nvs_writes++;
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+    (void)handle;
+    hal_stub_counters.nvs_commits++;
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) {
+    (void)handle;
+}
+
+// --- MQTT ---
+
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, const char *topic, const char *data, int len, int qos, int retain) {
+    (void)topic;
+    (void)qos;
+    (void)retain;
+    if (client == NULL) return -1;
+    hal_stub_counters.mqtt_publishes++;
+    hal_stub_counters.mqtt_bytes += len > 0 ? (size_t)len : strlen(data);
+    return ++client->next_msg_id;
+}
+
+int esp_mqtt_client_enqueue(esp_mqtt_client_handle_t client, const char *topic, const char *data, int len, int qos, int retain, bool store) {
+    (void)qos;
+    (void)retain;
+    (void)store;
+    if (client == NULL) return -1;
+    if (len <= 0) len = (int)strlen(data);
+    client->stats.enqueues++;
+    hal_stub_counters.mqtt_publishes++;
+    hal_stub_counters.mqtt_bytes += (size_t)len;
+    // Aproximação do pacote PUBLISH guardado na outbox do esp-mqtt
+    if (client->stalled) client->stats.outbox_bytes += len + (int)strlen(topic) + 4;
+    if (stub_mqtt_sink) stub_mqtt_sink(client, topic, data, len);
+    return ++client->next_msg_id;
+}
+
+int esp_mqtt_client_get_outbox_size(esp_mqtt_client_handle_t client) {
+    return client ? client->stats.outbox_bytes : 0;
+}
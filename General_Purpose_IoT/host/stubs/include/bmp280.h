@@ -0,0 +1,14 @@
+#ifndef HOST_STUB_BMP280_H
+#define HOST_STUB_BMP280_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// Subconjunto do driver bmp280 do esp-idf-lib
+typedef struct {
+    uint8_t id;
+} bmp280_t;
+
+esp_err_t bmp280_read_float(bmp280_t *dev, float *temperature, float *pressure, float *humidity);
+
+#endif // HOST_STUB_BMP280_H
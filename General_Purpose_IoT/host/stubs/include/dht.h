@@ -0,0 +1,16 @@
+#ifndef HOST_STUB_DHT_H
+#define HOST_STUB_DHT_H
+
+#include "esp_err.h"
+#include "driver/gpio.h"
+
+// Subconjunto do driver dht do esp-idf-lib
+typedef enum {
+    DHT_TYPE_DHT11 = 0,
+    DHT_TYPE_AM2301,
+    DHT_TYPE_SI7021,
+} dht_sensor_type_t;
+
+esp_err_t dht_read_float_data(dht_sensor_type_t sensor_type, gpio_num_t pin, float *humidity, float *temperature);
+
+#endif // HOST_STUB_DHT_H
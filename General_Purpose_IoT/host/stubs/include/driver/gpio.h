@@ -0,0 +1,26 @@
+#ifndef HOST_STUB_DRIVER_GPIO_H
+#define HOST_STUB_DRIVER_GPIO_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+
+typedef enum {
+    GPIO_MODE_DISABLE = 0,
+    GPIO_MODE_INPUT,
+    GPIO_MODE_OUTPUT,
+    GPIO_MODE_INPUT_OUTPUT,
+} gpio_mode_t;
+
+#define GPIO_NUM_MAX 40
+// Mesma regra do ESP32: GPIOs 34 a 39 são apenas entrada
+#define GPIO_IS_VALID_GPIO(n)        ((n) >= 0 && (n) < GPIO_NUM_MAX && !((n) >= 6 && (n) <= 11) && (n) != 20 && (n) != 24 && !((n) >= 28 && (n) <= 31))
+#define GPIO_IS_VALID_OUTPUT_GPIO(n) (GPIO_IS_VALID_GPIO(n) && (n) < 34)
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num);
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode);
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level);
+int gpio_get_level(gpio_num_t gpio_num);
+
+#endif // HOST_STUB_DRIVER_GPIO_H
@@ -0,0 +1,50 @@
+#ifndef HOST_STUB_ADC_CONTINUOUS_H
+#define HOST_STUB_ADC_CONTINUOUS_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_adc/adc_oneshot.h"
+
+typedef enum { ADC_UNIT_1, ADC_UNIT_2 } adc_unit_t;
+typedef enum { ADC_ATTEN_DB_0, ADC_ATTEN_DB_2_5, ADC_ATTEN_DB_6, ADC_ATTEN_DB_12 } adc_atten_t;
+typedef enum { ADC_BITWIDTH_DEFAULT = 0, ADC_BITWIDTH_9 = 9, ADC_BITWIDTH_10, ADC_BITWIDTH_11, ADC_BITWIDTH_12 } adc_bitwidth_t;
+typedef enum { ADC_CONV_SINGLE_UNIT_1 = 1, ADC_CONV_SINGLE_UNIT_2, ADC_CONV_BOTH_UNIT, ADC_CONV_ALTER_UNIT } adc_digi_convert_mode_t;
+typedef enum { ADC_DIGI_OUTPUT_FORMAT_TYPE1, ADC_DIGI_OUTPUT_FORMAT_TYPE2 } adc_digi_output_format_t;
+
+#define SOC_ADC_DIGI_RESULT_BYTES 2
+#define SOC_ADC_SAMPLE_FREQ_THRES_LOW 20000
+#define SOC_ADC_PATT_LEN_MAX 16
+
+typedef struct adc_continuous_ctx_t *adc_continuous_handle_t;
+
+typedef struct {
+    uint32_t max_store_buf_size;
+    uint32_t conv_frame_size;
+    struct {
+        uint32_t flush_pool : 1;
+    } flags;
+} adc_continuous_handle_cfg_t;
+
+typedef struct {
+    uint8_t atten;
+    uint8_t channel;
+    uint8_t unit;
+    uint8_t bit_width;
+} adc_digi_pattern_config_t;
+
+typedef struct {
+    uint32_t pattern_num;
+    adc_digi_pattern_config_t *adc_pattern;
+    uint32_t sample_freq_hz;
+    adc_digi_convert_mode_t conv_mode;
+    adc_digi_output_format_t format;
+} adc_continuous_config_t;
+
+esp_err_t adc_continuous_new_handle(const adc_continuous_handle_cfg_t *hdl_config, adc_continuous_handle_t *ret_handle);
+esp_err_t adc_continuous_config(adc_continuous_handle_t handle, const adc_continuous_config_t *config);
+esp_err_t adc_continuous_start(adc_continuous_handle_t handle);
+esp_err_t adc_continuous_read(adc_continuous_handle_t handle, uint8_t *buf, uint32_t length_max, uint32_t *out_length, uint32_t timeout_ms);
+esp_err_t adc_continuous_stop(adc_continuous_handle_t handle);
+esp_err_t adc_continuous_flush_pool(adc_continuous_handle_t handle);
+
+#endif // HOST_STUB_ADC_CONTINUOUS_H
@@ -0,0 +1,15 @@
+#ifndef HOST_STUB_ADC_ONESHOT_H
+#define HOST_STUB_ADC_ONESHOT_H
+
+#include "esp_err.h"
+
+typedef enum {
+    ADC_CHANNEL_0, ADC_CHANNEL_1, ADC_CHANNEL_2, ADC_CHANNEL_3, ADC_CHANNEL_4,
+    ADC_CHANNEL_5, ADC_CHANNEL_6, ADC_CHANNEL_7, ADC_CHANNEL_8, ADC_CHANNEL_9,
+} adc_channel_t;
+
+typedef struct adc_oneshot_unit_ctx_t *adc_oneshot_unit_handle_t;
+
+esp_err_t adc_oneshot_read(adc_oneshot_unit_handle_t handle, adc_channel_t chan, int *out_raw);
+
+#endif // HOST_STUB_ADC_ONESHOT_H
@@ -0,0 +1,21 @@
+#ifndef HOST_STUB_ESP_LOG_H
+#define HOST_STUB_ESP_LOG_H
+
+#include <stdio.h>
+
+// Os logs só são impressos com -DHOST_LOG=ON; desligados, o formato continua
+// sendo verificado pelo compilador mas o custo não entra nos benchmarks.
+#ifndef HOST_LOG_ENABLED
+#define HOST_LOG_ENABLED 0
+#endif
+
+#define HOST_STUB_LOG(level, tag, format, ...) \
+    do { if (HOST_LOG_ENABLED) printf(level " (%s) " format "\n", tag, ##__VA_ARGS__); } while (0)
+
+#define ESP_LOGE(tag, format, ...) HOST_STUB_LOG("E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) HOST_STUB_LOG("W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) HOST_STUB_LOG("I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) HOST_STUB_LOG("D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) HOST_STUB_LOG("V", tag, format, ##__VA_ARGS__)
+
+#endif // HOST_STUB_ESP_LOG_H
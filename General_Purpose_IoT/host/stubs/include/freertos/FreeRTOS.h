@@ -0,0 +1,14 @@
+#ifndef HOST_STUB_FREERTOS_H
+#define HOST_STUB_FREERTOS_H
+
+// Só as seções críticas usadas pelos componentes; no host tudo roda numa thread
+
+typedef struct {
+    int locked;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+#endif // HOST_STUB_FREERTOS_H
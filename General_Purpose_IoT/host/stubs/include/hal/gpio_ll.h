@@ -0,0 +1,10 @@
+#ifndef HOST_STUB_HAL_GPIO_LL_H
+#define HOST_STUB_HAL_GPIO_LL_H
+
+#include <stdint.h>
+#include "soc/gpio_struct.h"
+
+// No ESP32 é uma escrita em GPIO_OUT_W1TS/W1TC; aqui conta como gpio_set_level
+void gpio_ll_set_level(gpio_dev_t *hw, uint32_t gpio_num, uint32_t level);
+
+#endif // HOST_STUB_HAL_GPIO_LL_H
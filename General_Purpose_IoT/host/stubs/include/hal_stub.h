@@ -0,0 +1,61 @@
+#ifndef HAL_STUB_H
+#define HAL_STUB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_adc/adc_oneshot.h"
+#include "mqtt_client.h"
+
+// ======================================================
+// --- CONTROLE DA HAL SIMULADA ---
+// ======================================================
+// Os drivers simulados devolvem valores plausíveis que variam a cada
+// leitura (para não favorecer caminhos constantes) e contam as chamadas.
+
+typedef struct {
+    uint32_t adc_reads;
+    uint32_t bmp280_reads;
+    uint32_t dht_reads;
+    uint32_t gpio_writes;
+    uint32_t gpio_resets;     // gpio_reset_pin (reconfiguração do pino)
+    uint32_t nvs_writes;
+    uint32_t nvs_commits;
+    uint32_t mqtt_publishes;
+    size_t mqtt_bytes;
+} hal_stub_counters_t;
+
+extern hal_stub_counters_t hal_stub_counters;
+
+void hal_stub_reset(void);
+
+// Valor central do ADC em um canal (as leituras oscilam ±32 em torno dele)
+void hal_stub_set_adc(adc_channel_t channel, int raw);
+
+// Faz a próxima leitura de qualquer sensor falhar com err (ESP_OK desliga)
+void hal_stub_fail_next_read(esp_err_t err);
+
+// Handle não nulo aceito por esp_mqtt_client_publish (o mesmo que hal_stub_mqtt_client_at(0))
+esp_mqtt_client_handle_t hal_stub_mqtt_client(void);
+
+// Clientes MQTT simulados independentes (um por broker)
+#define HAL_STUB_MQTT_CLIENTS 2
+esp_mqtt_client_handle_t hal_stub_mqtt_client_at(int index);
+
+// esp_mqtt_client_enqueue chama o sink (se houver) com a mensagem. Num cliente
+// normal a mensagem sai na hora; num travado ela fica na outbox
+// (esp_mqtt_client_get_outbox_size cresce) até hal_stub_mqtt_deliver.
+typedef void (*hal_stub_mqtt_sink_t)(esp_mqtt_client_handle_t client, const char *topic, const char *data, int len);
+
+typedef struct {
+    uint32_t enqueues;      // Chamadas aceitas de esp_mqtt_client_enqueue
+    int outbox_bytes;
+} hal_stub_mqtt_stats_t;
+
+void hal_stub_mqtt_set_sink(hal_stub_mqtt_sink_t sink);
+void hal_stub_mqtt_set_stalled(esp_mqtt_client_handle_t client, bool stalled);
+void hal_stub_mqtt_deliver(esp_mqtt_client_handle_t client);   // Esvazia a outbox (acks do broker)
+hal_stub_mqtt_stats_t hal_stub_mqtt_stats(esp_mqtt_client_handle_t client);
+
+#endif // HAL_STUB_H
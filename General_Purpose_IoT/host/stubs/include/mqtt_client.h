@@ -0,0 +1,13 @@
+#ifndef HOST_STUB_MQTT_CLIENT_H
+#define HOST_STUB_MQTT_CLIENT_H
+
+#include <stdbool.h>
+
+// Subconjunto de mqtt_client.h do ESP-IDF: só publicação
+typedef struct esp_mqtt_client *esp_mqtt_client_handle_t;
+
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, const char *topic, const char *data, int len, int qos, int retain);
+int esp_mqtt_client_enqueue(esp_mqtt_client_handle_t client, const char *topic, const char *data, int len, int qos, int retain, bool store);
+int esp_mqtt_client_get_outbox_size(esp_mqtt_client_handle_t client);
+
+#endif // HOST_STUB_MQTT_CLIENT_H
@@ -0,0 +1,24 @@
+#ifndef HOST_STUB_SOC_GPIO_STRUCT_H
+#define HOST_STUB_SOC_GPIO_STRUCT_H
+
+#include <stdint.h>
+
+// Registradores de saída do GPIO do ESP32 (subconjunto). As escritas em
+// W1TS/W1TC são aplicadas em out/out1 pela HAL simulada na próxima operação de GPIO.
+
+typedef union {
+    uint32_t val;
+} gpio_out1_reg_t;
+
+typedef struct gpio_dev_s {
+    uint32_t out;
+    uint32_t out_w1ts;
+    uint32_t out_w1tc;
+    gpio_out1_reg_t out1;       // GPIOs 32 a 39
+    gpio_out1_reg_t out1_w1ts;
+    gpio_out1_reg_t out1_w1tc;
+} gpio_dev_t;
+
+extern gpio_dev_t GPIO;
+
+#endif // HOST_STUB_SOC_GPIO_STRUCT_H
@@ -0,0 +1,138 @@
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "telemetry_codec.h"
+
+// ======================================================
+// --- VETORES DE REFERÊNCIA DO CODEC BINÁRIO ---
+// ======================================================
+// Codifica os quatro sensores do codec com todas as combinações de flags de
+// metadados (flags 0 = registro v1) e grava, uma linha JSON por registro, os
+// bytes em hex e os valores esperados. O teste do gateway
+// (raspberry_mqtt_broker/tests/test_measurement_schema.py) decodifica os mesmos
+// bytes com decode_binary_records e compara.
+//
+//   telemetry_golden ARQUIVO           regrava o arquivo
+//   telemetry_golden --check ARQUIVO   falha se o codec gerar bytes diferentes
+
+#define GOLDEN_MAX_SIZE 32768
+
+// Metadados nos limites dos tipos: u32 com o bit alto ligado e ts acima de 2^32
+static const telemetry_meta_t golden_meta = {
+    .age_ms = 30017,
+    .seq = 0xFFFFFFFEu,
+    .ts_ms = 1760000000123LL,
+    .hold_ms = 60000,
+};
+
+static telemetry_reading_t golden_reading(telemetry_sensor_t sensor) {
+    telemetry_reading_t reading = { .sensor = sensor };
+    switch (sensor) {
+        case TELEMETRY_SENSOR_BMP280:
+            reading.bmp280.temperature = -12.34f;
+            reading.bmp280.pressure_hpa = 1013.25f;
+            reading.bmp280.pressure_sea_level = 1021.07f;
+            break;
+        case TELEMETRY_SENSOR_DHT11:
+            reading.dht11.temperature = 24.5f;
+            reading.dht11.humidity = 61.3f;
+            break;
+        case TELEMETRY_SENSOR_MQ135:
+            reading.mq135.adc_raw = 4095;
+            reading.mq135.ppm = 412.87f;
+            break;
+        default:
+            reading.ldr.ldr_raw = 0x8001;   // Byte alto e baixo distintos
+            break;
+    }
+    return reading;
+}
+
+__attribute__((format(printf, 3, 4)))
+static size_t append(char *out, size_t len, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int written = vsnprintf(out + len, GOLDEN_MAX_SIZE - len, fmt, args);
+    va_end(args);
+    if (written < 0 || (size_t)written >= GOLDEN_MAX_SIZE - len) {
+        fprintf(stderr, "telemetry_golden: GOLDEN_MAX_SIZE pequeno demais\n");
+        exit(2);
+    }
+    return len + (size_t)written;
+}
+
+// Uma linha: {"hex": ..., "measurement": ..., "fields": {...}, "meta": {...}}.
+// Os float32 saem com 9 algarismos, o suficiente para reconstruir o valor exato.
+static size_t golden_line(char *out, size_t len, const telemetry_reading_t *reading, uint8_t flags) {
+    telemetry_meta_t meta = golden_meta;
+    meta.flags = flags;
+    uint8_t buf[TELEMETRY_MAX_RECORD_SIZE];
+    size_t size = telemetry_encode_binary(reading, &meta, buf, sizeof(buf));
+    if (size == 0) {
+        fprintf(stderr, "telemetry_golden: falha ao codificar %s\n", telemetry_sensor_name(reading->sensor));
+        exit(2);
+    }
+
+    len = append(out, len, "{\"hex\": \"");
+    for (size_t i = 0; i < size; i++) len = append(out, len, "%02x", buf[i]);
+    len = append(out, len, "\", \"measurement\": \"%s\", \"fields\": {", telemetry_sensor_name(reading->sensor));
+    for (size_t i = 0; i < telemetry_field_count(reading->sensor); i++) {
+        len = append(out, len, "%s\"%s\": %.9g", i ? ", " : "",
+                     telemetry_field_name(reading->sensor, i), (double)telemetry_field_value(reading, i));
+    }
+    len = append(out, len, "}, \"meta\": {");
+    const char *sep = "";
+    if (flags & TELEMETRY_META_AGE) { len = append(out, len, "%s\"age_ms\": %lu", sep, (unsigned long)meta.age_ms); sep = ", "; }
+    if (flags & TELEMETRY_META_SEQ) { len = append(out, len, "%s\"seq\": %lu", sep, (unsigned long)meta.seq); sep = ", "; }
+    if (flags & TELEMETRY_META_TS) { len = append(out, len, "%s\"ts\": %lld", sep, (long long)meta.ts_ms); sep = ", "; }
+    if (flags & TELEMETRY_META_HOLD) { len = append(out, len, "%s\"hold_ms\": %lu", sep, (unsigned long)meta.hold_ms); }
+    return append(out, len, "}}\n");
+}
+
+static size_t golden_generate(char *out) {
+    static const telemetry_sensor_t sensors[] = {
+        TELEMETRY_SENSOR_BMP280, TELEMETRY_SENSOR_DHT11, TELEMETRY_SENSOR_MQ135, TELEMETRY_SENSOR_LDR,
+    };
+    const uint8_t all_flags = TELEMETRY_META_AGE | TELEMETRY_META_SEQ | TELEMETRY_META_TS | TELEMETRY_META_HOLD;
+    size_t len = 0;
+    for (size_t s = 0; s < sizeof(sensors) / sizeof(sensors[0]); s++) {
+        const telemetry_reading_t reading = golden_reading(sensors[s]);
+        for (unsigned flags = 0; flags <= all_flags; flags++) len = golden_line(out, len, &reading, (uint8_t)flags);
+    }
+    return len;
+}
+
+int main(int argc, char **argv) {
+    const bool check = argc == 3 && strcmp(argv[1], "--check") == 0;
+    if (argc != 2 && !check) {
+        fprintf(stderr, "uso: %s [--check] ARQUIVO\n", argv[0]);
+        return 2;
+    }
+    const char *path = argv[argc - 1];
+    static char expected[GOLDEN_MAX_SIZE], current[GOLDEN_MAX_SIZE];
+    const size_t len = golden_generate(expected);
+
+    if (!check) {
+        FILE *f = fopen(path, "w");
+        if (f == NULL || fwrite(expected, 1, len, f) != len || fclose(f) != 0) {
+            fprintf(stderr, "telemetry_golden: falha ao gravar %s\n", path);
+            return 2;
+        }
+        printf("telemetry_golden: %s gravado\n", path);
+        return 0;
+    }
+
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "telemetry_golden: %s não encontrado\n", path);
+        return 2;
+    }
+    const size_t got = fread(current, 1, sizeof(current), f);
+    fclose(f);
+    const bool same = got == len && memcmp(current, expected, len) == 0;
+    printf("telemetry_golden: %s\n", same ? "ok" : "FALHA (o codec mudou; regrave o arquivo e confira o gateway)");
+    return same ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "adc_reduce.h"
+
+// ======================================================
+// --- TESTE DA REDUÇÃO DO ADC CONTRA UMA REFERÊNCIA ---
+// ======================================================
+// A referência faz o mesmo cálculo do jeito mais direto: separa as amostras
+// de cada canal, aplica a mediana de 3 ordenando a janela e tira a média em
+// double. O kernel de inteiros precisa dar o mesmo Q12.4 em quadros
+// aleatórios e nos casos de borda (pico isolado, entrada constante, quadro
+// com byte final solto, limites de 12 bits).
+
+#define CHECK(cond) do { \
+        if (!(cond)) { printf("FALHA %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+    } while (0)
+
+#define MAX_WORDS 1024
+
+static int failures;
+static const uint8_t channels[] = { 6, 7 };
+#define CHANNELS (sizeof(channels) / sizeof(channels[0]))
+
+static size_t put_word(uint8_t *frame, size_t len, uint8_t channel, uint16_t sample) {
+    uint16_t word = (uint16_t)((channel << 12) | (sample & 0x0FFF));
+    frame[len] = (uint8_t)word;
+    frame[len + 1] = (uint8_t)(word >> 8);
+    return len + 2;
+}
+
+static int compare_u16(const void *a, const void *b) {
+    return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+// Média Q12.4 da referência; false se o canal não teve amostras
+static bool reference_mean_q4(const uint8_t *frame, size_t len, uint8_t channel, uint16_t *mean_q4, uint32_t *count) {
+    static uint16_t samples[MAX_WORDS];
+    size_t n = 0;
+    for (size_t i = 0; i + 1 < len; i += 2) {
+        uint16_t word = (uint16_t)(frame[i] | (frame[i + 1] << 8));
+        if (word >> 12 == channel) samples[n++] = word & 0x0FFF;
+    }
+    *count = (uint32_t)n;
+    if (n == 0) return false;
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (i < 2) {
+            sum += samples[i];
+            continue;
+        }
+        uint16_t window[3] = { samples[i - 2], samples[i - 1], samples[i] };
+        qsort(window, 3, sizeof(window[0]), compare_u16);
+        sum += window[1];
+    }
+    *mean_q4 = (uint16_t)floor(sum * (1 << ADC_REDUCE_FRAC_BITS) / n + 0.5);
+    return true;
+}
+
+// Confere o kernel contra a referência em todos os canais; retorna a média do primeiro
+static uint16_t check_against_reference(const uint8_t *frame, size_t len, const char *name) {
+    adc_reduce_t reduce;
+    uint16_t first = 0;
+    adc_reduce_init(&reduce, channels, CHANNELS);
+    adc_reduce_feed(&reduce, frame, len);
+    for (size_t c = 0; c < CHANNELS; c++) {
+        uint16_t expected = 0, got = 0;
+        uint32_t expected_count;
+        bool has = reference_mean_q4(frame, len, channels[c], &expected, &expected_count);
+        bool got_has = adc_reduce_mean_q4(&reduce, channels[c], &got);
+        CHECK(got_has == has);
+        CHECK(adc_reduce_count(&reduce, channels[c]) == expected_count);
+        if (has && got != expected) {
+            printf("FALHA %s canal %u: %u (referência %u)\n", name, channels[c], got, expected);
+            failures++;
+        }
+        if (c == 0) first = got;
+    }
+    return first;
+}
+
+static uint32_t lcg_state = 12345;
+static uint16_t lcg_sample(void) {
+    lcg_state = lcg_state * 1664525u + 1013904223u;
+    return (uint16_t)(lcg_state >> 20);
+}
+
+static void test_random_frames(void) {
+    static uint8_t frame[2 * MAX_WORDS];
+    for (int round = 0; round < 500; round++) {
+        size_t words = 1 + lcg_sample() % (MAX_WORDS - 1), len = 0;
+        for (size_t i = 0; i < words; i++) {
+            // Maioria nos dois canais configurados, algumas de um canal ignorado
+            uint16_t pick = lcg_sample() % 9;
+            uint8_t channel = pick == 0 ? 3 : channels[pick % CHANNELS];
+            len = put_word(frame, len, channel, lcg_sample());
+        }
+        check_against_reference(frame, len, "aleatório");
+    }
+}
+
+static void test_single_spike_is_removed(void) {
+    uint8_t frame[2 * 64];
+    size_t len = 0;
+    for (int i = 0; i < 64; i++) len = put_word(frame, len, channels[0], i == 31 ? 4095 : 1000);
+    uint16_t mean = check_against_reference(frame, len, "pico");
+    CHECK(mean == 1000 << ADC_REDUCE_FRAC_BITS);
+}
+
+static void test_constant_input(void) {
+    static const uint16_t values[] = { 0, 1, 1234, 2048, 4094, 4095 };
+    uint8_t frame[2 * 64];
+    for (size_t v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+        size_t len = 0;
+        for (int i = 0; i < 64; i++) len = put_word(frame, len, channels[i % CHANNELS], values[v]);
+        uint16_t mean = check_against_reference(frame, len, "constante");
+        CHECK(mean == values[v] << ADC_REDUCE_FRAC_BITS);
+        CHECK(adc_reduce_q4_to_raw(mean) == values[v]);
+    }
+}
+
+// Quadro com byte final solto e o mesmo quadro entregue em pedaços: o byte
+// ímpar é ignorado e a mediana continua entre as chamadas de feed
+static void test_partial_final_block(void) {
+    uint8_t frame[2 * 100 + 1];
+    size_t len = 0;
+    for (int i = 0; i < 100; i++) len = put_word(frame, len, channels[i % CHANNELS], lcg_sample());
+    frame[len] = 0xFF;
+    check_against_reference(frame, len + 1, "byte final");
+
+    adc_reduce_t whole, pieces;
+    adc_reduce_init(&whole, channels, CHANNELS);
+    adc_reduce_init(&pieces, channels, CHANNELS);
+    adc_reduce_feed(&whole, frame, len + 1);
+    for (size_t off = 0; off < len; off += 14) adc_reduce_feed(&pieces, frame + off, off + 14 <= len ? 14 : len - off);
+    for (size_t c = 0; c < CHANNELS; c++) {
+        uint16_t a = 0, b = 0;
+        CHECK(adc_reduce_mean_q4(&whole, channels[c], &a) && adc_reduce_mean_q4(&pieces, channels[c], &b));
+        CHECK(a == b);
+        CHECK(adc_reduce_count(&whole, channels[c]) == 50);
+    }
+
+    // Quadros com uma e duas amostras: entram sem filtro
+    len = put_word(frame, 0, channels[0], 4095);
+    CHECK(check_against_reference(frame, len, "uma amostra") == 4095 << ADC_REDUCE_FRAC_BITS);
+    len = put_word(frame, len, channels[0], 0);
+    CHECK(check_against_reference(frame, len, "duas amostras") == 4095 << (ADC_REDUCE_FRAC_BITS - 1));
+}
+
+static void test_12_bit_limits(void) {
+    static uint8_t frame[2 * MAX_WORDS];
+    size_t len = 0;
+    // Alternando 0 e 4095: toda mediana cai em um dos extremos
+    for (int i = 0; i < MAX_WORDS; i++) len = put_word(frame, len, channels[0], (i & 1) ? 4095 : 0);
+    check_against_reference(frame, len, "alternado");
+    // Escada de 0 a 4095: percorre todos os valores de 12 bits
+    len = 0;
+    for (int i = 0; i < MAX_WORDS; i++) len = put_word(frame, len, channels[0], (uint16_t)(i * 4));
+    len = put_word(frame, len - 2, channels[0], 4095);
+    check_against_reference(frame, len, "escada");
+    // Maior média possível ainda cabe em 16 bits
+    uint16_t mean = 0;
+    adc_reduce_t reduce;
+    adc_reduce_init(&reduce, channels, CHANNELS);
+    len = 0;
+    for (int i = 0; i < MAX_WORDS; i++) len = put_word(frame, len, channels[0], 4095);
+    for (int i = 0; i < 64; i++) adc_reduce_feed(&reduce, frame, len);
+    CHECK(adc_reduce_mean_q4(&reduce, channels[0], &mean) && mean == 4095 << ADC_REDUCE_FRAC_BITS);
+    CHECK(adc_reduce_q4_to_raw(mean) == 4095);
+}
+
+int main(void) {
+    test_random_frames();
+    test_single_spike_is_removed();
+    test_constant_input();
+    test_partial_final_block();
+    test_12_bit_limits();
+    printf("adc_reduce: %s\n", failures ? "FALHA" : "ok");
+    return failures ? 1 : 0;
+}
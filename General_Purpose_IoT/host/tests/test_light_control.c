@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "board_config.h"
+#include "light_control.h"
+
+// ======================================================
+// --- TESTE DA HISTERESE DO LED PELO LDR ---
+// ======================================================
+// Limiares e histerese do board_config.h do firmware local. Confere que o
+// nível não muda com a leitura dentro da histerese em volta de um limiar, que
+// só troca depois de ultrapassar limiar ± histerese, que falhas isoladas de
+// leitura mantêm o nível e os duties exatos do LEDC de cada nível.
+
+#define CHECK(cond) do { \
+        if (!(cond)) { printf("FALHA %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+    } while (0)
+
+#define LOW LIGHT_SENSOR_THRESHOLD_RED
+#define HIGH LIGHT_SENSOR_THRESHOLD_GREEN
+#define HYST LIGHT_SENSOR_HYSTERESIS
+
+static int failures;
+
+// Controlador já no nível da leitura inicial
+static void setup(light_control_t *ctl, uint16_t raw) {
+    light_control_init(ctl, LOW, HIGH, HYST);
+    CHECK(light_control_update(ctl, raw));
+}
+
+// Nenhuma leitura em [from, to] troca o nível
+static void check_holds(light_level_t level, uint16_t start, int from, int to) {
+    light_control_t ctl;
+    setup(&ctl, start);
+    CHECK(ctl.level == level);
+    for (int raw = from; raw <= to; raw++) {
+        if (light_control_update(&ctl, (uint16_t)raw) || ctl.level != level) {
+            printf("FALHA %s trocou para %s com %d\n", light_level_name(level), light_level_name(ctl.level), raw);
+            failures++;
+            return;
+        }
+    }
+    CHECK(ctl.transitions == 1);
+}
+
+// Partindo do nível de start, uma leitura em raw leva a to_level
+static void check_switch(uint16_t start, uint16_t raw, light_level_t to_level) {
+    light_control_t ctl;
+    setup(&ctl, start);
+    light_level_t before = ctl.level;
+    CHECK(light_control_update(&ctl, raw) == (to_level != before));
+    if (ctl.level != to_level) {
+        printf("FALHA de %u para %u: %s (esperado %s)\n", start, raw, light_level_name(ctl.level), light_level_name(to_level));
+        failures++;
+    }
+}
+
+// Primeira leitura: limiares sem histerese ("<=" fica no nível de baixo)
+static void test_first_reading(void) {
+    static const struct { uint16_t raw; light_level_t level; } cases[] = {
+        { 0, LIGHT_LEVEL_DARK }, { LOW, LIGHT_LEVEL_DARK }, { LOW + 1, LIGHT_LEVEL_DIM },
+        { HIGH, LIGHT_LEVEL_DIM }, { HIGH + 1, LIGHT_LEVEL_BRIGHT }, { 4095, LIGHT_LEVEL_BRIGHT },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        light_control_t ctl;
+        light_control_init(&ctl, LOW, HIGH, HYST);
+        CHECK(ctl.level == LIGHT_LEVEL_UNKNOWN);
+        CHECK(light_control_update(&ctl, cases[i].raw));
+        CHECK(ctl.level == cases[i].level);
+    }
+}
+
+static void test_holds_inside_hysteresis(void) {
+    check_holds(LIGHT_LEVEL_DARK, 0, 0, LOW + HYST);
+    check_holds(LIGHT_LEVEL_DIM, (LOW + HIGH) / 2, LOW - HYST + 1, HIGH + HYST);
+    check_holds(LIGHT_LEVEL_BRIGHT, 4095, HIGH - HYST + 1, 4095);
+}
+
+static void test_switches_past_threshold_plus_hysteresis(void) {
+    uint16_t dim = (LOW + HIGH) / 2;
+    check_switch(0, LOW + HYST, LIGHT_LEVEL_DARK);
+    check_switch(0, LOW + HYST + 1, LIGHT_LEVEL_DIM);
+    check_switch(0, HIGH + HYST + 1, LIGHT_LEVEL_BRIGHT);   // Pula o nível médio
+    check_switch(dim, LOW - HYST + 1, LIGHT_LEVEL_DIM);
+    check_switch(dim, LOW - HYST, LIGHT_LEVEL_DARK);
+    check_switch(dim, HIGH + HYST, LIGHT_LEVEL_DIM);
+    check_switch(dim, HIGH + HYST + 1, LIGHT_LEVEL_BRIGHT);
+    check_switch(4095, HIGH - HYST + 1, LIGHT_LEVEL_BRIGHT);
+    check_switch(4095, HIGH - HYST, LIGHT_LEVEL_DIM);
+    check_switch(4095, LOW - HYST, LIGHT_LEVEL_DARK);
+
+    // Ruído de ±HYST em volta de um limiar: uma troca só
+    light_control_t ctl;
+    setup(&ctl, LOW - HYST);
+    for (int i = 0; i < 1000; i++) light_control_update(&ctl, (uint16_t)(LOW + (i % (2 * HYST + 1)) - HYST));
+    CHECK(ctl.level == LIGHT_LEVEL_DARK && ctl.transitions == 1);
+}
+
+static void test_read_error_holds_level(void) {
+    light_control_t ctl;
+    setup(&ctl, (LOW + HIGH) / 2);
+    for (int i = 1; i < LIGHT_CONTROL_MAX_FAULTS; i++) {
+        CHECK(!light_control_fault(&ctl));
+        CHECK(ctl.level == LIGHT_LEVEL_DIM);
+    }
+    // Leitura boa zera a contagem de falhas seguidas
+    CHECK(!light_control_update(&ctl, (LOW + HIGH) / 2));
+    for (int i = 1; i < LIGHT_CONTROL_MAX_FAULTS; i++) CHECK(!light_control_fault(&ctl));
+    CHECK(ctl.level == LIGHT_LEVEL_DIM && ctl.transitions == 1);
+    // Sensor desconectado: apaga o LED uma vez e continua apagado
+    CHECK(light_control_fault(&ctl));
+    CHECK(ctl.level == LIGHT_LEVEL_UNKNOWN && ctl.transitions == 2);
+    CHECK(!light_control_fault(&ctl));
+    // Volta com a classificação sem histerese
+    CHECK(light_control_update(&ctl, HIGH + 1));
+    CHECK(ctl.level == LIGHT_LEVEL_BRIGHT);
+    // Falha antes da primeira leitura: continua desconhecido
+    light_control_init(&ctl, LOW, HIGH, HYST);
+    for (int i = 0; i < 2 * LIGHT_CONTROL_MAX_FAULTS; i++) CHECK(!light_control_fault(&ctl));
+    CHECK(ctl.level == LIGHT_LEVEL_UNKNOWN && ctl.transitions == 0);
+}
+
+static void test_ledc_duty(void) {
+    static const struct { light_level_t level; uint32_t duty[LIGHT_COLORS]; } cases[] = {
+        { LIGHT_LEVEL_UNKNOWN, { 0, 0, 0 } },
+        { LIGHT_LEVEL_DARK, { LIGHT_LEDC_DUTY_MAX, 0, 0 } },
+        { LIGHT_LEVEL_DIM, { 0, LIGHT_LEDC_DUTY_MAX, 0 } },
+        { LIGHT_LEVEL_BRIGHT, { 0, 0, LIGHT_LEDC_DUTY_MAX } },
+    };
+    CHECK(LIGHT_LEDC_DUTY_MAX == (1 << 10) - 1);   // LIGHT_LEDC_RESOLUTION de 10 bits
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        uint32_t duty[LIGHT_COLORS];
+        memset(duty, 0xA5, sizeof(duty));
+        light_control_duty(cases[i].level, LIGHT_LEDC_DUTY_MAX, duty);
+        CHECK(memcmp(duty, cases[i].duty, sizeof(duty)) == 0);
+    }
+}
+
+int main(void) {
+    test_first_reading();
+    test_holds_inside_hysteresis();
+    test_switches_past_threshold_plus_hysteresis();
+    test_read_error_holds_level();
+    test_ledc_duty();
+    printf("light_control: %s\n", failures ? "FALHA" : "ok");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "sensor_scheduler.h"
+
+// ======================================================
+// --- TESTE DO AGENDADOR COM RELÓGIO FALSO ---
+// ======================================================
+// O relógio (uptime_ms) só anda quando o teste manda, como a sampling_task
+// acordando no prazo. Confere a ordem dos prazos, as defasagens, a ausência de
+// deriva com despertares atrasados e o descarte dos períodos perdidos depois de
+// um travamento longo.
+
+#define CHECK(cond) do { \
+        if (!(cond)) { printf("FALHA %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+    } while (0)
+
+#define LOG_SIZE 256
+
+static int failures;
+static int64_t uptime_ms;
+
+typedef struct {
+    int id;
+    int64_t at_ms;
+} run_t;
+
+static run_t run_log[LOG_SIZE];
+static size_t run_count;
+
+static void record_run(void *ctx) {
+    if (run_count < LOG_SIZE) run_log[run_count++] = (run_t){ (int)(intptr_t)ctx, uptime_ms };
+}
+
+// Mesmo arranjo do firmware local: BMP280, DHT11, MQ-135 e LDR a cada 2 s, defasados
+static const struct { const char *name; uint32_t period_ms, phase_ms; } sensors[] = {
+    { "bmp280", 2000, 0 },
+    { "dht11", 2000, 500 },
+    { "mq135", 2000, 1000 },
+    { "ldr", 2000, 1500 },
+    { "heartbeat", 5000, 0 },   // Mesmo prazo do bmp280 em t = 0: desempate pela ordem de registro
+};
+#define SENSORS (sizeof(sensors) / sizeof(sensors[0]))
+
+static void setup(sensor_scheduler_t *sched, int64_t start_ms) {
+    sensor_scheduler_init(sched);
+    uptime_ms = start_ms;
+    run_count = 0;
+    for (size_t i = 0; i < SENSORS; i++) {
+        int id = sensor_scheduler_register(sched, sensors[i].name, sensors[i].period_ms, sensors[i].phase_ms,
+                                           record_run, (void *)(intptr_t)i, uptime_ms);
+        CHECK(id == (int)i);
+    }
+}
+
+// Acorda no prazo (mais jitter_ms) até until_ms
+static void run_until(sensor_scheduler_t *sched, int64_t until_ms, int64_t jitter_ms) {
+    while (sensor_scheduler_next_deadline(sched) <= until_ms) {
+        uptime_ms = sensor_scheduler_next_deadline(sched) + jitter_ms;
+        sensor_scheduler_run_due(sched, uptime_ms);
+    }
+}
+
+// Prazos na ordem de execução, prazos iguais pela ordem de registro, e a
+// primeira execução de cada sensor em início + defasagem
+static void test_order_and_phase(void) {
+    sensor_scheduler_t sched;
+    const int64_t start_ms = 1234;
+    setup(&sched, start_ms);
+    run_until(&sched, start_ms + 20000, 0);
+
+    int64_t first_ms[SENSORS];
+    size_t runs[SENSORS] = { 0 };
+    for (size_t i = 0; i < SENSORS; i++) first_ms[i] = -1;
+    for (size_t i = 0; i < run_count; i++) {
+        const run_t *run = &run_log[i];
+        const int64_t offset = run->at_ms - start_ms - sensors[run->id].phase_ms;
+        CHECK(offset % sensors[run->id].period_ms == 0);   // Sempre num instante da grade do sensor
+        if (first_ms[run->id] < 0) first_ms[run->id] = run->at_ms;
+        runs[run->id]++;
+        if (i > 0) {
+            CHECK(run->at_ms >= run_log[i - 1].at_ms);
+            if (run->at_ms == run_log[i - 1].at_ms) CHECK(run->id > run_log[i - 1].id);
+        }
+    }
+    for (size_t i = 0; i < SENSORS; i++) {
+        CHECK(first_ms[i] == start_ms + sensors[i].phase_ms);
+        CHECK(runs[i] == (20000 - sensors[i].phase_ms) / sensors[i].period_ms + 1);
+        CHECK(sched.entries[i].skipped_periods == 0);
+    }
+    CHECK(run_log[0].id == 0 && run_log[1].id == 4);   // bmp280 e heartbeat em t = 0
+}
+
+// Despertares 15 ms atrasados: cada execução sai 15 ms depois da grade, sem
+// acumular deriva, e o próximo prazo continua na grade
+static void test_jitter_without_drift(void) {
+    sensor_scheduler_t sched;
+    setup(&sched, 0);
+    run_until(&sched, 60000, 15);
+    for (size_t i = 0; i < run_count; i++) {
+        const int64_t offset = run_log[i].at_ms - sensors[run_log[i].id].phase_ms;
+        CHECK(offset % sensors[run_log[i].id].period_ms == 15);
+    }
+    for (size_t i = 0; i < SENSORS; i++) {
+        CHECK((sched.entries[i].next_due_ms - sensors[i].phase_ms) % sensors[i].period_ms == 0);
+        CHECK(sched.entries[i].skipped_periods == 0);
+    }
+}
+
+// Laço travado por 7,3 períodos: cada sensor roda uma vez só ao voltar (sem
+// rajada), os períodos perdidos são contados e o próximo prazo volta à grade,
+// depois do instante atual
+static void test_stall_skips_missed_periods(void) {
+    sensor_scheduler_t sched;
+    setup(&sched, 0);
+    run_until(&sched, 10000, 0);
+    const size_t before = run_count;
+    const int64_t stalled_until_ms = 10000 + 14600;
+    uptime_ms = stalled_until_ms;
+    size_t executed = sensor_scheduler_run_due(&sched, uptime_ms);
+    CHECK(executed == SENSORS);
+    CHECK(run_count - before == SENSORS);
+    for (size_t i = 0; i < SENSORS; i++) {
+        const sensor_schedule_entry_t *entry = &sched.entries[i];
+        const int64_t period = sensors[i].period_ms, phase = sensors[i].phase_ms;
+        // Prazo pendente antes do travamento: primeiro da grade depois de 10000
+        const int64_t pending_ms = phase + ((10000 - phase) / period + 1) * period;
+        const int64_t expected_next_ms = phase + ((stalled_until_ms - phase) / period + 1) * period;
+        CHECK(entry->next_due_ms == expected_next_ms);
+        CHECK(entry->next_due_ms > stalled_until_ms);
+        CHECK(entry->skipped_periods == (uint32_t)((expected_next_ms - pending_ms) / period - 1));
+        CHECK(entry->last_run_ms == stalled_until_ms);
+    }
+    CHECK(sensor_scheduler_run_due(&sched, uptime_ms) == 0);
+}
+
+static void test_register_limits(void) {
+    sensor_scheduler_t sched;
+    sensor_scheduler_init(&sched);
+    CHECK(sensor_scheduler_next_deadline(&sched) == INT64_MAX);
+    CHECK(sensor_scheduler_register(&sched, "zero", 0, 0, record_run, NULL, 0) == -1);
+    CHECK(sensor_scheduler_register(&sched, "sem_callback", 1000, 0, NULL, NULL, 0) == -1);
+    for (int i = 0; i < SENSOR_SCHEDULER_MAX_ENTRIES; i++) {
+        CHECK(sensor_scheduler_register(&sched, "s", 1000, (uint32_t)i, record_run, NULL, 0) == i);
+    }
+    CHECK(sensor_scheduler_register(&sched, "cheio", 1000, 0, record_run, NULL, 0) == -1);
+}
+
+int main(void) {
+    test_order_and_phase();
+    test_jitter_without_drift();
+    test_stall_skips_missed_periods();
+    test_register_limits();
+    printf("sensor_scheduler: %s\n", failures ? "FALHA" : "ok");
+    return failures ? 1 : 0;
+}
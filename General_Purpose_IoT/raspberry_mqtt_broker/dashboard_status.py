@@ -0,0 +1,50 @@
+import datetime
+
+# --- Campos do Dashboard (sistema/dashboard/status) ---
+# (chave, device_id, measurement, field, tags além de device_id, opções)
+DASHBOARD_STATUS_FIELDS = (
+    # esp32_01: sensores e GPIO
+    ("dht11_temperature", "esp32_01", "dht11", "temperature", {}, {}),
+    ("dht11_humidity", "esp32_01", "dht11", "humidity", {}, {"round_digits": 1}),
+    ("bmp280_temperature", "esp32_01", "bmp280", "temperature", {}, {}),
+    ("bmp280_pressure", "esp32_01", "bmp280", "pressure", {}, {}),
+    ("bmp280_sea_level_pressure", "esp32_01", "bmp280", "pressure_sea_level", {}, {}),
+    ("mq135_ppm", "esp32_01", "mq135", "ppm", {}, {}),
+    ("ldr_raw", "esp32_01", "ldr", "ldr_raw", {}, {"round_digits": 0}),
+    ("gpio_2_state", "esp32_01", "gpio_state", "state", {"pin": "gpio2"}, {"is_gpio": True}),
+    # esp32_02: status (mapeado para device_status no dashboard)
+    ("device_status", "esp32_02", "device_status", "status", {}, {"check_timeout": True}),
+)
+
+def format_status_value(measurement, value, options):
+    """Valor do campo como o dashboard espera (arredondado, ON/OFF, online)."""
+    if options.get("is_gpio"):
+        return "ON" if value == "ON" else "OFF"
+    if isinstance(value, (int, float)):
+        return round(value, options.get("round_digits", 2))
+    if measurement == "device_status" and value in ["heartbeat", "online"]:
+        return "online"
+    return value
+
+def build_dashboard_status(last_values, status_timeout, now=None):
+    """Monta o status do dashboard a partir do cache de últimos valores (LastValueCache).
+
+    Valores publicados por banda morta continuam no dashboard enquanto valem
+    (hold); passado o hold mais status_timeout sem nova mensagem, o dispositivo
+    deixou de publicar e o campo aparece como "offline". O status (check_timeout)
+    expira status_timeout depois da última mensagem, ou depois do hold quando o
+    heartbeat o informa (modo de baixo consumo, um heartbeat por rajada).
+    """
+    now = now or datetime.datetime.utcnow()
+    status_data = {}
+    for key, device_id, measurement, field, tags, options in DASHBOARD_STATUS_FIELDS:
+        entry = last_values.get(device_id, measurement, field, tags)
+        if entry is None or entry[0] is None:
+            continue
+        value, last_time, valid_until = entry
+        expires_from = valid_until or (last_time if options.get("check_timeout") else None)
+        if expires_from and (now - expires_from).total_seconds() > status_timeout:
+            status_data[key] = "offline"
+        else:
+            status_data[key] = format_status_value(measurement, value, options)
+    return status_data
@@ -0,0 +1,215 @@
+import datetime
+import logging
+import os
+import queue
+import threading
+import time
+
+# --- Conversão para Line Protocol ---
+
+def _escape_key(value):
+    return str(value).replace("\\", "\\\\").replace(",", "\\,").replace("=", "\\=").replace(" ", "\\ ")
+
+def _escape_measurement(value):
+    return str(value).replace("\\", "\\\\").replace(",", "\\,").replace(" ", "\\ ")
+
+def _format_field(value):
+    if isinstance(value, bool):
+        return "true" if value else "false"
+    if isinstance(value, int):
+        return f"{value}i"
+    if isinstance(value, float):
+        return repr(value)
+    return '"' + str(value).replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+def _to_ns(timestamp):
+    """Converte o campo "time" de um ponto (ISO 8601, datetime ou ns) para nanossegundos."""
+    if timestamp is None:
+        return time.time_ns()
+    if isinstance(timestamp, int):
+        return timestamp
+    if isinstance(timestamp, str):
+        timestamp = datetime.datetime.fromisoformat(timestamp.replace("Z", "+00:00"))
+    if timestamp.tzinfo is None:
+        timestamp = timestamp.replace(tzinfo=datetime.timezone.utc)
+    delta = timestamp - datetime.datetime(1970, 1, 1, tzinfo=datetime.timezone.utc)
+    return (delta.days * 86400 + delta.seconds) * 1_000_000_000 + delta.microseconds * 1000
+
+def point_to_line(point):
+    """Converte um ponto no formato JSON do cliente InfluxDB em uma linha de line protocol."""
+    tags = "".join(f",{_escape_key(k)}={_escape_key(v)}" for k, v in sorted(point.get("tags", {}).items()) if v != "")
+    fields = ",".join(f"{_escape_key(k)}={_format_field(v)}" for k, v in point["fields"].items() if v is not None)
+    return f"{_escape_measurement(point['measurement'])}{tags} {fields} {_to_ns(point.get('time'))}"
+
+
+# --- Escritor Assíncrono ---
+class InfluxWriter:
+    """Fila limitada de pontos drenada por uma thread que grava em lote no InfluxDB.
+
+    write_points() nunca faz I/O de rede: converte os pontos para line protocol e
+    os enfileira. A thread "InfluxWriter" agrupa por quantidade (batch_size) ou
+    idade (flush_interval), tenta novamente em caso de falha e, esgotadas as
+    tentativas, anexa o lote ao arquivo de spill, que é reenviado após a próxima
+    gravação bem-sucedida. Um reenvio interrompido por queda do gateway é
+    retomado na próxima partida (ver _recover_replay).
+    """
+
+    def __init__(self, influx_client, queue_size=10000, batch_size=500, flush_interval=1.0,
+                 enqueue_timeout=0.05, max_retries=3, retry_backoff=1.0, spill_file="influx_spill.lp"):
+        self.influx_client = influx_client
+        self.batch_size = batch_size
+        self.flush_interval = flush_interval
+        self.enqueue_timeout = enqueue_timeout
+        self.max_retries = max_retries
+        self.retry_backoff = retry_backoff
+        self.spill_file = spill_file
+        self.queue = queue.Queue(maxsize=queue_size)
+        self._stop = threading.Event()
+        self._thread = None
+        self._stats_lock = threading.Lock()
+        self._last_drop_log = 0.0
+        self.stats = {"enqueued": 0, "written": 0, "dropped": 0, "write_errors": 0, "spilled": 0, "replayed": 0}
+
+    def _count(self, key, amount=1):
+        with self._stats_lock:
+            self.stats[key] += amount
+
+    def get_stats(self):
+        with self._stats_lock:
+            snapshot = dict(self.stats)
+        snapshot["queue_depth"] = self.queue.qsize()
+        return snapshot
+
+    def start(self):
+        self._thread = threading.Thread(target=self._run, name="InfluxWriter", daemon=True)
+        self._thread.start()
+
+    def stop(self, timeout=10):
+        """Para a thread depois de drenar a fila."""
+        self._stop.set()
+        if self._thread:
+            self._thread.join(timeout)
+
+    def write_points(self, points):
+        """Enfileira pontos para gravação. Retorna False se algum ponto foi descartado."""
+        accepted = True
+        for point in points:
+            try:
+                self.queue.put(point_to_line(point), timeout=self.enqueue_timeout)
+                self._count("enqueued")
+            except queue.Full:
+                self._count("dropped")
+                accepted = False
+            except Exception as e:
+                logging.error(f"Ponto inválido descartado ({point.get('measurement')}): {e}")
+                self._count("dropped")
+                accepted = False
+        if not accepted and time.monotonic() - self._last_drop_log > 10:
+            self._last_drop_log = time.monotonic()
+            logging.warning(f"Fila do InfluxDB cheia ou ponto inválido; descartados até agora: {self.get_stats()['dropped']}")
+        return accepted
+
+    def _collect_batch(self):
+        batch = []
+        deadline = None
+        while len(batch) < self.batch_size:
+            timeout = self.flush_interval if deadline is None else deadline - time.monotonic()
+            if timeout <= 0:
+                break
+            try:
+                batch.append(self.queue.get(timeout=timeout))
+            except queue.Empty:
+                break
+            if deadline is None:
+                deadline = time.monotonic() + self.flush_interval
+        return batch
+
+    def _write_lines(self, lines):
+        self.influx_client.write_points(lines, protocol="line")
+
+    def _write_with_retry(self, lines):
+        for attempt in range(self.max_retries + 1):
+            try:
+                self._write_lines(lines)
+                return True
+            except Exception as e:
+                self._count("write_errors")
+                logging.error(f"Falha ao gravar lote de {len(lines)} pontos no InfluxDB (tentativa {attempt + 1}): {e}")
+                if attempt < self.max_retries and not self._stop.is_set():
+                    time.sleep(self.retry_backoff * (2 ** attempt))
+        return False
+
+    def _spill(self, lines):
+        try:
+            with open(self.spill_file, "a") as f:
+                f.write("\n".join(lines) + "\n")
+            self._count("spilled", len(lines))
+            logging.warning(f"{len(lines)} pontos gravados no arquivo de spill '{self.spill_file}'.")
+        except OSError as e:
+            self._count("dropped", len(lines))
+            logging.error(f"Falha ao gravar spill local, {len(lines)} pontos perdidos: {e}")
+
+    def _recover_replay(self):
+        """Devolve ao spill um ".replay" deixado por uma queda no meio do reenvio.
+
+        Fica na frente do spill (pontos mais antigos). Os pontos que já tinham
+        sido reenviados vão de novo: o InfluxDB sobrescreve o ponto de mesma
+        série e instante, então a repetição não duplica dados.
+        """
+        replaying = self.spill_file + ".replay"
+        if not os.path.exists(replaying):
+            return
+        merged = self.spill_file + ".tmp"
+        try:
+            with open(merged, "w") as out:
+                for path in (replaying, self.spill_file):
+                    if os.path.exists(path):
+                        with open(path) as f:
+                            out.writelines(line if line.endswith("\n") else line + "\n" for line in f if line.strip())
+                out.flush()
+                os.fsync(out.fileno())
+            os.replace(merged, self.spill_file)
+            os.remove(replaying)
+            logging.warning(f"Reenvio do spill interrompido na execução anterior: '{replaying}' devolvido ao spill.")
+        except OSError as e:
+            logging.error(f"Falha ao recuperar '{replaying}': {e}")
+
+    def _replay_spill(self):
+        """Reenvia o arquivo de spill em lotes; mantém o restante se o InfluxDB falhar de novo."""
+        if not os.path.exists(self.spill_file):
+            return
+        replaying = self.spill_file + ".replay"
+        try:
+            os.replace(self.spill_file, replaying)
+            with open(replaying) as f:
+                lines = [line.rstrip("\n") for line in f if line.strip()]
+        except OSError as e:
+            logging.error(f"Falha ao ler o arquivo de spill: {e}")
+            return
+        for start in range(0, len(lines), self.batch_size):
+            chunk = lines[start:start + self.batch_size]
+            try:
+                self._write_lines(chunk)
+                self._count("replayed", len(chunk))
+            except Exception as e:
+                logging.error(f"Falha ao reenviar spill, {len(lines) - start} pontos mantidos: {e}")
+                self._spill(lines[start:])
+                break
+        os.remove(replaying)
+        logging.info(f"Spill local reenviado: {self.get_stats()['replayed']} pontos no total.")
+
+    def _run(self):
+        self._recover_replay()
+        pending_replay = os.path.exists(self.spill_file)
+        while not (self._stop.is_set() and self.queue.empty()):
+            batch = self._collect_batch()
+            if not batch:
+                continue
+            if self._write_with_retry(batch):
+                self._count("written", len(batch))
+                if pending_replay:
+                    self._replay_spill()
+                    pending_replay = os.path.exists(self.spill_file)
+            else:
+                self._spill(batch)
+                pending_replay = True
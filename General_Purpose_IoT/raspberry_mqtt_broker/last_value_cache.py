@@ -0,0 +1,38 @@
+import threading
+
+# --- Cache do Último Valor ---
+class LastValueCache:
+    """Último valor de cada campo recebido, com o instante em que chegou e, se o
+    dispositivo publica por banda morta, até quando o valor continua válido sem
+    novas mensagens (hold).
+
+    A chave é (device_id, measurement, field, tags), onde tags são as tags além
+    de device_id (por exemplo, o pino de gpio_state) em forma ordenada. O cache
+    é preenchido pela thread do paho e lido pela thread de status, por isso todo
+    acesso passa pelo lock.
+    """
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._entries = {}
+
+    @staticmethod
+    def _extra_tags(tags):
+        return tuple(sorted((k, v) for k, v in (tags or {}).items() if k != "device_id"))
+
+    def update(self, measurement, tags, fields, timestamp, hold=None):
+        """hold é um datetime.timedelta; None quando o dispositivo publica toda leitura."""
+        device_id = tags.get("device_id")
+        extra = self._extra_tags(tags)
+        with self._lock:
+            for field, value in fields.items():
+                key = (device_id, measurement, field, extra)
+                current = self._entries.get(key)
+                # Nunca substitui um valor mais novo por um mais antigo (ex.: aquecimento pelo InfluxDB)
+                if current is None or current[1] <= timestamp:
+                    self._entries[key] = (value, timestamp, timestamp + hold if hold else None)
+
+    def get(self, device_id, measurement, field, tags=None):
+        """Retorna (valor, instante, válido até ou None) ou None."""
+        with self._lock:
+            return self._entries.get((device_id, measurement, field, self._extra_tags(tags)))
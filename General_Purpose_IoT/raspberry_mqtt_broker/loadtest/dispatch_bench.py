@@ -0,0 +1,246 @@
+import argparse
+import datetime
+import json
+import os
+import random
+import struct
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+from measurement_schema import build_local_router
+
+# --- Micro-benchmark do Despacho de Tópicos ---
+# Passa a mesma sequência de mensagens (tópico, payload) pelo caminho antigo do
+# on_local_message (split do tópico e cadeia de if/elif por sensor, copiado do
+# mqtt_to_influx.py antes do measurement_schema.py) e pelo atual (TopicRouter
+# mais handlers do esquema). Confere que os dois geram os mesmos pontos
+# (measurement, tags, fields) e mede o custo por mensagem, sem MQTT nem InfluxDB.
+#
+#   python dispatch_bench.py                           # sequência sintética da frota
+#   python dispatch_bench.py --save mensagens.jsonl    # grava a sequência usada
+#   python dispatch_bench.py --recorded mensagens.jsonl
+#
+# Arquivo gravado: uma linha JSON por mensagem, {"topic": ..., "payload_hex": ...}.
+
+
+# --- Caminho Antigo ---
+OLD_BINARY_HEADER = struct.Struct("<BB")
+OLD_BINARY_SENSOR_LAYOUTS = {
+    1: ("bmp280", struct.Struct("<fff"), (("temperature", 2), ("pressure", 2), ("pressure_sea_level", 2))),
+    2: ("dht11", struct.Struct("<ff"), (("temperature", 1), ("humidity", 1))),
+    3: ("mq135", struct.Struct("<Hf"), (("adc_raw", None), ("ppm", 2))),
+    4: ("ldr", struct.Struct("<H"), (("ldr_raw", None),)),
+}
+
+def old_decode_binary_records(payload):
+    readings, offset = [], 0
+    while offset + OLD_BINARY_HEADER.size <= len(payload):
+        version, sensor_id = OLD_BINARY_HEADER.unpack_from(payload, offset)
+        layout = OLD_BINARY_SENSOR_LAYOUTS.get(sensor_id)
+        if version != 1 or layout is None:
+            raise ValueError(f"registro binário desconhecido (versão {version}, sensor {sensor_id}) no byte {offset}")
+        measurement_name, record, field_specs = layout
+        offset += OLD_BINARY_HEADER.size
+        if offset + record.size > len(payload):
+            raise ValueError(f"registro de {measurement_name} truncado no byte {offset}")
+        values = record.unpack_from(payload, offset)
+        offset += record.size
+        fields = {name: int(value) if digits is None else round(value, digits)
+                  for (name, digits), value in zip(field_specs, values)}
+        readings.append((measurement_name, fields))
+    return readings
+
+def old_parse_sensor_fields(sensor_type, data):
+    fields, measurement_name = {}, None
+    if sensor_type == "bmp280" and isinstance(data, dict):
+        measurement_name = "bmp280"
+        if "temperature" in data: fields["temperature"] = float(data["temperature"])
+        if "pressure" in data: fields["pressure"] = float(data["pressure"])
+        if "pressure_sea_level" in data: fields["pressure_sea_level"] = float(data["pressure_sea_level"])
+    elif sensor_type == "dht11" and isinstance(data, dict):
+        measurement_name = "dht11"
+        if "temperature" in data: fields["temperature"] = float(data["temperature"])
+        if "humidity" in data: fields["humidity"] = float(data["humidity"])
+    elif sensor_type == "mq135" and isinstance(data, dict):
+        measurement_name = "mq135"
+        if "adc_raw" in data: fields["adc_raw"] = int(data["adc_raw"])
+        if "ppm" in data: fields["ppm"] = float(data["ppm"])
+    elif sensor_type == "ldr" and isinstance(data, dict):
+        measurement_name = "ldr"
+        if "ldr_raw" in data: fields["ldr_raw"] = int(data["ldr_raw"])
+    return measurement_name, fields
+
+def old_dispatch(topic, payload):
+    """on_local_message antigo, devolvendo o json_body em vez de gravá-lo."""
+    if topic.endswith('/bin'):
+        device_id = topic.split('/')[0]
+        timestamp = datetime.datetime.utcnow().isoformat() + "Z"
+        return [{"measurement": measurement_name, "tags": {"device_id": device_id}, "time": timestamp, "fields": fields}
+                for measurement_name, fields in old_decode_binary_records(payload)]
+
+    payload_str = payload.decode('utf-8')
+    topic_parts = topic.split('/')
+    device_id = topic_parts[0]
+    tags, fields, measurement_name = {"device_id": device_id}, {}, None
+    try:
+        data = json.loads(payload_str)
+    except json.JSONDecodeError:
+        data = payload_str
+
+    if len(topic_parts) == 3 and topic_parts[1] == 'sensor' and topic_parts[2] == 'batch':
+        timestamp = datetime.datetime.utcnow().isoformat() + "Z"
+        json_body = []
+        for reading in data if isinstance(data, list) else []:
+            if not isinstance(reading, dict):
+                continue
+            sensor_measurement, sensor_fields = old_parse_sensor_fields(reading.get("sensor"), reading)
+            if sensor_measurement and sensor_fields:
+                json_body.append({"measurement": sensor_measurement, "tags": dict(tags), "time": timestamp, "fields": sensor_fields})
+        return json_body
+
+    if len(topic_parts) > 2 and topic_parts[1] == 'sensor':
+        measurement_name, fields = old_parse_sensor_fields(topic_parts[2], data)
+    elif len(topic_parts) == 4 and topic_parts[1] == 'gpio' and topic_parts[3] == 'state':
+        measurement_name = "gpio_state"
+        tags['pin'] = f"gpio{topic_parts[2]}"
+        fields["state"] = payload_str.upper()
+    elif (len(topic_parts) == 3 and topic_parts[1] == "system" and topic_parts[2] == "status") or \
+         (len(topic_parts) == 2 and topic_parts[1] == "status"):
+        measurement_name = "device_status"
+        fields["status"] = payload_str
+
+    if measurement_name and fields:
+        return [{"measurement": measurement_name, "tags": tags, "time": datetime.datetime.utcnow().isoformat() + "Z", "fields": fields}]
+    return []
+
+
+# --- Caminho Atual (on_local_message de mqtt_to_influx.py) ---
+def new_dispatcher():
+    router = build_local_router()
+
+    def dispatch(topic, payload):
+        handler, topic_levels = router.match(topic)
+        points = handler(topic_levels, payload) if handler else []
+        if not points:
+            return []
+        timestamp = datetime.datetime.utcnow().isoformat() + "Z"
+        return [{"measurement": measurement_name, "tags": tags, "time": timestamp, "fields": fields}
+                for measurement_name, tags, fields, _ in points if fields]
+    return dispatch
+
+
+# --- Sequência de Mensagens ---
+# Mesma mistura da frota (loadtest/fleet.py): cada dispositivo local publica os
+# quatro sensores a cada ciclo, por tópico ou em lote, em JSON ou binário v1 (o
+# que o caminho antigo entende), e os de nuvem publicam estados de GPIO e status.
+SENSOR_FORMATS = {
+    "bmp280": ('{"temperature":%.2f,"pressure":%.2f,"pressure_sea_level":%.2f}', struct.Struct("<fff"), 1),
+    "dht11": ('{"temperature":%.1f,"humidity":%.1f}', struct.Struct("<ff"), 2),
+    "mq135": ('{"adc_raw":%d,"ppm":%.2f}', struct.Struct("<Hf"), 3),
+    "ldr": ('{"ldr_raw":%d}', struct.Struct("<H"), 4),
+}
+
+def _sensor_values(sensor, rng):
+    if sensor == "bmp280":
+        return (rng.uniform(15, 30), rng.uniform(1000, 1020), rng.uniform(1003, 1023))
+    if sensor == "dht11":
+        return (rng.uniform(15, 30), rng.uniform(30, 80))
+    if sensor == "mq135":
+        return (rng.randrange(4096), rng.uniform(300, 600))
+    return (rng.randrange(4096),)
+
+def synthetic_cycles(devices, cycles, seed=1):
+    """Mensagens de cada ciclo de 2 s, um ciclo por vez."""
+    rng = random.Random(seed)
+    for cycle in range(cycles):
+        messages = []
+        for d in range(devices):
+            device = f"sim_local_{d:04d}"
+            mode = d % 4   # 0: JSON por sensor, 1: binário por sensor, 2: lote JSON, 3: lote binário
+            readings = [(sensor, _sensor_values(sensor, rng)) for sensor in SENSOR_FORMATS]
+            if mode == 0:
+                messages += [(f"{device}/sensor/{s}", (SENSOR_FORMATS[s][0] % v).encode()) for s, v in readings]
+            elif mode == 1:
+                messages += [(f"{device}/sensor/{s}/bin", bytes([1, SENSOR_FORMATS[s][2]]) + SENSOR_FORMATS[s][1].pack(*v))
+                             for s, v in readings]
+            elif mode == 2:
+                batch = ",".join('{"sensor":"%s",%s' % (s, (SENSOR_FORMATS[s][0] % v)[1:]) for s, v in readings)
+                messages.append((f"{device}/sensor/batch", f"[{batch}]".encode()))
+            else:
+                messages.append((f"{device}/sensor/batch/bin",
+                                 b"".join(bytes([1, SENSOR_FORMATS[s][2]]) + SENSOR_FORMATS[s][1].pack(*v) for s, v in readings)))
+            if cycle % 10 == 0:
+                messages.append((f"{device}/system/status", b"online"))
+        for c in range(max(1, devices // 25)):
+            pin = rng.choice((2, 4, 5, 13, 14, 16, 17, 18, 19, 21, 22, 23, 25, 26, 27, 32, 33))
+            messages.append((f"sim_cloud_{c:04d}/gpio/{pin}/state", rng.choice((b"ON", b"OFF"))))
+        yield messages
+
+def synthetic_messages(devices, cycles, seed=1):
+    return [message for messages in synthetic_cycles(devices, cycles, seed) for message in messages]
+
+def load_messages(path):
+    with open(path, encoding="utf-8") as f:
+        return [(m["topic"], bytes.fromhex(m["payload_hex"])) for m in map(json.loads, f) if m]
+
+def save_messages(path, messages):
+    with open(path, "w", encoding="utf-8") as f:
+        for topic, payload in messages:
+            f.write(json.dumps({"topic": topic, "payload_hex": payload.hex()}) + "\n")
+
+
+# --- Comparação ---
+def _without_time(body):
+    return [(p["measurement"], p["tags"], p["fields"]) for p in body]
+
+def compare(messages):
+    """Lista de (índice, tópico) em que os dois caminhos geram pontos diferentes."""
+    new_dispatch = new_dispatcher()
+    return [(i, topic) for i, (topic, payload) in enumerate(messages)
+            if _without_time(old_dispatch(topic, payload)) != _without_time(new_dispatch(topic, payload))]
+
+def _elapsed(dispatch, messages):
+    start = time.perf_counter()
+    for topic, payload in messages:
+        dispatch(topic, payload)
+    return time.perf_counter() - start
+
+def time_paths(paths, messages, repeat):
+    """ns por mensagem de cada caminho: a repetição mais rápida, com os caminhos
+    alternados a cada repetição para que ruído da máquina afete os dois."""
+    best = [float("inf")] * len(paths)
+    for _ in range(repeat):
+        for i, dispatch in enumerate(paths):
+            best[i] = min(best[i], _elapsed(dispatch, messages))
+    return [b / len(messages) * 1e9 for b in best]
+
+def main():
+    parser = argparse.ArgumentParser(description="Compara o despacho de tópicos antigo (split/if) com o do esquema.")
+    parser.add_argument("--devices", type=int, default=100, help="Dispositivos locais na sequência sintética")
+    parser.add_argument("--cycles", type=int, default=50, help="Ciclos de 2 s na sequência sintética")
+    parser.add_argument("--repeat", type=int, default=9, help="Repetições; vale a mais rápida")
+    parser.add_argument("--recorded", help="Usa as mensagens gravadas neste arquivo")
+    parser.add_argument("--save", help="Grava a sequência usada neste arquivo")
+    args = parser.parse_args()
+
+    messages = load_messages(args.recorded) if args.recorded else synthetic_messages(args.devices, args.cycles)
+    if args.save:
+        save_messages(args.save, messages)
+    if not messages:
+        print("nenhuma mensagem")
+        return 1
+
+    mismatches = compare(messages)
+    old_ns, new_ns = time_paths((old_dispatch, new_dispatcher()), messages, args.repeat)
+    print(f"{len(messages)} mensagens, {len({t for t, _ in messages})} tópicos distintos")
+    print(f"  antigo (split/if):     {old_ns:8.0f} ns/mensagem")
+    print(f"  esquema (trie/cache):  {new_ns:8.0f} ns/mensagem ({old_ns / new_ns:.2f}x)")
+    for i, topic in mismatches[:10]:
+        print(f"  pontos diferentes na mensagem {i} ({topic})")
+    print(f"  mesmos pontos nos dois caminhos: {'FALHA' if mismatches else 'ok'}")
+    return 1 if mismatches else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,168 @@
+import argparse
+import json
+import logging
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import urlparse
+
+# --- InfluxDB Falso ---
+# Responde à API HTTP v1 usada pelo gateway (/ping, /query e /write) sem
+# armazenar nada: cada linha recebida em /write é contada e repassada ao
+# callback on_line(measurement, tags, fields, instante de chegada). /query
+# sempre devolve um resultado vazio.
+
+def _split_unescaped(text, separator, maxsplit=-1):
+    parts, current, escaped, quoted = [], [], False, False
+    for char in text:
+        if escaped:
+            current.append(char)
+            escaped = False
+        elif char == "\\":
+            current.append(char)
+            escaped = True
+        elif char == '"':
+            current.append(char)
+            quoted = not quoted
+        elif char == separator and not quoted and maxsplit != 0:
+            parts.append("".join(current))
+            current = []
+            maxsplit -= 1
+        else:
+            current.append(char)
+    parts.append("".join(current))
+    return parts
+
+def _unescape(text):
+    return text.replace("\\ ", " ").replace("\\,", ",").replace("\\=", "=").replace("\\\\", "\\")
+
+def _parse_field_value(raw):
+    if raw.startswith('"'):
+        return raw[1:-1].replace('\\"', '"').replace("\\\\", "\\")
+    if raw.endswith("i"):
+        return int(raw[:-1])
+    if raw in ("true", "false"):
+        return raw == "true"
+    return float(raw)
+
+def parse_line(line):
+    """Converte uma linha de line protocol em (measurement, tags, fields)."""
+    key, field_set = _split_unescaped(line, " ", 2)[:2]
+    measurement, *tag_pairs = _split_unescaped(key, ",")
+    tags = dict(_unescape(pair).split("=", 1) for pair in tag_pairs)
+    fields = {}
+    for pair in _split_unescaped(field_set, ","):
+        name, raw = _split_unescaped(pair, "=", 1)
+        fields[_unescape(name)] = _parse_field_value(raw)
+    return _unescape(measurement), tags, fields
+
+
+class FakeInfluxSink:
+    def __init__(self, host="127.0.0.1", port=8086, write_delay=0.0, on_line=None):
+        self.write_delay = write_delay
+        self.on_line = on_line
+        self.lock = threading.Lock()
+        self.stats = {"write_requests": 0, "lines": 0, "query_requests": 0, "bad_lines": 0}
+        self.by_measurement = {}
+        self.first_line_at = self.last_line_at = None
+        self.server = ThreadingHTTPServer((host, port), self._handler_class())
+        self.server.daemon_threads = True
+        self.thread = None
+
+    @property
+    def port(self):
+        return self.server.server_address[1]
+
+    def _handler_class(self):
+        sink = self
+
+        class Handler(BaseHTTPRequestHandler):
+            def log_message(self, format, *args):
+                pass
+
+            def _reply(self, status, body=b""):
+                self.send_response(status)
+                self.send_header("Content-Type", "application/json")
+                self.send_header("Content-Length", str(len(body)))
+                self.end_headers()
+                self.wfile.write(body)
+
+            def _body(self):
+                length = int(self.headers.get("Content-Length") or 0)
+                return self.rfile.read(length) if length else b""
+
+            def do_GET(self):
+                self._dispatch()
+
+            def do_POST(self):
+                self._dispatch()
+
+            def _dispatch(self):
+                path = urlparse(self.path).path
+                body = self._body()
+                if path == "/ping":
+                    self._reply(204)
+                elif path == "/query":
+                    with sink.lock:
+                        sink.stats["query_requests"] += 1
+                    self._reply(200, json.dumps({"results": [{"statement_id": 0}]}).encode())
+                elif path == "/write":
+                    if sink.write_delay:
+                        time.sleep(sink.write_delay)
+                    sink.ingest(body.decode("utf-8"))
+                    self._reply(204)
+                else:
+                    self._reply(404)
+
+        return Handler
+
+    def ingest(self, text):
+        arrived_at = time.monotonic()
+        lines = [line for line in text.split("\n") if line.strip()]
+        with self.lock:
+            self.stats["write_requests"] += 1
+            self.stats["lines"] += len(lines)
+            if self.first_line_at is None and lines:
+                self.first_line_at = arrived_at
+            if lines:
+                self.last_line_at = arrived_at
+        for line in lines:
+            try:
+                measurement, tags, fields = parse_line(line)
+            except (ValueError, IndexError):
+                with self.lock:
+                    self.stats["bad_lines"] += 1
+                continue
+            with self.lock:
+                self.by_measurement[measurement] = self.by_measurement.get(measurement, 0) + 1
+            if self.on_line:
+                self.on_line(measurement, tags, fields, arrived_at)
+
+    def start(self):
+        self.thread = threading.Thread(target=self.server.serve_forever, name="FakeInflux", daemon=True)
+        self.thread.start()
+
+    def stop(self):
+        self.server.shutdown()
+        self.server.server_close()
+
+    def snapshot(self):
+        with self.lock:
+            return dict(self.stats, by_measurement=dict(self.by_measurement))
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="InfluxDB v1 falso: aceita e conta gravações.")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8086)
+    parser.add_argument("--write-delay", type=float, default=0.0, help="Atraso artificial por /write, em segundos")
+    args = parser.parse_args()
+    logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(levelname)s - %(message)s')
+    sink = FakeInfluxSink(args.host, args.port, args.write_delay)
+    sink.start()
+    logging.info(f"InfluxDB falso escutando em {args.host}:{sink.port}")
+    try:
+        while True:
+            time.sleep(10)
+            logging.info(f"Recebido até agora: {sink.snapshot()}")
+    except KeyboardInterrupt:
+        sink.stop()
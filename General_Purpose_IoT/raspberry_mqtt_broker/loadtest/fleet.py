@@ -0,0 +1,464 @@
+import argparse
+import asyncio
+import collections
+import heapq
+import json
+import logging
+import random
+import struct
+import threading
+import time
+
+from mqtt_wire import MqttPublisher
+
+# --- Perfis dos Firmwares ---
+# Tópicos, formatos e períodos copiados de esp32_mqtt_local (board_config.h,
+# telemetry_codec.c e publish_policy.c), esp32_mqtt_cloud (board_config.h) e
+# runtime_metrics.c. Se o firmware mudar, atualize aqui também.
+
+LOCAL_SENSOR_TIMING_MS = {          # sensor -> (período, defasagem)
+    "heartbeat": (20000, 0),
+    "bmp280": (2000, 0),
+    "dht11": (2000, 500),
+    "mq135": (2000, 1000),
+    "ldr": (2000, 1500),
+}
+LOCAL_KEEPALIVE_S = 10
+BATCH_WINDOW_MS = 2000
+BATCH_MAX_READINGS = 4
+METRICS_INTERVAL_MS = 60000
+METRICS_PHASE_MS = 250
+
+# Publicação por banda morta (PUBLISH_POLICY_ENABLED): sensor -> limiar por campo.
+# Todos com SENSOR_MAX_SILENCE_MS, que também vai como hold_ms em cada leitura.
+SENSOR_MAX_SILENCE_MS = 60000
+PUBLISH_DEADBANDS = {"bmp280": (0.2, 0.5, 0.5), "dht11": (0.5, 1.5)}
+
+# Modo de baixo consumo (LOW_POWER_MODE_ENABLED): leituras, heartbeat e métricas
+# ficam na fila e saem juntos numa rajada por período, com age_ms
+LOW_POWER_BURST_PERIOD_MS = 30000
+LOW_POWER_BURST_PHASE_MS = 1900
+LOW_POWER_KEEPALIVE_S = 120
+
+CLOUD_HEARTBEAT_MS = 5000
+CLOUD_GPIO_PINS = (2, 4, 5, 13, 14, 16, 17, 18, 19, 21, 22, 23, 25, 26, 27, 32, 33)
+
+BINARY_CODEC_VERSION_META = 2
+BINARY_IDS = {"bmp280": 1, "dht11": 2, "mq135": 3, "ldr": 4}
+BINARY_LAYOUTS = {"bmp280": struct.Struct("<fff"), "dht11": struct.Struct("<ff"),
+                  "mq135": struct.Struct("<Hf"), "ldr": struct.Struct("<H")}
+BINARY_META = (("age_ms", 0x01, struct.Struct("<I")), ("seq", 0x02, struct.Struct("<I")),   # Ordem do registro v2
+               ("ts", 0x04, struct.Struct("<Q")), ("hold_ms", 0x08, struct.Struct("<I")))
+
+# Snapshot de system/metrics (runtime_metrics_format_json): operações com contagem na
+# janela e tarefas do FreeRTOS de cada firmware
+METRICS_BOUNDS_US = (50, 200, 1000, 5000, 20000, 100000, 500000)
+LOCAL_METRICS_OPS = ("sensor_read", "publish")
+LOCAL_METRICS_TASKS = ("sampling_task", "light_control", "mqtt_task", "tiT", "wifi", "IDLE0", "IDLE1")
+CLOUD_METRICS_OPS = ("publish", "nvs_commit", "gpio_command")
+CLOUD_METRICS_TASKS = ("heartbeat_task", "mqtt_task", "tiT", "wifi", "IDLE0", "IDLE1")
+
+# --- Sonda de Latência ---
+# Cada leitura carrega um código derivado do seu número de sequência em um campo
+# que o gateway grava sem alterar (respeitando as casas decimais do firmware).
+# O InfluxDB falso decodifica o código e o casa com o instante de publicação.
+
+PROBE_CODES = {"bmp280": 1000, "dht11": 500, "mq135": 4096, "ldr": 4096}
+
+def probe_reading(sensor, seq):
+    """Valores da leitura número seq, na ordem dos campos do firmware."""
+    code = seq % PROBE_CODES[sensor]
+    if sensor == "bmp280":
+        return code, (20 + code / 100, 1013.25, 1015.87)
+    if sensor == "dht11":
+        return code, (25.0, 40 + code / 10)
+    if sensor == "mq135":
+        return code, (code, 412.5)
+    return code, (code,)
+
+def probe_code(measurement, fields):
+    try:
+        if measurement == "bmp280":
+            return round((fields["temperature"] - 20) * 100)
+        if measurement == "dht11":
+            return round((fields["humidity"] - 40) * 10)
+        if measurement == "mq135":
+            return int(fields["adc_raw"])
+        if measurement == "ldr":
+            return int(fields["ldr_raw"])
+    except (KeyError, TypeError, ValueError):
+        pass
+    return None
+
+def format_json(sensor, values, meta=None):
+    """JSON do firmware, com os metadados no fim (telemetry_json_append_meta):
+    meta é um dict com seq, ts e, quando houver, age_ms e hold_ms."""
+    if sensor == "bmp280":
+        body = '{"temperature":%.2f,"pressure":%.2f,"pressure_sea_level":%.2f' % values
+    elif sensor == "dht11":
+        body = '{"temperature":%.1f,"humidity":%.1f' % values
+    elif sensor == "mq135":
+        body = '{"adc_raw":%d,"ppm":%.2f' % values
+    else:
+        body = '{"ldr_raw":%d' % values
+    for name, _, _ in BINARY_META:
+        if meta and name in meta:
+            body += ',"%s":%d' % (name, meta[name])
+    return body + "}"
+
+def encode_binary(sensor, values, meta=None):
+    """Registro binário v2: [2][sensor][flags][metadados presentes][campos]."""
+    flags, packed = 0, b""
+    for name, flag, layout in BINARY_META:
+        if meta and name in meta:
+            flags |= flag
+            packed += layout.pack(meta[name])
+    return bytes([BINARY_CODEC_VERSION_META, BINARY_IDS[sensor], flags]) + packed + BINARY_LAYOUTS[sensor].pack(*values)
+
+def format_metrics(uptime_s, ops, tasks, radio=None):
+    """Snapshot de system/metrics; ops: nome -> contagem na janela."""
+    parts = ['"up":%d,"heap":[%d,%d]' % (uptime_s, random.randint(150000, 180000), random.randint(120000, 150000)),
+             '"bounds_us":[%s]' % ",".join(str(b) for b in METRICS_BOUNDS_US)]
+    op_items = []
+    for name, count in ops.items():
+        if count:   # Operação sem contagem na janela fica fora, como no firmware
+            buckets = [0] * (len(METRICS_BOUNDS_US) + 1)
+            buckets[2] = count
+            op_items.append('"%s":[%d,0,%d,%d,[%s]]' % (name, count, random.randint(200, 900), random.randint(900, 5000),
+                                                        ",".join(map(str, buckets))))
+    parts.append('"ops":{%s}' % ",".join(op_items))
+    parts.append('"tasks":{%s}' % ",".join('"%s":[%d,%d]' % (task, random.randint(0, 50), random.randint(400, 2000))
+                                          for task in tasks))
+    if radio is not None:
+        parts.append('"radio":[%d,%d]' % radio)
+    return "{" + ",".join(parts) + "}"
+
+def metrics_points(ops, tasks):
+    """Pontos device_metrics que o gateway grava de um snapshot: o do dispositivo,
+    um por operação com contagem e um por tarefa."""
+    return 1 + sum(1 for count in ops.values() if count) + len(tasks)
+
+def format_health(reads):
+    return "{" + ",".join('"%s":{"reads":%d,"failures":0,"streak":0,"age_ms":%d}' % (sensor, count, random.randint(0, 2000))
+                          for sensor, count in reads.items()) + "}"
+
+
+# --- Contabilidade ---
+class FleetTracker:
+    """Conta o que foi publicado e casa as linhas que chegam ao InfluxDB falso."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.published = collections.Counter()      # measurement -> pontos esperados
+        self.messages = 0
+        self.bytes = 0
+        self.pending = {}                           # (device, measurement, código) -> deque de instantes
+        self.latencies = []
+        self.unmatched = 0
+
+    def record_message(self, size):
+        self.messages += 1
+        self.bytes += size
+
+    def record_point(self, device_id, measurement, code=None, sent_at=None, count=1):
+        with self.lock:
+            self.published[measurement] += count
+            if code is not None:
+                self.pending.setdefault((device_id, measurement, code), collections.deque()).append(sent_at)
+
+    def on_line(self, measurement, tags, fields, arrived_at):
+        code = probe_code(measurement, fields)
+        if code is None:
+            return
+        with self.lock:
+            sent = self.pending.get((tags.get("device_id"), measurement, code))
+            if sent:
+                self.latencies.append(arrived_at - sent.popleft())
+            else:
+                self.unmatched += 1
+
+
+# --- Dispositivos Simulados ---
+class LocalDevice:
+    """esp32_mqtt_local: sensores, heartbeat e métricas em um único escalonador, como sampling_task."""
+
+    def __init__(self, device_id, broker, tracker, speedup=1.0, encoding="json", batch=False,
+                 publish_policy=True, low_power=False):
+        self.device_id = device_id
+        self.tracker = tracker
+        self.speedup = speedup
+        self.encoding = encoding
+        self.batch = batch and not low_power     # No baixo consumo a fila sai leitura a leitura, sem lote
+        self.publish_policy = publish_policy
+        self.low_power = low_power
+        self.keepalive = LOW_POWER_KEEPALIVE_S if low_power else LOCAL_KEEPALIVE_S
+        self.client = MqttPublisher(device_id, *broker, keepalive=self.keepalive,
+                                    will=(f"{device_id}/status", "offline", 1, True))
+        self.seq = collections.Counter()          # Leituras por sensor: código da sonda
+        self.next_seq = 0                         # "seq" do firmware: um contador do dispositivo
+        self.last_sent = {}                       # sensor -> (valores, instante) da última leitura publicada
+        self.reads = collections.Counter()        # Leituras por sensor, para o JSON de saúde
+        self.ops = collections.Counter()          # Contagens da janela de métricas
+        self.queue = []                           # Baixo consumo: (sensor, código, valores, meta, instante)
+        self.pending = set()                      # Baixo consumo: heartbeat e métricas para a próxima rajada
+        self.bursts = 0
+        self.batch_items = []
+        self.batch_started = None
+        self.started = None
+
+    def _publish(self, topic, payload, qos=0, retain=False):
+        self.client.publish(topic, payload, qos, retain)
+        self.tracker.record_message(len(payload))
+        self.ops["publish"] += 1
+
+    def _flush_batch(self):
+        if not self.batch_items:
+            return
+        if self.encoding == "binary":
+            self._publish(f"{self.device_id}/sensor/batch/bin", b"".join(self.batch_items))
+        else:
+            self._publish(f"{self.device_id}/sensor/batch", "[" + ",".join(self.batch_items) + "]")
+        self.batch_items, self.batch_started = [], None
+
+    def _should_publish(self, sensor, values, now):
+        # publish_policy_should_publish: publica se algum campo passou da banda morta
+        # ou se o sensor ficou SENSOR_MAX_SILENCE_MS em silêncio
+        deadbands = PUBLISH_DEADBANDS.get(sensor) if self.publish_policy else None
+        if deadbands is None:
+            return True
+        last = self.last_sent.get(sensor)
+        if (last is None or now - last[1] >= SENSOR_MAX_SILENCE_MS / 1000 / self.speedup
+                or any(not abs(value - previous) <= deadband for value, previous, deadband in zip(values, last[0], deadbands))):
+            self.last_sent[sensor] = (values, now)
+            return True
+        return False
+
+    def _send(self, sensor, code, values, meta, now):
+        self.tracker.record_point(self.device_id, sensor, code, time.monotonic())
+        if self.batch:
+            if self.encoding == "binary":
+                self.batch_items.append(encode_binary(sensor, values, meta))
+            else:
+                self.batch_items.append('{"sensor":"%s",%s' % (sensor, format_json(sensor, values, meta)[1:]))
+            self.batch_started = self.batch_started or now
+            if len(self.batch_items) >= BATCH_MAX_READINGS:
+                self._flush_batch()
+        elif self.encoding == "binary":
+            self._publish(f"{self.device_id}/sensor/{sensor}/bin", encode_binary(sensor, values, meta))
+        else:
+            self._publish(f"{self.device_id}/sensor/{sensor}", format_json(sensor, values, meta))
+
+    def _heartbeat(self):
+        self._publish(f"{self.device_id}/status", "heartbeat")
+        self.tracker.record_point(self.device_id, "device_status")
+        self._publish(f"{self.device_id}/status/sensors", format_health(self.reads))   # O gateway não grava
+
+    def _metrics(self, now):
+        radio = (random.randint(20, 80), self.bursts) if self.low_power else None
+        uptime_s = int((now - self.started) * self.speedup)
+        ops, self.ops = self.ops, collections.Counter()
+        self._publish(f"{self.device_id}/system/metrics", format_metrics(uptime_s, ops, LOCAL_METRICS_TASKS, radio))
+        self.tracker.record_point(self.device_id, "device_metrics", count=metrics_points(ops, LOCAL_METRICS_TASKS))
+        self.bursts = 0
+
+    def _burst(self, now):
+        # publish_burst: fila com age_ms, depois heartbeat e métricas vencidos
+        self.bursts += 1
+        for sensor, code, values, meta, sampled_at in self.queue:
+            meta["age_ms"] = round((now - sampled_at) * 1000)
+            self._send(sensor, code, values, meta, now)
+        self.queue = []
+        if "heartbeat" in self.pending:
+            self._heartbeat()
+        if "metrics" in self.pending:
+            self._metrics(now)
+        self.pending.clear()
+
+    def _sample(self, sensor, now):
+        if sensor == "burst":
+            self._burst(now)
+            return
+        if sensor in ("heartbeat", "metrics"):
+            if self.low_power:
+                self.pending.add(sensor)
+            elif sensor == "heartbeat":
+                self._heartbeat()
+            else:
+                self._metrics(now)
+            return
+        code, values = probe_reading(sensor, self.seq[sensor])
+        self.seq[sensor] += 1
+        self.reads[sensor] += 1
+        self.ops["sensor_read"] += 1
+        if not self._should_publish(sensor, values, now):
+            return      # Leitura dentro da banda morta não consome seq
+        meta = {"seq": self.next_seq, "ts": int(time.time() * 1000)}
+        self.next_seq += 1
+        if self.publish_policy and sensor in PUBLISH_DEADBANDS:
+            meta["hold_ms"] = round(SENSOR_MAX_SILENCE_MS / self.speedup)
+        if self.low_power:
+            self.queue.append((sensor, code, values, meta, now))
+        else:
+            self._send(sensor, code, values, meta, now)
+
+    async def run(self, stop):
+        await self.client.connect()
+        self._publish(f"{self.device_id}/status", "online", qos=1)
+        self.tracker.record_point(self.device_id, "device_status")
+        start = self.started = time.monotonic()
+        offset = random.uniform(0, 2.0 / self.speedup)     # Dispositivos não ligam todos no mesmo instante
+        timing = dict(LOCAL_SENSOR_TIMING_MS, metrics=(METRICS_INTERVAL_MS, METRICS_PHASE_MS))
+        if self.low_power:
+            timing["burst"] = (LOW_POWER_BURST_PERIOD_MS, LOW_POWER_BURST_PHASE_MS)
+        queue = [(start + offset + phase / 1000 / self.speedup, index, sensor, period / 1000 / self.speedup)
+                 for index, (sensor, (period, phase)) in enumerate(timing.items())]
+        heapq.heapify(queue)
+        last_activity = start
+        while not stop.is_set():
+            now = time.monotonic()
+            while queue[0][0] <= now:
+                due, index, sensor, period = heapq.heappop(queue)
+                self._sample(sensor, now)
+                if not self.low_power or sensor == "burst":
+                    last_activity = now
+                heapq.heappush(queue, (max(due + period, now), index, sensor, period))
+            if self.batch_started is not None and now - self.batch_started >= BATCH_WINDOW_MS / 1000 / self.speedup:
+                self._flush_batch()
+            if now - last_activity > self.keepalive / 2:
+                await self.client.ping()
+                last_activity = now
+            await self.client.drain()
+            wake = queue[0][0]
+            if self.batch_started is not None:
+                wake = min(wake, self.batch_started + BATCH_WINDOW_MS / 1000 / self.speedup)
+            try:
+                await asyncio.wait_for(stop.wait(), max(wake - time.monotonic(), 0))
+            except asyncio.TimeoutError:
+                pass
+        self._flush_batch()
+        await self.client.drain()
+        await self.client.disconnect()
+
+
+class CloudDevice:
+    """esp32_mqtt_cloud no lado local: heartbeat, métricas e estados de GPIO retidos,
+    por pino (também após um comando em lote, seguido do aviso gpio/bulk/state)."""
+
+    def __init__(self, device_id, broker, tracker, speedup=1.0, gpio_rate=0.2, bulk_share=0.2):
+        self.device_id = device_id
+        self.tracker = tracker
+        self.speedup = speedup
+        self.gpio_period = 1.0 / gpio_rate if gpio_rate > 0 else None
+        self.bulk_share = bulk_share
+        self.client = MqttPublisher(device_id, *broker)
+        self.states = {pin: False for pin in CLOUD_GPIO_PINS}
+        self.ops = collections.Counter()
+
+    def _publish(self, topic, payload, qos=0, retain=False):
+        self.client.publish(topic, payload, qos, retain)
+        self.tracker.record_message(len(payload))
+        self.ops["publish"] += 1
+
+    def _toggle(self):
+        self.ops["gpio_command"] += 1
+        self.ops["nvs_commit"] += 1
+        if random.random() < self.bulk_share:
+            # Comando em lote: o estado retido de cada pino e um aviso {"mask", "value"}
+            # não retido (bit n = GPIO n), que o gateway não grava
+            mask = value = 0
+            for pin in random.sample(CLOUD_GPIO_PINS, random.randint(2, 6)):
+                self.states[pin] = random.random() < 0.5
+                mask |= 1 << pin
+                value |= self.states[pin] << pin
+                self._publish(f"{self.device_id}/gpio/{pin}/state", "ON" if self.states[pin] else "OFF", qos=1, retain=True)
+                self.tracker.record_point(self.device_id, "gpio_state")
+            self._publish(f"{self.device_id}/gpio/bulk/state", json.dumps({"mask": mask, "value": value}), qos=1)
+            return
+        pin = random.choice(CLOUD_GPIO_PINS)
+        self.states[pin] = not self.states[pin]
+        self._publish(f"{self.device_id}/gpio/{pin}/state", "ON" if self.states[pin] else "OFF", qos=1, retain=True)
+        self.tracker.record_point(self.device_id, "gpio_state")
+
+    async def run(self, stop):
+        await self.client.connect()
+        for pin in CLOUD_GPIO_PINS:    # Estado restaurado da NVS é publicado no boot
+            self._publish(f"{self.device_id}/gpio/{pin}/state", "OFF", qos=1, retain=True)
+            self.tracker.record_point(self.device_id, "gpio_state")
+        start = time.monotonic()
+        heartbeat_period = CLOUD_HEARTBEAT_MS / 1000 / self.speedup
+        metrics_period = METRICS_INTERVAL_MS / 1000 / self.speedup
+        next_heartbeat = start + heartbeat_period
+        next_metrics = start + metrics_period
+        next_toggle = start + (self.gpio_period or 0) * random.random()
+        while not stop.is_set():
+            now = time.monotonic()
+            if now >= next_heartbeat:
+                self._publish(f"{self.device_id}/system/status", "heartbeat")
+                self.tracker.record_point(self.device_id, "device_status")
+                next_heartbeat += heartbeat_period
+            if now >= next_metrics:
+                ops, self.ops = self.ops, collections.Counter()
+                self._publish(f"{self.device_id}/system/metrics",
+                              format_metrics(int((now - start) * self.speedup), ops, CLOUD_METRICS_TASKS))
+                self.tracker.record_point(self.device_id, "device_metrics", count=metrics_points(ops, CLOUD_METRICS_TASKS))
+                next_metrics += metrics_period
+            if self.gpio_period and now >= next_toggle:
+                self._toggle()
+                next_toggle += self.gpio_period
+            await self.client.drain()
+            wake = min(next_heartbeat, next_metrics, next_toggle if self.gpio_period else next_heartbeat)
+            try:
+                await asyncio.wait_for(stop.wait(), max(wake - time.monotonic(), 0))
+            except asyncio.TimeoutError:
+                pass
+        await self.client.disconnect()
+
+
+async def run_fleet(broker, tracker, duration, local_devices, cloud_devices, speedup=1.0,
+                    encoding="json", batch=False, gpio_rate=0.2, connect_rate=200,
+                    publish_policy=True, low_power=False, bulk_share=0.2):
+    """Conecta os dispositivos (no máximo connect_rate por segundo) e publica por duration segundos."""
+    stop = asyncio.Event()
+    devices = [LocalDevice(f"sim_local_{i:04d}", broker, tracker, speedup, encoding, batch, publish_policy, low_power)
+               for i in range(local_devices)]
+    devices += [CloudDevice(f"sim_cloud_{i:04d}", broker, tracker, speedup, gpio_rate, bulk_share)
+                for i in range(cloud_devices)]
+    tasks = []
+    for index, device in enumerate(devices):
+        tasks.append(asyncio.create_task(device.run(stop)))
+        if connect_rate and (index + 1) % connect_rate == 0:
+            await asyncio.sleep(1)
+    await asyncio.sleep(duration)
+    stop.set()
+    results = await asyncio.gather(*tasks, return_exceptions=True)
+    failures = [r for r in results if isinstance(r, Exception)]
+    for failure in failures[:5]:
+        logging.error(f"Dispositivo simulado falhou: {failure!r}")
+    return len(devices) - len(failures)
+
+def add_fleet_arguments(parser):
+    parser.add_argument("--devices", type=int, default=10, help="Dispositivos esp32_mqtt_local simulados")
+    parser.add_argument("--cloud-devices", type=int, default=1, help="Dispositivos esp32_mqtt_cloud simulados")
+    parser.add_argument("--speedup", type=float, default=1.0, help="Divide os períodos do firmware (10 = 10x mais leituras)")
+    parser.add_argument("--encoding", choices=("json", "binary"), default="json")
+    parser.add_argument("--batch", action="store_true", help="Simula MQTT_BATCH_MODE_ENABLED")
+    parser.add_argument("--gpio-rate", type=float, default=0.2, help="Mudanças de GPIO por segundo em cada dispositivo de nuvem")
+    parser.add_argument("--bulk-share", type=float, default=0.2, help="Fração das mudanças de GPIO feitas por comando em lote")
+    parser.add_argument("--publish-all", action="store_true", help="Simula PUBLISH_POLICY_ENABLED 0 (sem banda morta nem hold_ms)")
+    parser.add_argument("--low-power", action="store_true", help="Simula LOW_POWER_MODE_ENABLED (rajadas com age_ms)")
+    parser.add_argument("--duration", type=float, default=60, help="Segundos de publicação")
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Frota simulada publicando em um broker existente (sem medir latência).")
+    parser.add_argument("--broker", default="127.0.0.1:1883")
+    add_fleet_arguments(parser)
+    args = parser.parse_args()
+    logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(levelname)s - %(message)s')
+    host, port = args.broker.rsplit(":", 1)
+    tracker = FleetTracker()
+    connected = asyncio.run(run_fleet((host, int(port)), tracker, args.duration, args.devices, args.cloud_devices,
+                                      args.speedup, args.encoding, args.batch, args.gpio_rate,
+                                      publish_policy=not args.publish_all, low_power=args.low_power,
+                                      bulk_share=args.bulk_share))
+    logging.info(f"{connected} dispositivos, {tracker.messages} mensagens, {tracker.bytes} bytes, "
+                 f"pontos esperados: {json.dumps(dict(tracker.published))}")
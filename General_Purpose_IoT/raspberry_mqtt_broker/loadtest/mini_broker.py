@@ -0,0 +1,128 @@
+import argparse
+import asyncio
+import logging
+import struct
+
+import mqtt_wire as wire
+
+# --- Broker Substituto ---
+# Usado pelo teste de carga quando o Mosquitto não está instalado. Implementa o
+# subconjunto do MQTT 3.1.1 usado pelo sistema: sessões limpas, curingas + e #,
+# mensagens retidas, last will e entrega aos assinantes sempre em QoS 0. Não
+# substitui o Mosquitto em produção, e os números medidos com ele servem para
+# comparar versões do gateway, não para dimensionar o broker.
+
+class Session:
+    def __init__(self, writer):
+        self.writer = writer
+        self.client_id = None
+        self.subscriptions = set()
+        self.will = None
+
+
+class MiniBroker:
+    def __init__(self):
+        self.sessions = set()
+        self.retained = {}
+        self.stats = {"received": 0, "delivered": 0}
+
+    def route(self, topic, payload, retain):
+        self.stats["received"] += 1
+        if retain:
+            if payload:
+                self.retained[topic] = payload
+            else:
+                self.retained.pop(topic, None)
+        data = wire.publish_packet(topic, payload)
+        for session in self.sessions:
+            if any(wire.topic_matches(pattern, topic) for pattern in session.subscriptions):
+                session.writer.write(data)
+                self.stats["delivered"] += 1
+
+    def _parse_connect(self, session, body):
+        _, offset = wire.read_string(body, 0)           # "MQTT"
+        flags = body[offset + 1]
+        offset += 4                                      # nível, flags, keepalive
+        client_id, offset = wire.read_string(body, offset)
+        session.client_id = client_id.decode("utf-8", "replace")
+        if flags & 0x04:
+            will_topic, offset = wire.read_string(body, offset)
+            will_message, offset = wire.read_string(body, offset)
+            session.will = (will_topic.decode("utf-8"), will_message, bool(flags & 0x20))
+
+    def _subscribe(self, session, body):
+        (packet_id,) = struct.unpack_from("!H", body, 0)
+        offset, granted, patterns = 2, [], []
+        while offset < len(body):
+            pattern, offset = wire.read_string(body, offset)
+            offset += 1
+            patterns.append(pattern.decode("utf-8"))
+            granted.append(0)
+        session.subscriptions.update(patterns)
+        session.writer.write(wire.packet(wire.SUBACK, 0, struct.pack("!H", packet_id) + bytes(granted)))
+        for topic, payload in self.retained.items():
+            if any(wire.topic_matches(pattern, topic) for pattern in patterns):
+                session.writer.write(wire.publish_packet(topic, payload, retain=True))
+
+    def _unsubscribe(self, session, body):
+        (packet_id,) = struct.unpack_from("!H", body, 0)
+        offset = 2
+        while offset < len(body):
+            pattern, offset = wire.read_string(body, offset)
+            session.subscriptions.discard(pattern.decode("utf-8"))
+        session.writer.write(wire.packet(wire.UNSUBACK, 0, struct.pack("!H", packet_id)))
+
+    async def handle(self, reader, writer):
+        session = Session(writer)
+        clean_exit = False
+        try:
+            packet_type, _, body = await wire.read_packet(reader)
+            if packet_type != wire.CONNECT:
+                return
+            self._parse_connect(session, body)
+            writer.write(wire.packet(wire.CONNACK, 0, b"\x00\x00"))
+            self.sessions.add(session)
+            while True:
+                packet_type, flags, body = await wire.read_packet(reader)
+                if packet_type == wire.PUBLISH:
+                    topic, payload, qos, retain, packet_id = wire.parse_publish(flags, body)
+                    if qos:
+                        writer.write(wire.packet(wire.PUBACK, 0, struct.pack("!H", packet_id)))
+                    self.route(topic, payload, retain)
+                elif packet_type == wire.SUBSCRIBE:
+                    self._subscribe(session, body)
+                elif packet_type == wire.UNSUBSCRIBE:
+                    self._unsubscribe(session, body)
+                elif packet_type == wire.PINGREQ:
+                    writer.write(wire.packet(wire.PINGRESP, 0, b""))
+                elif packet_type == wire.DISCONNECT:
+                    clean_exit = True
+                    break
+                if writer.transport.get_write_buffer_size() > 1 << 20:
+                    await writer.drain()
+        except (asyncio.IncompleteReadError, ConnectionError):
+            pass
+        finally:
+            self.sessions.discard(session)
+            if session.will and not clean_exit:
+                self.route(*session.will)
+            writer.close()
+
+
+async def serve(host, port):
+    broker = MiniBroker()
+    server = await asyncio.start_server(broker.handle, host, port)
+    logging.info(f"Broker substituto escutando em {host}:{port}")
+    async with server:
+        await server.serve_forever()
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Broker MQTT mínimo para o teste de carga.")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=1883)
+    args = parser.parse_args()
+    logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(levelname)s - %(message)s')
+    try:
+        asyncio.run(serve(args.host, args.port))
+    except KeyboardInterrupt:
+        pass
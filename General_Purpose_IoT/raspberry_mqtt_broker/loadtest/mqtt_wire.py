@@ -0,0 +1,148 @@
+import asyncio
+import struct
+
+# --- Pacotes MQTT 3.1.1 ---
+# Só o necessário para o broker substituto e para os dispositivos simulados:
+# CONNECT, PUBLISH (QoS 0/1), SUBSCRIBE, PING e DISCONNECT.
+
+CONNECT, CONNACK, PUBLISH, PUBACK = 1, 2, 3, 4
+SUBSCRIBE, SUBACK, UNSUBSCRIBE, UNSUBACK = 8, 9, 10, 11
+PINGREQ, PINGRESP, DISCONNECT = 12, 13, 14
+
+def encode_length(length):
+    out = bytearray()
+    while True:
+        byte, length = length % 128, length // 128
+        out.append(byte | (0x80 if length else 0))
+        if not length:
+            return bytes(out)
+
+def encode_string(value):
+    data = value.encode("utf-8") if isinstance(value, str) else value
+    return struct.pack("!H", len(data)) + data
+
+def packet(packet_type, flags, body):
+    return bytes([(packet_type << 4) | flags]) + encode_length(len(body)) + body
+
+async def read_packet(reader):
+    """Lê um pacote e retorna (tipo, flags, corpo); levanta IncompleteReadError no fim da conexão."""
+    header = (await reader.readexactly(1))[0]
+    length, multiplier = 0, 1
+    while True:
+        byte = (await reader.readexactly(1))[0]
+        length += (byte & 0x7F) * multiplier
+        if not byte & 0x80:
+            break
+        multiplier *= 128
+    body = await reader.readexactly(length) if length else b""
+    return header >> 4, header & 0x0F, body
+
+def read_string(body, offset):
+    (length,) = struct.unpack_from("!H", body, offset)
+    offset += 2
+    return body[offset:offset + length], offset + length
+
+def connect_packet(client_id, keepalive=60, username=None, password=None, will=None, clean_session=True):
+    flags = 0x02 if clean_session else 0
+    payload = encode_string(client_id)
+    if will:
+        topic, message, qos, retain = will
+        flags |= 0x04 | (qos << 3) | (0x20 if retain else 0)
+        payload += encode_string(topic) + encode_string(message)
+    if username is not None:
+        flags |= 0x80
+        payload += encode_string(username)
+        if password is not None:
+            flags |= 0x40
+            payload += encode_string(password)
+    return packet(CONNECT, 0, encode_string("MQTT") + bytes([4, flags]) + struct.pack("!H", keepalive) + payload)
+
+def publish_packet(topic, payload, qos=0, retain=False, packet_id=None):
+    if isinstance(payload, str):
+        payload = payload.encode("utf-8")
+    body = encode_string(topic)
+    if qos:
+        body += struct.pack("!H", packet_id)
+    return packet(PUBLISH, (qos << 1) | (1 if retain else 0), body + payload)
+
+def parse_publish(flags, body):
+    """Retorna (tópico, payload, qos, retain, packet_id)."""
+    qos = (flags >> 1) & 0x03
+    topic, offset = read_string(body, 0)
+    packet_id = None
+    if qos:
+        (packet_id,) = struct.unpack_from("!H", body, offset)
+        offset += 2
+    return topic.decode("utf-8"), body[offset:], qos, bool(flags & 0x01), packet_id
+
+def topic_matches(pattern, topic):
+    pattern_levels, topic_levels = pattern.split("/"), topic.split("/")
+    for index, level in enumerate(pattern_levels):
+        if level == "#":
+            return True
+        if index >= len(topic_levels) or (level != "+" and level != topic_levels[index]):
+            return False
+    return len(pattern_levels) == len(topic_levels)
+
+
+# --- Cliente Mínimo (somente publicação) ---
+class MqttPublisher:
+    """Cliente assíncrono que só publica, suficiente para simular milhares de dispositivos.
+
+    Mensagens QoS 1 são enviadas sem esperar o PUBACK (como o esp_mqtt_client
+    faz com a outbox); os PUBACKs são apenas contados.
+    """
+
+    def __init__(self, client_id, host, port, username=None, password=None, will=None, keepalive=60):
+        self.client_id = client_id
+        self.host, self.port = host, port
+        self.username, self.password = username, password
+        self.will = will
+        self.keepalive = keepalive
+        self.reader = self.writer = None
+        self._next_id = 0
+        self.acks = 0
+        self._reader_task = None
+
+    async def connect(self):
+        self.reader, self.writer = await asyncio.open_connection(self.host, self.port)
+        self.writer.write(connect_packet(self.client_id, self.keepalive, self.username, self.password, self.will))
+        packet_type, _, body = await read_packet(self.reader)
+        if packet_type != CONNACK or body[1] != 0:
+            raise ConnectionError(f"{self.client_id}: CONNACK recusado ({body!r})")
+        self._reader_task = asyncio.create_task(self._read_loop())
+
+    async def _read_loop(self):
+        try:
+            while True:
+                packet_type, _, _ = await read_packet(self.reader)
+                if packet_type == PUBACK:
+                    self.acks += 1
+        except (asyncio.IncompleteReadError, ConnectionError, asyncio.CancelledError):
+            pass
+
+    def publish(self, topic, payload, qos=0, retain=False):
+        packet_id = None
+        if qos:
+            self._next_id = self._next_id % 65535 + 1
+            packet_id = self._next_id
+        self.writer.write(publish_packet(topic, payload, qos, retain, packet_id))
+
+    async def ping(self):
+        self.writer.write(packet(PINGREQ, 0, b""))
+        await self.writer.drain()
+
+    async def drain(self):
+        await self.writer.drain()
+
+    async def disconnect(self):
+        if self.writer is None:
+            return
+        try:
+            self.writer.write(packet(DISCONNECT, 0, b""))
+            await self.writer.drain()
+        except ConnectionError:
+            pass
+        if self._reader_task:
+            self._reader_task.cancel()
+        self.writer.close()
@@ -0,0 +1,237 @@
+import argparse
+import asyncio
+import json
+import logging
+import os
+import shutil
+import signal
+import socket
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+from fake_influx import FakeInfluxSink
+from fleet import FleetTracker, add_fleet_arguments, run_fleet
+
+# --- Teste de Carga de Ponta a Ponta ---
+# Sobe um broker (Mosquitto, se instalado, ou o broker substituto), um InfluxDB
+# falso e o mqtt_to_influx.py real como subprocesso; simula a frota e relata
+# vazão, latência dispositivo -> InfluxDB, pontos perdidos e CPU/memória do
+# gateway.
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+GATEWAY_SCRIPT = os.path.join(os.path.dirname(HERE), "mqtt_to_influx.py")
+
+def free_port():
+    with socket.socket() as s:
+        s.bind(("127.0.0.1", 0))
+        return s.getsockname()[1]
+
+def wait_for_port(port, timeout=10):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        try:
+            with socket.create_connection(("127.0.0.1", port), timeout=0.5):
+                return True
+        except OSError:
+            time.sleep(0.1)
+    return False
+
+def start_broker(args, workdir):
+    """Retorna (host, porta, processo ou None, descrição)."""
+    if args.broker:
+        host, port = args.broker.rsplit(":", 1)
+        return host, int(port), None, f"externo ({args.broker})"
+    port = free_port()
+    mosquitto = shutil.which("mosquitto")
+    if mosquitto and not args.embedded_broker:
+        config = os.path.join(workdir, "mosquitto.conf")
+        with open(config, "w") as f:
+            f.write(f"listener {port} 127.0.0.1\nallow_anonymous true\nmax_queued_messages 100000\n")
+        process = subprocess.Popen([mosquitto, "-c", config], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        description = "mosquitto"
+    else:
+        process = subprocess.Popen([sys.executable, os.path.join(HERE, "mini_broker.py"), "--port", str(port)],
+                                   stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        description = "broker substituto (mini_broker.py)"
+    if not wait_for_port(port):
+        process.kill()
+        raise RuntimeError(f"Broker não respondeu na porta {port}")
+    return "127.0.0.1", port, process, description
+
+def gateway_environment(args, broker_host, broker_port, influx_port, workdir):
+    env = dict(os.environ)
+    env.update({
+        "ACTIVE_NETWORK": "LOADTEST",
+        "LOADTEST_MQTT_BROKER_HOST": broker_host,
+        "MQTT_BROKER_PORT": str(broker_port),
+        "MQTT_USERNAME": "", "MQTT_PASSWORD": "",
+        "MQTT_TOPICS_JSON": json.dumps(["+/sensor/#", "+/status", "+/system/status", "+/gpio/+/state"]),
+        "CLOUD_MQTT_BROKER_HOST": broker_host,
+        "CLOUD_MQTT_BROKER_PORT": str(broker_port),
+        "CLOUD_MQTT_USERNAME": "", "CLOUD_MQTT_PASSWORD": "",
+        "CLOUD_MQTT_TLS": "false",
+        "LOADTEST_INFLUXDB_HOST": "127.0.0.1",
+        "INFLUXDB_PORT": str(influx_port),
+        "INFLUXDB_USERNAME": "", "INFLUXDB_PASSWORD": "",
+        "INFLUXDB_SPILL_FILE": os.path.join(workdir, "influx_spill.lp"),
+        "PYTHONUNBUFFERED": "1",
+    })
+    return env
+
+
+# --- Recursos do Gateway (Linux, via /proc) ---
+class ProcessSampler:
+    def __init__(self, pid, interval=1.0):
+        self.pid = pid
+        self.interval = interval
+        self.samples = []            # (cpu %, RSS em KiB)
+        self._stop = threading.Event()
+        self._thread = threading.Thread(target=self._run, name="ProcessSampler", daemon=True)
+        self.clock_ticks = os.sysconf("SC_CLK_TCK") if hasattr(os, "sysconf") else 100
+
+    def _cpu_ticks(self):
+        with open(f"/proc/{self.pid}/stat") as f:
+            fields = f.read().rsplit(")", 1)[1].split()
+        return int(fields[11]) + int(fields[12])    # utime + stime
+
+    def _rss_kib(self):
+        with open(f"/proc/{self.pid}/status") as f:
+            for line in f:
+                if line.startswith("VmRSS:"):
+                    return int(line.split()[1])
+        return 0
+
+    def _run(self):
+        try:
+            last_ticks, last_time = self._cpu_ticks(), time.monotonic()
+            while not self._stop.wait(self.interval):
+                ticks, now = self._cpu_ticks(), time.monotonic()
+                cpu = 100.0 * (ticks - last_ticks) / self.clock_ticks / (now - last_time)
+                self.samples.append((cpu, self._rss_kib()))
+                last_ticks, last_time = ticks, now
+        except (OSError, IndexError, ValueError):
+            pass    # Processo terminou ou /proc indisponível
+
+    def start(self):
+        if os.path.exists(f"/proc/{self.pid}/stat"):
+            self._thread.start()
+
+    def stop(self):
+        self._stop.set()
+
+
+def percentile(values, fraction):
+    if not values:
+        return None
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+def build_report(args, broker_description, tracker, sink, sampler, publish_seconds, connected, gateway_tail):
+    received = sink.snapshot()
+    expected = dict(tracker.published)
+    latencies_ms = [latency * 1000 for latency in tracker.latencies]
+    cpu = [sample[0] for sample in sampler.samples]
+    rss = [sample[1] for sample in sampler.samples]
+    active = (sink.last_line_at - sink.first_line_at) if sink.first_line_at and sink.last_line_at else 0
+    return {
+        "config": {"devices": args.devices, "cloud_devices": args.cloud_devices, "speedup": args.speedup,
+                   "encoding": args.encoding, "batch": args.batch, "gpio_rate": args.gpio_rate,
+                   "bulk_share": args.bulk_share, "publish_all": args.publish_all, "low_power": args.low_power,
+                   "duration_s": args.duration, "broker": broker_description, "sink_write_delay_s": args.sink_write_delay},
+        "devices_connected": connected,
+        "messages_published": tracker.messages,
+        "bytes_published": tracker.bytes,
+        "publish_rate_msgs_s": round(tracker.messages / publish_seconds, 1) if publish_seconds else None,
+        "points_expected": sum(expected.values()),
+        "points_received": received["lines"],
+        "points_dropped": max(sum(expected.values()) - received["lines"], 0),
+        "drops_by_measurement": {m: expected[m] - received["by_measurement"].get(m, 0)
+                                 for m in expected if expected[m] != received["by_measurement"].get(m, 0)},
+        "ingest_rate_points_s": round(received["lines"] / active, 1) if active else None,
+        "influx_write_requests": received["write_requests"],
+        "latency_ms": {"samples": len(latencies_ms), "unmatched": tracker.unmatched,
+                       "p50": percentile(latencies_ms, 0.50), "p90": percentile(latencies_ms, 0.90),
+                       "p99": percentile(latencies_ms, 0.99), "max": max(latencies_ms) if latencies_ms else None},
+        "gateway_cpu_percent": {"mean": round(sum(cpu) / len(cpu), 1) if cpu else None, "max": round(max(cpu), 1) if cpu else None},
+        "gateway_rss_kib": {"max": max(rss) if rss else None, "last": rss[-1] if rss else None},
+        "gateway_log_tail": gateway_tail,
+    }
+
+def print_report(report):
+    latency = report["latency_ms"]
+    fmt = lambda value: "-" if value is None else f"{value:.1f}"
+    print("\n=== Teste de carga do gateway ===")
+    print(f"Configuração:        {json.dumps(report['config'])}")
+    print(f"Dispositivos:        {report['devices_connected']} conectados")
+    print(f"Publicado:           {report['messages_published']} mensagens ({report['publish_rate_msgs_s']} msg/s), "
+          f"{report['points_expected']} pontos esperados")
+    print(f"Gravado no InfluxDB: {report['points_received']} pontos em {report['influx_write_requests']} requisições "
+          f"({report['ingest_rate_points_s']} pontos/s)")
+    print(f"Perdidos:            {report['points_dropped']} {report['drops_by_measurement'] or ''}")
+    print(f"Latência (ms):       p50 {fmt(latency['p50'])}  p90 {fmt(latency['p90'])}  p99 {fmt(latency['p99'])}  "
+          f"máx {fmt(latency['max'])}  ({latency['samples']} amostras)")
+    print(f"CPU do gateway (%):  média {fmt(report['gateway_cpu_percent']['mean'])}  máx {fmt(report['gateway_cpu_percent']['max'])}")
+    print(f"RSS do gateway:      máx {report['gateway_rss_kib']['max']} KiB")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Teste de carga de ponta a ponta do gateway mqtt_to_influx.py.")
+    add_fleet_arguments(parser)
+    parser.add_argument("--broker", help="host:porta de um broker já em execução (padrão: sobe um local)")
+    parser.add_argument("--embedded-broker", action="store_true", help="Usa mini_broker.py mesmo com o Mosquitto instalado")
+    parser.add_argument("--sink-write-delay", type=float, default=0.0, help="Atraso artificial por gravação no InfluxDB falso (s)")
+    parser.add_argument("--warmup", type=float, default=3.0, help="Segundos para o gateway conectar antes da frota")
+    parser.add_argument("--drain", type=float, default=5.0, help="Segundos de espera pelas últimas gravações")
+    parser.add_argument("--report", help="Também grava o relatório em JSON neste arquivo")
+    args = parser.parse_args()
+    logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(levelname)s - %(message)s')
+
+    workdir = tempfile.mkdtemp(prefix="loadtest_")
+    tracker = FleetTracker()
+    sink = FakeInfluxSink(port=0, write_delay=args.sink_write_delay, on_line=tracker.on_line)
+    sink.start()
+    broker_host, broker_port, broker_process, broker_description = start_broker(args, workdir)
+    logging.info(f"Broker: {broker_description} em {broker_host}:{broker_port}; InfluxDB falso na porta {sink.port}")
+
+    gateway_log = open(os.path.join(workdir, "gateway.log"), "w+")
+    gateway = subprocess.Popen([sys.executable, GATEWAY_SCRIPT], cwd=workdir, stdout=gateway_log, stderr=subprocess.STDOUT,
+                               env=gateway_environment(args, broker_host, broker_port, sink.port, workdir))
+    sampler = ProcessSampler(gateway.pid)
+    try:
+        time.sleep(args.warmup)
+        if gateway.poll() is not None:
+            gateway_log.seek(0)
+            raise RuntimeError(f"O gateway terminou durante o aquecimento:\n{gateway_log.read()}")
+        sampler.start()
+        started = time.monotonic()
+        connected = asyncio.run(run_fleet((broker_host, broker_port), tracker, args.duration, args.devices,
+                                          args.cloud_devices, args.speedup, args.encoding, args.batch, args.gpio_rate,
+                                          publish_policy=not args.publish_all, low_power=args.low_power,
+                                          bulk_share=args.bulk_share))
+        publish_seconds = time.monotonic() - started
+        time.sleep(args.drain)
+    finally:
+        sampler.stop()
+        gateway.send_signal(signal.SIGINT)
+        try:
+            gateway.wait(timeout=15)
+        except subprocess.TimeoutExpired:
+            gateway.kill()
+        if broker_process:
+            broker_process.terminate()
+        sink.stop()
+
+    gateway_log.seek(0)
+    gateway_tail = gateway_log.read().splitlines()[-5:]
+    report = build_report(args, broker_description, tracker, sink, sampler, publish_seconds, connected, gateway_tail)
+    print_report(report)
+    if args.report:
+        with open(args.report, "w") as f:
+            json.dump(report, f, indent=4)
+    logging.info(f"Arquivos do teste (log do gateway, spill) em {workdir}")
+
+if __name__ == "__main__":
+    main()
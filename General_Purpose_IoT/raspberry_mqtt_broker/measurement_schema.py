@@ -0,0 +1,310 @@
+import json
+import struct
+
+# --- Esquema das Medições ---
+# Cada sensor é declarado uma única vez: nome da measurement, id do registro binário
+# (ver telemetry_codec.h no firmware local) e a lista tipada de campos. Adicionar um
+# sensor é adicionar uma entrada em SENSOR_SCHEMAS.
+
+class Field:
+    def __init__(self, name, kind, digits=None, binary_format="f"):
+        self.name = name
+        self.kind = kind                    # float, int ou str
+        self.digits = digits                # Casas decimais ao decodificar float32 binário
+        self.binary_format = binary_format  # Código do módulo struct no registro binário
+
+    def coerce(self, value):
+        return self.kind(value)
+
+    def from_binary(self, value):
+        if self.kind is float and self.digits is not None:
+            return round(value, self.digits)
+        return self.kind(value)
+
+
+class SensorSchema:
+    def __init__(self, measurement, binary_id, fields):
+        self.measurement = measurement
+        self.binary_id = binary_id
+        self.fields = fields
+        self.binary_layout = struct.Struct("<" + "".join(f.binary_format for f in fields))
+
+    def parse_json(self, data):
+        if not isinstance(data, dict):
+            return {}
+        return {f.name: f.coerce(data[f.name]) for f in self.fields if f.name in data}
+
+
+SENSOR_SCHEMAS = {schema.measurement: schema for schema in (
+    SensorSchema("bmp280", 1, (Field("temperature", float, 2), Field("pressure", float, 2), Field("pressure_sea_level", float, 2))),
+    SensorSchema("dht11", 2, (Field("temperature", float, 1), Field("humidity", float, 1))),
+    SensorSchema("mq135", 3, (Field("adc_raw", int, binary_format="H"), Field("ppm", float, 2))),
+    SensorSchema("ldr", 4, (Field("ldr_raw", int, binary_format="H"),)),
+)}
+SENSOR_SCHEMAS_BY_BINARY_ID = {schema.binary_id: schema for schema in SENSOR_SCHEMAS.values()}
+
+# --- Metadados das Leituras ---
+# Campos opcionais que o firmware anexa a cada leitura, fora do esquema do sensor.
+# No binário v2 aparecem, na ordem dos bits de flags, entre o cabeçalho e os campos.
+READING_META = (
+    (0x01, "age_ms", struct.Struct("<I")),   # Atraso entre a amostra e o envio (fila offline)
+    (0x02, "seq", struct.Struct("<I")),      # Número da leitura no dispositivo (ver sequence_tracker.py)
+    (0x04, "ts", struct.Struct("<Q")),       # Instante da amostra, epoch em ms (relógio sincronizado por SNTP)
+    (0x08, "hold_ms", struct.Struct("<I")),  # Validade do valor: publicação por banda morta (ver publish_policy.h)
+)
+
+READING_META_NAMES = tuple(name for _, name, _ in READING_META)
+
+def parse_json_meta(data):
+    """Extrai os metadados de um objeto JSON de leitura (dict vazio se não houver)."""
+    meta = {}
+    for name in READING_META_NAMES:
+        value = data.get(name)
+        if value is not None and (type(value) is int or type(value) is float):   # bool fica de fora
+            meta[name] = int(value)
+    return meta
+
+
+# --- Registros Binários ---
+# v1: [versão u8][sensor u8][campos little-endian]
+# v2: [versão u8][sensor u8][flags u8][metadados][campos little-endian]
+# Tópicos com sufixo "/bin" carregam um registro (tópico do sensor) ou vários
+# concatenados (tópico de lote).
+BINARY_CODEC_VERSION = 1
+BINARY_CODEC_VERSION_META = 2
+BINARY_HEADER = struct.Struct("<BB")
+
+def decode_binary_records(payload):
+    """Decodifica registros binários concatenados em uma lista de (measurement, fields, meta)."""
+    readings, offset = [], 0
+    while offset + BINARY_HEADER.size <= len(payload):
+        version, sensor_id = BINARY_HEADER.unpack_from(payload, offset)
+        schema = SENSOR_SCHEMAS_BY_BINARY_ID.get(sensor_id)
+        if version not in (BINARY_CODEC_VERSION, BINARY_CODEC_VERSION_META) or schema is None:
+            raise ValueError(f"registro binário desconhecido (versão {version}, sensor {sensor_id}) no byte {offset}")
+        offset += BINARY_HEADER.size
+        meta = {}
+        if version == BINARY_CODEC_VERSION_META:
+            if offset >= len(payload):
+                raise ValueError(f"registro de {schema.measurement} truncado no byte {offset}")
+            flags = payload[offset]
+            offset += 1
+            for bit, name, layout in READING_META:
+                if flags & bit:
+                    if offset + layout.size > len(payload):
+                        raise ValueError(f"registro de {schema.measurement} truncado no byte {offset}")
+                    meta[name] = layout.unpack_from(payload, offset)[0]
+                    offset += layout.size
+        if offset + schema.binary_layout.size > len(payload):
+            raise ValueError(f"registro de {schema.measurement} truncado no byte {offset}")
+        values = schema.binary_layout.unpack_from(payload, offset)
+        offset += schema.binary_layout.size
+        fields = {f.name: f.from_binary(value) for f, value in zip(schema.fields, values)}
+        readings.append((schema.measurement, fields, meta))
+    return readings
+
+
+# --- Roteamento de Tópicos ---
+class TopicRouter:
+    """Trie de padrões MQTT ("+" casa um nível) compilada uma vez na inicialização.
+
+    match() memoriza o resultado por tópico completo, então o custo por mensagem
+    de um tópico já visto é uma única consulta a dicionário.
+    """
+    WILDCARD = "+"
+    HANDLER = object()
+
+    def __init__(self, cache_size=4096):
+        self._root = {}
+        self._cache = {}
+        self._cache_size = cache_size
+
+    def add(self, pattern, handler):
+        node = self._root
+        for level in pattern.split("/"):
+            node = node.setdefault(level, {})
+        node[self.HANDLER] = handler
+        self._cache.clear()
+
+    def _walk(self, node, levels, index):
+        if index == len(levels):
+            return node.get(self.HANDLER)
+        for key in (levels[index], self.WILDCARD):
+            child = node.get(key)
+            if child is not None:
+                handler = self._walk(child, levels, index + 1)
+                if handler is not None:
+                    return handler
+        return None
+
+    def match(self, topic):
+        """Retorna (handler, níveis do tópico) ou (None, None)."""
+        cached = self._cache.get(topic)
+        if cached is not None:
+            return cached
+        levels = topic.split("/")
+        handler = self._walk(self._root, levels, 0)
+        result = (handler, levels) if handler else (None, None)
+        if len(self._cache) >= self._cache_size:
+            self._cache.clear()
+        self._cache[topic] = result
+        return result
+
+
+# --- Handlers: (níveis do tópico, payload em bytes) -> [(measurement, tags, fields, meta)] ---
+# meta traz os metadados da leitura (ver READING_META); vazio quando o firmware não os envia.
+
+def _device_tags(levels):
+    return {"device_id": levels[0]}
+
+def _load_json(payload):
+    # decode() antes do loads: json.loads(bytes) detecta a codificação a cada mensagem
+    try:
+        return json.loads(payload.decode("utf-8"))
+    except ValueError:   # Inclui UnicodeDecodeError
+        return None
+
+def _sensor_json_handler(schema):
+    def handle(levels, payload):
+        data = _load_json(payload)
+        fields = schema.parse_json(data)
+        return [(schema.measurement, _device_tags(levels), fields, parse_json_meta(data))] if fields else []
+    return handle
+
+def _batch_json_handler(levels, payload):
+    # Lote do firmware local: [{"sensor": "bmp280", ...}, {"sensor": "dht11", ...}]
+    data = _load_json(payload)
+    points = []
+    for reading in data if isinstance(data, list) else []:
+        schema = SENSOR_SCHEMAS.get(reading.get("sensor")) if isinstance(reading, dict) else None
+        fields = schema.parse_json(reading) if schema else {}
+        if fields:
+            points.append((schema.measurement, _device_tags(levels), fields, parse_json_meta(reading)))
+    return points
+
+def _binary_handler(levels, payload):
+    return [(measurement, _device_tags(levels), fields, meta) for measurement, fields, meta in decode_binary_records(payload)]
+
+def _gpio_state_handler(levels, payload):
+    tags = _device_tags(levels)
+    tags["pin"] = f"gpio{levels[2]}"
+    return [("gpio_state", tags, {"state": payload.decode("utf-8").upper()}, {})]  # Grava "ON" ou "OFF" como string
+
+def _ignored_handler(levels, payload):
+    """Tópico conhecido que não vira medição: retorna None (sem aviso de tópico desconhecido)."""
+    return None
+
+def _device_status_handler(levels, payload):
+    # Texto ("heartbeat", "online") ou, no modo de baixo consumo do firmware da nuvem,
+    # {"status": "heartbeat", "hold_ms": N}: um heartbeat por rajada, válido por hold_ms
+    data = _load_json(payload) if payload.startswith(b"{") else None
+    if isinstance(data, dict) and isinstance(data.get("status"), str):
+        return [("device_status", _device_tags(levels), {"status": data["status"]}, parse_json_meta(data))]
+    return [("device_status", _device_tags(levels), {"status": payload.decode("utf-8")}, {})]
+
+def _is_count(value):
+    return isinstance(value, int) and not isinstance(value, bool) and value >= 0
+
+def _counts(values, length):
+    return isinstance(values, list) and len(values) == length and all(_is_count(v) for v in values)
+
+def _metrics_handler(levels, payload):
+    # Snapshot de DEVICE_ID/system/metrics (runtime_metrics.h nos firmwares), tudo na
+    # measurement device_metrics: um ponto do dispositivo (uptime, heap e, no modo de
+    # baixo consumo, a parcela do tempo com o rádio acordado e as rajadas), um por
+    # operação (tag op; contagens da janela e uma coluna por faixa do histograma,
+    # le_<limite>us e le_inf) e um por tarefa (tag task).
+    data = _load_json(payload)
+    if not isinstance(data, dict):
+        return []
+    points = []
+    device = {}
+    if _is_count(data.get("up")):
+        device["uptime_s"] = data["up"]
+    if _counts(data.get("heap"), 2):
+        device["heap_free"], device["heap_min"] = data["heap"]
+    if _counts(data.get("radio"), 2):
+        device["radio_awake_permille"], device["radio_bursts"] = data["radio"]
+    if device:
+        points.append(("device_metrics", _device_tags(levels), device, {}))
+    bounds = data.get("bounds_us")
+    buckets = [f"le_{b}us" for b in bounds] + ["le_inf"] if isinstance(bounds, list) and _counts(bounds, len(bounds)) else []
+    ops = data.get("ops")
+    for op, values in (ops.items() if isinstance(ops, dict) else ()):
+        if not (isinstance(values, list) and len(values) == 5 and _counts(values[:4], 4)):
+            continue
+        count, failures, mean_us, max_us, histogram = values
+        fields = {"count": count, "failures": failures, "mean_us": mean_us, "max_us": max_us}
+        if buckets and _counts(histogram, len(buckets)):
+            fields.update(zip(buckets, histogram))
+        points.append(("device_metrics", {**_device_tags(levels), "op": op}, fields, {}))
+    tasks = data.get("tasks")
+    for task, values in (tasks.items() if isinstance(tasks, dict) else ()):
+        if _counts(values, 2):
+            points.append(("device_metrics", {**_device_tags(levels), "task": task},
+                           {"cpu_permille": values[0], "stack_free": values[1]}, {}))
+    return points
+
+def _sensor_health_handler(levels, payload):
+    # DEVICE_ID/status/sensors (sensor_registry_format_health no firmware local): um ponto
+    # de sensor_health por driver (tag sensor). age_ms -1 = nenhuma leitura boa ainda,
+    # fica de fora do ponto.
+    data = _load_json(payload)
+    points = []
+    for sensor, health in (data.items() if isinstance(data, dict) else ()):
+        if not isinstance(health, dict):
+            continue
+        fields = {name: health[name] for name in ("reads", "failures", "streak", "age_ms") if _is_count(health.get(name))}
+        if fields:
+            points.append(("sensor_health", {**_device_tags(levels), "sensor": sensor}, fields, {}))
+    return points
+
+def _diagnostics_handler(levels, payload):
+    # DEVICE_ID/system/diagnostics (gpio_latency.h no firmware da nuvem): latência dos
+    # comandos de GPIO na última janela, em um ponto de gpio_latency com colunas
+    # edge_<last|mean|max>_us e publish_<last|mean|max>_us.
+    data = _load_json(payload)
+    if not isinstance(data, dict):
+        return []
+    fields = {name: data[name] for name in ("commands", "window") if _is_count(data.get(name))}
+    for stage in ("edge", "publish"):
+        stats = data.get(f"{stage}_us")
+        for name, value in (stats.items() if isinstance(stats, dict) else ()):
+            if _is_count(value):
+                fields[f"{stage}_{name}_us"] = value
+    return [("gpio_latency", _device_tags(levels), fields, {})] if fields else []
+
+def _outbox_handler(levels, payload):
+    # DEVICE_ID/system/outbox (mqtt_outbox.h no firmware da nuvem): um ponto de
+    # device_outbox por broker (tag broker) com a fila e os contadores de envio.
+    data = _load_json(payload)
+    points = []
+    for broker, stats in (data.items() if isinstance(data, dict) else ()):
+        if not isinstance(stats, dict):
+            continue
+        fields = {name: value for name, value in stats.items() if _is_count(value)}
+        if fields:
+            points.append(("device_outbox", {**_device_tags(levels), "broker": broker}, fields, {}))
+    return points
+
+def build_local_router():
+    """Compila o roteador dos tópicos publicados pelos dispositivos na rede local."""
+    router = TopicRouter()
+    for name, schema in SENSOR_SCHEMAS.items():
+        router.add(f"+/sensor/{name}", _sensor_json_handler(schema))
+    router.add("+/sensor/batch", _batch_json_handler)
+    router.add("+/sensor/+/bin", _binary_handler)
+    router.add("+/gpio/+/state", _gpio_state_handler)
+    # Aviso não retido de um comando em lote ({"mask": M, "value": V}): o firmware também
+    # publica o estado retido de cada pino, que é o que vira gpio_state
+    router.add("+/gpio/bulk/state", _ignored_handler)
+    router.add("+/system/status", _device_status_handler)
+    router.add("+/system/metrics", _metrics_handler)
+    router.add("+/status", _device_status_handler)
+    router.add("+/status/sensors", _sensor_health_handler)
+    router.add("+/system/diagnostics", _diagnostics_handler)
+    router.add("+/system/outbox", _outbox_handler)
+    # Anel de logs sob demanda (hot_log.h): texto para leitura humana, não é medição
+    router.add("+/system/logs", _ignored_handler)
+    router.add("+/system/logs/get", _ignored_handler)
+    return router
@@ -9,18 +9,50 @@ import threading
 import uuid
 from dotenv import load_dotenv
 
+from dashboard_status import DASHBOARD_STATUS_FIELDS, build_dashboard_status
+from influx_writer import InfluxWriter
+from last_value_cache import LastValueCache
+from sequence_tracker import SequenceTracker
+from measurement_schema import build_local_router
+from rule_engine import RuleEngine
+from rule_store import RuleStore
+
 # --- Configuração do Logging ---
 logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(threadName)s - %(levelname)s - %(message)s')
 
 # --- Carregando Configurações do Ambiente ---
 load_dotenv()
 
+EPOCH = datetime.datetime(1970, 1, 1)
+
+def parse_influx_time(value):
+    """Converte o RFC 3339 devolvido pelo InfluxDB em datetime UTC ingênuo (frações além de µs são truncadas)."""
+    value = value.rstrip("Z")
+    if "." in value:
+        base, fraction = value.split(".", 1)
+        value = f"{base}.{fraction[:6]}"
+    return datetime.datetime.fromisoformat(value)
+
 # --- Classe Principal do Gateway ---
 class IoTGateway:
     def __init__(self):
         logging.info("Inicializando o Gateway IoT...")
         self.load_config()
+        self.local_router = build_local_router()
+        self.last_values = LastValueCache()
+        self.sequences = SequenceTracker()
         self.influx_client = self.setup_influxdb_client()
+        self.rule_engine = RuleEngine(self.fire_rule, refire_interval=self.check_interval, history=self.query_rule_history)
+        self.rule_store = RuleStore(self.rules_file)
+        self.rule_engine.set_rules(self.rule_store.all())
+        self.rule_store.subscribe(self.on_rules_changed)
+        self.influx_writer = InfluxWriter(
+            self.influx_client,
+            queue_size=self.influx_queue_size,
+            batch_size=self.influx_batch_size,
+            flush_interval=self.influx_flush_interval,
+            spill_file=self.influx_spill_file,
+        )
         self.local_mqtt_client = self.setup_local_mqtt_client()
         self.cloud_mqtt_client = self.setup_cloud_mqtt_client()
 
@@ -43,6 +75,7 @@ class IoTGateway:
         self.cloud_mqtt_port = int(os.getenv("CLOUD_MQTT_BROKER_PORT", 8883))
         self.cloud_mqtt_user = os.getenv("CLOUD_MQTT_USERNAME")
         self.cloud_mqtt_pass = os.getenv("CLOUD_MQTT_PASSWORD")
+        self.cloud_mqtt_tls = os.getenv("CLOUD_MQTT_TLS", "true").lower() != "false"
         
         # Tópicos Nuvem
         self.topic_manage_rules = "sistema/regras/gerenciar"
@@ -55,11 +88,18 @@ class IoTGateway:
         self.influx_user = os.getenv("INFLUXDB_USERNAME")
         self.influx_pass = os.getenv("INFLUXDB_PASSWORD")
         self.influx_db = os.getenv("INFLUXDB_DATABASE", "esp32_dados")
+        self.influx_queue_size = int(os.getenv("INFLUXDB_WRITE_QUEUE_SIZE", 10000))
+        self.influx_batch_size = int(os.getenv("INFLUXDB_WRITE_BATCH_SIZE", 500))
+        self.influx_flush_interval = float(os.getenv("INFLUXDB_WRITE_FLUSH_INTERVAL", 1.0))
+        self.influx_spill_file = os.getenv("INFLUXDB_SPILL_FILE", "influx_spill.lp")
 
         # Arquivo de Regras
         self.rules_file = "automation_rules.json"
         self.check_interval = 15
+        self.rule_tick_interval = float(os.getenv("RULE_TICK_INTERVAL", 1))
+        self.status_interval = float(os.getenv("DASHBOARD_STATUS_INTERVAL", 5))
         self.status_timeout = 15  # Timeout in seconds for device status
+        self.device_stats_interval = float(os.getenv("DEVICE_STATS_INTERVAL", 60))
 
     def setup_influxdb_client(self):
         """Configura e retorna um cliente InfluxDB."""
@@ -95,7 +135,7 @@ class IoTGateway:
         client.username_pw_set(self.cloud_mqtt_user, self.cloud_mqtt_pass)
         client.on_connect = self.on_cloud_connect
         client.on_message = self.on_cloud_message
-        client.tls_set()
+        if self.cloud_mqtt_tls: client.tls_set()
         try:
             client.connect(self.cloud_mqtt_host, self.cloud_mqtt_port, 60)
             return client
@@ -124,168 +164,195 @@ class IoTGateway:
     def on_local_message(self, client, userdata, msg):
         """Processa mensagens da rede local (sensores) e grava no InfluxDB."""
         topic = msg.topic
-        payload_str = msg.payload.decode('utf-8')
-
         try:
-            topic_parts = topic.split('/')
-            device_id = topic_parts[0]
-            tags, fields, measurement_name = {"device_id": device_id}, {}, None
-            
-            try: 
-                data = json.loads(payload_str)
-            except json.JSONDecodeError: 
-                data = payload_str
-            
-            if len(topic_parts) > 2 and topic_parts[1] == 'sensor':
-                sensor_type = topic_parts[2]
-                if sensor_type == "bmp280" and isinstance(data, dict):
-                    measurement_name = "bmp280"
-                    if "temperature" in data: fields["temperature"] = float(data["temperature"])
-                    if "pressure" in data: fields["pressure"] = float(data["pressure"])
-                    if "pressure_sea_level" in data: fields["pressure_sea_level"] = float(data["pressure_sea_level"])
-                elif sensor_type == "dht11" and isinstance(data, dict):
-                    measurement_name = "dht11"
-                    if "temperature" in data: fields["temperature"] = float(data["temperature"])
-                    if "humidity" in data: fields["humidity"] = float(data["humidity"])
-                elif sensor_type == "mq135" and isinstance(data, dict):
-                    measurement_name = "mq135"
-                    if "adc_raw" in data: fields["adc_raw"] = int(data["adc_raw"])
-                    if "ppm" in data: fields["ppm"] = float(data["ppm"])
-                elif sensor_type == "ldr" and isinstance(data, dict):
-                    measurement_name = "ldr"
-                    if "ldr_raw" in data: fields["ldr_raw"] = int(data["ldr_raw"])
-            
-            elif len(topic_parts) == 4 and topic_parts[1] == 'gpio' and topic_parts[3] == 'state':
-                measurement_name = "gpio_state"
-                pin_num = topic_parts[2]
-                tags['pin'] = f"gpio{pin_num}"
-                fields["state"] = payload_str.upper()  # Store "ON" or "OFF" as string
-            
-            elif (len(topic_parts) == 3 and topic_parts[1] == "system" and topic_parts[2] == "status") or \
-                 (len(topic_parts) == 2 and topic_parts[1] == "status"):
-                measurement_name = "device_status"
-                fields["status"] = payload_str
-
-            if measurement_name and fields:
-                json_body = [{"measurement": measurement_name, "tags": tags, "time": datetime.datetime.utcnow().isoformat() + "Z", "fields": fields}]
-                self.influx_client.write_points(json_body)
+            handler, topic_levels = self.local_router.match(topic)
+            points = handler(topic_levels, msg.payload) if handler else []
+            if points is None:
+                return   # Tópico conhecido sem medição (_ignored_handler)
+            if points:
+                received_at = datetime.datetime.utcnow()
+                received_ms = int(received_at.replace(tzinfo=datetime.timezone.utc).timestamp() * 1000)
+                json_body = []
+                for measurement_name, tags, fields, meta in points:
+                    if "seq" in meta and self.sequences.observe(tags["device_id"], meta["seq"], received_ms, meta.get("ts"),
+                                                                meta.get("age_ms")) == SequenceTracker.DUPLICATE:
+                        logging.debug(f"Leitura duplicada ignorada: {tags['device_id']} seq {meta['seq']}")
+                        continue
+                    sampled_at = self.sample_time(received_at, meta)
+                    if fields:
+                        json_body.append({"measurement": measurement_name, "tags": tags,
+                                          "time": sampled_at.isoformat() + "Z", "fields": fields})
+                    # Com banda morta (hold_ms), o silêncio do dispositivo significa "valor inalterado"
+                    hold_ms = meta.get("hold_ms")
+                    self.last_values.update(measurement_name, tags, fields, sampled_at,
+                                            datetime.timedelta(milliseconds=hold_ms) if hold_ms else None)
+                    # Leituras atrasadas (rajadas do modo de baixo consumo, fila offline) entram
+                    # nas janelas no instante da amostra; o motor ignora as velhas demais
+                    age_ms = meta.get("age_ms")
+                    self.rule_engine.ingest(measurement_name, tags, fields, hold_s=hold_ms / 1000 if hold_ms else None,
+                                            age_s=age_ms / 1000 if age_ms else None)
+                if json_body:
+                    self.influx_writer.write_points(json_body)
             else:
                 logging.warning(f"Nenhuma medição ou campo válido identificado para o tópico '{topic}'. Nenhum dado foi gravado.")
 
         except Exception as e:
             logging.error(f"Erro inesperado ao processar mensagem local de {topic}: {e}")
 
+    @staticmethod
+    def sample_time(received_at, meta):
+        """Instante da amostra: o "ts" do dispositivo (relógio sincronizado) ou, sem ele, a
+        chegada menos o atraso informado pelo dispositivo."""
+        if meta.get("ts"):
+            return EPOCH + datetime.timedelta(milliseconds=meta["ts"])
+        age_ms = meta.get("age_ms")
+        return received_at - datetime.timedelta(milliseconds=age_ms) if age_ms else received_at
+
     def on_cloud_message(self, client, userdata, msg):
         """Processa comandos de gerenciamento de regras vindos do frontend."""
         try:
             payload = json.loads(msg.payload.decode())
             command = payload.get("command")
-            
-            rules = self.get_rules()
+
+            # add/delete publicam só a alteração (ver on_rules_changed); os demais comandos recebem a lista completa
             if command == "add_rule":
-                new_rule = payload.get("rule")
-                new_rule['id'] = str(uuid.uuid4())
-                rules.append(new_rule)
+                self.rule_store.add_rule(payload.get("rule"))
             elif command == "delete_rule":
-                rule_id_to_delete = payload.get("rule_id")
-                rules = [rule for rule in rules if rule.get('id') != rule_id_to_delete]
-            
-            self.save_rules(rules)
-            self.cloud_mqtt_client.publish(self.topic_list_rules, json.dumps(rules), qos=1)
+                self.rule_store.delete_rule(payload.get("rule_id"))
+            else:
+                self.cloud_mqtt_client.publish(self.topic_list_rules, json.dumps(self.rule_store.all()), qos=1)
         except Exception as e:
             logging.error(f"Erro ao processar comando da nuvem: {e}")
 
-    def get_rules(self):
-        try:
-            with open(self.rules_file, 'r') as f: return json.load(f)
-        except: return []
+    def on_rules_changed(self, event, rule):
+        """Recompila o motor de regras e publica a alteração em sistema/regras/lista."""
+        self.rule_engine.set_rules(self.rule_store.all())
+        if event == "add":
+            delta = {"op": "add", "rule": rule}
+        else:
+            delta = {"op": "delete", "rule_id": rule["id"]}
+        self.cloud_mqtt_client.publish(self.topic_list_rules, json.dumps(delta), qos=1)
+
+    def fire_rule(self, rule):
+        """Executa a ação de uma regra cuja condição foi satisfeita.
+
+        action_payload pode ser texto ("ON") ou um objeto JSON, enviado serializado;
+        assim uma regra comanda vários pinos de uma vez pelo tópico em lote
+        (ex.: "esp32_02/gpio/bulk/set" com {"on": [2, 4], "off": [5]}).
+        """
+        payload = rule['action_payload']
+        if isinstance(payload, (dict, list)):
+            payload = json.dumps(payload, separators=(",", ":"))
+        self.cloud_mqtt_client.publish(rule['action_topic'], payload, qos=1)
+        logging.info(f"Regra '{rule.get('name')}' disparada: {rule['action_topic']} <- {payload}")
+
+    def query_rule_history(self, measurement, field, tag_filter, range_s):
+        """Pontos já gravados para uma janela nova do motor de regras: [(epoch em s, valor)]."""
+        conditions = [f"time > now() - {round(range_s * 1000)}ms"] + [f"\"{tag}\" = '{value}'" for tag, value in tag_filter]
+        query = f"SELECT \"{field}\" FROM \"{measurement}\" WHERE {' AND '.join(conditions)}"
+        return [((parse_influx_time(p['time']) - EPOCH).total_seconds(), p[field])
+                for p in self.influx_client.query(query).get_points() if p.get(field) is not None]
+
+    def run_fallback_rule(self, rule):
+        """Avalia por consulta InfluxQL uma regra que o motor de streaming não interpreta."""
+        aggregator = "last" if rule['measurement'] == "gpio_state" else "mean"
+        query = f"SELECT {aggregator}(\"{rule['field']}\") FROM \"{rule['measurement']}\" WHERE time > now() - {rule['range']}"
+        if rule.get('filter'): query += f" AND {rule['filter']}"
 
-    def save_rules(self, rules):
-        with open(self.rules_file, 'w') as f: json.dump(rules, f, indent=4)
+        result = self.influx_client.query(query)
+        points = list(result.get_points())
+
+        if points and points[0].get(aggregator) is not None:
+            value, threshold, op = points[0][aggregator], float(rule["threshold"]), rule["operator"]
+            if (op == ">" and value > threshold) or (op == "<" and value < threshold) or (op == "==" and value == threshold):
+                self.fire_rule(rule)
 
     def automation_loop(self):
-        """Loop principal da thread de automação e status."""
+        """Loop principal da thread de automação.
+
+        As regras são avaliadas em on_local_message pelo motor de streaming; aqui
+        apenas expiramos as janelas a cada rule_tick_interval e, a cada
+        check_interval, consultamos as regras que ficaram no fallback InfluxQL.
+        """
+        next_check = 0
         while True:
-            rules = self.get_rules()
-            if rules:
-                for rule in rules:
+            now = time.monotonic()
+            self.rule_engine.tick()
+            if now >= next_check:
+                next_check = now + self.check_interval
+                for rule in self.rule_engine.fallback_rules:
                     try:
-                        aggregator = "last" if rule['measurement'] == "gpio_state" else "mean"
-                        query = f"SELECT {aggregator}(\"{rule['field']}\") FROM \"{rule['measurement']}\" WHERE time > now() - {rule['range']}"
-                        if rule.get('filter'): query += f" AND {rule['filter']}"
-                        
-                        result = self.influx_client.query(query)
-                        points = list(result.get_points())
-                        
-                        if points and points[0].get(aggregator) is not None:
-                            value, threshold, op = points[0][aggregator], float(rule["threshold"]), rule["operator"]
-                            if (op == ">" and value > threshold) or (op == "<" and value < threshold) or (op == "==" and value == threshold):
-                                self.cloud_mqtt_client.publish(rule['action_topic'], rule['action_payload'], qos=1)
+                        self.run_fallback_rule(rule)
                     except Exception as e:
                         logging.error(f"Erro ao executar a regra '{rule['name']}': {e}")
 
+            time.sleep(self.rule_tick_interval)
+
+    def warm_last_value_cache(self):
+        """Preenche o cache com o último ponto gravado de cada campo do dashboard (uma vez, na inicialização)."""
+        for key, device_id, measurement, field, tags, options in DASHBOARD_STATUS_FIELDS:
             try:
-                status_data = {}
-                
-                def query_and_add(measurement, field, key, tag_filter="", is_gpio=False, round_digits=2, check_timeout=False):
-                    try:
-                        query = f"SELECT last(\"{field}\") FROM \"{measurement}\""
-                        if tag_filter:
-                            query += f" WHERE {tag_filter}"
-                        result = self.influx_client.query(query)
-                        points = list(result.get_points())
-                        if points and points[0].get('last') is not None:
-                            value = points[0]['last']
-                            if check_timeout:
-                                # Get timestamp of the last point
-                                last_time = points[0].get('time')
-                                last_time_dt = datetime.datetime.strptime(last_time, "%Y-%m-%dT%H:%M:%S.%fZ")
-                                time_diff = (datetime.datetime.utcnow() - last_time_dt).total_seconds()
-                                if time_diff > self.status_timeout:
-                                    status_data[key] = "offline"
-                                    return
-                            if is_gpio:
-                                status_data[key] = "ON" if value == "ON" else "OFF"
-                            elif isinstance(value, (int, float)):
-                                status_data[key] = round(value, round_digits)
-                            elif measurement == "device_status" and value in ["heartbeat", "online"]:
-                                status_data[key] = "online"
-                            else:
-                                status_data[key] = value
-                    except:
-                        pass
-
-                # esp32_01 sensor and GPIO data
-                query_and_add("dht11", "temperature", "dht11_temperature", tag_filter="\"device_id\" = 'esp32_01'")
-                query_and_add("dht11", "humidity", "dht11_humidity", tag_filter="\"device_id\" = 'esp32_01'", round_digits=1)
-                query_and_add("bmp280", "temperature", "bmp280_temperature", tag_filter="\"device_id\" = 'esp32_01'")
-                query_and_add("bmp280", "pressure", "bmp280_pressure", tag_filter="\"device_id\" = 'esp32_01'")
-                query_and_add("bmp280", "pressure_sea_level", "bmp280_sea_level_pressure", tag_filter="\"device_id\" = 'esp32_01'")
-                query_and_add("mq135", "ppm", "mq135_ppm", tag_filter="\"device_id\" = 'esp32_01'")
-                query_and_add("ldr", "ldr_raw", "ldr_raw", tag_filter="\"device_id\" = 'esp32_01'", round_digits=0)
-                query_and_add("gpio_state", "state", "gpio_2_state", tag_filter="\"pin\" = 'gpio2' AND \"device_id\" = 'esp32_01'", is_gpio=True)
-
-                # esp32_02 status (mapped to device_status for dashboard)
-                query_and_add("device_status", "status", "device_status", tag_filter="\"device_id\" = 'esp32_02'", check_timeout=True)
+                conditions = [f"\"device_id\" = '{device_id}'"] + [f"\"{k}\" = '{v}'" for k, v in tags.items()]
+                query = f"SELECT last(\"{field}\") FROM \"{measurement}\" WHERE {' AND '.join(conditions)}"
+                points = list(self.influx_client.query(query).get_points())
+                if points and points[0].get('last') is not None:
+                    self.last_values.update(measurement, {"device_id": device_id, **tags},
+                                            {field: points[0]['last']}, parse_influx_time(points[0]['time']))
+            except Exception as e:
+                logging.warning(f"Não foi possível aquecer o cache para '{key}': {e}")
+
+    def build_dashboard_status(self, now=None):
+        """Monta o status do dashboard a partir do cache de últimos valores."""
+        return build_dashboard_status(self.last_values, self.status_timeout, now)
 
+    def write_device_stats(self):
+        """Grava as estatísticas de sequência e relógio de cada dispositivo (measurement device_telemetry)."""
+        timestamp = datetime.datetime.utcnow().isoformat() + "Z"
+        json_body = []
+        for device_id, stats in self.sequences.snapshot().items():
+            fields = {name: value for name, value in stats.items() if value is not None}
+            json_body.append({"measurement": "device_telemetry", "tags": {"device_id": device_id},
+                              "time": timestamp, "fields": fields})
+            logging.info(f"Telemetria de {device_id}: {stats}")
+        if json_body:
+            self.influx_writer.write_points(json_body)
+
+    def status_loop(self):
+        """Publica periodicamente o status do dashboard, servido inteiramente pelo cache,
+        e grava as estatísticas dos dispositivos a cada device_stats_interval."""
+        next_stats = time.monotonic() + self.device_stats_interval
+        while True:
+            try:
+                status_data = self.build_dashboard_status()
                 if status_data:
                     status_data['last_update'] = datetime.datetime.now().isoformat()
                     self.cloud_mqtt_client.publish(self.topic_dashboard_status, json.dumps(status_data), qos=1)
                     logging.info(f"Status publicado para o dashboard: {status_data}")
-
             except Exception as e:
                 logging.error(f"Erro ao publicar status periódico completo: {e}")
 
-            time.sleep(self.check_interval)
+            if time.monotonic() >= next_stats:
+                next_stats += self.device_stats_interval
+                try:
+                    self.write_device_stats()
+                except Exception as e:
+                    logging.error(f"Erro ao gravar estatísticas dos dispositivos: {e}")
+
+            time.sleep(self.status_interval)
 
     def run(self):
         """Inicia todos os loops e threads."""
+        self.influx_writer.start()
         self.local_mqtt_client.loop_start()
         self.cloud_mqtt_client.loop_start()
 
         automation_thread = threading.Thread(target=self.automation_loop, name="AutomationThread", daemon=True)
         automation_thread.start()
 
+        self.warm_last_value_cache()
+        status_thread = threading.Thread(target=self.status_loop, name="StatusThread", daemon=True)
+        status_thread.start()
+
         logging.info("Gateway IoT em execução. Pressione Ctrl+C para parar.")
         try:
             while True:
@@ -294,7 +361,8 @@ class IoTGateway:
             logging.info("Desligando o Gateway IoT...")
             self.local_mqtt_client.loop_stop()
             self.cloud_mqtt_client.loop_stop()
-            logging.info("Gateway desligado.")
+            self.influx_writer.stop()
+            logging.info(f"Gateway desligado. Estatísticas de gravação: {self.influx_writer.get_stats()}")
 
 if __name__ == '__main__':
     gateway = IoTGateway()
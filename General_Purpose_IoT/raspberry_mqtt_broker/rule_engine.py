@@ -0,0 +1,323 @@
+import collections
+import logging
+import operator
+import re
+import threading
+import time
+
+# --- Interpretação das Regras ---
+# As regras usam o mesmo esquema salvo pelo dashboard: measurement, field, range
+# (duração InfluxQL, ex. "5m"), filter (ex. "device_id" = 'esp32_01'), operator e
+# threshold. "aggregator" é opcional: por padrão "last" para gpio_state e "mean"
+# para o resto, como no laço de consultas antigo.
+
+RANGE_UNITS = {"ms": 0.001, "s": 1, "m": 60, "h": 3600, "d": 86400, "w": 604800}
+RANGE_PATTERN = re.compile(r"^\s*(\d+(?:\.\d+)?)\s*(ms|s|m|h|d|w)\s*$")
+FILTER_TERM_PATTERN = re.compile(r"""^\s*"?([A-Za-z_][\w]*)"?\s*=\s*'([^']*)'\s*$""")
+
+OPERATORS = {">": operator.gt, "<": operator.lt, "==": operator.eq,
+             ">=": operator.ge, "<=": operator.le, "!=": operator.ne}
+AGGREGATORS = ("mean", "last", "min", "max")
+
+# Leituras atrasadas mais velhas que isto (fila offline depois de uma queda longa)
+# só vão para o histórico. Acima do LOW_POWER_BURST_PERIOD_MS do firmware (30 s):
+# no modo de baixo consumo toda leitura chega com age_ms de até um período.
+MAX_READING_AGE_S = 60
+
+def parse_range(value):
+    """Converte uma duração InfluxQL ("30s", "5m", "1h") em segundos; None se não reconhecida."""
+    match = RANGE_PATTERN.match(str(value))
+    if not match:
+        return None
+    seconds = float(match.group(1)) * RANGE_UNITS[match.group(2)]
+    return seconds if seconds > 0 else None
+
+def parse_filter(value):
+    """Converte '"tag" = 'valor' AND ...' em tupla ordenada de (tag, valor); None se não reconhecido."""
+    if not value:
+        return ()
+    terms = {}
+    for term in re.split(r"\s+AND\s+", value.strip(), flags=re.IGNORECASE):
+        match = FILTER_TERM_PATTERN.match(term)
+        if not match:
+            return None
+        terms[match.group(1)] = match.group(2)
+    return tuple(sorted(terms.items()))
+
+def default_aggregator(rule):
+    return rule.get("aggregator") or ("last" if rule.get("measurement") == "gpio_state" else "mean")
+
+
+# --- Janela Deslizante ---
+class SlidingWindow:
+    """Pontos de (measurement, field) que casam com um filtro, nos últimos range_s segundos.
+
+    Mantém soma e contagem para a média e deques monotônicos para mínimo e
+    máximo, então cada ponto custa O(1) amortizado em push() e evict().
+
+    Um ponto com hold_until (dispositivo que publica por banda morta) continua
+    valendo até esse instante: se a janela esvaziar antes, evict() recoloca o
+    último valor no lugar de deixá-la sem pontos.
+
+    A janela começa vazia (gateway reiniciado ou regra nova) e só passa a ter
+    todos os pontos do range depois de range_s segundos do primeiro ponto
+    (covers()); antes disso, média, mínimo e máximo veriam só o fim da janela.
+    seed() completa a janela com o histórico do InfluxDB e a dá por coberta.
+    """
+
+    def __init__(self, range_s):
+        self.range_s = range_s
+        self.points = collections.deque()   # (instante, valor)
+        self.mins = collections.deque()
+        self.maxs = collections.deque()
+        self.total = 0.0
+        self.held = None                    # (valor, hold_until) do último ponto
+        self.started = None                 # Instante do primeiro ponto recebido
+        self.warm = False                   # covers() já foi verdade em um tick()
+        self.rules = []
+
+    def push(self, timestamp, value, hold_until=None):
+        if self.started is None:
+            self.started = timestamp
+        self.held = (value, hold_until) if hold_until is not None else None
+        self._append(timestamp, value)
+
+    def _append(self, timestamp, value):
+        if self.points and timestamp < self.points[-1][0]:
+            timestamp = self.points[-1][0]   # Mantém a ordem temporal exigida pelos deques
+        entry = (timestamp, value)
+        self.points.append(entry)
+        self.total += value
+        while self.mins and self.mins[-1][1] >= value:
+            self.mins.pop()
+        self.mins.append(entry)
+        while self.maxs and self.maxs[-1][1] <= value:
+            self.maxs.pop()
+        self.maxs.append(entry)
+
+    def evict(self, now):
+        """Remove pontos fora da janela (equivale a "time > now() - range"). Retorna True se algo saiu."""
+        cutoff = now - self.range_s
+        evicted = False
+        while self.points and self.points[0][0] <= cutoff:
+            self.total -= self.points.popleft()[1]
+            evicted = True
+        while self.mins and self.mins[0][0] <= cutoff:
+            self.mins.popleft()
+        while self.maxs and self.maxs[0][0] <= cutoff:
+            self.maxs.popleft()
+        if not self.points:
+            self.total = 0.0
+            if self.held and now < self.held[1]:
+                self._append(now, self.held[0])
+        return evicted
+
+    def seed(self, history, now):
+        """Acrescenta, antes dos pontos já recebidos, o histórico [(instante, valor)]
+        dos últimos range_s segundos; a janela passa a cobrir o range."""
+        live = list(self.points)
+        first_live = live[0][0] if live else None
+        older = sorted((t, v) for t, v in history
+                       if isinstance(v, (int, float)) and not isinstance(v, bool)
+                       and t > now - self.range_s and (first_live is None or t < first_live))
+        self.points.clear()
+        self.mins.clear()
+        self.maxs.clear()
+        self.total = 0.0
+        for timestamp, value in older + live:
+            self._append(timestamp, value)
+        start = now - self.range_s
+        self.started = start if self.started is None else min(self.started, start)
+
+    def covers(self, now):
+        """True quando a janela já observou um range inteiro."""
+        return self.started is not None and now - self.started >= self.range_s
+
+    def aggregate(self, name):
+        if not self.points:
+            return None
+        if name == "mean":
+            return self.total / len(self.points)
+        if name == "last":
+            return self.points[-1][1]
+        if name == "min":
+            return self.mins[0][1]
+        return self.maxs[0][1]
+
+
+class CompiledRule:
+    def __init__(self, rule, window, aggregator, compare, threshold):
+        self.rule = rule
+        self.window = window
+        self.aggregator = aggregator
+        self.compare = compare
+        self.threshold = threshold
+        self.active = False
+        self.last_fired = None
+
+
+# --- Motor de Regras ---
+class RuleEngine:
+    """Avalia as regras de automação à medida que os pontos chegam.
+
+    As regras são indexadas por (measurement, field, device_id do filtro);
+    ingest() só atualiza as janelas do ponto e só reavalia as regras ligadas a elas. Uma regra dispara
+    quando a condição passa de falsa para verdadeira e, enquanto continuar
+    verdadeira, repete o disparo no máximo a cada refire_interval segundos.
+    Regras de média, mínimo ou máximo não disparam enquanto a janela ainda não
+    cobre o range (ver SlidingWindow.covers), em vez de decidir com a janela
+    parcial de depois de um reinício. Com history (measurement, field, filtro,
+    range_s) -> [(instante, valor)], cada janela nova é preenchida com os pontos
+    já gravados e decide de imediato, como a consulta InfluxQL de antes; sem
+    history, ou se a consulta falhar, a janela aquece com os pontos que chegam.
+    tick() deve ser chamado periodicamente para expirar pontos antigos e repetir
+    os disparos das regras que continuam ativas sem novos pontos.
+
+    Uma leitura atrasada (age_s) entra nas janelas no instante da amostra; as
+    mais velhas que max_age_s são ignoradas.
+
+    Regras cujo range ou filter não são reconhecidos ficam em fallback_rules
+    para serem avaliadas pela consulta InfluxQL de antes.
+    """
+
+    def __init__(self, fire, refire_interval=15, max_age_s=MAX_READING_AGE_S, history=None):
+        self.fire = fire
+        self.history = history
+        self.refire_interval = refire_interval
+        self.max_age_s = max_age_s
+        self._lock = threading.Lock()
+        self._windows = {}          # (measurement, field, filtro, range_s) -> SlidingWindow
+        self._index = {}            # (measurement, field, device_id ou None) -> [(resto do filtro, SlidingWindow)]
+        self._compiled = []
+        self.fallback_rules = []
+
+    def set_rules(self, rules, now=None):
+        """Recompila as regras, preservando janelas e estado das regras que não mudaram."""
+        with self._lock:
+            compiled, fallback, fresh = self._compile(rules)
+        if self.history:
+            self._seed(fresh, now)
+        logging.info(f"Motor de regras: {len(compiled)} regras em streaming, {len(fallback)} via consulta InfluxQL.")
+
+    def _compile(self, rules):
+        previous_by_id = {c.rule.get("id"): c for c in self._compiled if c.rule.get("id")}
+        windows, index, compiled, fallback, fresh = {}, {}, [], [], []
+        for rule in rules:
+            try:
+                range_s = parse_range(rule["range"])
+                tag_filter = parse_filter(rule.get("filter"))
+                aggregator = default_aggregator(rule)
+                compare = OPERATORS.get(rule["operator"])
+                threshold = float(rule["threshold"])
+            except (KeyError, TypeError, ValueError) as e:
+                logging.error(f"Regra '{rule.get('name')}' inválida, ignorada: {e}")
+                continue
+            if range_s is None or tag_filter is None or aggregator not in AGGREGATORS or compare is None:
+                fallback.append(rule)
+                continue
+            key = (rule["measurement"], rule["field"], tag_filter, range_s)
+            window = windows.get(key)
+            if window is None:
+                window = self._windows.get(key)
+                if window is None:
+                    window = SlidingWindow(range_s)
+                    fresh.append((key, window))
+                window.rules = []
+                windows[key] = window
+                # Quase toda regra filtra por device_id: indexado por ele, um ponto só
+                # visita as janelas do próprio dispositivo (e as sem device_id)
+                device_id = dict(tag_filter).get("device_id")
+                rest = tuple((tag, value) for tag, value in tag_filter if tag != "device_id")
+                index.setdefault((rule["measurement"], rule["field"], device_id), []).append((rest, window))
+            entry = CompiledRule(rule, window, aggregator, compare, threshold)
+            old = previous_by_id.get(rule.get("id"))
+            if old is not None and old.rule == rule:
+                entry.active, entry.last_fired = old.active, old.last_fired
+            window.rules.append(entry)
+            compiled.append(entry)
+        self._windows, self._index, self._compiled = windows, index, compiled
+        self.fallback_rules = fallback
+        return compiled, fallback, fresh
+
+    def _seed(self, fresh, now=None):
+        # Consulta fora do lock: os pontos que chegarem nesse meio tempo ficam
+        # depois do histórico (ver SlidingWindow.seed)
+        for (measurement, field, tag_filter, range_s), window in fresh:
+            try:
+                history = self.history(measurement, field, tag_filter, range_s)
+            except Exception as e:
+                logging.warning(f"Histórico de {measurement}.{field} indisponível; a janela de {range_s:g} s "
+                                f"aquece com os pontos novos: {e}")
+                continue
+            with self._lock:
+                window.seed(history, time.time() if now is None else now)
+
+    def _evaluate(self, entry, now, fired, aggregates):
+        value = aggregates.get(entry.aggregator, aggregates)
+        if value is aggregates:
+            value = aggregates[entry.aggregator] = entry.window.aggregate(entry.aggregator)
+        # "last" já vale com um ponto; os outros agregados esperam a janela cobrir o range
+        condition = (value is not None and entry.compare(value, entry.threshold)
+                     and (entry.aggregator == "last" or entry.window.covers(now)))
+        if condition and (not entry.active or now - entry.last_fired >= self.refire_interval):
+            entry.last_fired = now
+            fired.append(entry.rule)
+        entry.active = condition
+
+    def _fire_all(self, fired):
+        for rule in fired:
+            try:
+                self.fire(rule)
+            except Exception as e:
+                logging.error(f"Erro ao executar a regra '{rule.get('name')}': {e}")
+
+    def ingest(self, measurement, tags, fields, now=None, hold_s=None, age_s=None):
+        """Alimenta as janelas com um ponto e avalia as regras afetadas.
+
+        hold_s: por quanto tempo o valor continua válido sem novos pontos (banda morta).
+        age_s: atraso entre a amostra e a chegada (age_ms do firmware).
+        """
+        now = time.time() if now is None else now
+        if age_s and age_s > self.max_age_s:
+            return
+        sampled_at = now - age_s if age_s else now
+        hold_until = sampled_at + hold_s if hold_s else None
+        fired = []
+        device_id = tags.get("device_id")
+        devices = (device_id, None) if device_id is not None else (None,)
+        with self._lock:
+            for field, value in fields.items():
+                if isinstance(value, bool) or not isinstance(value, (int, float)):
+                    continue
+                for device in devices:
+                    for tag_filter, window in self._index.get((measurement, field, device), ()):
+                        if all(tags.get(tag) == expected for tag, expected in tag_filter):
+                            window.evict(now)
+                            if sampled_at <= now - window.range_s:
+                                continue   # Amostra já fora do range desta janela
+                            window.push(sampled_at, value, hold_until)
+                            aggregates = {}   # Cada agregado é calculado uma vez por janela
+                            for entry in window.rules:
+                                self._evaluate(entry, now, fired, aggregates)
+        self._fire_all(fired)
+
+    def tick(self, now=None):
+        """Expira pontos antigos e reavalia as regras afetadas ou ainda ativas."""
+        now = time.time() if now is None else now
+        fired = []
+        with self._lock:
+            for window in self._windows.values():
+                aggregates = {}
+                evicted = window.points and window.evict(now)
+                # Janela que acabou de cobrir o range: as regras suspensas são avaliadas agora
+                warmed = not window.warm and window.covers(now)
+                if warmed:
+                    window.warm = True
+                if evicted or warmed:
+                    for entry in window.rules:
+                        self._evaluate(entry, now, fired, aggregates)
+                else:
+                    for entry in window.rules:
+                        if entry.active:
+                            self._evaluate(entry, now, fired, aggregates)
+        self._fire_all(fired)
@@ -0,0 +1,147 @@
+import collections
+import json
+import logging
+import os
+import threading
+import uuid
+
+# --- Armazenamento das Regras ---
+class RuleStore:
+    """Regras de automação em memória, indexadas por id e por (measurement, field).
+
+    O arquivo JSON só é lido na inicialização. Cada alteração é gravada por
+    completo em um arquivo temporário, sincronizada no disco e renomeada sobre
+    o original, então uma queda no meio da gravação deixa a versão anterior
+    intacta. Os listeners recebem (evento, regra) depois de cada alteração, fora
+    do lock (podem consultar ou alterar o store e chamar código que trava outros
+    locks), na mesma ordem em que as alterações foram aplicadas: elas entram numa
+    fila sob o lock e uma thread por vez a esvazia.
+    """
+
+    def __init__(self, path):
+        self.path = path
+        self._lock = threading.RLock()
+        self._rules = {}          # id -> regra, na ordem de criação
+        self._by_field = {}       # (measurement, field) -> {id: regra}
+        self._listeners = []
+        self._pending = collections.deque()   # (evento, regra) ainda não entregues
+        self._notify_lock = threading.Lock()
+        self._load()
+
+    def _index(self, rule):
+        self._rules[rule["id"]] = rule
+        self._by_field.setdefault((rule.get("measurement"), rule.get("field")), {})[rule["id"]] = rule
+
+    def _unindex(self, rule):
+        self._rules.pop(rule["id"], None)
+        bucket = self._by_field.get((rule.get("measurement"), rule.get("field")), {})
+        bucket.pop(rule["id"], None)
+        if not bucket:
+            self._by_field.pop((rule.get("measurement"), rule.get("field")), None)
+
+    def _load(self):
+        try:
+            with open(self.path, "r") as f:
+                rules = json.load(f)
+        except FileNotFoundError:
+            return
+        except (OSError, ValueError) as e:
+            logging.error(f"Não foi possível ler o arquivo de regras '{self.path}': {e}")
+            return
+        missing_ids = False
+        for rule in rules if isinstance(rules, list) else []:
+            if not isinstance(rule, dict):
+                continue
+            if not rule.get("id"):
+                rule["id"] = str(uuid.uuid4())
+                missing_ids = True
+            self._index(rule)
+        if missing_ids:
+            try:
+                self._persist()
+            except OSError as e:
+                logging.error(f"Não foi possível gravar os ids gerados em '{self.path}': {e}")
+        logging.info(f"{len(self._rules)} regras carregadas de '{self.path}'.")
+
+    def _persist(self):
+        temp_path = f"{self.path}.tmp"
+        with open(temp_path, "w") as f:
+            json.dump(list(self._rules.values()), f, indent=4)
+            f.flush()
+            os.fsync(f.fileno())
+        os.replace(temp_path, self.path)
+        try:
+            dir_fd = os.open(os.path.dirname(os.path.abspath(self.path)), os.O_RDONLY)
+        except OSError:
+            return
+        try:
+            os.fsync(dir_fd)   # Garante que a renomeação também sobreviva a uma queda
+        except OSError:
+            pass
+        finally:
+            os.close(dir_fd)
+
+    def _notify(self):
+        """Entrega a fila de alterações; chamado sem o lock, depois de cada alteração."""
+        while self._pending:
+            # Se outra thread (ou um listener desta, alterando o store) já está
+            # entregando, ela também entrega o que acabou de entrar na fila
+            if not self._notify_lock.acquire(blocking=False):
+                return
+            try:
+                while self._pending:
+                    event, rule = self._pending.popleft()
+                    for listener in list(self._listeners):
+                        try:
+                            listener(event, rule)
+                        except Exception as e:
+                            logging.error(f"Erro ao notificar alteração de regra ({event}): {e}")
+            finally:
+                self._notify_lock.release()
+
+    def subscribe(self, listener):
+        self._listeners.append(listener)
+
+    def all(self):
+        with self._lock:
+            return list(self._rules.values())
+
+    def get(self, rule_id):
+        with self._lock:
+            return self._rules.get(rule_id)
+
+    def rules_for(self, measurement, field):
+        with self._lock:
+            return list(self._by_field.get((measurement, field), {}).values())
+
+    def add_rule(self, rule):
+        """Atribui um id à regra, grava e retorna a regra armazenada."""
+        if not isinstance(rule, dict):
+            raise ValueError("regra deve ser um objeto JSON")
+        rule = dict(rule, id=str(uuid.uuid4()))
+        with self._lock:
+            self._index(rule)
+            try:
+                self._persist()
+            except OSError:
+                self._unindex(rule)
+                raise
+            self._pending.append(("add", rule))
+        self._notify()
+        return rule
+
+    def delete_rule(self, rule_id):
+        """Remove e retorna a regra, ou None se o id não existe."""
+        with self._lock:
+            rule = self._rules.get(rule_id)
+            if rule is None:
+                return None
+            self._unindex(rule)
+            try:
+                self._persist()
+            except OSError:
+                self._index(rule)
+                raise
+            self._pending.append(("delete", rule))
+        self._notify()
+        return rule
@@ -0,0 +1,126 @@
+import threading
+
+# --- Rastreamento de Sequência e Relógio dos Dispositivos ---
+# O firmware local numera cada leitura ("seq", u32, iniciada em valor aleatório a
+# cada boot) e, com o relógio sincronizado por SNTP, envia o instante da amostra
+# ("ts", epoch em ms). O rastreador detecta lacunas, duplicatas e entregas fora de
+# ordem pela sequência e mede a diferença entre o relógio do gateway e o do
+# dispositivo.
+
+SEQ_MODULUS = 1 << 32
+
+def seq_distance(seq, reference):
+    """Diferença seq - reference em aritmética módulo 2^32, no intervalo [-2^31, 2^31)."""
+    return (seq - reference + SEQ_MODULUS // 2) % SEQ_MODULUS - SEQ_MODULUS // 2
+
+
+class DeviceSequence:
+    def __init__(self, seq):
+        self.highest = seq
+        self.missing = set()     # Sequências puladas que ainda podem chegar fora de ordem
+        self.received = 1
+        self.duplicates = 0
+        self.late = 0            # Chegaram depois de uma sequência maior
+        self.lost = 0            # Saíram da janela sem chegar
+        self.restarts = 0
+        self.skew_count = 0
+        self.skew_last_ms = None
+        self.skew_mean_ms = None
+        self.skew_min_ms = None
+        self.skew_max_ms = None
+
+    def add_skew(self, skew_ms, alpha):
+        self.skew_count += 1
+        self.skew_last_ms = skew_ms
+        self.skew_mean_ms = skew_ms if self.skew_mean_ms is None else self.skew_mean_ms + alpha * (skew_ms - self.skew_mean_ms)
+        self.skew_min_ms = skew_ms if self.skew_min_ms is None else min(self.skew_min_ms, skew_ms)
+        self.skew_max_ms = skew_ms if self.skew_max_ms is None else max(self.skew_max_ms, skew_ms)
+
+    def stats(self):
+        return {
+            "received": self.received, "duplicates": self.duplicates, "late": self.late,
+            "lost": self.lost, "missing": len(self.missing), "restarts": self.restarts,
+            "skew_samples": self.skew_count, "skew_last_ms": self.skew_last_ms,
+            "skew_mean_ms": None if self.skew_mean_ms is None else round(float(self.skew_mean_ms), 1),
+            "skew_min_ms": self.skew_min_ms, "skew_max_ms": self.skew_max_ms,
+        }
+
+
+class SequenceTracker:
+    """Estado de sequência por dispositivo. observe() é chamado pela thread do paho e
+    snapshot() pela thread de status, por isso todo acesso passa pelo lock.
+
+    Sequências até window abaixo da maior já vista são atrasadas (se estavam faltando)
+    ou duplicatas. Um salto para frente de até max_gap é uma lacuna (ex.: leituras
+    descartadas pela fila offline cheia); saltos maiores, ou para trás além da janela,
+    indicam que o dispositivo reiniciou: as pendentes contam como perdidas e o estado
+    recomeça.
+    """
+    NEW, LATE, DUPLICATE, RESTART = "new", "late", "duplicate", "restart"
+
+    def __init__(self, window=1024, max_gap=1 << 20, skew_alpha=0.05):
+        self.window = window
+        self.max_gap = max_gap
+        self.skew_alpha = skew_alpha
+        self._lock = threading.Lock()
+        self._devices = {}
+
+    def observe(self, device_id, seq, received_ms, ts_ms=None, age_ms=None):
+        """Registra uma leitura e retorna NEW, LATE, DUPLICATE ou RESTART.
+
+        received_ms é o relógio do gateway (epoch em ms) na chegada. Com ts_ms, a
+        diferença de relógio é received_ms - (ts_ms + age_ms): o dispositivo calcula
+        ts_ms no momento do envio menos age_ms, então o atraso da fila offline não
+        entra na medida, só o atraso de rede e a diferença de relógio.
+        """
+        with self._lock:
+            state = self._devices.get(device_id)
+            if state is None:
+                state = self._devices[device_id] = DeviceSequence(seq)
+                result = self.NEW
+            else:
+                result = self._advance(state, seq)
+            if ts_ms is not None and result != self.DUPLICATE:
+                state.add_skew(received_ms - (ts_ms + (age_ms or 0)), self.skew_alpha)
+            return result
+
+    def _advance(self, state, seq):
+        distance = seq_distance(seq, state.highest)
+        if 0 < distance <= self.max_gap:
+            # Só as sequências puladas dentro da janela ainda podem chegar fora de ordem
+            skipped = distance - 1
+            tracked = min(skipped, self.window - 1)
+            state.lost += skipped - tracked
+            state.missing.update((state.highest + i) % SEQ_MODULUS for i in range(distance - tracked, distance))
+            state.highest = seq
+            state.received += 1
+            self._expire_missing(state)
+            return self.NEW
+        if distance <= 0 and -distance < self.window:
+            if seq in state.missing:
+                state.missing.discard(seq)
+                state.received += 1
+                state.late += 1
+                return self.LATE
+            state.duplicates += 1
+            return self.DUPLICATE
+        # Salto grande demais para ser lacuna: o dispositivo reiniciou (seq inicial aleatória)
+        state.lost += len(state.missing)
+        state.missing.clear()
+        state.highest = seq
+        state.received += 1
+        state.restarts += 1
+        return self.RESTART
+
+    def _expire_missing(self, state):
+        if not state.missing:
+            return
+        expired = [seq for seq in state.missing if seq_distance(state.highest, seq) >= self.window]
+        for seq in expired:
+            state.missing.discard(seq)
+        state.lost += len(expired)
+
+    def snapshot(self):
+        """Estatísticas por dispositivo: {device_id: {...}}."""
+        with self._lock:
+            return {device_id: state.stats() for device_id, state in self._devices.items()}
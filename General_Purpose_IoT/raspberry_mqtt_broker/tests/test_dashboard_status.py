@@ -0,0 +1,175 @@
+import datetime
+import os
+import random
+import sys
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), ".."))
+
+from dashboard_status import DASHBOARD_STATUS_FIELDS, build_dashboard_status
+from last_value_cache import LastValueCache
+from measurement_schema import build_local_router
+
+STATUS_TIMEOUT = 15
+BURST_PERIOD_S = 30   # LOW_POWER_BURST_PERIOD_MS do esp32_mqtt_cloud
+T0 = datetime.datetime(2026, 10, 17, 12, 0, 0)
+
+
+def at(seconds):
+    return T0 + datetime.timedelta(seconds=seconds)
+
+
+class Replay:
+    """Reaplica pontos como o on_local_message: cada um vai para o "InfluxDB"
+    (lista de pontos) e para o cache, com o instante da amostra e o hold."""
+
+    def __init__(self):
+        self.points = []
+        self.cache = LastValueCache()
+
+    def write(self, sampled_at, measurement, device_id, fields, tags=None, hold_ms=None):
+        tags = {"device_id": device_id, **(tags or {})}
+        self.points.append((sampled_at, measurement, tags, fields))
+        self.cache.update(measurement, tags, fields, sampled_at,
+                          datetime.timedelta(milliseconds=hold_ms) if hold_ms else None)
+
+    def query_status(self, now):
+        """Status pelo caminho antigo: um SELECT last() por campo no InfluxDB, com
+        as regras do query_and_add de antes do cache."""
+        status_data = {}
+        for key, device_id, measurement, field, tags, options in DASHBOARD_STATUS_FIELDS:
+            wanted = {"device_id": device_id, **tags}
+            matching = [(t, f[field]) for t, m, tg, f in self.points
+                        if m == measurement and field in f and all(tg.get(k) == v for k, v in wanted.items())]
+            if not matching:
+                continue
+            last_time, value = max(matching, key=lambda p: p[0])   # last(): o ponto mais novo pelo tempo
+            if options.get("check_timeout") and (now - last_time).total_seconds() > STATUS_TIMEOUT:
+                status_data[key] = "offline"
+            elif options.get("is_gpio"):
+                status_data[key] = "ON" if value == "ON" else "OFF"
+            elif isinstance(value, (int, float)):
+                status_data[key] = round(value, options.get("round_digits", 2))
+            elif measurement == "device_status" and value in ["heartbeat", "online"]:
+                status_data[key] = "online"
+            else:
+                status_data[key] = value
+        return status_data
+
+    def cache_status(self, now):
+        return build_dashboard_status(self.cache, STATUS_TIMEOUT, now)
+
+
+def firmware_stream(replay, rng, start_s, seconds):
+    """Leituras do esp32_01 a cada 2 s e heartbeat do esp32_02 a cada 5 s."""
+    for t in range(start_s, start_s + seconds, 2):
+        replay.write(at(t), "bmp280", "esp32_01", {"temperature": rng.uniform(18, 30), "pressure": rng.uniform(1000, 1020),
+                                                   "pressure_sea_level": rng.uniform(1003, 1023)})
+        replay.write(at(t + 0.5), "dht11", "esp32_01", {"temperature": rng.uniform(18, 30), "humidity": rng.uniform(30, 80)})
+        replay.write(at(t + 1.0), "mq135", "esp32_01", {"adc_raw": rng.randrange(4096), "ppm": rng.uniform(300, 600)})
+        replay.write(at(t + 1.5), "ldr", "esp32_01", {"ldr_raw": rng.randrange(4096)})
+        if t % 10 == 0:
+            replay.write(at(t), "gpio_state", "esp32_01", {"state": rng.choice(("ON", "OFF", "on"))}, {"pin": "gpio2"})
+            replay.write(at(t), "gpio_state", "esp32_01", {"state": "ON"}, {"pin": "gpio4"})
+            replay.write(at(t), "bmp280", "esp32_03", {"temperature": -99.0})   # Outro dispositivo: fora do dashboard
+    for t in range(start_s, start_s + seconds, 5):
+        replay.write(at(t), "device_status", "esp32_02", {"status": rng.choice(("heartbeat", "online", "rebooting"))})
+
+
+class LastValueCacheReplayTest(unittest.TestCase):
+    def assert_same_status(self, replay, seconds):
+        for s in seconds:
+            with self.subTest(t=s):
+                self.assertEqual(replay.cache_status(at(s)), replay.query_status(at(s)))
+
+    def test_empty(self):
+        replay = Replay()
+        self.assertEqual(replay.cache_status(at(0)), {})
+        self.assertEqual(replay.query_status(at(0)), {})
+
+    def test_stream_matches_query_output(self):
+        replay = Replay()
+        rng = random.Random(6)
+        for chunk in range(0, 600, 60):
+            firmware_stream(replay, rng, chunk, 60)
+            self.assert_same_status(replay, (chunk + 59, chunk + 61.3))
+
+    def test_device_status_timeout(self):
+        replay = Replay()
+        replay.write(at(0), "device_status", "esp32_02", {"status": "heartbeat"})
+        self.assert_same_status(replay, (0, 10, 15, 15.001, 60))
+        self.assertEqual(replay.cache_status(at(15))["device_status"], "online")
+        self.assertEqual(replay.cache_status(at(15.001))["device_status"], "offline")
+
+    def test_low_power_heartbeat_stays_online_between_bursts(self):
+        # Modo de baixo consumo do esp32_mqtt_cloud: um heartbeat por rajada, mais
+        # espaçado que STATUS_TIMEOUT, com hold_ms de dois períodos no payload
+        replay = Replay()
+        router = build_local_router()
+        payload = b'{"status":"heartbeat","hold_ms":%d}' % (2 * BURST_PERIOD_S * 1000)
+        handler, levels = router.match("esp32_02/system/status")
+        [(measurement, tags, fields, meta)] = handler(levels, payload)
+        for t in range(0, 300, BURST_PERIOD_S):
+            if t == 150:
+                continue   # Uma rajada perdida
+            replay.write(at(t), measurement, tags["device_id"], fields, hold_ms=meta["hold_ms"])
+            for s in (t + STATUS_TIMEOUT + 0.001, t + BURST_PERIOD_S - 0.1):
+                self.assertEqual(replay.cache_status(at(s))["device_status"], "online", s)
+        # Parou de publicar: offline depois do hold mais STATUS_TIMEOUT
+        last = 270
+        self.assertEqual(replay.cache_status(at(last + 2 * BURST_PERIOD_S + STATUS_TIMEOUT))["device_status"], "online")
+        self.assertEqual(replay.cache_status(at(last + 2 * BURST_PERIOD_S + STATUS_TIMEOUT + 0.001))["device_status"],
+                         "offline")
+
+    def test_late_readings_do_not_replace_newer_values(self):
+        # Fila offline reenviada depois da volta do link: amostras mais antigas
+        # chegam depois das novas e o last() do InfluxDB continua com a mais nova
+        replay = Replay()
+        replay.write(at(100), "dht11", "esp32_01", {"temperature": 25.0, "humidity": 50.0})
+        for t in range(40, 100, 2):
+            replay.write(at(t), "dht11", "esp32_01", {"temperature": 20.0 + t / 100, "humidity": 40.0})
+        self.assert_same_status(replay, (100, 101))
+        self.assertEqual(replay.cache_status(at(101))["dht11_temperature"], 25.0)
+
+    def test_deadband_value_held_while_valid(self):
+        # Publicação por banda morta: o dispositivo fica em silêncio enquanto o
+        # valor não muda; dentro do hold (mais status_timeout) o dashboard mostra o
+        # mesmo que o last() do InfluxDB
+        replay = Replay()
+        replay.write(at(0), "ldr", "esp32_01", {"ldr_raw": 1234}, hold_ms=60000)
+        replay.write(at(0), "mq135", "esp32_01", {"adc_raw": 900, "ppm": 412.345}, hold_ms=60000)
+        self.assert_same_status(replay, (0, 30, 59.9, 60, 74.9, 75))
+        self.assertEqual(replay.cache_status(at(75))["ldr_raw"], 1234)
+
+    def test_deadband_value_expires_after_hold_and_timeout(self):
+        # Diferença intencional do cache: o last() mostrava o último valor para
+        # sempre; passado hold + status_timeout sem mensagem, o campo fica "offline"
+        replay = Replay()
+        replay.write(at(0), "ldr", "esp32_01", {"ldr_raw": 1234}, hold_ms=60000)
+        replay.write(at(0), "dht11", "esp32_01", {"temperature": 22.0, "humidity": 55.0})   # Sem hold: não expira
+        expired = replay.cache_status(at(75.001))
+        self.assertEqual(expired["ldr_raw"], "offline")
+        self.assertEqual(replay.query_status(at(75.001))["ldr_raw"], 1234)
+        self.assertEqual(expired["dht11_temperature"], 22.0)
+        self.assertEqual(replay.cache_status(at(3600))["dht11_temperature"], 22.0)
+
+    def test_new_reading_renews_or_clears_hold(self):
+        replay = Replay()
+        replay.write(at(0), "ldr", "esp32_01", {"ldr_raw": 1000}, hold_ms=60000)
+        replay.write(at(70), "ldr", "esp32_01", {"ldr_raw": 1100}, hold_ms=60000)   # Renova até 130 s
+        self.assert_same_status(replay, (75.001, 130, 145))
+        self.assertEqual(replay.cache_status(at(145.001))["ldr_raw"], "offline")
+        replay.write(at(150), "ldr", "esp32_01", {"ldr_raw": 1200})                  # Sem hold: vale até a próxima
+        self.assert_same_status(replay, (150, 3600))
+
+    def test_late_reading_does_not_extend_hold(self):
+        # Uma amostra atrasada com hold não pode trazer de volta um valor expirado
+        replay = Replay()
+        replay.write(at(100), "ldr", "esp32_01", {"ldr_raw": 2000}, hold_ms=10000)
+        replay.write(at(50), "ldr", "esp32_01", {"ldr_raw": 1500}, hold_ms=600000)
+        self.assertEqual(replay.cache_status(at(110))["ldr_raw"], 2000)
+        self.assertEqual(replay.cache_status(at(125.001))["ldr_raw"], "offline")
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,27 @@
+import os
+import sys
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "..", "loadtest"))
+
+from dispatch_bench import compare, synthetic_messages
+
+
+class DispatchTest(unittest.TestCase):
+    def test_schema_router_matches_old_if_chain(self):
+        # Sensores por tópico e em lote, JSON e binário v1, GPIO e status
+        messages = synthetic_messages(devices=8, cycles=11)
+        self.assertEqual(compare(messages), [])
+
+    def test_unknown_and_malformed_topics_produce_no_points(self):
+        messages = [
+            ("dev/sensor/unknown", b'{"x": 1}'),
+            ("dev/sensor/bmp280", b"not json"),
+            ("dev/sensor/batch", b'{"sensor": "ldr"}'),
+            ("dev/other/topic", b"1"),
+        ]
+        self.assertEqual(compare(messages), [])
+
+
+if __name__ == "__main__":
+    unittest.main()
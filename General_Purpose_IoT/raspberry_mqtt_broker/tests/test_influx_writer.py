@@ -0,0 +1,85 @@
+import os
+import sys
+import tempfile
+import time
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), ".."))
+
+from influx_writer import InfluxWriter, point_to_line
+
+
+class Crash(BaseException):
+    """Queda do processo: não é capturada pelos except Exception do escritor."""
+
+
+class FakeInflux:
+    def __init__(self, crash_on_write=None):
+        self.lines = []
+        self.writes = 0
+        self.crash_on_write = crash_on_write
+
+    def write_points(self, lines, protocol=None):
+        self.writes += 1
+        if self.writes == self.crash_on_write:
+            raise Crash()
+        self.lines.extend(lines)
+
+
+def point(i):
+    return {"measurement": "dht11", "tags": {"device_id": "esp32_01"}, "fields": {"temperature": 20.0 + i},
+            "time": 1760000000000000000 + i}
+
+
+class SpillReplayTest(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.spill = os.path.join(self.dir.name, "influx_spill.lp")
+
+    def tearDown(self):
+        self.dir.cleanup()
+
+    def test_crash_during_replay_is_resumed_on_next_start(self):
+        spilled = [point_to_line(point(i)) for i in range(6)]
+        with open(self.spill, "w") as f:
+            f.write("\n".join(spilled) + "\n")
+        # Queda no segundo lote do reenvio: o primeiro já chegou ao InfluxDB
+        first = FakeInflux(crash_on_write=2)
+        writer = InfluxWriter(first, batch_size=2, spill_file=self.spill)
+        with self.assertRaises(Crash):
+            writer._replay_spill()
+        self.assertEqual(first.lines, spilled[:2])
+        self.assertTrue(os.path.exists(self.spill + ".replay"))
+        self.assertFalse(os.path.exists(self.spill))
+        # Antes da queda, outro lote falhou e foi para um spill novo
+        late = point_to_line(point(6))
+        with open(self.spill, "w") as f:
+            f.write(late + "\n")
+
+        # Próxima partida: o .replay volta ao spill e é reenviado depois da primeira gravação
+        second = FakeInflux()
+        writer = InfluxWriter(second, batch_size=2, flush_interval=0.05, spill_file=self.spill)
+        writer.start()
+        writer.write_points([point(7)])
+        deadline = time.monotonic() + 5
+        while len(second.lines) < 8 and time.monotonic() < deadline:
+            time.sleep(0.01)
+        writer.stop()
+        self.assertEqual(second.lines, [point_to_line(point(7))] + spilled + [late])
+        self.assertFalse(os.path.exists(self.spill))
+        self.assertFalse(os.path.exists(self.spill + ".replay"))
+        self.assertEqual(writer.get_stats()["replayed"], 7)
+
+    def test_leftover_replay_without_new_spill(self):
+        spilled = [point_to_line(point(i)) for i in range(3)]
+        with open(self.spill + ".replay", "w") as f:
+            f.write("\n".join(spilled) + "\n")
+        writer = InfluxWriter(FakeInflux(), spill_file=self.spill)
+        writer._recover_replay()
+        with open(self.spill) as f:
+            self.assertEqual(f.read().splitlines(), spilled)
+        self.assertFalse(os.path.exists(self.spill + ".replay"))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,129 @@
+import json
+import os
+import sys
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), ".."))
+
+from measurement_schema import READING_META, SENSOR_SCHEMAS, build_local_router, decode_binary_records
+
+# Vetores gerados pelo codec do firmware (host/tests/telemetry_golden.c): os
+# quatro sensores com todas as combinações de flags de metadados, em v1 e v2.
+GOLDEN_PATH = os.path.join(os.path.dirname(__file__), "fixtures", "telemetry_golden.jsonl")
+
+
+def load_golden():
+    with open(GOLDEN_PATH, encoding="utf-8") as f:
+        return [json.loads(line) for line in f if line.strip()]
+
+
+def expected_fields(vector):
+    schema = SENSOR_SCHEMAS[vector["measurement"]]
+    return {f.name: f.from_binary(vector["fields"][f.name]) for f in schema.fields}
+
+
+class GoldenVectorTest(unittest.TestCase):
+    def test_covers_every_sensor_and_flag_combination(self):
+        vectors = load_golden()
+        all_flags = 0
+        for bit, _, _ in READING_META:
+            all_flags |= bit
+        combos = {(v["measurement"], frozenset(v["meta"])) for v in vectors}
+        self.assertEqual(len(combos), len(SENSOR_SCHEMAS) * (all_flags + 1))
+
+    def test_each_record_decodes_to_the_encoded_values(self):
+        for vector in load_golden():
+            payload = bytes.fromhex(vector["hex"])
+            with self.subTest(measurement=vector["measurement"], meta=sorted(vector["meta"])):
+                self.assertEqual(payload[0], 2 if vector["meta"] else 1)
+                readings = decode_binary_records(payload)
+                self.assertEqual(len(readings), 1)
+                measurement, fields, meta = readings[0]
+                self.assertEqual(measurement, vector["measurement"])
+                self.assertEqual(fields, expected_fields(vector))
+                self.assertEqual(meta, vector["meta"])
+
+    def test_concatenated_records_decode_as_a_batch(self):
+        vectors = load_golden()
+        payload = b"".join(bytes.fromhex(v["hex"]) for v in vectors)
+        readings = decode_binary_records(payload)
+        self.assertEqual([r[0] for r in readings], [v["measurement"] for v in vectors])
+        self.assertEqual([r[1] for r in readings], [expected_fields(v) for v in vectors])
+        self.assertEqual([r[2] for r in readings], [v["meta"] for v in vectors])
+
+    def test_truncated_record_is_rejected(self):
+        for vector in load_golden():
+            payload = bytes.fromhex(vector["hex"])
+            with self.subTest(measurement=vector["measurement"], meta=sorted(vector["meta"])):
+                with self.assertRaises(ValueError):
+                    decode_binary_records(payload[:-1])
+
+
+
+class LocalRouterTest(unittest.TestCase):
+    def setUp(self):
+        self.router = build_local_router()
+
+    def route(self, topic, payload):
+        handler, levels = self.router.match(topic)
+        self.assertIsNotNone(handler, topic)
+        return handler(levels, payload)
+
+    def test_pin_state_is_a_gpio_state_point(self):
+        self.assertEqual(self.route("esp32_02/gpio/4/state", b"on"),
+                         [("gpio_state", {"device_id": "esp32_02", "pin": "gpio4"}, {"state": "ON"}, {})])
+
+    def test_bulk_state_is_known_but_not_recorded(self):
+        # O estado de cada pino do lote chega pelo tópico retido do pino
+        self.assertIsNone(self.route("esp32_02/gpio/bulk/state", b'{"mask": 20, "value": 4}'))
+
+    def test_sensor_health_is_one_point_per_driver(self):
+        payload = (b'{"bmp280":{"reads":120,"failures":2,"streak":0,"age_ms":850},'
+                   b'"dht11":{"reads":0,"failures":7,"streak":7,"age_ms":-1}}')
+        self.assertEqual(self.route("esp32_01/status/sensors", payload), [
+            ("sensor_health", {"device_id": "esp32_01", "sensor": "bmp280"},
+             {"reads": 120, "failures": 2, "streak": 0, "age_ms": 850}, {}),
+            # age_ms -1: o driver ainda não teve leitura boa
+            ("sensor_health", {"device_id": "esp32_01", "sensor": "dht11"},
+             {"reads": 0, "failures": 7, "streak": 7}, {}),
+        ])
+
+    def test_device_status_is_not_shadowed_by_sensor_health(self):
+        self.assertEqual(self.route("esp32_01/status", b"heartbeat"),
+                         [("device_status", {"device_id": "esp32_01"}, {"status": "heartbeat"}, {})])
+
+    def test_low_power_heartbeat_carries_hold(self):
+        self.assertEqual(self.route("esp32_02/system/status", b'{"status":"heartbeat","hold_ms":60000}'),
+                         [("device_status", {"device_id": "esp32_02"}, {"status": "heartbeat"}, {"hold_ms": 60000})])
+
+    def test_diagnostics_is_a_gpio_latency_point(self):
+        payload = (b'{"commands":42,"window":16,"edge_us":{"last":35,"mean":40,"max":120},'
+                   b'"publish_us":{"last":900,"mean":1100,"max":4800}}')
+        self.assertEqual(self.route("esp32_02/system/diagnostics", payload), [
+            ("gpio_latency", {"device_id": "esp32_02"},
+             {"commands": 42, "window": 16, "edge_last_us": 35, "edge_mean_us": 40, "edge_max_us": 120,
+              "publish_last_us": 900, "publish_mean_us": 1100, "publish_max_us": 4800}, {}),
+        ])
+
+    def test_outbox_is_one_point_per_broker(self):
+        payload = (b'{"cloud":{"up":1,"pending":0,"bytes":0,"sent":57,"coalesced":3,"dropped":0,"failed":1},'
+                   b'"local":{"up":0,"pending":4,"bytes":96,"sent":50,"coalesced":0,"dropped":2,"failed":0}}')
+        self.assertEqual(self.route("esp32_02/system/outbox", payload), [
+            ("device_outbox", {"device_id": "esp32_02", "broker": "cloud"},
+             {"up": 1, "pending": 0, "bytes": 0, "sent": 57, "coalesced": 3, "dropped": 0, "failed": 1}, {}),
+            ("device_outbox", {"device_id": "esp32_02", "broker": "local"},
+             {"up": 0, "pending": 4, "bytes": 96, "sent": 50, "coalesced": 0, "dropped": 2, "failed": 0}, {}),
+        ])
+
+    def test_malformed_diagnostics_have_no_points(self):
+        for topic in ("esp32_01/status/sensors", "esp32_02/system/diagnostics", "esp32_02/system/outbox"):
+            self.assertEqual(self.route(topic, b"{truncado"), [], topic)
+            self.assertEqual(self.route(topic, b'{"x":"y"}'), [], topic)
+
+    def test_logs_are_known_but_not_recorded(self):
+        self.assertIsNone(self.route("esp32_02/system/logs", b"I (1200) mqtt: conectado\n"))
+        self.assertIsNone(self.route("esp32_01/system/logs/get", b""))
+
+
+if __name__ == "__main__":
+    unittest.main()
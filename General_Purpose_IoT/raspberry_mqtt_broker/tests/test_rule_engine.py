@@ -0,0 +1,219 @@
+import argparse
+import os
+import sys
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), ".."))
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "..", "loadtest"))
+
+import rule_bench
+from rule_engine import RuleEngine
+
+DEVICE = {"device_id": "esp32_01"}
+
+
+def rule(rule_id, aggregator, operator=">", threshold=30, range_="5m", measurement="dht11", field="temperature"):
+    return {"id": rule_id, "name": rule_id, "measurement": measurement, "field": field, "range": range_,
+            "filter": "\"device_id\" = 'esp32_01'", "operator": operator, "threshold": threshold,
+            "aggregator": aggregator}
+
+
+class RuleEngineTestCase(unittest.TestCase):
+    def setUp(self):
+        self.fired = []
+        self.engine = RuleEngine(lambda r: self.fired.append((r["id"], self.now)), refire_interval=15)
+        self.now = 1000.0
+
+    def ingest(self, value, **kwargs):
+        self.engine.ingest("dht11", DEVICE, {"temperature": value}, now=self.now, **kwargs)
+
+    def fired_ids(self):
+        return [rule_id for rule_id, _ in self.fired]
+
+
+class WarmUpTest(RuleEngineTestCase):
+    # Sem histórico (InfluxDB fora do ar) as janelas começam vazias depois de um
+    # reinício: média, mínimo e máximo só decidem quando a janela já viu um range
+    # inteiro; "last" decide com um ponto
+
+    def test_mean_waits_for_a_full_range(self):
+        self.engine.set_rules([rule("mean", "mean")])
+        start = self.now
+        while self.now < start + 300:
+            self.ingest(35.0)
+            self.now += 2
+        self.assertEqual(self.fired, [])
+        self.ingest(35.0)                                    # now = start + 300: janela coberta
+        self.assertEqual(self.fired, [("mean", start + 300)])
+
+    def test_partial_window_would_have_misfired(self):
+        # Dois pontos altos logo depois do reinício: a média parcial passaria de 30,
+        # mas a janela completa (com os pontos baixos que chegam) não passa
+        self.engine.set_rules([rule("mean", "mean")])
+        start = self.now
+        for value in (40.0, 40.0):
+            self.ingest(value)
+            self.now += 2
+        while self.now <= start + 320:
+            self.ingest(20.0)
+            self.now += 2
+        self.assertEqual(self.fired, [])
+
+    def test_last_fires_immediately(self):
+        self.engine.set_rules([rule("last", "last"), rule("max", "max")])
+        self.ingest(35.0)
+        self.assertEqual(self.fired_ids(), ["last"])
+
+    def test_tick_fires_when_window_becomes_covered(self):
+        # Dispositivo por banda morta: um ponto e silêncio; o valor mantido
+        # (hold) completa a janela e tick() avalia a regra suspensa
+        self.engine.set_rules([rule("max", "max", range_="1m")])
+        self.ingest(35.0, hold_s=600)
+        start = self.now
+        for step in range(1, 61):
+            self.now = start + step
+            self.engine.tick(now=self.now)
+        self.assertEqual(self.fired, [("max", start + 60)])
+
+    def test_unchanged_rules_keep_their_warm_window(self):
+        rules = [rule("mean", "mean", threshold=12, range_="1m")]   # Média final: (29 x 10 + 100) / 30 = 13
+        self.engine.set_rules(rules)
+        for _ in range(31):
+            self.ingest(10.0)
+            self.now += 2
+        self.engine.set_rules(rules + [rule("other", "mean", range_="2m")])   # Janela nova para "other"
+        self.ingest(100.0)
+        self.assertEqual(self.fired_ids(), ["mean"])
+
+
+class HistorySeedTest(RuleEngineTestCase):
+    # Gateway reiniciado com o InfluxDB no ar: cada janela nova é preenchida com
+    # os pontos já gravados e a regra decide de imediato, como a consulta de antes
+
+    def setUp(self):
+        super().setUp()
+        self.queries = []
+        self.stored = [(self.now - 3600 + t, 35.0) for t in range(0, 3600, 2)]   # Última hora, a cada 2 s
+
+    def history(self, measurement, field, tag_filter, range_s):
+        self.queries.append((measurement, field, tag_filter, range_s))
+        return [(t, v) for t, v in self.stored if t > self.now - range_s]
+
+    def restart(self, history):
+        self.engine = RuleEngine(lambda r: self.fired.append((r["id"], self.now)), refire_interval=15, history=history)
+
+    def test_restart_fires_on_first_tick(self):
+        self.restart(self.history)
+        self.engine.set_rules([rule("hour", "mean", range_="1h"), rule("max", "max", range_="5m")], now=self.now)
+        self.assertEqual(self.queries, [("dht11", "temperature", (("device_id", "esp32_01"),), 3600.0),
+                                        ("dht11", "temperature", (("device_id", "esp32_01"),), 300.0)])
+        self.engine.tick(now=self.now)
+        self.assertEqual(sorted(self.fired), [("hour", self.now), ("max", self.now)])
+        hour = self.engine._compiled[0].window
+        self.assertEqual(len(hour.points), 1799)   # "time > now() - 1h": sem o ponto de now - 3600
+        self.assertAlmostEqual(hour.aggregate("mean"), 35.0)
+
+    def test_seeded_window_matches_stored_points(self):
+        self.stored = [(self.now - 300 + t, float(t % 7)) for t in range(0, 300, 2)]
+        self.restart(self.history)
+        self.engine.set_rules([rule("mean", "mean", threshold=3)], now=self.now)
+        self.ingest(10.0)
+        in_range = [v for t, v in self.stored if t > self.now - 300]
+        expected = (sum(in_range) + 10.0) / (len(in_range) + 1)
+        self.assertAlmostEqual(self.engine._compiled[0].window.aggregate("mean"), expected)
+        self.assertEqual(self.fired_ids(), ["mean"])
+
+    def test_points_received_during_query_are_kept_once(self):
+        # Um ponto chega entre a criação da janela e a resposta: fica uma vez só,
+        # depois do histórico
+        def history(*args):
+            self.ingest(50.0)
+            return self.history(*args) + [(self.now, 50.0)]
+        self.restart(history)
+        self.engine.set_rules([rule("max", "max", range_="1m")], now=self.now)
+        window = self.engine._compiled[0].window
+        self.assertEqual(list(window.points)[-2:], [(self.now - 2, 35.0), (self.now, 50.0)])
+        self.assertEqual(len(window.points), 30)
+
+    def test_unchanged_rules_are_not_queried_again(self):
+        self.restart(self.history)
+        rules = [rule("mean", "mean")]
+        self.engine.set_rules(rules, now=self.now)
+        self.engine.set_rules(rules + [rule("other", "max", range_="2m")], now=self.now)
+        self.assertEqual([q[3] for q in self.queries], [300.0, 120.0])
+
+    def test_failed_query_falls_back_to_warm_up(self):
+        def history(*args):
+            raise ConnectionError("InfluxDB fora do ar")
+        self.restart(history)
+        with self.assertLogs(level="WARNING"):
+            self.engine.set_rules([rule("mean", "mean")], now=self.now)
+        self.ingest(35.0)
+        self.engine.tick(now=self.now)
+        self.assertEqual(self.fired, [])
+        self.now += 300
+        self.ingest(35.0)
+        self.assertEqual(self.fired_ids(), ["mean"])
+
+
+class DelayedReadingTest(RuleEngineTestCase):
+    # Modo de baixo consumo: as leituras do período chegam juntas numa rajada a
+    # cada 30 s, cada uma com o seu age_ms
+
+    def burst(self, value, period=30, step=2):
+        """Rajada com as leituras dos últimos period segundos, a mais velha primeiro."""
+        for age in range(period - step, -1, -step):
+            self.ingest(value, age_s=age)
+
+    def test_bursts_fire_rules(self):
+        self.engine.set_rules([rule("last", "last"), rule("mean", "mean", range_="1m")])
+        self.burst(35.0)
+        self.assertEqual(self.fired, [("last", self.now)])
+        for _ in range(2):
+            self.now += 30
+            self.burst(35.0)
+        # Só na terceira rajada a primeira amostra (now - 88) cobre a janela de 1 min;
+        # "last" repete a cada rajada enquanto a condição vale
+        self.assertEqual([t for rule_id, t in self.fired if rule_id == "mean"], [self.now])
+        self.assertEqual(self.fired_ids().count("last"), 3)
+
+    def test_readings_enter_windows_at_sample_time(self):
+        self.engine.set_rules([rule("max", "max", range_="1m")])
+        self.ingest(20.0, age_s=28)
+        self.now += 30
+        self.ingest(40.0, age_s=28)   # Amostrado 30 s depois do primeiro
+        window = self.engine._compiled[0].window
+        self.assertEqual([t for t, _ in window.points], [self.now - 58, self.now - 28])
+        self.engine.tick(now=self.now + 2.1)   # O primeiro ponto (20) sai da janela
+        self.assertEqual(window.aggregate("max"), 40.0)
+        self.assertEqual(len(window.points), 1)
+
+    def test_sample_older_than_window_is_skipped(self):
+        self.engine.set_rules([rule("short", "max", range_="30s"), rule("long", "max", range_="5m")])
+        self.ingest(35.0, age_s=45)
+        short, long_ = (entry.window for entry in self.engine._compiled)
+        self.assertEqual(list(short.points), [])
+        self.assertEqual(list(long_.points), [(self.now - 45, 35.0)])
+
+    def test_stale_offline_queue_is_ignored(self):
+        self.engine.set_rules([rule("last", "last")])
+        self.ingest(35.0, age_s=600)   # Fila offline de uma queda longa: só histórico
+        self.assertEqual(self.fired, [])
+        self.assertEqual(list(self.engine._compiled[0].window.points), [])
+        self.ingest(35.0, age_s=59)
+        self.assertEqual(self.fired_ids(), ["last"])
+
+
+class ReplayTest(unittest.TestCase):
+    def test_windows_match_recomputed_aggregates(self):
+        # Versão curta do loadtest/rule_bench.py: centenas de regras, 16 minutos
+        # simulados (cobre a janela de 15 min) e os agregados conferidos a cada minuto
+        args = argparse.Namespace(rules=400, devices=8, minutes=16, seed=3, recorded=None, rate=100.0)
+        result = rule_bench.run(args)
+        self.assertGreater(result["checked"], 0)
+        self.assertGreater(result["fired"], 0)
+        self.assertEqual(result["mismatches"], 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
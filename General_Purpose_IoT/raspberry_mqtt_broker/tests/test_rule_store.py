@@ -0,0 +1,181 @@
+import json
+import os
+import random
+import signal
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+import unittest
+from unittest import mock
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), ".."))
+
+from rule_store import RuleStore
+
+GATEWAY_DIR = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+
+
+def sample_rule(i, measurement="dht11"):
+    return {"name": f"regra {i}", "measurement": measurement, "field": "temperature", "range": "5m",
+            "filter": "\"device_id\" = 'esp32_01'", "operator": ">", "threshold": 30 + i,
+            "action_topic": "esp32_02/gpio/2/set", "action_payload": "ON"}
+
+
+def read_rules(path):
+    with open(path) as f:
+        return json.load(f)
+
+
+class RuleStoreTestCase(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.path = os.path.join(self.dir.name, "automation_rules.json")
+
+    def tearDown(self):
+        self.dir.cleanup()
+
+
+class ConcurrencyTest(RuleStoreTestCase):
+    def test_concurrent_add_and_delete(self):
+        # 8 threads criando e apagando regras ao mesmo tempo: memória, índice,
+        # arquivo e eventos dos listeners terminam consistentes
+        store = RuleStore(self.path)
+        events = []
+        store.subscribe(lambda event, rule: events.append((event, rule["id"])))
+        kept, errors = [], []
+
+        def worker(n):
+            try:
+                rng = random.Random(n)
+                for i in range(40):
+                    rule = store.add_rule(sample_rule(i, measurement=rng.choice(("dht11", "bmp280"))))
+                    if i % 2:
+                        self.assertIs(store.delete_rule(rule["id"]), rule)
+                    else:
+                        kept.append(rule["id"])
+                    store.all()
+                    store.rules_for("dht11", "temperature")
+            except Exception as e:   # Falha numa thread vira falha do teste
+                errors.append(e)
+
+        threads = [threading.Thread(target=worker, args=(n,)) for n in range(8)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertEqual(errors, [])
+        self.assertEqual(sorted(r["id"] for r in store.all()), sorted(kept))
+        self.assertEqual(sorted(r["id"] for r in read_rules(self.path)), sorted(kept))
+        self.assertEqual(sorted(r["id"] for r in RuleStore(self.path).all()), sorted(kept))
+        by_field = store.rules_for("dht11", "temperature") + store.rules_for("bmp280", "temperature")
+        self.assertEqual(sorted(r["id"] for r in by_field), sorted(kept))
+        # Um evento por alteração, e o "delete" de uma regra sempre depois do "add"
+        self.assertEqual(len(events), 8 * 40 + 8 * 20)
+        seen = set()
+        for event, rule_id in events:
+            if event == "add":
+                seen.add(rule_id)
+            else:
+                self.assertIn(rule_id, seen)
+
+    def test_listener_runs_without_the_store_lock(self):
+        # O listener espera outra thread usar o store: com o lock ainda preso, travaria
+        store = RuleStore(self.path)
+        results = []
+
+        def listener(event, rule):
+            other = threading.Thread(target=lambda: results.append(len(store.all())))
+            other.start()
+            other.join(timeout=5)
+            results.append(other.is_alive())
+
+        store.subscribe(listener)
+        store.add_rule(sample_rule(1))
+        self.assertEqual(results, [1, False])
+
+    def test_listener_can_change_the_store(self):
+        # Alteração feita dentro de um listener é entregue depois, na ordem
+        store = RuleStore(self.path)
+        events = []
+
+        def listener(event, rule):
+            events.append((event, rule["name"]))
+            if event == "add" and rule["name"] == "regra 1":
+                store.delete_rule(rule["id"])
+                store.add_rule(sample_rule(2))
+
+        store.subscribe(listener)
+        store.add_rule(sample_rule(1))
+        self.assertEqual(events, [("add", "regra 1"), ("delete", "regra 1"), ("add", "regra 2")])
+        self.assertEqual([r["name"] for r in store.all()], ["regra 2"])
+
+
+class CrashConsistencyTest(RuleStoreTestCase):
+    def test_failed_write_keeps_old_file_and_memory(self):
+        store = RuleStore(self.path)
+        first = store.add_rule(sample_rule(1))
+        before = read_rules(self.path)
+        events = []
+        store.subscribe(lambda event, rule: events.append(event))
+        # Queda depois de gravar metade do temporário, antes da renomeação
+        real_dump = json.dump
+
+        def torn_dump(obj, f, **kwargs):
+            text = json.dumps(obj, **kwargs)
+            f.write(text[:len(text) // 2])
+            raise OSError("disco cheio")
+
+        with mock.patch("rule_store.json.dump", torn_dump):
+            with self.assertRaises(OSError):
+                store.add_rule(sample_rule(2))
+            with self.assertRaises(OSError):
+                store.delete_rule(first["id"])
+        self.assertIs(json.dump, real_dump)
+        self.assertEqual(read_rules(self.path), before)
+        self.assertEqual(store.all(), before)
+        self.assertEqual(store.rules_for("dht11", "temperature"), before)
+        self.assertEqual(events, [])
+        with mock.patch("rule_store.os.replace", side_effect=OSError("queda na renomeação")):
+            with self.assertRaises(OSError):
+                store.add_rule(sample_rule(3))
+        self.assertEqual(read_rules(self.path), before)
+        self.assertEqual(RuleStore(self.path).all(), before)
+
+    def test_killed_writer_leaves_old_or_new_file(self):
+        # Um processo grava regras sem parar e é morto (SIGKILL) em instantes
+        # aleatórios: o arquivo é sempre uma lista JSON completa, com as regras
+        # inteiras, de uma das versões gravadas
+        writer = (
+            "import sys\n"
+            f"sys.path.insert(0, {GATEWAY_DIR!r})\n"
+            "from rule_store import RuleStore\n"
+            "store = RuleStore(sys.argv[1])\n"
+            "print('pronto', flush=True)\n"
+            "i = len(store.all())\n"
+            "while True:\n"
+            "    i += 1\n"
+            "    store.add_rule({'name': f'regra {i}', 'measurement': 'dht11', 'field': 'temperature',\n"
+            "                    'range': '5m', 'operator': '>', 'threshold': i, 'pad': 'x' * 2000})\n"
+        )
+        rng = random.Random(8)
+        previous = 0
+        for _ in range(12):
+            proc = subprocess.Popen([sys.executable, "-c", writer, self.path], stdout=subprocess.PIPE)
+            self.assertEqual(proc.stdout.readline().strip(), b"pronto")
+            time.sleep(rng.uniform(0.005, 0.05))
+            proc.send_signal(signal.SIGKILL)
+            proc.wait()
+            proc.stdout.close()
+            rules = read_rules(self.path)   # JSONDecodeError aqui seria um arquivo rasgado
+            self.assertIsInstance(rules, list)
+            self.assertGreaterEqual(len(rules), previous)
+            self.assertEqual([r["threshold"] for r in rules], list(range(1, len(rules) + 1)))
+            self.assertTrue(all(r.get("id") and r["pad"] == "x" * 2000 for r in rules))
+            previous = len(rules)
+        self.assertGreater(previous, 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,167 @@
+import os
+import sys
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), ".."))
+
+from sequence_tracker import SEQ_MODULUS, SequenceTracker, seq_distance
+
+DEVICE = "esp32_01"
+
+
+class FakeClock:
+    """Relógio do gateway (epoch em ms) controlado pelo teste."""
+
+    def __init__(self, now_ms=1760000000000):
+        self.now_ms = now_ms
+
+    def advance(self, ms):
+        self.now_ms += ms
+        return self.now_ms
+
+
+class SequenceTrackerTestCase(unittest.TestCase):
+    def setUp(self):
+        self.clock = FakeClock()
+        self.tracker = SequenceTracker()
+
+    def observe(self, seq, **kwargs):
+        self.clock.advance(500)
+        return self.tracker.observe(DEVICE, seq, self.clock.now_ms, **kwargs)
+
+    def stats(self):
+        return self.tracker.snapshot()[DEVICE]
+
+
+class SequenceTest(SequenceTrackerTestCase):
+    def test_in_order_readings_are_new(self):
+        results = [self.observe(seq) for seq in range(100, 110)]
+        self.assertEqual(results, [SequenceTracker.NEW] * 10)
+        stats = self.stats()
+        self.assertEqual((stats["received"], stats["lost"], stats["missing"]), (10, 0, 0))
+
+    def test_skipped_reading_arriving_later_is_late(self):
+        self.observe(100)
+        self.observe(103)
+        self.assertEqual(self.stats()["missing"], 2)
+        self.assertEqual(self.observe(101), SequenceTracker.LATE)
+        self.assertEqual(self.observe(102), SequenceTracker.LATE)
+        stats = self.stats()
+        self.assertEqual((stats["received"], stats["late"], stats["missing"], stats["lost"]), (4, 2, 0, 0))
+
+    def test_repeated_reading_is_duplicate(self):
+        for seq in (100, 101, 102):
+            self.observe(seq)
+        self.assertEqual(self.observe(101), SequenceTracker.DUPLICATE)
+        self.assertEqual(self.observe(102), SequenceTracker.DUPLICATE)
+        stats = self.stats()
+        self.assertEqual((stats["received"], stats["duplicates"]), (3, 2))
+
+    def test_late_reading_seen_twice_is_duplicate_the_second_time(self):
+        self.observe(100)
+        self.observe(102)
+        self.assertEqual(self.observe(101), SequenceTracker.LATE)
+        self.assertEqual(self.observe(101), SequenceTracker.DUPLICATE)
+
+    def test_device_restart_with_new_random_seq(self):
+        for seq in range(5000, 5010):
+            self.observe(seq)
+        self.observe(5013)   # 5010..5012 pendentes
+        self.assertEqual(self.observe(7), SequenceTracker.RESTART)
+        self.assertEqual(self.observe(8), SequenceTracker.NEW)
+        stats = self.stats()
+        self.assertEqual((stats["restarts"], stats["lost"], stats["missing"], stats["received"]), (1, 3, 0, 13))
+
+    def test_missing_readings_expire_as_lost_after_the_window(self):
+        self.observe(100)
+        self.observe(102)    # 101 pendente
+        self.observe(100 + self.tracker.window)
+        self.assertEqual(self.stats()["lost"], 0)
+        self.observe(101 + self.tracker.window)
+        stats = self.stats()
+        self.assertEqual((stats["lost"], stats["missing"]), (1, self.tracker.window - 3))
+
+    def test_gap_wider_than_window_counts_untracked_as_lost(self):
+        self.observe(0)
+        self.assertEqual(self.observe(2000), SequenceTracker.NEW)
+        stats = self.stats()
+        tracked = self.tracker.window - 1
+        self.assertEqual((stats["missing"], stats["lost"]), (tracked, 1999 - tracked))
+
+    def test_seq_wraps_around_2_32(self):
+        self.assertEqual(seq_distance(0, SEQ_MODULUS - 1), 1)
+        self.assertEqual(seq_distance(SEQ_MODULUS - 1, 0), -1)
+        results = [self.observe(seq) for seq in (SEQ_MODULUS - 2, SEQ_MODULUS - 1, 1)]
+        self.assertEqual(results, [SequenceTracker.NEW] * 3)
+        self.assertEqual(self.observe(0), SequenceTracker.LATE)
+        self.assertEqual(self.observe(SEQ_MODULUS - 1), SequenceTracker.DUPLICATE)
+        self.assertEqual(self.observe(2), SequenceTracker.NEW)
+        stats = self.stats()
+        self.assertEqual((stats["restarts"], stats["lost"], stats["missing"], stats["late"]), (0, 0, 0, 1))
+
+    def test_jump_up_to_max_gap_is_a_gap_beyond_is_a_restart(self):
+        tracker = SequenceTracker(window=16, max_gap=1000)
+        tracker.observe(DEVICE, 0, self.clock.now_ms)
+        self.assertEqual(tracker.observe(DEVICE, 1000, self.clock.now_ms), SequenceTracker.NEW)
+        stats = tracker.snapshot()[DEVICE]
+        self.assertEqual((stats["missing"], stats["lost"]), (15, 999 - 15))
+        self.assertEqual(tracker.observe(DEVICE, 2001, self.clock.now_ms), SequenceTracker.RESTART)
+        stats = tracker.snapshot()[DEVICE]
+        self.assertEqual((stats["restarts"], stats["missing"], stats["lost"]), (1, 0, 999))
+
+    def test_devices_are_tracked_independently(self):
+        self.observe(100)
+        self.assertEqual(self.tracker.observe("esp32_03", 100, self.clock.now_ms), SequenceTracker.NEW)
+        self.assertEqual(set(self.tracker.snapshot()), {DEVICE, "esp32_03"})
+
+
+class SkewTest(SequenceTrackerTestCase):
+    DEVICE_BEHIND_MS = 250   # O relógio do dispositivo está atrasado em relação ao do gateway
+    NETWORK_MS = 20
+
+    def send(self, seq, age_ms=0):
+        """Leitura amostrada age_ms antes do envio; chega NETWORK_MS depois no gateway."""
+        sent_device_ms = self.clock.now_ms - self.DEVICE_BEHIND_MS
+        self.clock.advance(self.NETWORK_MS)
+        return self.tracker.observe(DEVICE, seq, self.clock.now_ms, ts_ms=sent_device_ms - age_ms, age_ms=age_ms)
+
+    def test_skew_is_clock_offset_plus_network_delay(self):
+        self.send(1)
+        stats = self.stats()
+        expected = self.DEVICE_BEHIND_MS + self.NETWORK_MS
+        self.assertEqual((stats["skew_last_ms"], stats["skew_mean_ms"]), (expected, expected))
+
+    def test_age_ms_removes_offline_queue_delay(self):
+        self.send(1, age_ms=30000)
+        self.send(2, age_ms=12500)
+        stats = self.stats()
+        expected = self.DEVICE_BEHIND_MS + self.NETWORK_MS
+        self.assertEqual((stats["skew_min_ms"], stats["skew_max_ms"]), (expected, expected))
+
+    def test_mean_is_ewma(self):
+        alpha = self.tracker.skew_alpha
+        self.send(1)
+        self.clock.advance(1000)
+        self.NETWORK_MS = 120
+        self.send(2)
+        first, second = 270, 370
+        stats = self.stats()
+        self.assertEqual((stats["skew_samples"], stats["skew_min_ms"], stats["skew_max_ms"]), (2, first, second))
+        self.assertAlmostEqual(stats["skew_mean_ms"], round(first + alpha * (second - first), 1))
+
+    def test_duplicate_does_not_update_skew(self):
+        self.send(1)
+        ts_ms = self.clock.now_ms - self.NETWORK_MS - self.DEVICE_BEHIND_MS
+        self.clock.advance(5000)   # Reentrega da mesma leitura bem depois: não deve contar
+        self.tracker.observe(DEVICE, 1, self.clock.now_ms, ts_ms=ts_ms, age_ms=0)
+        stats = self.stats()
+        self.assertEqual((stats["skew_samples"], stats["skew_max_ms"]), (1, self.DEVICE_BEHIND_MS + self.NETWORK_MS))
+
+    def test_reading_without_ts_has_no_skew(self):
+        self.observe(1)
+        stats = self.stats()
+        self.assertEqual((stats["skew_samples"], stats["skew_mean_ms"]), (0, None))
+
+
+if __name__ == "__main__":
+    unittest.main()